@@ -0,0 +1,74 @@
+// Microbenchmark: N same-size windows through N × SpectrumAnalyzer::Compute vs one
+// BatchSpectrumAnalyzer::Compute (SIMD kissfft, lanes() streams per FFT call), single thread.
+// Usage: batch_spectrum_bench [iterations]
+
+#include "fft_spectrum.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+template <typename Fn>
+double TimeIt(Fn&& fn) {
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+  const int windows[] = {512, 1024, 2048, 4096};
+  const int stream_counts[] = {4, 8};
+
+  std::printf("lanes per FFT call: %d\n", sw::BatchSpectrumAnalyzer::lanes());
+  std::printf("%-8s %-8s %14s %14s %10s\n", "window", "streams", "single us", "batch us",
+              "speedup");
+  for (int window : windows) {
+    sw::SpectrumConfig cfg;
+    cfg.window_size = window;
+    sw::SpectrumAnalyzer single(cfg);
+    sw::BatchSpectrumAnalyzer batch(cfg);
+    const size_t bins = static_cast<size_t>(window / 2 + 1);
+
+    for (int streams : stream_counts) {
+      std::vector<std::vector<float>> input(static_cast<size_t>(streams),
+                                            std::vector<float>(static_cast<size_t>(window)));
+      std::vector<std::vector<float>> out(static_cast<size_t>(streams), std::vector<float>(bins));
+      std::vector<const float*> in_ptrs;
+      std::vector<float*> out_ptrs;
+      for (int s = 0; s < streams; ++s) {
+        for (int n = 0; n < window; ++n) {
+          input[static_cast<size_t>(s)][static_cast<size_t>(n)] =
+              std::sin(0.01f * static_cast<float>(n * (s + 1)));
+        }
+        in_ptrs.push_back(input[static_cast<size_t>(s)].data());
+        out_ptrs.push_back(out[static_cast<size_t>(s)].data());
+      }
+
+      const double single_s = TimeIt([&]() {
+        for (int it = 0; it < iterations; ++it) {
+          for (int s = 0; s < streams; ++s) {
+            single.Compute(in_ptrs[static_cast<size_t>(s)], static_cast<size_t>(window),
+                           out_ptrs[static_cast<size_t>(s)], bins);
+          }
+        }
+      });
+      const double batch_s = TimeIt([&]() {
+        for (int it = 0; it < iterations; ++it) {
+          batch.Compute(in_ptrs.data(), static_cast<size_t>(window), streams, out_ptrs.data(),
+                        bins);
+        }
+      });
+      std::printf("%-8d %-8d %14.2f %14.2f %9.2fx\n", window, streams,
+                  single_s * 1e6 / iterations, batch_s * 1e6 / iterations, single_s / batch_s);
+    }
+  }
+  return 0;
+}
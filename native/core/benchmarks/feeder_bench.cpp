@@ -0,0 +1,83 @@
+// Benchmark: 引擎整条播放链路（裸 PCM 解码 + 预解码 + 喂数暂存 + 回放线程）的进程 CPU 开销，
+// 按实际播放的音频时长归一为「每秒音频耗用的 CPU 毫秒数」，并报告播放期间的欠载次数。
+// 回放线程按墙钟节拍消费，运行时长约等于给定秒数。
+// Usage: feeder_bench [seconds_of_playback] [pcm_frames_per_push]
+
+#include "audio_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+constexpr int kChannels = 2;
+
+// s16 双声道斜坡，比播放时长多留 2 秒，避免测到 EOF 之后的静音填充。
+std::string WriteRawPcm(double seconds) {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "sw_feeder_bench.raw").string();
+  const size_t frames = static_cast<size_t>((seconds + 2.0) * kSampleRate);
+  std::vector<int16_t> samples(frames * kChannels);
+  for (size_t i = 0; i < frames; ++i) {
+    samples[i * kChannels] = static_cast<int16_t>(i % 32768);
+    samples[i * kChannels + 1] = static_cast<int16_t>(-static_cast<int32_t>(i % 32768));
+  }
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(samples.data()),
+            static_cast<std::streamsize>(samples.size() * sizeof(int16_t)));
+  return path;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const double seconds = argc > 1 ? std::max(0.5, std::atof(argv[1])) : 2.0;
+  const int push = argc > 2 ? std::max(0, std::atoi(argv[2])) : 0;
+  const std::string path = WriteRawPcm(seconds);
+
+  std::unique_ptr<sw::AudioEngine> engine = sw::CreateAudioEngineStub();
+  sw::AudioConfig cfg;
+  cfg.sample_rate = kSampleRate;
+  cfg.channels = kChannels;
+  cfg.frames_per_buffer = 480;
+  cfg.pcm_frames_per_push = push;
+  if (engine->Init(cfg) != sw::Status::kOk || engine->Load(path) != sw::Status::kOk) {
+    std::printf("failed to load %s\n", path.c_str());
+    return 1;
+  }
+  std::atomic<int64_t> last_pos{0};
+  engine->SetPositionCallback(
+      [](int64_t pos, void* ud) { static_cast<std::atomic<int64_t>*>(ud)->store(pos); },
+      &last_pos);
+
+  const std::clock_t cpu_start = std::clock();
+  engine->Play();
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  engine->Pause();
+  const double cpu_ms = 1000.0 * static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+  const double audio_s = static_cast<double>(last_pos.load()) / 1000.0;
+  const sw::BufferStats stats = engine->GetBufferStats();
+  engine.reset();
+  std::remove(path.c_str());
+  if (audio_s <= 0.0) {
+    std::printf("no audio played\n");
+    return 1;
+  }
+  const double per_second = cpu_ms / audio_s;
+  std::printf("played %.2f s, push %d frames\n", audio_s, push > 0 ? push : cfg.frames_per_buffer);
+  std::printf("%.2f ms CPU per second of audio (%.0fx realtime), %llu underruns\n", per_second,
+              1000.0 / std::max(per_second, 1e-3),
+              static_cast<unsigned long long>(stats.playback_underruns));
+  return 0;
+}
@@ -0,0 +1,62 @@
+// Microbenchmark: RingBuffer kLocked vs kSpsc with one producer and one consumer thread.
+// Usage: ring_buffer_bench [total_frames]
+
+#include "ring_buffer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kChannels = 2;
+constexpr size_t kCapacityFrames = 16384;
+
+double RunOnce(sw::RingBufferMode mode, size_t chunk_frames, size_t total_frames) {
+  sw::RingBuffer buffer(kCapacityFrames, kChannels, mode);
+  const auto start = std::chrono::steady_clock::now();
+
+  std::thread producer([&]() {
+    std::vector<float> chunk(chunk_frames * kChannels, 0.25f);
+    size_t produced = 0;
+    while (produced < total_frames) {
+      const size_t wrote = buffer.Write(chunk.data(), chunk_frames);
+      if (wrote == 0) {
+        std::this_thread::yield();
+      }
+      produced += wrote;
+    }
+  });
+
+  std::vector<float> out(chunk_frames * kChannels);
+  size_t consumed = 0;
+  while (consumed < total_frames) {
+    const size_t got = buffer.Read(out.data(), chunk_frames);
+    if (got == 0) {
+      std::this_thread::yield();
+    }
+    consumed += got;
+  }
+  producer.join();
+
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t total_frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000000ULL;
+  const size_t chunks[] = {256, 1024, 4096};
+
+  std::printf("%-8s %12s %12s %10s\n", "chunk", "locked Mf/s", "spsc Mf/s", "speedup");
+  for (size_t chunk : chunks) {
+    const double locked = RunOnce(sw::RingBufferMode::kLocked, chunk, total_frames);
+    const double spsc = RunOnce(sw::RingBufferMode::kSpsc, chunk, total_frames);
+    std::printf("%-8zu %12.1f %12.1f %9.2fx\n", chunk, total_frames / locked / 1e6,
+                total_frames / spsc / 1e6, locked / spsc);
+  }
+  return 0;
+}
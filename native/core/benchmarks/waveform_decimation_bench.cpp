@@ -0,0 +1,85 @@
+// Microbenchmark: min/max/RMS waveform decimation of one interleaved PCM push, scalar vs every
+// SIMD level available on this CPU, plus the payload reduction versus pushing raw PCM.
+// Usage: waveform_decimation_bench [iterations_per_case]
+
+#include "simd_kernels.h"
+#include "waveform_decimator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+// 与 WaveformDecimator::Process 相同的分桶方式，但指定内核级别。
+double NsPerPush(const sw::SimdKernels& k, const std::vector<float>& pcm, int frames,
+                 int channels, int buckets, size_t iterations) {
+  std::vector<float> scratch(static_cast<size_t>(channels) * 3);
+  float* mn = scratch.data();
+  float* mx = mn + channels;
+  float* ss = mx + channels;
+  float sink = 0.0f;
+  auto run = [&](size_t count) {
+    for (size_t it = 0; it < count; ++it) {
+      int64_t begin = 0;
+      for (int b = 0; b < buckets; ++b) {
+        const int64_t end = static_cast<int64_t>(b + 1) * frames / buckets;
+        k.min_max_sumsq(pcm.data() + begin * channels, static_cast<size_t>(end - begin),
+                        channels, mn, mx, ss);
+        sink += mx[0] - mn[0] + ss[0];
+        begin = end;
+      }
+    }
+  };
+  run(iterations / 10 + 1);
+  const auto start = std::chrono::steady_clock::now();
+  run(iterations);
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  if (sink == 12345.0f) std::printf(" ");
+  return elapsed.count() / static_cast<double>(iterations);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000ULL;
+  struct Case {
+    int frames;
+    int channels;
+    int buckets;
+  };
+  const Case cases[] = {{1024, 2, 256}, {1024, 2, 64}, {4096, 2, 256}, {4096, 2, 128},
+                        {4096, 6, 128}, {16384, 2, 256}};
+  const sw::SimdLevel levels[] = {sw::SimdLevel::kSse2, sw::SimdLevel::kAvx2,
+                                  sw::SimdLevel::kNeon};
+  const sw::SimdKernels& scalar = *sw::SimdKernelsFor(sw::SimdLevel::kScalar);
+
+  std::printf("active: %s\n", sw::SimdLevelName(sw::ActiveSimdKernels().level));
+  std::printf("%-7s %-3s %-7s %10s %-8s %12s %9s\n", "frames", "ch", "buckets", "bytes", "level",
+              "ns/push", "speedup");
+  for (const Case& c : cases) {
+    std::vector<float> pcm(static_cast<size_t>(c.frames) * static_cast<size_t>(c.channels));
+    for (size_t i = 0; i < pcm.size(); ++i) {
+      pcm[i] = static_cast<float>(i % 89) * 0.02f - 0.9f;
+    }
+    const size_t raw_bytes = pcm.size() * sizeof(float);
+    const size_t out_bytes = static_cast<size_t>(c.buckets) * static_cast<size_t>(c.channels) *
+                             sizeof(sw::WaveformBucket);
+    char bytes[32];
+    std::snprintf(bytes, sizeof(bytes), "%zu/%zu", raw_bytes, out_bytes);
+    const double base = NsPerPush(scalar, pcm, c.frames, c.channels, c.buckets, iterations);
+    std::printf("%-7d %-3d %-7d %10s %-8s %12.1f %8.2fx  (payload %.1fx smaller)\n", c.frames,
+                c.channels, c.buckets, bytes, "scalar", base, 1.0,
+                static_cast<double>(raw_bytes) / static_cast<double>(out_bytes));
+    for (sw::SimdLevel level : levels) {
+      const sw::SimdKernels* k = sw::SimdKernelsFor(level);
+      if (k == nullptr) continue;
+      const double ns = NsPerPush(*k, pcm, c.frames, c.channels, c.buckets, iterations);
+      std::printf("%-7d %-3d %-7d %10s %-8s %12.1f %8.2fx\n", c.frames, c.channels, c.buckets,
+                  bytes, sw::SimdLevelName(level), ns, base / ns);
+    }
+  }
+  return 0;
+}
@@ -9,6 +9,12 @@
 
 namespace sw {
 
+// 波形降采样：每次 PCM 推送按帧均分为 num_buckets 个桶，逐桶逐声道输出 min/max/RMS，
+// 替代整段交错 PCM 供波形视图绘制。
+struct WaveformConfig {
+  int num_buckets = 256;  // 通常取视图的像素列数；推送帧数不足时每帧一个桶。
+};
+
 struct AudioConfig {
   int sample_rate = 48000;
   int channels = 2;
@@ -20,6 +26,11 @@ struct AudioConfig {
   int spectrum_max_fps = 30;     // 频谱推送频率上限（帧/秒，默认低于 PCM）。
   size_t spectrum_max_pending = 2;  // 频谱待发上限。
   SpectrumConfig spectrum_cfg;    // 频谱计算配置。
+  WaveformConfig waveform_cfg;    // 波形降采样配置；推送限频沿用 pcm_max_fps/pcm_max_pending。
+  // 后台预解码窗口（高水位，毫秒）：解码线程最多领先喂数线程这么多音频。
+  int prefetch_ms = 500;
+  // 预解码降到该时长以下才恢复解码（低水位），0 取 prefetch_ms / 2；不得大于 prefetch_ms。
+  int prefetch_refill_ms = 0;
 };
 
 enum class Status {
@@ -59,15 +70,61 @@ struct PcmFrame {
 
 struct SpectrumFrame {
   const float* bins = nullptr;
-  int num_bins = 0;           // window_size/2 + 1
+  int num_bins = 0;           // window_size/2 + 1；启用频带时为频带数。
   int window_size = 0;
-  float bin_hz = 0.0f;
+  float bin_hz = 0.0f;        // 线性 bin 间距（启用频带时仍为 FFT 分辨率）。
+  BandScale band_scale = BandScale::kNone;  // 非 kNone 时 bins 为频带值。
+  const float* band_hz = nullptr;           // 各频带中心频率（num_bins 个），仅频带模式有效。
   int sample_rate = 0;
   WindowType window = WindowType::kHann;
   bool power_spectrum = true;  // true: power, false: magnitude.
+  bool decibels = false;       // bins/peaks 已换算为 dB（spectrum_cfg.post.decibels）。
+  const float* peaks = nullptr;  // 峰值保持值（num_bins 个，单位同 bins），仅 post.peak_hold 时有效。
   int64_t timestamp_ms = 0;
 };
 
+struct WaveformBucket {
+  float min = 0.0f;
+  float max = 0.0f;
+  float rms = 0.0f;
+};
+
+struct WaveformFrame {
+  // num_buckets × num_channels 个桶，按桶交错：buckets[b * num_channels + c]。
+  const WaveformBucket* buckets = nullptr;
+  int num_buckets = 0;
+  int num_channels = 0;
+  int num_frames = 0;           // 覆盖的源 PCM 帧数（桶 b 为 [b·N/B, (b+1)·N/B)）。
+  int sample_rate = 0;
+  int64_t timestamp_ms = 0;     // 首帧的 presentation time。
+  uint32_t sequence = 0;
+  uint32_t dropped_before = 0;  // 同 PcmFrame。
+};
+
+// 异步分发队列满时的处理策略。
+enum class PcmOverflowPolicy {
+  kDropOldest,  // 丢弃最旧的待分发帧，保证 UI 看到最新数据。
+  kDropNewest,  // 丢弃新到的帧。
+};
+
+// 订阅者配置：每个订阅者独立限频/限帧，负载在订阅者之间按引用共享。
+struct PcmSubscriberConfig {
+  int max_fps = 60;        // 0 表示不限频。
+  size_t max_pending = 4;  // 限频时最多排队的帧数；异步分发时也是该订阅者的队列容量。
+  PcmOverflowPolicy overflow = PcmOverflowPolicy::kDropOldest;  // 仅异步分发时生效。
+};
+
+using SubscriptionId = uint32_t;  // 0 为无效 id。
+
+// 播放缓冲快照（GetBufferStats），欠载计数自 Init 起累计。
+struct BufferStats {
+  int64_t prefetched_ms = 0;      // 已预解码、尚未送入环形缓冲的音频时长。
+  int64_t ring_ms = 0;            // 环形缓冲中尚未播放的音频时长。
+  int64_t buffered_ahead_ms = 0;  // 二者之和：当前播放位置之后已解码就绪的音频。
+  uint64_t decode_underruns = 0;    // 播放中途预解码队列被取空（解码跟不上）的次数。
+  uint64_t playback_underruns = 0;  // 播放中途环形缓冲被取空（出现断音）的次数。
+};
+
 // Minimal audio engine interface (stub for TDD).
 class AudioEngine {
  public:
@@ -86,6 +143,26 @@ class AudioEngine {
   virtual void SetPositionCallback(void (*callback)(int64_t position_ms, void*), void* user_data) = 0;
   virtual void SetSpectrumCallback(void (*callback)(const SpectrumFrame&, void*),
                                    void* user_data) = 0;
+  // 按 AudioConfig::waveform_cfg 降采样后的波形，限频同 PCM 回调。
+  virtual void SetWaveformCallback(void (*callback)(const WaveformFrame&, void*),
+                                   void* user_data) = 0;
+
+  // Additional subscribers, each throttled independently of the callbacks above and of each
+  // other. Returns 0 on invalid arguments. Must not be called from inside a callback.
+  virtual SubscriptionId AddPcmSubscriber(const PcmSubscriberConfig& config,
+                                          void (*callback)(const PcmFrame&, void*),
+                                          void* user_data) = 0;
+  virtual SubscriptionId AddSpectrumSubscriber(const PcmSubscriberConfig& config,
+                                               void (*callback)(const SpectrumFrame&, void*),
+                                               void* user_data) = 0;
+  virtual SubscriptionId AddWaveformSubscriber(const PcmSubscriberConfig& config,
+                                               void (*callback)(const WaveformFrame&, void*),
+                                               void* user_data) = 0;
+  // Returns false if id is unknown. After return the callback is no longer invoked.
+  virtual bool RemoveSubscriber(SubscriptionId id) = 0;
+
+  // Snapshot of how much decoded audio is queued ahead of playback; callable from any thread.
+  virtual BufferStats GetBufferStats() const = 0;
 };
 
 // Factory for the stub implementation used in bootstrap/testing.
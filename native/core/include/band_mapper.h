@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "audio_engine.h"
+#include "fft_spectrum.h"
+
+namespace sw {
+
+// 线性 bin → 频带的稀疏权重矩阵（每个频带只存覆盖到的连续 bin 区间与权重，权重和为 1，
+// 即频带值为所覆盖 bin 的加权平均）。按 (band 配置, window_size, sample_rate) 预计算，
+// Apply 不分配。频带窄于 bin 间距时退化为在中心频率处对相邻两个 bin 线性插值。
+// 非线程安全，每条流一个实例。
+class BandMapper {
+ public:
+  BandMapper() = default;
+
+  // band_scale 为 kNone 或参数无效（min_hz <= 0、min_hz >= 上限、num_bands < 1、
+  // octave_fraction 不在 [1, 24]、window_size/sample_rate <= 0、没有可用频带）时返回 false。
+  // 参数未变化时直接返回 true，不重建权重。
+  bool Configure(const SpectrumConfig& cfg, int sample_rate);
+  bool configured() const { return !bands_.empty(); }
+
+  int num_bands() const { return static_cast<int>(bands_.size()); }
+  // 输入线性 bin 数（window_size/2 + 1）。
+  int num_bins() const { return num_bins_; }
+  // 各频带中心频率（Hz），用于 UI 标注。
+  const float* center_hz() const { return center_hz_.data(); }
+
+  // bins 至少 num_bins() 个，out_bands 至少 num_bands() 个；否则返回 false。
+  bool Apply(const float* bins, size_t bin_count, float* out_bands, size_t out_capacity) const;
+
+  // 频带 |band| 覆盖的首个 bin 与对应权重（count 个），主要供测试检查。
+  int first_bin(int band) const {
+    return static_cast<int>(bands_[static_cast<size_t>(band)].first_bin);
+  }
+  int bin_count(int band) const {
+    return static_cast<int>(bands_[static_cast<size_t>(band)].count);
+  }
+  const float* weights(int band) const {
+    return weights_.data() + bands_[static_cast<size_t>(band)].weight_offset;
+  }
+
+ private:
+  struct Band {
+    uint32_t first_bin = 0;
+    uint32_t count = 0;
+    uint32_t weight_offset = 0;
+  };
+
+  // 当前权重对应的参数（用于判断是否需要重建）。
+  BandScale scale_ = BandScale::kNone;
+  int bands_requested_ = 0;
+  int octave_fraction_ = 0;
+  float min_hz_ = 0.0f;
+  float max_hz_ = 0.0f;
+  int window_size_ = 0;
+  int sample_rate_ = 0;
+
+  int num_bins_ = 0;
+  std::vector<Band> bands_;
+  std::vector<float> weights_;
+  std::vector<float> center_hz_;
+
+  void Clear();
+  // 追加一个频带：|bin_weights| 为 [first, first + count) 的未归一权重；全为 0 时按
+  // |center| 插值。
+  void AddBand(float center, int first, const std::vector<float>& bin_weights, float bin_hz);
+};
+
+// 频谱产出方（引擎/事件总线/流式 STFT）共用的频带阶段：cfg.band_scale 为 kNone 时不改动
+// |frame| 并返回 true；否则按 frame 的 window_size/sample_rate 配置 |mapper|，把线性 bin 映射
+// 到 |scratch|，并让 frame 改为指向频带值（num_bins = 频带数，band_hz = 中心频率）。
+// 频带参数无效时返回 false。scratch 仅在频带数变化时扩容。
+bool MapSpectrumFrame(const SpectrumConfig& cfg, BandMapper* mapper, std::vector<float>* scratch,
+                      SpectrumFrame* frame);
+
+}  // namespace sw
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "audio_engine.h"
+#include "decoder.h"
+
+namespace sw {
+
+struct DecodePrefetcherConfig {
+  int sample_rate = 48000;  // 解码器输出采样率，用于毫秒与帧数换算。
+  int channels = 2;
+  // 预解码窗口（高水位）：已解码未取走的音频达到该时长即暂停解码。
+  int read_ahead_ms = 500;
+  // 低水位：暂停后降到该时长以下才恢复解码（成批补满，避免每取一块就唤醒一次）。
+  // 0 表示 read_ahead_ms / 2；不得大于 read_ahead_ms。
+  int refill_ms = 0;
+  // 预计的单块帧数（解码器每次 Read 的输出），仅用于确定预分配的块数。
+  int block_frames_hint = 1024;
+};
+
+struct DecodePrefetchStats {
+  int64_t buffered_frames = 0;  // 已解码、尚未被 Pop 取走的帧数（近似）。
+  uint64_t blocks_decoded = 0;
+  uint64_t refills = 0;    // 从低水位恢复解码的次数。
+  uint64_t underruns = 0;  // 播放中途 Pop 发现队列已空（解码跟不上）的次数。
+};
+
+enum class PrefetchResult {
+  kBlock,  // 取到一块。
+  kEmpty,  // 暂无数据（解码未跟上，或刚 Seek/Start）。
+  kEnd,    // 当前位置之后已无数据：EOF 或解码出错，见 Pop 的 status 参数。
+};
+
+// 后台预解码：独立线程提前调用 Decoder::Read，把解码好的块放进无锁 SPSC 队列，消费者（喂数线程）
+// 按需取用，解码耗时的抖动不再直接造成环形缓冲欠载。块缓冲预先分配并在两个 SPSC 队列之间循环，
+// 稳态不分配内存。
+// 线程模型：Start/Stop/Reset 在控制线程调用（Reset 需已 Stop）；Seek 可在任意线程调用；
+// Pop/WaitForData 仅在一个消费线程调用；stats 可在任意线程调用。
+class DecodePrefetcher {
+ public:
+  explicit DecodePrefetcher(const DecodePrefetcherConfig& config);
+  ~DecodePrefetcher();
+
+  DecodePrefetcher(const DecodePrefetcher&) = delete;
+  DecodePrefetcher& operator=(const DecodePrefetcher&) = delete;
+
+  // 启动预解码线程；运行期间 decoder 只由该线程访问，须在 Stop 之后才能释放或另作他用。
+  // 配置非法、decoder 为空或已在运行时返回 false。
+  bool Start(Decoder* decoder);
+  // 停止并 join 预解码线程；已解码的块保留，再次 Start 后继续消费。
+  void Stop();
+  bool running() const;
+
+  // 丢弃已预解码的块，从 frame 处重新解码（停止期间调用则在下次 Start 时生效）。
+  void Seek(int64_t frame);
+  // 清空队列与待定位请求（例如更换解码器前），统计计数保留。需已 Stop。
+  void Reset();
+
+  // 取出最早的一块：与 out->interleaved 交换存储（out 原有的缓冲回收进池），不拷贝。
+  // 返回 kEnd 时 *status 为解码器的结束状态（kOk 表示正常 EOF），其余情况不修改 *status。
+  PrefetchResult Pop(PcmBuffer* out, Status* status);
+  // 阻塞到有块可取、到达结尾、Stop 或超时；返回时是否有数据可 Pop。
+  bool WaitForData(std::chrono::nanoseconds timeout);
+
+  int64_t buffered_frames() const;
+  int64_t buffered_ms() const;
+  DecodePrefetchStats stats() const;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace sw
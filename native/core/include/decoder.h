@@ -24,12 +24,16 @@ class Decoder {
   // Returns true if a frame is read; false on EOF or error.
   virtual bool Read(PcmBuffer& out_buffer) = 0;
   virtual void Close() = 0;
+  // Positions the next Read at output frame `frame` (clamped to the end of the stream).
+  // Returns false when not opened, on negative frames, or if the source cannot seek.
+  virtual bool Seek(int64_t frame) = 0;
 
   virtual int sample_rate() const = 0;
   virtual int channels() const = 0;
 
-  // Optional: override output format (e.g., resampler placeholder).
-  // Returns false on invalid arguments; no-op stub will adjust reported format.
+  // Optional: override output format. File decoders resample and remap channels to it
+  // (see resampler.h); the stub only adjusts the reported format.
+  // Returns false on invalid arguments or unsupported conversions.
   virtual bool ConfigureOutput(int target_sample_rate, int target_channels) = 0;
 
   // Returns last operation status (open/read/config).
@@ -38,4 +42,10 @@ class Decoder {
 
 std::unique_ptr<Decoder> CreateStubDecoder();
 
+// Picks a decoder for `source` (a path or file:// URI): existing local .wav/.wave/.pcm/.raw
+// files get a PcmFileDecoder (see pcm_file_decoder.h), existing .flac files a FlacDecoder
+// (flac_decoder.h); everything else still falls back to the stub until the corresponding codecs
+// land.
+std::unique_ptr<Decoder> CreateDecoderForSource(const std::string& source);
+
 }  // namespace sw
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -8,20 +10,168 @@ namespace sw {
 
 enum class WindowType { kHann, kHamming };
 
+// Optional band aggregation after the FFT (see band_mapper.h).
+enum class BandScale {
+  kNone,    // all window_size/2 + 1 linear bins.
+  kLog,     // num_bands log-spaced rectangular bands.
+  kMel,     // num_bands triangular mel (HTK) filters.
+  kOctave,  // 1/octave_fraction octave bands centred on 1 kHz * 2^(k/N).
+};
+
+// Stateful per-stream post-processing after the FFT/band stage (see spectrum_post.h). Applied
+// by the engine, PcmEventBus and StreamingStft; the stateless ComputeSpectrum* helpers ignore it.
+struct SpectrumPostConfig {
+  bool decibels = false;         // 10·log10 (power) / 20·log10 (magnitude), clamped to db_floor.
+  float db_floor = -100.0f;
+  float attack_ms = 0.0f;        // Rise time constant; 0 → follow instantly.
+  float release_ms = 0.0f;       // Fall time constant; 0 → follow instantly.
+  bool peak_hold = false;
+  float peak_hold_ms = 500.0f;   // Peaks stay put this long before decaying.
+  float peak_decay_db_per_s = 20.0f;
+};
+
 struct SpectrumConfig {
   int window_size = 1024;
   int overlap = 0;              // samples overlap between frames.
   WindowType window = WindowType::kHann;
   bool power_spectrum = true;   // true: power spectrum, false: magnitude.
+  // Band stage: when band_scale != kNone, spectra carry band values instead of linear bins.
+  BandScale band_scale = BandScale::kNone;
+  int num_bands = 64;           // kLog / kMel.
+  int octave_fraction = 3;      // kOctave: 1/N octave (1..24).
+  float min_hz = 20.0f;
+  float max_hz = 0.0f;          // 0 → Nyquist; clamped to Nyquist.
+  SpectrumPostConfig post;
+};
+
+// Fills |size| window coefficients (symmetric, N - 1 denominator) into |out| and returns their
+// sum, used to normalise spectra. Returns 0 if |size| <= 0 or |out| is null.
+float FillWindow(WindowType type, int size, float* out);
+
+// Reusable spectrum analyzer: owns the kiss_fftr plan, the precomputed window table (and its
+// sum) and scratch buffers, so repeated frames of the same size do no re-planning.
+// Not thread-safe; use one instance per thread/stream.
+class SpectrumAnalyzer {
+ public:
+  SpectrumAnalyzer();
+  explicit SpectrumAnalyzer(const SpectrumConfig& cfg);
+  ~SpectrumAnalyzer();
+
+  SpectrumAnalyzer(const SpectrumAnalyzer&) = delete;
+  SpectrumAnalyzer& operator=(const SpectrumAnalyzer&) = delete;
+  SpectrumAnalyzer(SpectrumAnalyzer&&) noexcept;
+  SpectrumAnalyzer& operator=(SpectrumAnalyzer&&) noexcept;
+
+  // Applies config; the plan/window table is rebuilt only when window_size or window changes.
+  // Returns false if window_size is invalid or the plan cannot be allocated.
+  bool Configure(const SpectrumConfig& cfg);
+
+  const SpectrumConfig& config() const;
+  // window_size/2 + 1 when configured, otherwise 0.
+  int num_bins() const;
+
+  // Computes one frame from the first window_size samples.
+  // Returns empty if not configured or |samples| is shorter than window_size.
+  std::vector<float> Compute(const std::vector<float>& samples);
+
+  // Zero-allocation variant: reads window_size samples from |samples| (|count| available) and
+  // writes num_bins() values into |out_bins| (|out_capacity| available). Returns false on
+  // invalid arguments, short input or insufficient output capacity.
+  bool Compute(const float* samples, size_t count, float* out_bins, size_t out_capacity);
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+// Multi-stream analyzer: the same config over one window per stream (e.g. several decks/tracks
+// on one core). On x86-64 GCC/Clang builds windows are packed lanes() at a time into kissfft's
+// USE_SIMD build (__m128, one FFT call for four streams); elsewhere lanes() is 1 and streams are
+// processed one by one. Not thread-safe; use one instance per thread.
+class BatchSpectrumAnalyzer {
+ public:
+  // Streams per FFT call: 4 with the SIMD kissfft build, otherwise 1.
+  static int lanes();
+
+  BatchSpectrumAnalyzer();
+  explicit BatchSpectrumAnalyzer(const SpectrumConfig& cfg);
+  ~BatchSpectrumAnalyzer();
+
+  BatchSpectrumAnalyzer(const BatchSpectrumAnalyzer&) = delete;
+  BatchSpectrumAnalyzer& operator=(const BatchSpectrumAnalyzer&) = delete;
+  BatchSpectrumAnalyzer(BatchSpectrumAnalyzer&&) noexcept;
+  BatchSpectrumAnalyzer& operator=(BatchSpectrumAnalyzer&&) noexcept;
+
+  // Same contract as SpectrumAnalyzer::Configure (window_size must be even).
+  bool Configure(const SpectrumConfig& cfg);
+
+  const SpectrumConfig& config() const;
+  int num_bins() const;
+
+  // Reads window_size samples from each samples[s] (|count| available per stream) and writes
+  // num_bins() values into out_bins[s] (|out_capacity| each), s in [0, num_streams). Any
+  // num_streams >= 1 works; streams are grouped lanes() per FFT. Does not allocate.
+  bool Compute(const float* const* samples, size_t count, int num_streams,
+               float* const* out_bins, size_t out_capacity);
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
 };
 
 // Compute single-frame spectrum from time-domain samples.
-// Returns size window_size/2 + 1 bins (DC..Nyquist).
+// Returns size window_size/2 + 1 bins (DC..Nyquist), or the band values when cfg.band_scale is
+// set (see SpectrumOutputSize). Plans and band weights are cached per thread. cfg.post is not
+// applied (it needs per-stream state); run the result through a SpectrumPostProcessor instead.
 std::vector<float> ComputeSpectrum(const std::vector<float>& samples, int sample_rate,
                                    const SpectrumConfig& cfg);
 
+// Caller-buffer variant of ComputeSpectrum: writes SpectrumOutputSize() values into |out_bins|.
+// Does not allocate once this thread's plan (and band weights) for the config are warm.
+bool ComputeSpectrum(const float* samples, size_t count, int sample_rate,
+                     const SpectrumConfig& cfg, float* out_bins, size_t out_capacity);
+
+// Values produced by ComputeSpectrum for |cfg| at |sample_rate|: the band count when a band
+// stage is configured, otherwise window_size/2 + 1. 0 if the config is invalid.
+int SpectrumOutputSize(const SpectrumConfig& cfg, int sample_rate);
+
+// Offline spectrogram (e.g. thumbnails / seek previews): frames at start = i * hop_size, each
+// window_size samples long, zero-padded to fft_size.
+struct SpectrogramConfig {
+  int window_size = 1024;
+  int hop_size = 512;
+  int fft_size = 0;     // 0 → window_size; must be even and >= window_size.
+  WindowType window = WindowType::kHann;
+  bool power_spectrum = true;
+  int num_threads = 0;  // 0 → hardware concurrency; 1 → calling thread only.
+};
+
+// Number of full windows in |num_frames| samples (0 if config is invalid or input too short).
+int SpectrogramFrameCount(size_t num_frames, const SpectrogramConfig& cfg);
+// fft_size/2 + 1 (0 if config is invalid).
+int SpectrogramBinCount(const SpectrogramConfig& cfg);
+
+// Fills a row-major frames × bins matrix (row i = window starting at sample i * hop_size).
+// |samples| holds |num_frames| frames of |num_channels| interleaved channels (1 = mono);
+// multi-channel input is downmixed per window. Frames are split into contiguous blocks shared
+// by the calling thread and a process-wide pool of persistent worker threads (started on first
+// use, grown to num_threads - 1); every thread keeps its own cached FFT plan across calls.
+// Concurrent calls do not share the pool: a call that finds it busy runs on its own thread.
+// Returns false on invalid arguments or if |out_capacity| < frames * bins.
+bool ComputeSpectrogram(const float* samples, size_t num_frames, int num_channels,
+                        const SpectrogramConfig& cfg, float* out, size_t out_capacity);
+
+// Convenience variant returning the matrix (empty on failure).
+std::vector<float> ComputeSpectrogram(const float* samples, size_t num_frames, int num_channels,
+                                      const SpectrogramConfig& cfg);
+
 // Downmix interleaved PCM (float32) to mono for FFT input. Returns at most window_size samples.
 std::vector<float> DownmixToMono(const float* data, int num_frames, int num_channels,
                                  int window_size);
 
+// Caller-buffer variant of DownmixToMono: writes at most min(window_size, num_frames,
+// out_capacity) samples into |out| and returns the count written (0 on invalid input).
+int DownmixToMono(const float* data, int num_frames, int num_channels, int window_size,
+                  float* out, int out_capacity);
+
 }  // namespace sw
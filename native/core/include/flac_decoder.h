@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "decoder.h"
+#include "resampler.h"
+
+namespace sw {
+
+struct FlacDecoderConfig {
+  // 每次 Read 输出的最大帧数（从已解码的 FLAC 帧中切出；重采样时为每次切出的源帧数）。
+  int frames_per_read = 1024;
+  // 为 true 时逐帧校验 CRC-16，不符返回 kError；关掉可省去每字节一次查表。
+  bool verify_crc = true;
+  // 源采样率与 ConfigureOutput 目标不同时的重采样质量；只做可视化的路径可用 kLinear。
+  ResamplerQuality resample_quality = ResamplerQuality::kSinc;
+};
+
+// 库内自带的 FLAC 解码器（本地 .flac 文件，4~24 位、1~8 声道）。文件以只读 mmap 打开；Open 时
+// 只扫描各帧帧头（CRC-8 校验、帧号与 STREAMINFO 一致）建立帧索引，Seek 二分定位到所在帧、
+// 解码该帧后丢弃前面的样本，不需要线性扫描。LPC 还原与双声道去相关走 SIMD 内核。
+// 每个 FLAC 帧（通常 4096 帧）整块解码后按 frames_per_read 分片输出；稳态不分配。
+// 输出声道换算与重采样规则同 PcmFileDecoder。
+// 非线程安全。
+class FlacDecoder : public Decoder {
+ public:
+  explicit FlacDecoder(const FlacDecoderConfig& cfg = FlacDecoderConfig());
+  ~FlacDecoder() override;
+
+  // kIoError：文件不存在/无法映射；kError：码流损坏（含帧 CRC 不符）；kNotSupported：
+  // 非 FLAC 文件、位深超出 4~24、sinc 模式下采样率比例过于复杂（见 Resampler）。
+  bool Open(const std::string& source) override;
+  // 读到损坏的帧时返回 false，last_status 为 kError。
+  bool Read(PcmBuffer& out_buffer) override;
+  void Close() override;
+  // frame 以输出采样率计；重采样时落到对应的源帧（向下取整）并清空滤波器历史。
+  bool Seek(int64_t frame) override;
+
+  int sample_rate() const override;
+  int channels() const override;
+  // 打开后只能改采样率（重新配置重采样，读位置不变），声道数须与当前输出相同。
+  bool ConfigureOutput(int target_sample_rate, int target_channels) override;
+  Status last_status() const override;
+
+  // 已打开文件的总帧数（STREAMINFO 未记录时取索引累计）、下一次读取的帧位置（均以源采样率
+  // 计）、源位深与声道数，以及帧索引的条目数。
+  int64_t num_frames() const;
+  int64_t position() const;
+  int bits_per_sample() const;
+  int source_channels() const;
+  size_t index_size() const;
+  // 帧头损坏导致索引中缺失的样本帧数。Open 会跳过损坏的帧头，从下一个可确认的帧继续建索引，
+  // 缺失区段解码为静音（总长与时间轴不变）；完好的文件为 0。
+  int64_t missing_frames() const;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace sw
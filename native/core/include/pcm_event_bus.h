@@ -1,39 +1,176 @@
 #pragma once
 
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "audio_engine.h"
+#include "band_mapper.h"
 #include "pcm_ingress.h"
+#include "pcm_throttler.h"
+#include "spectrum_post.h"
+#include "waveform_decimator.h"
 
 namespace sw {
 
-// 负责将上层推送的 PCM 经过校验/节流后分发波形与频谱事件（频谱可占位）。
+enum class PcmDispatchMode {
+  kSync,   // Push 线程内直接回调（默认，兼容旧行为）。
+  kAsync,  // Push 只入队，由专用分发线程计算频谱并回调。
+};
+
+struct PcmDispatchConfig {
+  PcmDispatchMode mode = PcmDispatchMode::kSync;
+  // SetPcmCallback/SetSpectrumCallback 对应默认订阅者的异步队列容量（至少 1）与溢出策略。
+  size_t queue_capacity = 8;
+  PcmOverflowPolicy overflow = PcmOverflowPolicy::kDropOldest;
+};
+
+struct PcmStageLatency {
+  uint64_t count = 0;
+  int64_t ns_total = 0;
+  int64_t ns_max = 0;
+};
+
+// 计数均以“投递给某个订阅者的一帧”为单位；总计为各订阅者之和。
+struct PcmDispatchStats {
+  uint64_t enqueued = 0;    // 通过订阅者限频、进入分发阶段的帧（含丢帧标记）。
+  uint64_t dispatched = 0;  // 已回调完成的帧。
+  uint64_t dropped_oldest = 0;
+  uint64_t dropped_newest = 0;
+  size_t queue_high_water = 0;
+  PcmStageLatency queue_wait;    // 入队 → 分发线程取出（仅异步模式）。
+  PcmStageLatency pcm_callback;  // pcm 回调耗时。
+  PcmStageLatency spectrum;      // downmix + FFT + 频谱回调耗时（同一帧的 FFT 只算一次）。
+  PcmStageLatency waveform;      // 波形降采样 + 波形回调耗时（同一帧只降采样一次）。
+};
+
+// 负责将上层推送的 PCM 经过校验/节流后分发波形与频谱事件。
+// 入口节流（ingress_cfg.throttle）是全局上限；每个订阅者再按自身 PcmSubscriberConfig 限频，
+// 投递的 PcmFrame 共享同一负载（owner 引用计数），不按订阅者拷贝。
+// 异步模式下每个订阅者有独立的有界队列，丢弃的帧计入该订阅者下一帧的 dropped_before；
+// 析构时未分发的帧直接丢弃。
 class PcmEventBus {
  public:
   using PcmCallback = std::function<void(const PcmFrame&)>;
   using SpectrumCallback = std::function<void(const SpectrumFrame&)>;
+  using WaveformCallback = std::function<void(const WaveformFrame&)>;
+
+  PcmEventBus(const PcmIngressConfig& ingress_cfg, const SpectrumConfig& spectrum_cfg,
+              const PcmDispatchConfig& dispatch_cfg = PcmDispatchConfig(),
+              const WaveformConfig& waveform_cfg = WaveformConfig());
+  ~PcmEventBus();
 
-  PcmEventBus(const PcmIngressConfig& ingress_cfg, const SpectrumConfig& spectrum_cfg);
+  PcmEventBus(const PcmEventBus&) = delete;
+  PcmEventBus& operator=(const PcmEventBus&) = delete;
 
   // 推送一帧 PCM，now_ms 为当前时间（用于节流）；返回状态。
+  // 仅允许单一推送线程调用。
   Status Push(const PcmInputFrame& frame, int64_t now_ms);
 
-  void SetPcmCallback(PcmCallback cb) { pcm_cb_ = std::move(cb); }
-  void SetSpectrumCallback(SpectrumCallback cb) { spectrum_cb_ = std::move(cb); }
+  // 默认订阅者（不额外限频）；传空回调即取消。异步模式下回调在分发线程执行。
+  void SetPcmCallback(PcmCallback cb);
+  void SetSpectrumCallback(SpectrumCallback cb);
+  // 按 waveform_cfg 降采样后的 min/max/RMS；与频谱一样不接收丢帧标记，丢帧数计入 dropped_before。
+  void SetWaveformCallback(WaveformCallback cb);
 
+  // 订阅/退订可在任意线程调用，但不能在回调内部调用；返回 0 表示参数无效。
+  // RemoveSubscriber 返回后不会再有该订阅者的回调。
+  SubscriptionId AddPcmSubscriber(const PcmSubscriberConfig& config, PcmCallback cb);
+  SubscriptionId AddSpectrumSubscriber(const PcmSubscriberConfig& config, SpectrumCallback cb);
+  SubscriptionId AddWaveformSubscriber(const PcmSubscriberConfig& config, WaveformCallback cb);
+  bool RemoveSubscriber(SubscriptionId id);
+
+  // 阻塞直到已入队的帧全部分发完成（同步模式立即返回）。
+  void Flush();
+
+  // 丢弃排队中的帧，复位节流与频谱后处理（平滑/峰值保持）状态；Seek 或断流后调用。
   void Reset();
 
+  PcmDispatchStats stats() const;
+  // 单个订阅者的统计；id 未知时返回 false。
+  bool subscriber_stats(SubscriptionId id, PcmDispatchStats* out) const;
+  const PcmDispatchConfig& dispatch_config() const { return dispatch_cfg_; }
+
  private:
+  struct PendingFrame {
+    PcmFrame frame;
+    int64_t enqueue_ns = 0;
+  };
+
+  struct Subscriber {
+    Subscriber(SubscriptionId id, const PcmSubscriberConfig& config);
+
+    SubscriptionId id;
+    PcmSubscriberConfig config;
+    PcmCallback pcm_cb;            // 三者仅其一有效，创建后不变。
+    SpectrumCallback spectrum_cb;
+    WaveformCallback waveform_cb;
+    PcmThrottler throttler;        // 仅推送线程访问。
+    // 异步队列与统计，由 mutex_ 保护。
+    std::vector<PendingFrame> pending;
+    size_t pending_head = 0;
+    size_t pending_size = 0;
+    uint32_t pending_overflow = 0;  // kDropNewest 丢弃、待计入下一帧的数量。
+    PcmDispatchStats stats;
+  };
+
   PcmIngress ingress_;
   SpectrumConfig spectrum_cfg_;
-  PcmCallback pcm_cb_;
-  SpectrumCallback spectrum_cb_;
-  uint32_t spectrum_seq_ = 0;
+  PcmDispatchConfig dispatch_cfg_;
+
+  // 频谱计算状态与缓存，仅在持有 dispatch_mutex_ 时访问；同一帧被多个频谱订阅者接收时复用结果。
+  SpectrumAnalyzer analyzer_;
+  std::vector<float> mono_scratch_;  // 复用的 downmix/频谱缓冲，稳态下不分配。
+  std::vector<float> bins_scratch_;
+  BandMapper band_mapper_;           // spectrum_cfg_.band_scale 非 kNone 时把 bin 聚合为频带。
+  std::vector<float> bands_scratch_;
+  SpectrumPostProcessor post_;       // spectrum_cfg_.post：dB/平滑/峰值保持，跨帧保留状态。
+  SpectrumFrame spectrum_cache_;
+  const float* spectrum_cache_data_ = nullptr;
+  uint32_t spectrum_cache_seq_ = 0;
+  bool spectrum_cache_valid_ = false;
+  // 波形降采样状态与缓存，同样仅在持有 dispatch_mutex_ 时访问。
+  WaveformDecimator decimator_;
+  WaveformFrame waveform_cache_;
+  const float* waveform_cache_data_ = nullptr;
+  uint32_t waveform_cache_seq_ = 0;
+  bool waveform_cache_valid_ = false;
+
+  // 锁顺序：dispatch_mutex_ → mutex_。回调执行期间持有 dispatch_mutex_；
+  // subscribers_ 的增删需同时持有两者，因此持有任一把锁即可安全遍历。
+  std::mutex dispatch_mutex_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;       // 有新帧或停止。
+  std::condition_variable idle_cv_;  // 队列清空且分发线程空闲。
+  std::vector<std::unique_ptr<Subscriber>> subscribers_;
+  SubscriptionId next_id_ = 1;
+  SubscriptionId default_pcm_id_ = 0;
+  SubscriptionId default_spectrum_id_ = 0;
+  SubscriptionId default_waveform_id_ = 0;
+  size_t pending_total_ = 0;
+  size_t next_subscriber_ = 0;  // 分发线程轮询起点，避免单个订阅者饿死其他订阅者。
+  bool dispatching_ = false;
+  bool stop_ = false;
+  PcmDispatchStats stats_;
+  std::thread dispatcher_;
 
-  void EmitSpectrumIfNeeded(const PcmFrame& frame);
+  SubscriptionId AddSubscriber(const PcmSubscriberConfig& config, PcmCallback pcm_cb,
+                               SpectrumCallback spectrum_cb, WaveformCallback waveform_cb);
+  PcmSubscriberConfig DefaultSubscriberConfig() const;
+  // 按订阅者自身限频决定是否投递；投递帧与 frame 共享负载。
+  static bool Admit(Subscriber& sub, const PcmFrame& frame, int64_t now_ms, PcmFrame* out);
+  void EnqueueLocked(Subscriber& sub, PcmFrame&& frame);
+  void DispatcherMain();
+  // 执行回调，返回耗时（纳秒）。
+  int64_t Deliver(const Subscriber& sub, const PcmFrame& frame);
+  void RecordDeliveryLocked(Subscriber& sub, int64_t ns);
+  const SpectrumFrame* SpectrumFor(const PcmFrame& frame);
+  const WaveformFrame* WaveformFor(const PcmFrame& frame);
+  Subscriber* FindLocked(SubscriptionId id) const;
 };
 
 }  // namespace sw
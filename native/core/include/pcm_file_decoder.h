@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "decoder.h"
+#include "resampler.h"
+
+namespace sw {
+
+// 文件中的样本编码（小端）。
+enum class PcmEncoding { kS16, kS24, kS32, kF32 };
+
+// 无头裸 PCM（.pcm/.raw）的格式；0 表示沿用 ConfigureOutput 的目标采样率/声道数。
+struct RawPcmFormat {
+  int sample_rate = 0;
+  int channels = 0;
+  PcmEncoding encoding = PcmEncoding::kS16;
+};
+
+struct PcmFileDecoderConfig {
+  int frames_per_read = 1024;  // 每次 Read 输出的最大帧数（重采样时为每次读取的源帧数）。
+  RawPcmFormat raw;
+  // 源采样率与 ConfigureOutput 目标不同时的重采样质量；只做可视化的路径可用 kLinear。
+  ResamplerQuality resample_quality = ResamplerQuality::kSinc;
+};
+
+// RIFF/WAVE（PCM16/24/32、IEEE float32，含 WAVE_FORMAT_EXTENSIBLE）与裸 PCM 解码器。
+// 文件以只读 mmap 打开，Read 用 SIMD 内核直接把映射区的样本转换进调用方缓冲（稳态不分配，
+// 同声道数时没有中间拷贝）；Seek 只改读位置，O(1) 且精确到样本帧。
+// 输出声道数由 ConfigureOutput 决定：目标为单声道时 downmix，源为单声道时复制到各声道，
+// 其余取前 min(源, 目标) 个声道、多出的补零。目标采样率与源不同时，声道换算后经 Resampler
+// 流式重采样（见 resampler.h），Read 的块长随之按比例变化。非线程安全。
+class PcmFileDecoder : public Decoder {
+ public:
+  explicit PcmFileDecoder(const PcmFileDecoderConfig& cfg = PcmFileDecoderConfig());
+  ~PcmFileDecoder() override;
+
+  // source 为本地路径或 file:// URI。kIoError：文件不存在/无法映射；kError：WAV 结构损坏；
+  // kNotSupported：编码或扩展名不支持、sinc 模式下采样率比例过于复杂（见 Resampler）。
+  bool Open(const std::string& source) override;
+  bool Read(PcmBuffer& out_buffer) override;
+  void Close() override;
+  // frame 以输出采样率计；重采样时落到对应的源帧（向下取整）并清空滤波器历史。
+  bool Seek(int64_t frame) override;
+
+  // 打开前为输出格式；打开后为实际输出格式。
+  int sample_rate() const override;
+  int channels() const override;
+  // 打开后只能改采样率（重新配置重采样，读位置不变），声道数须与当前输出相同。
+  bool ConfigureOutput(int target_sample_rate, int target_channels) override;
+  Status last_status() const override;
+
+  // 已打开文件的总帧数、下一次读取的帧位置（均以源采样率计）与源编码/声道数。
+  int64_t num_frames() const;
+  int64_t position() const;
+  PcmEncoding encoding() const;
+  int source_channels() const;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace sw
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sw {
+
+struct PcmFramePoolStats {
+  size_t capacity = 0;     // pooled buffers.
+  size_t in_use = 0;       // pooled buffers currently referenced outside the pool.
+  size_t high_water = 0;   // max in_use observed at Acquire time.
+  uint64_t hits = 0;       // Acquire served from the pool.
+  uint64_t misses = 0;     // Acquire fell back to a fresh heap buffer (pool exhausted).
+  uint64_t grows = 0;      // pooled buffer had to grow its storage (warm-up / larger frames).
+};
+
+// Fixed-capacity pool of PCM payload buffers handed out as PcmFrame::owner.
+// A buffer returns to the pool automatically once every shared_ptr copy handed out is gone
+// (the pool then holds the only reference), so recycling needs no custom deleter and no
+// control-block allocation. Acquire/stats must be called from a single thread (the producer);
+// released references may be dropped on any thread.
+class PcmFramePool {
+ public:
+  // samples_hint: per-buffer capacity reserved up front (0 = grow on first use).
+  explicit PcmFramePool(size_t capacity, size_t samples_hint = 0);
+
+  PcmFramePool(const PcmFramePool&) = delete;
+  PcmFramePool& operator=(const PcmFramePool&) = delete;
+
+  // Returns a buffer resized to |samples|. Never fails: on exhaustion a fresh unpooled buffer is
+  // allocated and counted as a miss.
+  std::shared_ptr<std::vector<float>> Acquire(size_t samples);
+
+  PcmFramePoolStats stats() const;
+
+ private:
+  size_t CountInUse() const;
+
+  std::vector<std::shared_ptr<std::vector<float>>> slots_;
+  size_t next_ = 0;
+  size_t high_water_ = 0;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t grows_ = 0;
+};
+
+}  // namespace sw
@@ -1,11 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
-#include <deque>
 #include <vector>
 
 #include "audio_engine.h"
+#include "pcm_frame_pool.h"
 #include "pcm_throttler.h"
+#include "spsc_queue.h"
 
 namespace sw {
 
@@ -13,6 +15,10 @@ struct PcmIngressConfig {
   int expected_sample_rate = 0;  // 0 表示不校验
   int expected_channels = 0;     // 0 表示不校验
   PcmThrottleConfig throttle;
+  // PCM 负载缓冲池容量；0 表示 throttle.max_pending + kDefaultPoolSlack。
+  size_t pool_capacity = 0;
+  // 预留的单帧样本数（帧数 × 通道数），0 表示首次使用时按需增长。
+  size_t pool_samples_hint = 0;
 };
 
 struct PcmInputFrame {
@@ -25,6 +31,9 @@ struct PcmInputFrame {
 };
 
 // 负责校验上层推送的 PCM，并按节流规则输出队列。
+// 线程模型：Push 仅在一个生产线程（平台层）调用，Pop 仅在一个消费线程调用，二者可并发；
+// 输出队列为固定容量的无锁 SPSC 队列（容量 = throttle.max_pending + 1，至少 2）。
+// Reset 需在两端都空闲时调用。
 class PcmIngress {
  public:
   explicit PcmIngress(const PcmIngressConfig& config);
@@ -35,16 +44,31 @@ class PcmIngress {
   // 取出一帧经过节流的输出；若无可用帧返回 false。
   bool Pop(PcmFrame& out);
 
+  size_t queue_capacity() const { return queue_.capacity(); }
+  // 因输出队列已满（消费端跟不上）被丢弃的帧数；会累加到下一帧的 dropped_before。
+  uint64_t queue_overflow_drops() const {
+    return queue_overflow_total_.load(std::memory_order_relaxed);
+  }
+
   void Reset();
 
+  // 负载缓冲池统计（高水位、命中/未命中等），仅在推送线程调用。
+  PcmFramePoolStats pool_stats() const { return pool_.stats(); }
+
+  // 默认池容量在 max_pending 之外额外预留的缓冲数（覆盖出队后仍被回调持有的帧）。
+  static constexpr size_t kDefaultPoolSlack = 4;
+
  private:
- struct OwnedFrame {
+  struct OwnedFrame {
     PcmFrame frame;
   };
 
   PcmIngressConfig cfg_;
   PcmThrottler throttler_;
-  std::deque<OwnedFrame> queue_;
+  PcmFramePool pool_;
+  SpscQueue<OwnedFrame> queue_;
+  uint32_t queue_overflow_pending_ = 0;  // 生产端私有：尚未报告的溢出丢帧。
+  std::atomic<uint64_t> queue_overflow_total_{0};
 };
 
 }  // namespace sw
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -33,13 +34,18 @@ class PcmThrottler {
  public:
   explicit PcmThrottler(const PcmThrottleConfig& config);
 
-  // 处理一帧输入，返回需推送给上层的帧/标记（0 或 1 个元素）。
+  // 处理一帧输入；需推送给上层的帧/标记写入 *out 并返回 true，否则返回 false。
+  // 不触碰堆，适合每帧调用的热路径。
+  bool Push(const PcmThrottleInput& input, int64_t now_ms, PcmThrottleOutput* out);
+
+  // 兼容接口：返回 0 或 1 个元素（每次调用会分配 vector）。
   std::vector<PcmThrottleOutput> Push(const PcmThrottleInput& input, int64_t now_ms);
 
   void Reset();
 
  private:
   PcmThrottleConfig config_;
+  int min_interval_ms_ = 0;
   int64_t last_emit_ms_ = -1;
   uint32_t pending_drops_ = 0;
   int pending_kept_ = 0;
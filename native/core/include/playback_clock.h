@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace sw {
+
+// Sample-accurate playback clock. Position is kept as a 64-bit frame counter; ms/us/ns are
+// derived on read, so per-buffer rounding never accumulates (no drift over long sessions).
+// Advance/Reset may race with readers on other threads; readers always see a whole value.
+class PlaybackClock {
+ public:
+  explicit PlaybackClock(int sample_rate = 48000);
+
+  PlaybackClock(const PlaybackClock&) = delete;
+  PlaybackClock& operator=(const PlaybackClock&) = delete;
+
+  // Changing the rate keeps the frame count; call Reset* afterwards if needed.
+  void set_sample_rate(int sample_rate);
+  int sample_rate() const { return sample_rate_.load(std::memory_order_relaxed); }
+
+  // Adds |frames| and returns the new position in frames.
+  int64_t Advance(int64_t frames);
+  void Reset(int64_t position_frames = 0);
+  void ResetMs(int64_t position_ms);
+
+  int64_t frames() const { return frames_.load(std::memory_order_acquire); }
+  int64_t us() const { return FramesToUs(frames(), sample_rate()); }
+  int64_t ms() const { return FramesToMs(frames(), sample_rate()); }
+
+  // Conversions floor toward zero and are exact for any 64-bit frame count.
+  static int64_t FramesToMs(int64_t frames, int sample_rate);
+  static int64_t FramesToUs(int64_t frames, int sample_rate);
+  static int64_t FramesToNs(int64_t frames, int sample_rate);
+  static int64_t MsToFrames(int64_t ms, int sample_rate);
+
+ private:
+  std::atomic<int64_t> frames_{0};
+  std::atomic<int> sample_rate_;
+};
+
+}  // namespace sw
@@ -7,6 +7,7 @@
 #include <mutex>
 #include <thread>
 
+#include "playback_clock.h"
 #include "ring_buffer.h"
 
 namespace sw {
@@ -32,11 +33,19 @@ class PlaybackThread {
   void Stop();
   bool running() const { return running_.load(); }
 
-  // Current playback position in milliseconds (accumulated).
-  int64_t position_ms() const { return position_ms_.load(); }
-  void ResetPosition(int64_t position_ms = 0) { position_ms_.store(position_ms); }
+  // Current playback position, kept as a consumed-frame counter (sample accurate).
+  int64_t position_frames() const { return clock_.frames(); }
+  int64_t position_us() const { return clock_.us(); }
+  int64_t position_ms() const { return clock_.ms(); }
+  void ResetPosition(int64_t position_ms = 0) { clock_.ResetMs(position_ms); }
+  void ResetPositionFrames(int64_t position_frames) { clock_.Reset(position_frames); }
 
-  // Optional callback invoked when position advances; called from playback thread.
+  // Times the loop found the buffer empty after having consumed data (each starvation episode
+  // counts once; the initial wait after Start does not count).
+  uint64_t underruns() const { return underruns_.load(std::memory_order_relaxed); }
+
+  // Optional callback invoked when position advances (ms derived from the frame counter);
+  // called from playback thread.
   void SetPositionCallback(std::function<void(int64_t)> cb);
 
  private:
@@ -47,7 +56,8 @@ class PlaybackThread {
 
   std::thread thread_;
   std::atomic<bool> running_{false};
-  std::atomic<int64_t> position_ms_{0};
+  PlaybackClock clock_;
+  std::atomic<uint64_t> underruns_{0};
 
   std::function<void(int64_t)> pos_cb_;
   mutable std::mutex cb_mu_;
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sw {
+
+enum class ResamplerQuality {
+  // 两点线性插值：开销极低但有混叠与高频衰减，只适合不回放的可视化路径（波形、频谱预览）。
+  kLinear,
+  // Kaiser 窗 sinc 多相 FIR（每相 kSincTaps · ⌈M/L⌉ 抽头，阻带约 -70 dB），用于回放。
+  kSinc,
+};
+
+struct ResamplerConfig {
+  int input_rate = 44100;
+  int output_rate = 48000;
+  int channels = 2;
+  ResamplerQuality quality = ResamplerQuality::kSinc;
+};
+
+// 流式重采样（交错 float）。采样率比化简为 L/M（如 44.1→48 kHz 为 160/147），输出第 n 帧
+// 对应输入位置 n·M/L：sinc 模式取该位置附近 T = kSincTaps · ⌈M/L⌉ 个输入与第 (n·M mod L) 相
+// 的系数做内积（SIMD 内核 dot）。降采样时截止频率随输出 Nyquist 下移，抽头数同比例增加，
+// 过渡带与阻带衰减不随比例变化，每个输入帧的计算量也大致不变。线性模式只用相邻两帧。
+// 滤波器组按 (L, M) 在进程内缓存共享，44.1↔48 kHz 等常用比例只在首次用到时计算一次。
+// 输出与输入对齐（已补偿滤波器延迟），流结束时调用 Flush 取出尾部。除首次增长外 Process
+// 不分配内存。非线程安全。
+class Resampler {
+ public:
+  // 升采样与 M ≤ L 时的抽头数。
+  static constexpr int kSincTaps = 64;
+  // sinc 模式支持的最大相数 L（滤波器组 L × T 个系数）；线性模式不限。
+  static constexpr int kMaxPhases = 1024;
+  // sinc 模式的最大抽头数 T，即最多支持 32:1 的抽取；线性模式不限。
+  static constexpr int kMaxSincTaps = 2048;
+
+  Resampler();
+  ~Resampler();
+
+  Resampler(const Resampler&) = delete;
+  Resampler& operator=(const Resampler&) = delete;
+
+  // 配置并清空状态。参数非法，或 sinc 模式下 L 超过 kMaxPhases、T 超过 kMaxSincTaps 时返回
+  // false。
+  bool Configure(const ResamplerConfig& config);
+  const ResamplerConfig& config() const;
+  bool configured() const;
+
+  // 送入 frames 帧交错输入，本次能产出的输出写入 *out（覆盖，resize 为输出帧数 × 声道数），
+  // 返回输出帧数。输入会先积累到足够填满滤波器窗口，开头几次调用的输出可能少于按比例的帧数。
+  size_t Process(const float* interleaved, size_t frames, std::vector<float>* out);
+  // 流结束：补零推出滤波器中剩余的输出，之后状态同 Reset。总输出帧数为 ⌈输入帧数 · L / M⌉。
+  size_t Flush(std::vector<float>* out);
+  // 丢弃历史（Seek 后调用）。
+  void Reset();
+
+  // 化简后的插值/抽取因子。
+  int interpolation() const;
+  int decimation() const;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace sw
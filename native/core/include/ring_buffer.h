@@ -1,15 +1,61 @@
 #pragma once
 
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 
 namespace sw {
 
-// Lock-safe ring buffer for interleaved PCM frames (single producer/consumer focused).
+enum class RingBufferMode {
+  // Every call takes an internal mutex; any thread may call any method.
+  kLocked,
+  // Wait-free single producer / single consumer: Write only from one producer thread,
+  // Read only from one consumer thread. Queries are safe from any thread (may be stale).
+  // Clear may be called from any thread; it is applied by the consumer on its next Read, so
+  // the producer only sees the freed space afterwards.
+  kSpsc,
+};
+
+enum class RingBufferLayout {
+  // Plain storage; regions that cross the end are split into two spans.
+  kContiguous,
+  // Linux: the same pages are mapped twice back to back (memfd + mmap), so every readable or
+  // writable region is a single contiguous span. Capacity is rounded up to whole pages. Falls
+  // back to kContiguous when mapping is unavailable or fails (see mirrored()).
+  kMirrored,
+};
+
+// Up to two contiguous interleaved spans inside the ring storage (second is used on wrap;
+// always empty for a mirrored buffer).
+struct RingBufferRegion {
+  float* data[2] = {nullptr, nullptr};
+  size_t frames[2] = {0, 0};
+
+  size_t total_frames() const { return frames[0] + frames[1]; }
+};
+
+// Blocking-wait counters (cumulative since construction).
+struct RingBufferWaitStats {
+  uint64_t reader_waits = 0;       // WaitForReadable calls that had to block.
+  uint64_t reader_wakeups = 0;     // times a blocked reader was woken (incl. timeouts).
+  uint64_t reader_timeouts = 0;
+  int64_t reader_wait_ns_total = 0;
+  int64_t reader_wait_ns_max = 0;
+  uint64_t writer_waits = 0;
+  uint64_t writer_wakeups = 0;
+  uint64_t writer_timeouts = 0;
+  int64_t writer_wait_ns_total = 0;
+  int64_t writer_wait_ns_max = 0;
+};
+
+// Ring buffer for interleaved PCM frames. Transfers are at most two memcpy spans per call.
 class RingBuffer {
  public:
   // capacity_frames: number of PCM frames (per channel) the buffer can hold.
-  RingBuffer(size_t capacity_frames, int channels);
+  RingBuffer(size_t capacity_frames, int channels,
+             RingBufferMode mode = RingBufferMode::kLocked,
+             RingBufferLayout layout = RingBufferLayout::kContiguous);
   ~RingBuffer();
 
   RingBuffer(const RingBuffer&) = delete;
@@ -19,6 +65,9 @@ class RingBuffer {
 
   size_t capacity_frames() const;
   int channels() const;
+  RingBufferMode mode() const;
+  // True if the double-mapped layout is active (regions never wrap).
+  bool mirrored() const;
 
   // Number of frames currently buffered/available to read.
   size_t readable_frames() const;
@@ -36,9 +85,32 @@ class RingBuffer {
   // Returns the number of frames actually read (0 if empty).
   size_t Read(float* interleaved_out, size_t frames);
 
+  // Zero-copy producer access: exposes up to |frames| writable frames in place. Fill them, then
+  // call CommitWrite(n) (n <= region.total_frames(), first n frames in span order) before the
+  // next Write/BeginWrite. Producer thread only; frames are not visible to readers until commit.
+  RingBufferRegion BeginWrite(size_t frames);
+  void CommitWrite(size_t frames);
+
+  // Zero-copy consumer access: exposes up to |frames| readable frames in place. The region stays
+  // valid until CommitRead(n) releases the first n frames back to the producer.
+  // Consumer thread only. A Clear() issued in between takes precedence over the commit.
+  RingBufferRegion BeginRead(size_t frames);
+  void CommitRead(size_t frames);
+
   // Drops all buffered data.
   void Clear();
 
+  // Blocks until at least |min_frames| (clamped to capacity) are readable / writable, WakeAll()
+  // is called or |timeout| elapses. Returns true if the condition holds on return. The other
+  // side only signals when a waiter is present and its low-water mark is reached, so the
+  // non-blocking paths stay lock-free in kSpsc mode.
+  bool WaitForReadable(size_t min_frames, std::chrono::nanoseconds timeout);
+  bool WaitForWritable(size_t min_frames, std::chrono::nanoseconds timeout);
+  // Wakes all blocked waiters (e.g. on shutdown).
+  void WakeAll();
+
+  RingBufferWaitStats wait_stats() const;
+
  private:
   struct Impl;
   std::unique_ptr<Impl> impl_;
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sw {
+
+// 频谱路径的逐样本内核（窗口化、downmix、幅度/功率换算）与解码用的 PCM 格式转换、FLAC
+// LPC 还原、双声道去相关和重采样 FIR 内积。
+// x86-64 上 SSE2 为基线，运行时检测到 AVX2 时切换；aarch64 使用 NEON；其余平台走标量实现。
+enum class SimdLevel { kScalar, kSse2, kAvx2, kNeon };
+
+// 双声道去相关方式（FLAC 声道分配 8/9/10）：a/b 为帧内两个子帧的解码结果。
+enum class StereoDecorrelation {
+  kIndependent,  // a = L，b = R
+  kLeftSide,     // a = L，b = L - R
+  kSideRight,    // a = L - R，b = R
+  kMidSide,      // a = (L + R) >> 1，b = L - R（mid 丢掉的最低位由 side 的奇偶补回）
+};
+
+struct SimdKernels {
+  SimdLevel level;
+  // out[i] = a[i] * b[i]；out 可与 a 相同（原地）。
+  void (*multiply)(const float* a, const float* b, float* out, size_t n);
+  // out[i] = scale * sum(interleaved[i * channels + c])，c ∈ [0, channels)。
+  void (*downmix)(const float* interleaved, size_t frames, int channels, float scale, float* out);
+  // |complex| 为交错 (re, im) 对：out[k] = (re² + im²) * scale。
+  void (*power)(const float* complex, size_t bins, float scale, float* out);
+  // out[k] = sqrt(re² + im²) * scale。
+  void (*magnitude)(const float* complex, size_t bins, float scale, float* out);
+  // out[i] = max(db_per_decade * log10(in[i]), floor_db)；db_per_decade 取 10（功率）或
+  // 20（幅度），out 可与 in 相同。快速 log：指数/尾数拆分 + atanh 级数，绝对误差 < 1e-4 dB；
+  // <= 0 或 NaN 输出 floor。
+  void (*decibels)(const float* in, size_t n, float db_per_decade, float floor_db, float* out);
+  // 交错 PCM 的逐声道归约：out_min/out_max/out_sumsq 各写 channels 个值（Σx²，RMS 由调用方
+  // 按帧数换算）。frames 为 0 时全部输出 0。1..8 声道走向量路径，其余为标量。
+  void (*min_max_sumsq)(const float* interleaved, size_t frames, int channels, float* out_min,
+                        float* out_max, float* out_sumsq);
+  // 小端整型 PCM → [-1, 1] float：n 个样本，in 无对齐要求（可直接指向文件映射）。
+  // 24 位为紧凑的 3 字节样本。
+  void (*s16_to_float)(const void* in, size_t n, float* out);
+  void (*s24_to_float)(const void* in, size_t n, float* out);
+  void (*s32_to_float)(const void* in, size_t n, float* out);
+  // 线性预测还原（原地）：samples[0, n) 进来是残差，出去是样本；samples[-order, -1] 必须是
+  // 已还原的历史。samples[i] += (Σ coefs[j] · samples[i - j - 1]) >> shift，order ∈ [1, 32]。
+  // 累加为 32 位（回绕），调用方须保证 位深 + 系数精度 + ⌈log2 order⌉ <= 32。
+  void (*lpc_restore)(int32_t* samples, size_t n, const int32_t* coefs, int order, int shift);
+  // 按 mode 还原左右声道并交错为 float：out[2i] = L · scale，out[2i + 1] = R · scale。
+  void (*stereo_to_float)(const int32_t* a, const int32_t* b, size_t n, StereoDecorrelation mode,
+                          float scale, float* out);
+  // Σ a[i] · b[i]（重采样多相滤波的内积）。各级别累加顺序不同，结果可能差几个 ulp。
+  float (*dot)(const float* a, const float* b, size_t n);
+};
+
+// 当前 CPU 可用的最优内核（首次调用时检测，之后不变）。
+const SimdKernels& ActiveSimdKernels();
+
+// 指定级别的内核；该级别未编译进来或 CPU 不支持时返回 nullptr（kScalar 始终可用）。
+// 主要供测试/基准逐级对比。
+const SimdKernels* SimdKernelsFor(SimdLevel level);
+
+const char* SimdLevelName(SimdLevel level);
+
+}  // namespace sw
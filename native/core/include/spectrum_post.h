@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "audio_engine.h"
+#include "fft_spectrum.h"
+
+namespace sw {
+
+// 频谱后处理阶段（在 FFT / 频带映射之后运行）：
+//   1. dB 换算（SIMD 快速 log，功率 10·log10、幅度 20·log10，低于 db_floor 截断）；
+//   2. 指数平滑，上升用 attack_ms、下降用 release_ms 作为时间常数，系数按相邻两帧的
+//      timestamp_ms 间隔计算（α = 1 - e^(-Δt/τ)），因此与帧率/限频无关；
+//   3. 峰值保持：峰值在 peak_hold_ms 内不动，之后按 peak_decay_db_per_s 衰减（线性输出时换算为
+//      等效的乘法衰减），且不低于当前值。
+// 启用 dB 时平滑与峰值都在 dB 域进行。每条流一个实例（持有上一帧状态），非线程安全；
+// 稳态（bin 数不变）下不分配。
+class SpectrumPostProcessor {
+ public:
+  SpectrumPostProcessor() = default;
+
+  // 时间参数或衰减速率为负、db_floor 非有限值时返回 false，此后 Process 一律失败直到重新配置。
+  // 会清空状态。
+  bool Configure(const SpectrumPostConfig& cfg);
+  const SpectrumPostConfig& config() const { return cfg_; }
+  // 配置有效且至少启用了一项处理。
+  bool enabled() const { return valid_ && active_; }
+
+  // 丢弃平滑/峰值状态，下一帧直接作为初值（Seek、断流后使用）。
+  void Reset();
+
+  // 未启用时不改动 |frame| 并返回 true。否则把结果写入内部缓冲，frame->bins 改为指向它，并设置
+  // frame->decibels / frame->peaks（指针在下一次 Process/Configure 前有效）。bin 数或谱类型变化、
+  // 时间戳倒退或间隔超过 1 秒时自动重置状态。frame 无效或配置无效时返回 false。
+  bool Process(SpectrumFrame* frame);
+
+ private:
+  SpectrumPostConfig cfg_;
+  bool valid_ = true;
+  bool active_ = false;
+
+  std::vector<float> input_;    // 本帧输入（dB 换算后）。
+  std::vector<float> values_;   // 平滑后的输出。
+  std::vector<float> peaks_;
+  std::vector<float> peak_age_ms_;
+  bool has_state_ = false;
+  int64_t last_timestamp_ms_ = 0;
+  bool last_power_ = true;
+};
+
+}  // namespace sw
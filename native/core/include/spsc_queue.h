@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace sw {
+
+// Bounded wait-free single-producer/single-consumer queue. Slots are preallocated at
+// construction; TryPush/TryPop never allocate (beyond what moving T itself does).
+// TryPush only from the producer thread, TryPop/Clear only from the consumer thread.
+template <typename T>
+class SpscQueue {
+ public:
+  explicit SpscQueue(size_t capacity) : slots_(capacity > 0 ? capacity : 1) {}
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  size_t capacity() const { return slots_.size(); }
+
+  // Returns false (and leaves |value| untouched) when full.
+  bool TryPush(T&& value) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) >= slots_.size()) {
+      return false;
+    }
+    slots_[tail % slots_.size()] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Moves the oldest element into |out|; returns false when empty. The slot is reset to T{} so
+  // resources (e.g. shared_ptr payloads) are not kept alive by the queue.
+  bool TryPop(T& out) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    T& slot = slots_[head % slots_.size()];
+    out = std::move(slot);
+    slot = T{};
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Drops all queued elements (consumer side).
+  void Clear() {
+    T discard;
+    while (TryPop(discard)) {
+    }
+  }
+
+  // Approximate when called concurrently with push/pop.
+  size_t size() const {
+    const size_t head = head_.load(std::memory_order_acquire);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    return tail >= head ? tail - head : 0;
+  }
+  bool empty() const { return size() == 0; }
+
+ private:
+  static constexpr size_t kCacheLineSize = 64;
+
+  std::vector<T> slots_;
+  alignas(kCacheLineSize) std::atomic<size_t> head_{0};  // consumer-owned.
+  alignas(kCacheLineSize) std::atomic<size_t> tail_{0};  // producer-owned.
+};
+
+}  // namespace sw
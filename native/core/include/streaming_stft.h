@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "audio_engine.h"
+#include "band_mapper.h"
+#include "fft_spectrum.h"
+#include "spectrum_post.h"
+
+namespace sw {
+
+struct StftFrame {
+  SpectrumFrame spectrum;   // bins 指向内部缓冲，下一次 Next/Push/Configure 前有效。
+  int64_t start_frame = 0;  // 窗口首个样本的绝对帧号；spectrum.timestamp_ms 由其换算。
+};
+
+// 流式 STFT：维护单声道滑动历史，每凑满一个 hop（window_size - overlap）输出一帧频谱，
+// 与每次推送的块大小无关；时间戳按帧号精确到 hop。已计算过的窗口不会重复计算。
+// 稳态（推送块不超过历史最大值）下不分配。非线程安全，每条流一个实例。
+class StreamingStft {
+ public:
+  StreamingStft() = default;
+
+  // 要求 window_size > 0、0 <= overlap < window_size、sample_rate > 0，且频带参数与后处理参数
+  // （若启用）有效；失败返回 false。
+  // 会清空历史（等价于 Reset(0)）与后处理状态。
+  bool Configure(const SpectrumConfig& cfg, int sample_rate);
+  bool configured() const { return hop_ > 0; }
+
+  // 清空历史与平滑/峰值状态，下一次 Push 的首个样本记为绝对帧号 next_input_frame
+  // （用于 seek/断流后对齐）。
+  void Reset(int64_t next_input_frame = 0);
+
+  // 追加交错 PCM（downmix 为单声道）。
+  void Push(const float* interleaved, int num_frames, int num_channels);
+
+  // 下一个 hop 的完整窗口已就绪。
+  bool ready() const;
+  // 计算下一个 hop 的频谱并前移一个 hop；未就绪时返回 false。
+  bool Next(StftFrame* out);
+  // 跳过下一个 hop（不做 FFT），供节流丢弃时使用；未就绪时返回 false。
+  bool Skip();
+
+  int hop() const { return hop_; }
+  // 每帧输出的值个数：启用频带时为频带数，否则 window_size/2 + 1。
+  int num_bins() const {
+    return cfg_.band_scale != BandScale::kNone ? band_mapper_.num_bands() : analyzer_.num_bins();
+  }
+  int sample_rate() const { return sample_rate_; }
+  const SpectrumConfig& config() const { return cfg_; }
+  // 下一个窗口首样本 / 下一次 Push 首样本的绝对帧号。
+  int64_t next_window_frame() const {
+    return history_start_frame_ + static_cast<int64_t>(read_pos_);
+  }
+  int64_t next_input_frame() const {
+    return history_start_frame_ + static_cast<int64_t>(size_);
+  }
+
+ private:
+  SpectrumAnalyzer analyzer_;
+  SpectrumConfig cfg_;
+  int sample_rate_ = 0;
+  int hop_ = 0;
+  std::vector<float> history_;  // [read_pos_, size_) 为尚未完全消费的单声道样本。
+  size_t read_pos_ = 0;
+  size_t size_ = 0;
+  int64_t history_start_frame_ = 0;  // history_[0] 的绝对帧号。
+  std::vector<float> bins_;
+  BandMapper band_mapper_;
+  std::vector<float> bands_;
+  SpectrumPostProcessor post_;
+
+  void Compact();
+};
+
+}  // namespace sw
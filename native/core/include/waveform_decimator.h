@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+#include "audio_engine.h"
+
+namespace sw {
+
+// 交错 PCM → 逐桶逐声道 min/max/RMS（SIMD 归约，见 SimdKernels::min_max_sumsq）。
+// 引擎与事件总线用它替代整段 PCM 推送：每桶 3 个 float，负载缩小约 (每桶帧数 / 3) 倍，
+// 例如 4096 帧立体声推送降为 128 个桶时从 32 KB 降到 3 KB。稳态（桶数与声道数不变）下不分配。
+// 非线程安全。
+class WaveformDecimator {
+ public:
+  WaveformDecimator() = default;
+
+  // num_buckets < 1 时返回 false，此后 Process 一律失败直到重新配置。
+  bool Configure(const WaveformConfig& cfg);
+  const WaveformConfig& config() const { return cfg_; }
+
+  // 对 frame 的负载降采样，out->buckets 指向内部缓冲（下一次 Process/Configure 前有效），其余字段
+  // 取自 frame。丢帧标记、空负载或配置无效时返回 false。
+  bool Process(const PcmFrame& frame, WaveformFrame* out);
+
+ private:
+  WaveformConfig cfg_;
+  bool valid_ = true;
+  std::vector<WaveformBucket> buckets_;
+  std::vector<float> scratch_;  // 每声道 min/max/Σx²。
+};
+
+}  // namespace sw
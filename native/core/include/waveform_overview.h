@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "audio_engine.h"
+#include "decoder.h"
+
+namespace sw {
+
+// 整轨波形概览（拖动条/缩略图）：第 0 层每 base_bucket_frames 帧一个桶，逐层两两合并
+// （桶长翻倍）直到只剩一个桶，每个桶逐声道存 WaveformBucket{min, max, rms}。
+struct WaveformOverviewConfig {
+  int base_bucket_frames = 256;
+};
+
+// 只读的 min/max/RMS mip 金字塔。可由 WaveformOverviewBuilder 在内存中构建，也可从 Save 写出的
+// 文件 Open：文件按 mmap 只读映射（不支持 mmap 的平台整体读入），各层数据直接指向映射区，
+// 重新打开同一轨道无需再解码。Query 按像素列选层，每列只合并 1~3 个桶，耗时 O(列数)。
+// 构建/打开完成后只读，可多线程并发查询。
+class WaveformOverview {
+ public:
+  WaveformOverview();
+  ~WaveformOverview();
+
+  WaveformOverview(const WaveformOverview&) = delete;
+  WaveformOverview& operator=(const WaveformOverview&) = delete;
+  WaveformOverview(WaveformOverview&&) noexcept;
+  WaveformOverview& operator=(WaveformOverview&&) noexcept;
+
+  // 映射 Save 写出的文件。kIoError：无法打开/映射；kError：格式或尺寸校验失败；
+  // 失败时对象回到空状态。
+  Status Open(const std::string& path);
+  // 写出紧凑的二进制文件（主机字节序，含魔数/版本/各层偏移）。
+  Status Save(const std::string& path) const;
+  void Close();
+
+  // 已构建或已打开（空轨道也算有效，此时 num_levels 为 0）。
+  bool valid() const;
+  int sample_rate() const;
+  int channels() const;
+  int64_t num_frames() const;
+  int base_bucket_frames() const;
+  int num_levels() const;
+  // 第 level 层每桶帧数（base_bucket_frames << level）与桶数。
+  int64_t bucket_frames(int level) const;
+  int64_t level_buckets(int level) const;
+  // 第 level 层数据：level_buckets × channels 个桶，按桶交错（同 WaveformFrame）。
+  const WaveformBucket* level_data(int level) const;
+
+  // 每列覆盖 frames_per_column 帧时使用的层：桶长不超过列宽的最高层（列宽小于基础桶时为 0）。
+  int LevelFor(double frames_per_column) const;
+
+  // 把 [start_frame, end_frame) 均分为 columns 列，逐列逐声道写出 min/max/RMS 到 out
+  // （columns × channels 个，按列交错）。超出轨道的部分截断到轨道末尾；范围为空、参数无效或
+  // out_capacity 不足时返回 false。
+  bool Query(int64_t start_frame, int64_t end_frame, int columns, WaveformBucket* out,
+             size_t out_capacity) const;
+
+ private:
+  friend class WaveformOverviewBuilder;
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+// 增量构建：Begin 后按解码顺序 Append 交错 PCM（块大小任意），Finish 生成各层。
+// 第 0 层用 SIMD 归约内核逐桶计算，跨 Append 的残桶会累积到下一块。非线程安全。
+class WaveformOverviewBuilder {
+ public:
+  WaveformOverviewBuilder() = default;
+
+  // sample_rate/channels <= 0 或 base_bucket_frames < 1 时返回 false。
+  bool Begin(int sample_rate, int channels, const WaveformOverviewConfig& cfg);
+  // 未 Begin 或参数无效时返回 false。
+  bool Append(const float* interleaved, size_t frames);
+  // 输出金字塔并重置构建状态；未 Begin 时返回 false。
+  bool Finish(WaveformOverview* out);
+
+  int64_t num_frames() const { return num_frames_; }
+
+ private:
+  int sample_rate_ = 0;
+  int channels_ = 0;
+  int base_bucket_frames_ = 0;
+  int64_t num_frames_ = 0;
+  std::vector<WaveformBucket> level0_;
+  // 当前未满的桶：逐声道 min/max/Σx² 与已累积帧数。
+  std::vector<float> pending_;
+  std::vector<float> scratch_;
+  int64_t pending_frames_ = 0;
+
+  void FlushPending();
+};
+
+// 读取 decoder 直到 EOF 构建概览（调用方负责 Open；采样率/声道取自首个缓冲，中途变化视为错误）。
+// 解码出错时返回 decoder 的 last_status。
+Status BuildWaveformOverview(Decoder& decoder, const WaveformOverviewConfig& cfg,
+                             WaveformOverview* out);
+
+}  // namespace sw
@@ -1,14 +1,21 @@
 #include "audio_engine.h"
+#include "band_mapper.h"
+#include "decode_prefetcher.h"
 #include "decoder.h"
 #include "fft_spectrum.h"
 #include "pcm_throttler.h"
+#include "playback_clock.h"
 #include "playback_thread.h"
 #include "ring_buffer.h"
+#include "spectrum_post.h"
+#include "streaming_stft.h"
+#include "waveform_decimator.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <memory>
-#include <optional>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
@@ -22,27 +29,65 @@ class AudioEngineStub : public AudioEngine {
   ~AudioEngineStub() override { ShutdownPlayback(); }
 
   Status Init(const AudioConfig& config) override {
-    if (config.sample_rate <= 0 || config.channels <= 0) {
+    if (config.sample_rate <= 0 || config.channels <= 0 || config.prefetch_ms <= 0 ||
+        config.prefetch_refill_ms < 0 || config.prefetch_refill_ms > config.prefetch_ms) {
       return Status::kInvalidArguments;
     }
-    EnsureDecoder();
+    // 先在副本上补齐默认值并校验其余参数，通过之后才停线程、改解码器与 cfg_：被拒绝的
+    // 再次 Init 不动正在使用的配置，cfg_ 与环形缓冲、预解码器始终一致。
+    AudioConfig next = config;
+    if (next.frames_per_buffer <= 0) {
+      next.frames_per_buffer = kDefaultFramesPerBuffer;
+    }
+    if (next.spectrum_cfg.window_size <= 0) {
+      next.spectrum_cfg.window_size = next.frames_per_buffer;
+    }
+    // overlap 决定是否走流式 STFT，越界时直接拒绝，不悄悄退回逐块频谱。
+    if (next.spectrum_cfg.overlap < 0 ||
+        next.spectrum_cfg.overlap >= next.spectrum_cfg.window_size) {
+      return Status::kInvalidArguments;
+    }
+    // 频带参数在 Init 时校验，避免运行中每块都映射失败、静默不出频谱。
+    if (next.spectrum_cfg.band_scale != BandScale::kNone &&
+        !BandMapper().Configure(next.spectrum_cfg, next.sample_rate)) {
+      return Status::kInvalidArguments;
+    }
+    if (!SpectrumPostProcessor().Configure(next.spectrum_cfg.post) ||
+        !WaveformDecimator().Configure(next.waveform_cfg)) {
+      return Status::kInvalidArguments;
+    }
+    // 下面会重建环形缓冲与预解码器，先停掉仍在使用它们的线程。
+    StopPlayback();
+    // Init 之后须重新 Load：已打开的解码器不再使用（它可能不支持新的输出格式），换回占位解码器。
+    decoder_ = CreateStubDecoder();
     last_sample_rate_ = config.sample_rate;
     last_channels_ = config.channels;
     if (!decoder_->ConfigureOutput(config.sample_rate, config.channels)) {
       return decoder_->last_status();
     }
-    cfg_ = config;
-    if (cfg_.frames_per_buffer <= 0) {
-      cfg_.frames_per_buffer = kDefaultFramesPerBuffer;
-    }
-    if (cfg_.spectrum_cfg.window_size <= 0) {
-      cfg_.spectrum_cfg.window_size = cfg_.frames_per_buffer;
+    cfg_ = next;
+    if (cfg_.spectrum_cfg.band_scale != BandScale::kNone) {
+      spectrum_band_mapper_.Configure(cfg_.spectrum_cfg, cfg_.sample_rate);  // 上面已校验。
     }
-    ring_buffer_ = std::make_unique<RingBuffer>(kRingBufferCapacityFrames, cfg_.channels);
+    spectrum_post_.Configure(cfg_.spectrum_cfg.post);
+    waveform_decimator_.Configure(cfg_.waveform_cfg);
+    // 旧的回放线程析构时还会访问它的环形缓冲，先于缓冲释放。
+    playback_thread_.reset();
+    // 喂数线程为唯一生产者、回放线程为唯一消费者；Seek/Stop 的 Clear 由消费者延迟应用。
+    // 镜像布局使读写区域始终连续（不可用时自动回退）。
+    ring_buffer_ = std::make_unique<RingBuffer>(kRingBufferCapacityFrames, cfg_.channels,
+                                                RingBufferMode::kSpsc, RingBufferLayout::kMirrored);
     playback_thread_ =
         std::make_unique<PlaybackThread>(*ring_buffer_, PlaybackConfig{cfg_.sample_rate,
                                                                        cfg_.channels,
                                                                        cfg_.frames_per_buffer});
+    DecodePrefetcherConfig prefetch_cfg;
+    prefetch_cfg.sample_rate = cfg_.sample_rate;
+    prefetch_cfg.channels = cfg_.channels;
+    prefetch_cfg.read_ahead_ms = cfg_.prefetch_ms;
+    prefetch_cfg.refill_ms = cfg_.prefetch_refill_ms;
+    prefetcher_ = std::make_unique<DecodePrefetcher>(prefetch_cfg);
+    seek_epoch_.fetch_add(1);
     playback_thread_->SetPositionCallback([this](int64_t pos_ms) {
       if (pos_cb_) {
         pos_cb_(pos_ms, pos_ud_);
@@ -52,14 +97,19 @@ class AudioEngineStub : public AudioEngine {
     throttle_cfg.max_fps = cfg_.pcm_max_fps;
     throttle_cfg.max_pending = cfg_.pcm_max_pending;
     throttler_ = std::make_unique<PcmThrottler>(throttle_cfg);
+    waveform_throttler_ = std::make_unique<PcmThrottler>(throttle_cfg);
     PcmThrottleConfig spectrum_cfg;
     spectrum_cfg.max_fps = cfg_.spectrum_max_fps > 0 ? cfg_.spectrum_max_fps : cfg_.pcm_max_fps;
     spectrum_cfg.max_pending =
         cfg_.spectrum_max_pending > 0 ? cfg_.spectrum_max_pending : cfg_.pcm_max_pending;
     spectrum_throttler_ = std::make_unique<PcmThrottler>(spectrum_cfg);
     pcm_sequence_.store(0);
-    pcm_timestamp_ms_.store(0);
+    pcm_clock_.set_sample_rate(cfg_.sample_rate);
+    pcm_clock_.Reset(0);
     spectrum_sequence_.store(0);
+    // overlap > 0 时频谱走流式 STFT：按 hop 输出，与推送块大小无关（参数上面已校验）。
+    stft_enabled_ = cfg_.spectrum_cfg.overlap > 0 &&
+                    stft_.Configure(cfg_.spectrum_cfg, cfg_.sample_rate);
 
     initialized_ = true;
     loaded_ = false;
@@ -75,11 +125,18 @@ class AudioEngineStub : public AudioEngine {
       EmitState(PlaybackState::kIdle, Status::kInvalidArguments);
       return Status::kInvalidArguments;
     }
+    // 预解码线程直接读 decoder_，换解码器前先停下并丢弃旧解码器的块。
+    StopPlayback();
     eof_emitted_.store(false);
-    EnsureDecoder();
-    if (decoder_ && !decoder_->Open(source)) {
-      EmitState(PlaybackState::kIdle, decoder_->last_status());
-      return decoder_->last_status();
+    if (prefetcher_) {
+      prefetcher_->Reset();
+    }
+    seek_epoch_.fetch_add(1);
+    decoder_ = CreateDecoderForSource(source);
+    if (!decoder_->ConfigureOutput(cfg_.sample_rate, cfg_.channels) || !decoder_->Open(source)) {
+      const Status status = decoder_->last_status();
+      EmitState(PlaybackState::kIdle, status);
+      return status;
     }
     loaded_ = true;
     playback_state_ = PlaybackState::kReady;
@@ -122,6 +179,11 @@ class AudioEngineStub : public AudioEngine {
     if (playback_thread_) {
       playback_thread_->ResetPosition(0);
     }
+    if (prefetcher_) {
+      prefetcher_->Seek(0);
+    }
+    pcm_clock_.Reset(0);
+    seek_epoch_.fetch_add(1);
     eof_emitted_.store(false);
     playback_state_ = PlaybackState::kStopped;
     EmitState(playback_state_, Status::kOk);
@@ -134,18 +196,28 @@ class AudioEngineStub : public AudioEngine {
     if (position_ms < 0) {
       return Status::kInvalidArguments;
     }
-    if (ring_buffer_) {
-      ring_buffer_->Clear();
+    {
+      // 与喂数线程的「取块—写环形缓冲—推进时钟」互斥：Seek 返回后环形缓冲里不会再出现旧位置
+      // 的数据，首个新块的时间戳从 position_ms 起算。
+      std::lock_guard<std::mutex> lock(feed_mutex_);
+      seek_epoch_.fetch_add(1);  // 作废喂数线程的暂存。
+      if (ring_buffer_) {
+        ring_buffer_->Clear();
+      }
+      // 解码器只在预解码线程访问：由它定位并丢弃已预解码的旧块。
+      if (prefetcher_) {
+        prefetcher_->Seek(position_ms * cfg_.sample_rate / 1000);
+      }
+      pcm_clock_.ResetMs(position_ms);
+      pcm_sequence_.store(0);
     }
-    pcm_timestamp_ms_.store(position_ms);
-    pcm_sequence_.store(0);
     spectrum_sequence_.store(0);
     eof_emitted_.store(false);
-    if (throttler_) {
-      throttler_->Reset();
-    }
-    if (spectrum_throttler_) {
-      spectrum_throttler_->Reset();
+    {
+      std::lock_guard<std::mutex> lock(subscribers_mutex_);
+      for (auto& sub : subscribers_) {
+        sub.throttler.Reset();
+      }
     }
     if (playback_thread_) {
       playback_thread_->ResetPosition(position_ms);
@@ -174,7 +246,127 @@ class AudioEngineStub : public AudioEngine {
     spectrum_ud_ = user_data;
   }
 
+  void SetWaveformCallback(void (*callback)(const WaveformFrame&, void*),
+                           void* user_data) override {
+    waveform_cb_ = callback;
+    waveform_ud_ = user_data;
+  }
+
+  SubscriptionId AddPcmSubscriber(const PcmSubscriberConfig& config,
+                                  void (*callback)(const PcmFrame&, void*),
+                                  void* user_data) override {
+    if (callback == nullptr) return 0;
+    return AddSubscriber(config, callback, nullptr, nullptr, user_data);
+  }
+
+  SubscriptionId AddSpectrumSubscriber(const PcmSubscriberConfig& config,
+                                       void (*callback)(const SpectrumFrame&, void*),
+                                       void* user_data) override {
+    if (callback == nullptr) return 0;
+    return AddSubscriber(config, nullptr, callback, nullptr, user_data);
+  }
+
+  SubscriptionId AddWaveformSubscriber(const PcmSubscriberConfig& config,
+                                       void (*callback)(const WaveformFrame&, void*),
+                                       void* user_data) override {
+    if (callback == nullptr) return 0;
+    return AddSubscriber(config, nullptr, nullptr, callback, user_data);
+  }
+
+  bool RemoveSubscriber(SubscriptionId id) override {
+    // 喂数线程投递期间持有该锁，返回后不会再回调被移除的订阅者。
+    std::lock_guard<std::mutex> lock(subscribers_mutex_);
+    for (auto it = subscribers_.begin(); it != subscribers_.end(); ++it) {
+      if (it->id == id) {
+        subscribers_.erase(it);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  BufferStats GetBufferStats() const override {
+    BufferStats stats;
+    if (prefetcher_) {
+      const DecodePrefetchStats prefetch = prefetcher_->stats();
+      stats.prefetched_ms = PlaybackClock::FramesToMs(prefetch.buffered_frames, cfg_.sample_rate);
+      stats.decode_underruns = prefetch.underruns;
+    }
+    if (ring_buffer_) {
+      stats.ring_ms = PlaybackClock::FramesToMs(
+          static_cast<int64_t>(ring_buffer_->readable_frames()), cfg_.sample_rate);
+    }
+    if (playback_thread_) {
+      stats.playback_underruns = playback_thread_->underruns();
+    }
+    stats.buffered_ahead_ms = stats.prefetched_ms + stats.ring_ms;
+    return stats;
+  }
+
  private:
+  // 喂数线程的暂存区：[read, write) 为已解码、尚未写入环形缓冲的帧。环形缓冲只接收一部分时
+  // 剩余帧留在这里下次续写，超出推送块大小的部分也不丢弃，解码出的每一帧都恰好推送一次。
+  struct PcmStaging {
+    std::vector<float> samples;  // 交错存储，size() 即容量。
+    size_t read = 0;             // 帧游标。
+    size_t write = 0;
+
+    size_t readable() const { return write - read; }
+    const float* read_ptr(int channels) const {
+      return samples.data() + read * static_cast<size_t>(channels);
+    }
+    void Consume(size_t frames) { read += std::min(frames, readable()); }
+    void Clear() { read = write = 0; }
+
+    // 把未读部分移到开头，并保证能再追加 frames 帧（仅预热期可能扩容）。
+    float* PrepareAppend(size_t frames, int channels) {
+      const size_t ch = static_cast<size_t>(channels);
+      if (read > 0) {
+        std::copy(samples.begin() + static_cast<std::ptrdiff_t>(read * ch),
+                  samples.begin() + static_cast<std::ptrdiff_t>(write * ch), samples.begin());
+        write -= read;
+        read = 0;
+      }
+      if (samples.size() < (write + frames) * ch) {
+        samples.resize((write + frames) * ch);
+      }
+      return samples.data() + write * ch;
+    }
+
+    // 暂存区为空时直接与解码块交换存储（零拷贝，旧存储随块回到预解码池），否则追加拷贝。
+    void Append(PcmBuffer* block, int channels) {
+      const size_t frames = block->interleaved.size() / static_cast<size_t>(channels);
+      if (readable() == 0) {
+        samples.swap(block->interleaved);
+        read = 0;
+        write = frames;
+        return;
+      }
+      float* dst = PrepareAppend(frames, channels);
+      std::copy(block->interleaved.begin(),
+                block->interleaved.begin() +
+                    static_cast<std::ptrdiff_t>(frames * static_cast<size_t>(channels)),
+                dst);
+      write += frames;
+    }
+
+    void AppendSilence(size_t frames, int channels) {
+      float* dst = PrepareAppend(frames, channels);
+      std::fill(dst, dst + frames * static_cast<size_t>(channels), 0.0f);
+      write += frames;
+    }
+  };
+
+  struct Subscriber {
+    SubscriptionId id = 0;
+    PcmThrottler throttler;
+    void (*pcm_cb)(const PcmFrame&, void*) = nullptr;
+    void (*spectrum_cb)(const SpectrumFrame&, void*) = nullptr;
+    void (*waveform_cb)(const WaveformFrame&, void*) = nullptr;
+    void* user_data = nullptr;
+    bool accepted = false;  // 当前 STFT hop 是否通过该订阅者的限频（仅喂数线程使用）。
+  };
+
   bool initialized_ = false;
   bool loaded_ = false;
   int last_sample_rate_ = 48000;
@@ -182,6 +374,8 @@ class AudioEngineStub : public AudioEngine {
   AudioConfig cfg_;
   PlaybackState playback_state_ = PlaybackState::kIdle;
   std::unique_ptr<Decoder> decoder_;
+  // 后台预解码：播放期间 decoder_ 只由它的线程访问，喂数线程从它的队列取块。
+  std::unique_ptr<DecodePrefetcher> prefetcher_;
   std::unique_ptr<RingBuffer> ring_buffer_;
   std::unique_ptr<PlaybackThread> playback_thread_;
   std::thread feeder_thread_;
@@ -189,10 +383,57 @@ class AudioEngineStub : public AudioEngine {
   std::atomic<bool> playing_{false};
   std::unique_ptr<PcmThrottler> throttler_;
   std::unique_ptr<PcmThrottler> spectrum_throttler_;
+  std::unique_ptr<PcmThrottler> waveform_throttler_;
   std::atomic<uint32_t> pcm_sequence_{0};
-  std::atomic<int64_t> pcm_timestamp_ms_{0};
+  // Position of the next frame handed to the ring; PCM/spectrum timestamps derive from it.
+  PlaybackClock pcm_clock_;
   std::atomic<uint32_t> spectrum_sequence_{0};
   std::atomic<bool> eof_emitted_{false};
+  // Seek/Stop/Load 时递增；喂数线程发现变化即清空暂存区。
+  std::atomic<uint64_t> seek_epoch_{0};
+  // 喂数线程持有它完成检查 epoch、取块、写环形缓冲与推进 pcm_clock_（不含等待与回调）；
+  // Seek 持有它完成清空与定位，两者不会交错。
+  std::mutex feed_mutex_;
+  // 以下仅喂数线程访问（跨 Pause/Play 保留，未推送的帧在恢复后继续推送）。
+  PcmBuffer pcm_block_;
+  PcmStaging staging_;
+  uint64_t staging_epoch_ = 0;
+  // Spectrum scratch state, only touched from the feeder thread (no steady-state allocation).
+  SpectrumAnalyzer spectrum_analyzer_;
+  std::vector<float> spectrum_mono_;
+  std::vector<float> spectrum_bins_;
+  BandMapper spectrum_band_mapper_;
+  std::vector<float> spectrum_bands_;
+  SpectrumPostProcessor spectrum_post_;
+  SpectrumFrame spectrum_frame_;
+  // 流式 STFT（spectrum_cfg.overlap > 0 时启用），仅喂数线程访问。
+  StreamingStft stft_;
+  bool stft_enabled_ = false;
+  uint64_t feeder_chunk_ = 0;           // 喂数线程每推送一块递增，作为频谱缓存的键。
+  uint64_t spectrum_frame_chunk_ = 0;   // spectrum_frame_ 对应的块；0 表示无效。
+  // 波形降采样状态，同样仅喂数线程访问、按块缓存。
+  WaveformDecimator waveform_decimator_;
+  WaveformFrame waveform_frame_;
+  uint64_t waveform_frame_chunk_ = 0;
+  // 额外订阅者：喂数线程投递期间持有 subscribers_mutex_。
+  std::mutex subscribers_mutex_;
+  std::vector<Subscriber> subscribers_;
+  SubscriptionId next_subscription_id_ = 1;
+
+  SubscriptionId AddSubscriber(const PcmSubscriberConfig& config,
+                               void (*pcm_cb)(const PcmFrame&, void*),
+                               void (*spectrum_cb)(const SpectrumFrame&, void*),
+                               void (*waveform_cb)(const WaveformFrame&, void*), void* user_data) {
+    if (config.max_fps < 0 || config.max_pending == 0) return 0;
+    PcmThrottleConfig throttle_cfg;
+    throttle_cfg.max_fps = config.max_fps;
+    throttle_cfg.max_pending = config.max_pending;
+    std::lock_guard<std::mutex> lock(subscribers_mutex_);
+    subscribers_.push_back(
+        Subscriber{next_subscription_id_++, PcmThrottler(throttle_cfg), pcm_cb, spectrum_cb,
+                   waveform_cb, user_data});
+    return subscribers_.back().id;
+  }
 
   void EnsureDecoder() {
     if (!decoder_) {
@@ -212,8 +453,12 @@ class AudioEngineStub : public AudioEngine {
   void (*spectrum_cb_)(const SpectrumFrame&, void*) = nullptr;
   void* spectrum_ud_ = nullptr;
 
+  void (*waveform_cb_)(const WaveformFrame&, void*) = nullptr;
+  void* waveform_ud_ = nullptr;
+
   static constexpr int kDefaultFramesPerBuffer = 256;
   static constexpr int kRingBufferCapacityFrames = 4096;
+  static constexpr std::chrono::milliseconds kFeederMaxIdleWait{100};
 
   void EmitState(PlaybackState state, Status status) {
     if (state_cb_) {
@@ -226,78 +471,123 @@ class AudioEngineStub : public AudioEngine {
     if (feeder_running_.exchange(true)) {
       return;
     }
+    if (feeder_thread_.joinable()) {
+      feeder_thread_.join();  // 上次因解码出错自行退出的线程。
+    }
+    if (prefetcher_ && decoder_) {
+      prefetcher_->Start(decoder_.get());
+    }
     feeder_thread_ = std::thread([this]() {
-      PcmBuffer pcm_buffer;
       const size_t target_frames = static_cast<size_t>(
           cfg_.pcm_frames_per_push > 0 ? cfg_.pcm_frames_per_push : cfg_.frames_per_buffer);
+      const int channels = cfg_.channels;
       while (feeder_running_.load()) {
-        if (!ring_buffer_ || !decoder_) {
+        if (!ring_buffer_ || !prefetcher_) {
           std::this_thread::sleep_for(std::chrono::milliseconds(1));
           continue;
         }
+        std::unique_lock<std::mutex> lock(feed_mutex_);
+        const uint64_t epoch = seek_epoch_.load();
+        if (epoch != staging_epoch_) {
+          // Seek/Stop/Load 之后暂存的旧位置数据作废；节流器与频谱平滑/峰值状态只由本线程使用，
+          // 也在这里复位，新位置的频谱不会与旧位置的混合。
+          staging_.Clear();
+          staging_epoch_ = epoch;
+          throttler_->Reset();
+          spectrum_throttler_->Reset();
+          waveform_throttler_->Reset();
+          spectrum_post_.Reset();
+          if (stft_enabled_) {
+            stft_.Reset(pcm_clock_.frames());
+          }
+        }
 
-        bool has_frame = decoder_->Read(pcm_buffer);
-        if (!has_frame) {
-          if (decoder_->last_status() != Status::kOk) {
+        // 暂存不足一个推送块时先补数据；解码未跟上或已到结尾时推送已有的部分。
+        if (staging_.readable() < target_frames) {
+          Status end_status = Status::kOk;
+          const PrefetchResult fetched = prefetcher_->Pop(&pcm_block_, &end_status);
+          if (fetched == PrefetchResult::kBlock) {
+            staging_.Append(&pcm_block_, channels);
+            continue;
+          }
+          if (fetched == PrefetchResult::kEnd && end_status != Status::kOk) {
+            lock.unlock();
             feeder_running_.store(false);
             playing_.store(false);
-            EmitState(PlaybackState::kStopped, decoder_->last_status());
+            EmitState(PlaybackState::kStopped, end_status);
             break;
           }
-          // EOF：发出结束事件，但仍填充静音以维持时钟推进。
-          if (!eof_emitted_.exchange(true)) {
-            EmitState(PlaybackState::kStopped, Status::kOk);
+          if (staging_.readable() == 0) {
+            if (fetched == PrefetchResult::kEmpty) {
+              // 解码尚未跟上（或刚 Seek）：等预解码线程交付，环形缓冲里的存量继续播放。
+              lock.unlock();
+              prefetcher_->WaitForData(kFeederMaxIdleWait);
+              continue;
+            }
+            // EOF：发出结束事件（回调里可能调用 Seek，先放锁），但仍填充静音以维持时钟推进。
+            if (!eof_emitted_.exchange(true)) {
+              lock.unlock();
+              EmitState(PlaybackState::kStopped, Status::kOk);
+              continue;
+            }
+            staging_.AppendSilence(target_frames, channels);
           }
-          pcm_buffer.sample_rate = cfg_.sample_rate;
-          pcm_buffer.channels = cfg_.channels;
-          pcm_buffer.interleaved.assign(target_frames * static_cast<size_t>(cfg_.channels), 0.0f);
         }
-        if (pcm_buffer.channels <= 0) {
-          pcm_buffer.channels = cfg_.channels;
-        }
-        if (pcm_buffer.sample_rate <= 0) {
-          pcm_buffer.sample_rate = cfg_.sample_rate;
-        }
-        size_t frames = pcm_buffer.interleaved.size() / static_cast<size_t>(pcm_buffer.channels);
-        if (frames == 0) {
+
+        // 等到能整块写入再写，推送块大小保持一致；个别仍被截短的写入由读游标续写剩余部分。
+        const size_t frames = std::min({staging_.readable(), target_frames,
+                                        ring_buffer_->capacity_frames()});
+        if (ring_buffer_->writable_frames() < frames) {
+          // 缓冲已满：阻塞到回放线程腾出一个推送块的空间（StopFeeder 会唤醒）。
+          lock.unlock();
+          ring_buffer_->WaitForWritable(frames, kFeederMaxIdleWait);
           continue;
         }
-        // Limit per-push frames to target; excess remains in buffer to be read next tick.
-        if (frames > target_frames) {
-          frames = target_frames;
-        }
-        size_t wrote =
-            ring_buffer_->Write(pcm_buffer.interleaved.data(), static_cast<size_t>(frames));
+        const float* data = staging_.read_ptr(channels);
+        const size_t wrote = ring_buffer_->Write(data, frames);
         if (wrote == 0) {
-          std::this_thread::sleep_for(std::chrono::milliseconds(1));
           continue;
         }
-        // 可视化 PCM 推送（交错 float32）。
+        staging_.Consume(wrote);
+
+        // 可视化推送只覆盖实际写入环形缓冲的帧（交错 float32）。data 仍指向暂存区，暂存区只有
+        // 本线程会改动，放锁后照常可读。
+        ++feeder_chunk_;
+        PcmFrame chunk;
+        chunk.data = data;
+        chunk.num_frames = static_cast<int>(wrote);
+        chunk.num_channels = channels;
+        chunk.sample_rate = cfg_.sample_rate;
+        chunk.timestamp_ms = pcm_clock_.ms();
+        chunk.sequence = pcm_sequence_.fetch_add(1) + 1;
+        const int64_t chunk_start_frame = pcm_clock_.frames();
+        pcm_clock_.Advance(static_cast<int64_t>(wrote));
+        lock.unlock();
         if (pcm_cb_ && throttler_) {
           PcmThrottleInput in;
-          in.sequence = pcm_sequence_.fetch_add(1) + 1;
-          in.timestamp_ms = pcm_timestamp_ms_.load();
-          in.num_frames = static_cast<int>(frames);
-          in.num_channels = pcm_buffer.channels;
-          auto outs = throttler_->Push(in, in.timestamp_ms);
-          for (const auto& o : outs) {
+          in.sequence = chunk.sequence;
+          in.timestamp_ms = chunk.timestamp_ms;
+          in.num_frames = chunk.num_frames;
+          in.num_channels = chunk.num_channels;
+          PcmThrottleOutput o;
+          if (throttler_->Push(in, in.timestamp_ms, &o)) {
             if (o.dropped) {
-              MaybeEmitSpectrum(/*frame=*/std::nullopt, o.timestamp_ms);
-              continue;
+              MaybeEmitSpectrum(/*frame=*/nullptr, o.timestamp_ms);
+            } else {
+              PcmFrame frame = chunk;
+              frame.timestamp_ms = o.timestamp_ms;
+              frame.sequence = o.sequence;
+              frame.dropped_before = o.dropped_before;
+              pcm_cb_(frame, pcm_ud_);
+              MaybeEmitSpectrum(&frame, o.timestamp_ms);
             }
-            PcmFrame frame;
-            frame.data = pcm_buffer.interleaved.data();
-            frame.num_frames = in.num_frames;
-            frame.num_channels = in.num_channels;
-            frame.sample_rate = pcm_buffer.sample_rate;
-            frame.timestamp_ms = o.timestamp_ms;
-            pcm_cb_(frame, pcm_ud_);
-            MaybeEmitSpectrum(frame, o.timestamp_ms);
           }
         }
-        const int64_t frame_duration_ms =
-            static_cast<int64_t>((frames * 1000) / static_cast<size_t>(pcm_buffer.sample_rate));
-        pcm_timestamp_ms_.fetch_add(frame_duration_ms);
+        MaybeEmitWaveform(chunk);
+        DeliverToSubscribers(chunk);
+        if (stft_enabled_) {
+          EmitStftSpectra(chunk, chunk_start_frame);
+        }
       }
       playing_ = false;
       EmitState(PlaybackState::kStopped, Status::kOk);
@@ -306,6 +596,12 @@ class AudioEngineStub : public AudioEngine {
 
   void StopFeeder() {
     feeder_running_.store(false);
+    if (ring_buffer_) {
+      ring_buffer_->WakeAll();
+    }
+    if (prefetcher_) {
+      prefetcher_->Stop();  // 也会唤醒等在 WaitForData 上的喂数线程。
+    }
     if (feeder_thread_.joinable()) {
       feeder_thread_.join();
     }
@@ -330,48 +626,200 @@ class AudioEngineStub : public AudioEngine {
     StopPlayback();
   }
 
-  void MaybeEmitSpectrum(std::optional<PcmFrame> frame_opt, int64_t timestamp_ms) {
-    if (!spectrum_cb_ || !spectrum_throttler_) return;
+  // frame 为空表示 PCM 侧丢帧标记：只推进频谱节流状态，不计算。
+  void MaybeEmitSpectrum(const PcmFrame* frame, int64_t timestamp_ms) {
+    if (!spectrum_cb_ || !spectrum_throttler_ || stft_enabled_) return;
     const uint32_t seq = spectrum_sequence_.fetch_add(1) + 1;
     PcmThrottleInput in;
     in.sequence = seq;
     in.timestamp_ms = timestamp_ms;
-    in.num_frames = frame_opt ? frame_opt->num_frames : 0;
-    in.num_channels = frame_opt ? frame_opt->num_channels : 0;
+    in.num_frames = frame ? frame->num_frames : 0;
+    in.num_channels = frame ? frame->num_channels : 0;
 
-    const auto outs = spectrum_throttler_->Push(in, timestamp_ms);
-    for (const auto& o : outs) {
-      if (o.dropped || !frame_opt) {
-        continue;
-      }
-      const PcmFrame& frame = *frame_opt;
-      const int samples_per_channel = frame.num_frames;
-      if (frame.num_channels <= 0 || samples_per_channel <= 0) continue;
+    PcmThrottleOutput o;
+    if (!spectrum_throttler_->Push(in, timestamp_ms, &o)) return;
+    if (o.dropped || frame == nullptr) return;
+
+    const SpectrumFrame* spectrum = SpectrumForChunk(*frame);
+    if (spectrum == nullptr) return;
+    SpectrumFrame out = *spectrum;
+    out.timestamp_ms = o.timestamp_ms;
+    spectrum_cb_(out, spectrum_ud_);
+  }
+
+  // 计算当前块的频谱；同一块内多次调用（默认回调与各频谱订阅者）只计算一次。
+  const SpectrumFrame* SpectrumForChunk(const PcmFrame& frame) {
+    if (spectrum_frame_chunk_ == feeder_chunk_) {
+      return &spectrum_frame_;
+    }
+    const int samples_per_channel = frame.num_frames;
+    if (frame.num_channels <= 0 || samples_per_channel <= 0) return nullptr;
+
+    SpectrumConfig spec_cfg = cfg_.spectrum_cfg;
+    if (spec_cfg.window_size <= 0 || spec_cfg.window_size > samples_per_channel) {
+      spec_cfg.window_size = samples_per_channel;
+    }
+
+    if (spectrum_mono_.size() < static_cast<size_t>(spec_cfg.window_size)) {
+      spectrum_mono_.resize(static_cast<size_t>(spec_cfg.window_size));
+    }
+    spec_cfg.window_size = DownmixToMono(frame.data, samples_per_channel, frame.num_channels,
+                                         spec_cfg.window_size, spectrum_mono_.data(),
+                                         static_cast<int>(spectrum_mono_.size()));
+    if (spec_cfg.window_size <= 0) return nullptr;
+
+    if (!spectrum_analyzer_.Configure(spec_cfg)) return nullptr;
+    const size_t num_bins = static_cast<size_t>(spectrum_analyzer_.num_bins());
+    if (spectrum_bins_.size() < num_bins) {
+      spectrum_bins_.resize(num_bins);
+    }
+    if (!spectrum_analyzer_.Compute(spectrum_mono_.data(),
+                                    static_cast<size_t>(spec_cfg.window_size),
+                                    spectrum_bins_.data(), num_bins)) {
+      return nullptr;
+    }
+
+    SpectrumFrame& out = spectrum_frame_;
+    out.bins = spectrum_bins_.data();
+    out.num_bins = static_cast<int>(num_bins);
+    out.window_size = spec_cfg.window_size;
+    out.bin_hz =
+        static_cast<float>(frame.sample_rate) / static_cast<float>(spec_cfg.window_size);
+    out.sample_rate = frame.sample_rate;
+    out.window = spec_cfg.window;
+    out.power_spectrum = spec_cfg.power_spectrum;
+    out.timestamp_ms = frame.timestamp_ms;
+    out.band_scale = BandScale::kNone;
+    out.band_hz = nullptr;
+    out.decibels = false;
+    out.peaks = nullptr;
+    if (!MapSpectrumFrame(spec_cfg, &spectrum_band_mapper_, &spectrum_bands_, &out) ||
+        !spectrum_post_.Process(&out)) {
+      return nullptr;
+    }
+    spectrum_frame_chunk_ = feeder_chunk_;
+    return &out;
+  }
+
+  // 默认波形回调：独立限频（参数同 PCM 回调），通过时对当前块降采样。
+  void MaybeEmitWaveform(const PcmFrame& frame) {
+    if (!waveform_cb_ || !waveform_throttler_) return;
+    PcmThrottleInput in;
+    in.sequence = frame.sequence;
+    in.timestamp_ms = frame.timestamp_ms;
+    in.num_frames = frame.num_frames;
+    in.num_channels = frame.num_channels;
+    PcmThrottleOutput o;
+    if (!waveform_throttler_->Push(in, frame.timestamp_ms, &o) || o.dropped) return;
 
-      SpectrumConfig spec_cfg = cfg_.spectrum_cfg;
-      if (spec_cfg.window_size <= 0 || spec_cfg.window_size > samples_per_channel) {
-        spec_cfg.window_size = samples_per_channel;
+    const WaveformFrame* waveform = WaveformForChunk(frame);
+    if (waveform == nullptr) return;
+    WaveformFrame out = *waveform;
+    out.timestamp_ms = o.timestamp_ms;
+    out.sequence = o.sequence;
+    out.dropped_before = o.dropped_before;
+    waveform_cb_(out, waveform_ud_);
+  }
+
+  // 当前块的降采样结果；同一块内默认回调与各订阅者只计算一次。
+  const WaveformFrame* WaveformForChunk(const PcmFrame& frame) {
+    if (waveform_frame_chunk_ == feeder_chunk_) {
+      return &waveform_frame_;
+    }
+    if (!waveform_decimator_.Process(frame, &waveform_frame_)) return nullptr;
+    waveform_frame_chunk_ = feeder_chunk_;
+    return &waveform_frame_;
+  }
+
+  // 按各订阅者自己的限频规则投递当前块；所有订阅者共享同一份 PCM（不拷贝）与同一次 FFT。
+  void DeliverToSubscribers(const PcmFrame& frame) {
+    std::lock_guard<std::mutex> lock(subscribers_mutex_);
+    if (subscribers_.empty()) return;
+
+    PcmThrottleInput in;
+    in.sequence = frame.sequence;
+    in.timestamp_ms = frame.timestamp_ms;
+    in.num_frames = frame.num_frames;
+    in.num_channels = frame.num_channels;
+    for (auto& sub : subscribers_) {
+      if (sub.spectrum_cb && stft_enabled_) continue;  // 由 EmitStftSpectra 按 hop 驱动。
+      PcmThrottleOutput o;
+      if (!sub.throttler.Push(in, frame.timestamp_ms, &o)) continue;
+      if (sub.pcm_cb) {
+        PcmFrame out = frame;
+        out.dropped_before = o.dropped_before;
+        if (o.dropped) {
+          out.dropped = true;
+          out.data = nullptr;
+          out.num_frames = 0;
+        }
+        sub.pcm_cb(out, sub.user_data);
+      } else if (sub.waveform_cb) {
+        if (o.dropped) continue;
+        if (const WaveformFrame* waveform = WaveformForChunk(frame)) {
+          WaveformFrame out = *waveform;
+          out.dropped_before = o.dropped_before;
+          sub.waveform_cb(out, sub.user_data);
+        }
+      } else if (!o.dropped && !stft_enabled_) {
+        if (const SpectrumFrame* spectrum = SpectrumForChunk(frame)) {
+          sub.spectrum_cb(*spectrum, sub.user_data);
+        }
       }
+    }
+  }
+
+  // 把当前块送入流式 STFT，并对每个就绪的 hop 按默认回调与各频谱订阅者的限频决定是否输出；
+  // 无人接收的 hop 直接跳过，不做 FFT。start_frame 为本块首帧的绝对帧号。
+  void EmitStftSpectra(const PcmFrame& chunk, int64_t start_frame) {
+    const int frames = chunk.num_frames;
+    std::lock_guard<std::mutex> lock(subscribers_mutex_);
+    const bool has_subscriber =
+        std::any_of(subscribers_.begin(), subscribers_.end(),
+                    [](const Subscriber& sub) { return sub.spectrum_cb != nullptr; });
+    if (!has_subscriber && (!spectrum_cb_ || !spectrum_throttler_)) {
+      stft_.Reset(start_frame + frames);  // 无人订阅：不保留历史，之后从当前位置重新累积。
+      return;
+    }
+    if (stft_.next_input_frame() != start_frame) {
+      stft_.Reset(start_frame);  // Seek 或断流：历史不再连续。
+    }
+    stft_.Push(chunk.data, frames, chunk.num_channels);
 
-      auto mono =
-          DownmixToMono(frame.data, samples_per_channel, frame.num_channels, spec_cfg.window_size);
-      spec_cfg.window_size = static_cast<int>(mono.size());
-      if (mono.empty()) continue;
-
-      auto spectrum = ComputeSpectrum(mono, frame.sample_rate, spec_cfg);
-      if (spectrum.empty()) continue;
-
-      SpectrumFrame out;
-      out.bins = spectrum.data();
-      out.num_bins = static_cast<int>(spectrum.size());
-      out.window_size = spec_cfg.window_size;
-      out.bin_hz = static_cast<float>(frame.sample_rate) /
-                   static_cast<float>(spec_cfg.window_size);
-      out.sample_rate = frame.sample_rate;
-      out.window = spec_cfg.window;
-      out.power_spectrum = spec_cfg.power_spectrum;
-      out.timestamp_ms = o.timestamp_ms;
-      spectrum_cb_(out, spectrum_ud_);
+    StftFrame hop;
+    while (stft_.ready()) {
+      const int64_t timestamp_ms =
+          PlaybackClock::FramesToMs(stft_.next_window_frame(), stft_.sample_rate());
+      PcmThrottleInput in;
+      in.sequence = spectrum_sequence_.fetch_add(1) + 1;
+      in.timestamp_ms = timestamp_ms;
+      in.num_frames = stft_.config().window_size;
+      in.num_channels = 1;
+
+      PcmThrottleOutput o;
+      const bool to_default = spectrum_cb_ && spectrum_throttler_ &&
+                              spectrum_throttler_->Push(in, timestamp_ms, &o) && !o.dropped;
+      bool any = to_default;
+      for (auto& sub : subscribers_) {
+        sub.accepted = false;
+        if (sub.spectrum_cb == nullptr) continue;
+        PcmThrottleOutput sub_out;
+        sub.accepted = sub.throttler.Push(in, timestamp_ms, &sub_out) && !sub_out.dropped;
+        any = any || sub.accepted;
+      }
+      if (!any) {
+        stft_.Skip();
+        continue;
+      }
+      if (!stft_.Next(&hop)) break;
+      if (to_default) {
+        spectrum_cb_(hop.spectrum, spectrum_ud_);
+      }
+      for (auto& sub : subscribers_) {
+        if (sub.accepted) {
+          sub.spectrum_cb(hop.spectrum, sub.user_data);
+        }
+      }
     }
   }
 };
@@ -0,0 +1,201 @@
+#include "band_mapper.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sw {
+namespace {
+
+constexpr int kMaxOctaveFraction = 24;
+constexpr float kOctaveReferenceHz = 1000.0f;
+
+inline float HzToMel(float hz) { return 2595.0f * std::log10(1.0f + hz / 700.0f); }
+inline float MelToHz(float mel) { return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f); }
+
+}  // namespace
+
+void BandMapper::Clear() {
+  scale_ = BandScale::kNone;
+  num_bins_ = 0;
+  bands_.clear();
+  weights_.clear();
+  center_hz_.clear();
+}
+
+void BandMapper::AddBand(float center, int first, const std::vector<float>& bin_weights,
+                         float bin_hz) {
+  // 去掉两端的零权重，只保留真正参与的 bin。
+  size_t lo = 0;
+  size_t hi = bin_weights.size();
+  while (lo < hi && bin_weights[lo] <= 0.0f) ++lo;
+  while (hi > lo && bin_weights[hi - 1] <= 0.0f) --hi;
+
+  Band band;
+  band.weight_offset = static_cast<uint32_t>(weights_.size());
+  float sum = 0.0f;
+  for (size_t i = lo; i < hi; ++i) sum += bin_weights[i];
+  if (sum > 0.0f) {
+    band.first_bin = static_cast<uint32_t>(first + static_cast<int>(lo));
+    band.count = static_cast<uint32_t>(hi - lo);
+    for (size_t i = lo; i < hi; ++i) {
+      weights_.push_back(bin_weights[i] / sum);
+    }
+  } else {
+    // 频带内没有 bin 中心：在中心频率处对相邻 bin 线性插值。
+    const float pos = std::min(center / bin_hz, static_cast<float>(num_bins_ - 1));
+    const int k0 = static_cast<int>(pos);
+    const float frac = pos - static_cast<float>(k0);
+    band.first_bin = static_cast<uint32_t>(k0);
+    if (frac > 0.0f && k0 + 1 < num_bins_) {
+      band.count = 2;
+      weights_.push_back(1.0f - frac);
+      weights_.push_back(frac);
+    } else {
+      band.count = 1;
+      weights_.push_back(1.0f);
+    }
+  }
+  bands_.push_back(band);
+  center_hz_.push_back(center);
+}
+
+bool BandMapper::Configure(const SpectrumConfig& cfg, int sample_rate) {
+  if (configured() && cfg.band_scale == scale_ && cfg.num_bands == bands_requested_ &&
+      cfg.octave_fraction == octave_fraction_ && cfg.min_hz == min_hz_ &&
+      cfg.max_hz == max_hz_ && cfg.window_size == window_size_ && sample_rate == sample_rate_) {
+    return true;
+  }
+  Clear();
+  if (cfg.band_scale == BandScale::kNone || cfg.window_size <= 0 || sample_rate <= 0) {
+    return false;
+  }
+  const float nyquist = static_cast<float>(sample_rate) * 0.5f;
+  const float lo_hz = cfg.min_hz;
+  const float hi_hz = cfg.max_hz > 0.0f ? std::min(cfg.max_hz, nyquist) : nyquist;
+  if (!(lo_hz > 0.0f) || lo_hz >= hi_hz) {
+    return false;
+  }
+  num_bins_ = cfg.window_size / 2 + 1;
+  const float bin_hz = static_cast<float>(sample_rate) / static_cast<float>(cfg.window_size);
+  const int last_bin = num_bins_ - 1;
+  std::vector<float> w;
+
+  // 矩形频带 [lo, hi)：中心频率落在区间内的 bin 权重相同。
+  auto add_rect = [&](float lo, float hi, float center) {
+    const int first = std::max(0, static_cast<int>(std::ceil(lo / bin_hz)));
+    const int last = std::min(last_bin, static_cast<int>(std::ceil(hi / bin_hz)) - 1);
+    w.assign(static_cast<size_t>(std::max(0, last - first + 1)), 1.0f);
+    AddBand(center, first, w, bin_hz);
+  };
+
+  switch (cfg.band_scale) {
+    case BandScale::kMel: {
+      if (cfg.num_bands < 1) return false;
+      const int count = cfg.num_bands;
+      const float mel_lo = HzToMel(lo_hz);
+      const float mel_step = (HzToMel(hi_hz) - mel_lo) / static_cast<float>(count + 1);
+      for (int b = 0; b < count; ++b) {
+        const float lower = MelToHz(mel_lo + mel_step * static_cast<float>(b));
+        const float center = MelToHz(mel_lo + mel_step * static_cast<float>(b + 1));
+        const float upper = MelToHz(mel_lo + mel_step * static_cast<float>(b + 2));
+        const int first = std::max(0, static_cast<int>(std::floor(lower / bin_hz)) + 1);
+        const int last = std::min(last_bin, static_cast<int>(std::ceil(upper / bin_hz)) - 1);
+        w.assign(static_cast<size_t>(std::max(0, last - first + 1)), 0.0f);
+        for (int k = first; k <= last; ++k) {
+          const float f = static_cast<float>(k) * bin_hz;
+          w[static_cast<size_t>(k - first)] =
+              f <= center ? (f - lower) / (center - lower) : (upper - f) / (upper - center);
+        }
+        AddBand(center, first, w, bin_hz);
+      }
+      break;
+    }
+    case BandScale::kLog: {
+      if (cfg.num_bands < 1) return false;
+      const int count = cfg.num_bands;
+      const float ratio = hi_hz / lo_hz;
+      for (int b = 0; b < count; ++b) {
+        const float lo = lo_hz * std::pow(ratio, static_cast<float>(b) / count);
+        const float hi = lo_hz * std::pow(ratio, static_cast<float>(b + 1) / count);
+        add_rect(lo, hi, std::sqrt(lo * hi));
+      }
+      break;
+    }
+    case BandScale::kOctave: {
+      const int n = cfg.octave_fraction;
+      if (n < 1 || n > kMaxOctaveFraction) return false;
+      const int k_first = static_cast<int>(std::ceil(n * std::log2(lo_hz / kOctaveReferenceHz)));
+      const int k_last = static_cast<int>(std::floor(n * std::log2(hi_hz / kOctaveReferenceHz)));
+      const float half_band = std::pow(2.0f, 0.5f / static_cast<float>(n));
+      for (int k = k_first; k <= k_last; ++k) {
+        const float center =
+            kOctaveReferenceHz * std::pow(2.0f, static_cast<float>(k) / static_cast<float>(n));
+        add_rect(center / half_band, center * half_band, center);
+      }
+      break;
+    }
+    case BandScale::kNone:
+      break;
+  }
+
+  if (bands_.empty()) {
+    Clear();
+    return false;
+  }
+  scale_ = cfg.band_scale;
+  bands_requested_ = cfg.num_bands;
+  octave_fraction_ = cfg.octave_fraction;
+  min_hz_ = cfg.min_hz;
+  max_hz_ = cfg.max_hz;
+  window_size_ = cfg.window_size;
+  sample_rate_ = sample_rate;
+  return true;
+}
+
+bool BandMapper::Apply(const float* bins, size_t bin_count, float* out_bands,
+                       size_t out_capacity) const {
+  if (!configured() || bins == nullptr || out_bands == nullptr ||
+      bin_count < static_cast<size_t>(num_bins_) || out_capacity < bands_.size()) {
+    return false;
+  }
+  for (size_t b = 0; b < bands_.size(); ++b) {
+    const Band& band = bands_[b];
+    const float* src = bins + band.first_bin;
+    const float* w = weights_.data() + band.weight_offset;
+    float sum = 0.0f;
+    for (uint32_t i = 0; i < band.count; ++i) {
+      sum += src[i] * w[i];
+    }
+    out_bands[b] = sum;
+  }
+  return true;
+}
+
+bool MapSpectrumFrame(const SpectrumConfig& cfg, BandMapper* mapper, std::vector<float>* scratch,
+                      SpectrumFrame* frame) {
+  if (cfg.band_scale == BandScale::kNone) {
+    return true;
+  }
+  if (mapper == nullptr || scratch == nullptr || frame == nullptr || frame->bins == nullptr) {
+    return false;
+  }
+  SpectrumConfig band_cfg = cfg;
+  band_cfg.window_size = frame->window_size;
+  if (!mapper->Configure(band_cfg, frame->sample_rate)) {
+    return false;
+  }
+  const size_t bands = static_cast<size_t>(mapper->num_bands());
+  if (scratch->size() < bands) {
+    scratch->resize(bands);
+  }
+  if (!mapper->Apply(frame->bins, static_cast<size_t>(frame->num_bins), scratch->data(), bands)) {
+    return false;
+  }
+  frame->bins = scratch->data();
+  frame->num_bins = static_cast<int>(bands);
+  frame->band_scale = cfg.band_scale;
+  frame->band_hz = mapper->center_hz();
+  return true;
+}
+
+}  // namespace sw
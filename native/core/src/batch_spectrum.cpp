@@ -0,0 +1,206 @@
+#include "fft_spectrum.h"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(SW_KISSFFT_SIMD4)
+#include <xmmintrin.h>
+
+#include "kiss_fft_simd4.h"
+#endif
+
+namespace sw {
+
+#if defined(SW_KISSFFT_SIMD4)
+
+namespace {
+
+constexpr int kLanes = 4;
+
+// 4 路 (re, im) → 幅度/功率，每个 lane 对应一路流。
+inline __m128 LaneSpectrum(const kiss_fft_cpx& c, bool power_spectrum, __m128 scale) {
+  const __m128 mag2 = _mm_add_ps(_mm_mul_ps(c.r, c.r), _mm_mul_ps(c.i, c.i));
+  return _mm_mul_ps(power_spectrum ? mag2 : _mm_sqrt_ps(mag2), scale);
+}
+
+}  // namespace
+
+struct BatchSpectrumAnalyzer::Impl {
+  SpectrumConfig cfg;
+  kiss_fftr_cfg plan = nullptr;
+  int planned_size = 0;
+  WindowType planned_window = WindowType::kHann;
+  std::vector<float> window;
+  float inv_window_sum = 0.0f;
+  // 时域输入：按 __m128 视图第 n 个元素 = 4 路流的第 n 个加窗样本。以 N/2 个复数存放（kiss_fftr
+  // 内部同样把实数输入当作复数对读取），避开 std::vector<__m128> 丢失对齐属性的问题。
+  std::vector<kiss_fft_cpx> packed;
+  std::vector<kiss_fft_cpx> freq;
+
+  ~Impl() { ReleasePlan(); }
+
+  void ReleasePlan() {
+    if (plan) {
+      kiss_fftr_free(plan);
+      plan = nullptr;
+    }
+    planned_size = 0;
+  }
+
+  bool Configure(const SpectrumConfig& new_cfg) {
+    cfg = new_cfg;
+    const int N = cfg.window_size;
+    if (N <= 0 || N % 2 != 0) {
+      ReleasePlan();
+      return false;
+    }
+    if (plan && planned_size == N && planned_window == cfg.window) {
+      return true;
+    }
+    if (!plan || planned_size != N) {
+      ReleasePlan();
+      plan = kiss_fftr_alloc(N, 0, nullptr, nullptr);
+      if (!plan) return false;
+      packed.assign(static_cast<size_t>(N / 2), kiss_fft_cpx{});
+      freq.assign(static_cast<size_t>(N / 2 + 1), kiss_fft_cpx{});
+    }
+    window.resize(static_cast<size_t>(N));
+    const float window_sum = FillWindow(cfg.window, N, window.data());
+    if (window_sum <= 0.0f) {
+      ReleasePlan();
+      return false;
+    }
+    inv_window_sum = 1.0f / window_sum;
+    planned_size = N;
+    planned_window = cfg.window;
+    return true;
+  }
+
+  bool configured() const { return plan != nullptr; }
+
+  // 一组最多 4 路：4×4 转置打包 → 一次 SIMD FFT → 4×4 转置写回各路输出。
+  void ComputeGroup(const float* const* samples, int used, float* const* out_bins) {
+    const size_t N = static_cast<size_t>(planned_size);
+    const size_t bins = N / 2 + 1;
+    // 未使用的 lane 复用第 0 路输入，结果丢弃。
+    const float* s0 = samples[0];
+    const float* s1 = used > 1 ? samples[1] : s0;
+    const float* s2 = used > 2 ? samples[2] : s0;
+    const float* s3 = used > 3 ? samples[3] : s0;
+    __m128* time = reinterpret_cast<__m128*>(packed.data());
+
+    size_t n = 0;
+    for (; n + 4 <= N; n += 4) {
+      __m128 r0 = _mm_loadu_ps(s0 + n);
+      __m128 r1 = _mm_loadu_ps(s1 + n);
+      __m128 r2 = _mm_loadu_ps(s2 + n);
+      __m128 r3 = _mm_loadu_ps(s3 + n);
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+      time[n] = _mm_mul_ps(r0, _mm_set1_ps(window[n]));
+      time[n + 1] = _mm_mul_ps(r1, _mm_set1_ps(window[n + 1]));
+      time[n + 2] = _mm_mul_ps(r2, _mm_set1_ps(window[n + 2]));
+      time[n + 3] = _mm_mul_ps(r3, _mm_set1_ps(window[n + 3]));
+    }
+    for (; n < N; ++n) {
+      time[n] = _mm_mul_ps(_mm_setr_ps(s0[n], s1[n], s2[n], s3[n]), _mm_set1_ps(window[n]));
+    }
+
+    kiss_fftr(plan, time, freq.data());
+
+    const __m128 scale = _mm_set1_ps(cfg.power_spectrum ? inv_window_sum * inv_window_sum
+                                                        : inv_window_sum);
+    const bool power = cfg.power_spectrum;
+    size_t k = 0;
+    for (; k + 4 <= bins; k += 4) {
+      __m128 b0 = LaneSpectrum(freq[k], power, scale);
+      __m128 b1 = LaneSpectrum(freq[k + 1], power, scale);
+      __m128 b2 = LaneSpectrum(freq[k + 2], power, scale);
+      __m128 b3 = LaneSpectrum(freq[k + 3], power, scale);
+      _MM_TRANSPOSE4_PS(b0, b1, b2, b3);  // 转置后 b_l = 第 l 路流的 bin k..k+3
+      const __m128 rows[kLanes] = {b0, b1, b2, b3};
+      for (int l = 0; l < used; ++l) {
+        _mm_storeu_ps(out_bins[l] + k, rows[l]);
+      }
+    }
+    for (; k < bins; ++k) {
+      alignas(16) float lane[kLanes];
+      _mm_store_ps(lane, LaneSpectrum(freq[k], power, scale));
+      for (int l = 0; l < used; ++l) {
+        out_bins[l][k] = lane[l];
+      }
+    }
+  }
+};
+
+int BatchSpectrumAnalyzer::lanes() { return kLanes; }
+
+#else  // !SW_KISSFFT_SIMD4
+
+// 无 SIMD kissfft 构建时逐路复用单路分析器，接口与结果保持一致。
+struct BatchSpectrumAnalyzer::Impl {
+  SpectrumConfig cfg;
+  SpectrumAnalyzer analyzer;
+
+  bool Configure(const SpectrumConfig& new_cfg) {
+    cfg = new_cfg;
+    if (cfg.window_size <= 0 || cfg.window_size % 2 != 0) {
+      analyzer.Configure(SpectrumConfig{0});
+      return false;
+    }
+    return analyzer.Configure(cfg);
+  }
+
+  bool configured() const { return analyzer.num_bins() > 0; }
+
+  void ComputeGroup(const float* const* samples, int used, float* const* out_bins) {
+    const size_t N = static_cast<size_t>(cfg.window_size);
+    for (int l = 0; l < used; ++l) {
+      analyzer.Compute(samples[l], N, out_bins[l], N / 2 + 1);
+    }
+  }
+};
+
+int BatchSpectrumAnalyzer::lanes() { return 1; }
+
+#endif  // SW_KISSFFT_SIMD4
+
+BatchSpectrumAnalyzer::BatchSpectrumAnalyzer() : impl_(std::make_unique<Impl>()) {}
+
+BatchSpectrumAnalyzer::BatchSpectrumAnalyzer(const SpectrumConfig& cfg)
+    : BatchSpectrumAnalyzer() {
+  Configure(cfg);
+}
+
+BatchSpectrumAnalyzer::~BatchSpectrumAnalyzer() = default;
+
+BatchSpectrumAnalyzer::BatchSpectrumAnalyzer(BatchSpectrumAnalyzer&& other) noexcept = default;
+BatchSpectrumAnalyzer& BatchSpectrumAnalyzer::operator=(BatchSpectrumAnalyzer&& other) noexcept =
+    default;
+
+bool BatchSpectrumAnalyzer::Configure(const SpectrumConfig& cfg) { return impl_->Configure(cfg); }
+
+const SpectrumConfig& BatchSpectrumAnalyzer::config() const { return impl_->cfg; }
+
+int BatchSpectrumAnalyzer::num_bins() const {
+  return impl_->configured() ? impl_->cfg.window_size / 2 + 1 : 0;
+}
+
+bool BatchSpectrumAnalyzer::Compute(const float* const* samples, size_t count, int num_streams,
+                                    float* const* out_bins, size_t out_capacity) {
+  Impl& s = *impl_;
+  const int N = s.cfg.window_size;
+  if (!s.configured() || samples == nullptr || out_bins == nullptr || num_streams <= 0 ||
+      count < static_cast<size_t>(N) || out_capacity < static_cast<size_t>(N / 2 + 1)) {
+    return false;
+  }
+  for (int i = 0; i < num_streams; ++i) {
+    if (samples[i] == nullptr || out_bins[i] == nullptr) return false;
+  }
+  const int group = lanes();
+  for (int base = 0; base < num_streams; base += group) {
+    s.ComputeGroup(samples + base, std::min(group, num_streams - base), out_bins + base);
+  }
+  return true;
+}
+
+}  // namespace sw
@@ -0,0 +1,328 @@
+#include "decode_prefetcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "spsc_queue.h"
+
+namespace sw {
+
+namespace {
+
+// 单次阻塞等待的上限；Seek/Stop 及水位变化都会提前唤醒，这里只是兜底。
+constexpr auto kMaxIdleWait = std::chrono::milliseconds(100);
+constexpr uint64_t kNoEnd = std::numeric_limits<uint64_t>::max();
+
+int64_t MsToFrames(int64_t ms, int sample_rate) { return ms * sample_rate / 1000; }
+
+}  // namespace
+
+struct DecodePrefetcher::Impl {
+  struct Block {
+    PcmBuffer pcm;
+    int64_t frames = 0;
+    uint64_t generation = 0;
+  };
+
+  DecodePrefetcherConfig cfg;
+  bool valid = false;
+  int64_t high_frames = 0;
+  int64_t low_frames = 0;
+
+  // 已解码块：预解码线程 → 消费者；空块：消费者 → 预解码线程。块总数固定，两个队列都不会满。
+  SpscQueue<Block> filled;
+  SpscQueue<Block> free_blocks;
+
+  Decoder* decoder = nullptr;
+  std::thread thread;
+  std::atomic<bool> running{false};
+
+  // Seek 请求：generation 每次 Seek 递增，旧代的块由消费者丢弃。帧位置与代号在锁内成对更新。
+  std::mutex seek_mutex;
+  int64_t pending_seek = -1;
+  std::atomic<uint64_t> generation{0};
+  // 预解码线程在 generation 代的最后一块之后写入结尾状态。
+  std::atomic<uint64_t> end_generation{kNoEnd};
+  std::atomic<Status> end_status{Status::kOk};
+
+  std::atomic<int64_t> buffered{0};
+  std::atomic<uint64_t> blocks_decoded{0};
+  std::atomic<uint64_t> refills{0};
+  std::atomic<uint64_t> underruns{0};
+
+  // 两端仅在对方可能睡眠时才加锁通知，热路径保持无锁。
+  std::mutex wait_mutex;
+  std::condition_variable producer_cv;
+  std::condition_variable consumer_cv;
+  std::atomic<bool> producer_waiting{false};
+  std::atomic<bool> consumer_waiting{false};
+
+  // 仅预解码线程访问（Start/Stop 之间由 join 建立先后关系）。
+  Block spare;
+  bool have_spare = false;
+  uint64_t producer_generation = 0;
+  bool at_end = false;
+  bool filling = true;
+
+  // 仅消费线程访问。
+  uint64_t consumer_generation = 0;
+  bool primed = false;  // 当前代已取到过数据：此后取空才算欠载。
+
+  Impl(const DecodePrefetcherConfig& config, size_t num_blocks)
+      : cfg(config), filled(num_blocks), free_blocks(num_blocks) {}
+
+  void NotifyProducer() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (producer_waiting.load()) {
+      std::lock_guard<std::mutex> lock(wait_mutex);
+      producer_cv.notify_one();
+    }
+  }
+
+  void NotifyConsumer() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumer_waiting.load()) {
+      std::lock_guard<std::mutex> lock(wait_mutex);
+      consumer_cv.notify_one();
+    }
+  }
+
+  bool ProducerReady() const {
+    if (!running.load() || generation.load() != producer_generation) return true;
+    if (at_end) return false;
+    return filling ? !free_blocks.empty() : buffered.load() <= low_frames;
+  }
+
+  bool ConsumerReady() const {
+    return !running.load() || !filled.empty() ||
+           end_generation.load(std::memory_order_acquire) == generation.load();
+  }
+
+  void ApplySeek() {
+    int64_t frame = -1;
+    {
+      std::lock_guard<std::mutex> lock(seek_mutex);
+      producer_generation = generation.load();
+      frame = pending_seek;
+      pending_seek = -1;
+    }
+    at_end = false;
+    filling = true;
+    if (frame >= 0 && !decoder->Seek(frame)) {
+      Finish(decoder->last_status());
+    }
+  }
+
+  void Finish(Status status) {
+    at_end = true;
+    end_status.store(status);
+    end_generation.store(producer_generation, std::memory_order_release);
+    NotifyConsumer();
+  }
+
+  void Run() {
+    while (running.load()) {
+      if (generation.load(std::memory_order_acquire) != producer_generation) {
+        ApplySeek();
+        continue;
+      }
+      if (!at_end && !filling && buffered.load() <= low_frames) {
+        filling = true;
+        refills.fetch_add(1, std::memory_order_relaxed);
+      }
+      if (filling && !have_spare) {
+        have_spare = free_blocks.TryPop(spare);
+      }
+      if (at_end || !filling || !have_spare) {
+        producer_waiting.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        producer_cv.wait_for(lock, kMaxIdleWait, [this] { return ProducerReady(); });
+        producer_waiting.store(false);
+        continue;
+      }
+
+      if (!decoder->Read(spare.pcm)) {
+        Finish(decoder->last_status());
+        continue;
+      }
+      const int channels = spare.pcm.channels > 0 ? spare.pcm.channels : cfg.channels;
+      spare.frames = static_cast<int64_t>(spare.pcm.interleaved.size()) / channels;
+      if (spare.frames == 0) continue;
+      spare.generation = producer_generation;
+      blocks_decoded.fetch_add(1, std::memory_order_relaxed);
+      const int64_t now_buffered = buffered.fetch_add(spare.frames) + spare.frames;
+      filled.TryPush(std::move(spare));
+      have_spare = false;
+      if (now_buffered >= high_frames) {
+        filling = false;
+      }
+      NotifyConsumer();
+    }
+  }
+};
+
+DecodePrefetcher::DecodePrefetcher(const DecodePrefetcherConfig& config) {
+  const bool valid = config.sample_rate > 0 && config.channels > 0 && config.read_ahead_ms > 0 &&
+                     config.refill_ms >= 0 && config.refill_ms <= config.read_ahead_ms &&
+                     config.block_frames_hint > 0;
+  int64_t high = 0;
+  size_t num_blocks = 2;
+  if (valid) {
+    high = std::max<int64_t>(MsToFrames(config.read_ahead_ms, config.sample_rate), 1);
+    // 窗口内的块数再加两块：一块在预解码线程手中，一块在消费者手中。
+    num_blocks = static_cast<size_t>((high + config.block_frames_hint - 1) /
+                                     config.block_frames_hint) + 2;
+  }
+  impl_ = std::make_unique<Impl>(config, num_blocks);
+  Impl& s = *impl_;
+  s.valid = valid;
+  s.high_frames = high;
+  s.low_frames = valid ? MsToFrames(config.refill_ms > 0 ? config.refill_ms
+                                                         : config.read_ahead_ms / 2,
+                                    config.sample_rate)
+                       : 0;
+  const size_t samples_hint = valid ? static_cast<size_t>(config.block_frames_hint) *
+                                          static_cast<size_t>(config.channels)
+                                    : 0;
+  for (size_t i = 0; i < num_blocks; ++i) {
+    Impl::Block block;
+    block.pcm.interleaved.reserve(samples_hint);
+    s.free_blocks.TryPush(std::move(block));
+  }
+}
+
+DecodePrefetcher::~DecodePrefetcher() { Stop(); }
+
+bool DecodePrefetcher::Start(Decoder* decoder) {
+  Impl& s = *impl_;
+  if (!s.valid || decoder == nullptr || s.running.load()) return false;
+  s.decoder = decoder;
+  s.running.store(true);
+  s.thread = std::thread([&s] { s.Run(); });
+  return true;
+}
+
+void DecodePrefetcher::Stop() {
+  Impl& s = *impl_;
+  s.running.store(false);
+  {
+    std::lock_guard<std::mutex> lock(s.wait_mutex);
+    s.producer_cv.notify_all();
+    s.consumer_cv.notify_all();
+  }
+  if (s.thread.joinable()) {
+    s.thread.join();
+  }
+}
+
+bool DecodePrefetcher::running() const { return impl_->running.load(); }
+
+void DecodePrefetcher::Seek(int64_t frame) {
+  Impl& s = *impl_;
+  {
+    std::lock_guard<std::mutex> lock(s.seek_mutex);
+    s.pending_seek = std::max<int64_t>(frame, 0);
+    s.generation.fetch_add(1);
+  }
+  std::lock_guard<std::mutex> lock(s.wait_mutex);
+  s.producer_cv.notify_one();
+}
+
+void DecodePrefetcher::Reset() {
+  Impl& s = *impl_;
+  Impl::Block block;
+  while (s.filled.TryPop(block)) {
+    s.free_blocks.TryPush(std::move(block));
+  }
+  std::lock_guard<std::mutex> lock(s.seek_mutex);
+  s.pending_seek = -1;
+  s.producer_generation = s.generation.load();
+  s.consumer_generation = s.producer_generation;
+  s.end_generation.store(kNoEnd);
+  s.end_status.store(Status::kOk);
+  s.buffered.store(0);
+  s.at_end = false;
+  s.filling = true;
+  s.primed = false;
+}
+
+PrefetchResult DecodePrefetcher::Pop(PcmBuffer* out, Status* status) {
+  Impl& s = *impl_;
+  for (;;) {
+    const uint64_t generation = s.generation.load(std::memory_order_acquire);
+    if (generation != s.consumer_generation) {
+      s.consumer_generation = generation;
+      s.primed = false;
+    }
+    // 先读结尾标记再尝试出队：标记写入前的块必然已可见，队列为空即确实到了结尾。
+    const bool ended = s.end_generation.load(std::memory_order_acquire) == generation;
+    Impl::Block block;
+    if (!s.filled.TryPop(block)) {
+      if (ended) {
+        *status = s.end_status.load();
+        return PrefetchResult::kEnd;
+      }
+      if (s.primed) {
+        s.underruns.fetch_add(1, std::memory_order_relaxed);
+        s.primed = false;
+      }
+      return PrefetchResult::kEmpty;
+    }
+    const int64_t remaining = s.buffered.fetch_sub(block.frames) - block.frames;
+    const bool current = block.generation == generation;
+    if (current) {
+      std::swap(out->interleaved, block.pcm.interleaved);
+      out->sample_rate = block.pcm.sample_rate;
+      out->channels = block.pcm.channels;
+    }
+    s.free_blocks.TryPush(std::move(block));
+    if (remaining <= s.low_frames || s.free_blocks.size() == 1) {
+      s.NotifyProducer();
+    }
+    if (current) {
+      s.primed = true;
+      return PrefetchResult::kBlock;
+    }
+  }
+}
+
+bool DecodePrefetcher::WaitForData(std::chrono::nanoseconds timeout) {
+  Impl& s = *impl_;
+  if (!s.filled.empty()) return true;
+  s.consumer_waiting.store(true);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  bool ready;
+  {
+    std::unique_lock<std::mutex> lock(s.wait_mutex);
+    ready = s.consumer_cv.wait_for(lock, timeout, [&s] { return s.ConsumerReady(); });
+  }
+  s.consumer_waiting.store(false);
+  return ready && (!s.filled.empty() ||
+                   s.end_generation.load(std::memory_order_acquire) == s.generation.load());
+}
+
+int64_t DecodePrefetcher::buffered_frames() const {
+  return std::max<int64_t>(impl_->buffered.load(), 0);
+}
+
+int64_t DecodePrefetcher::buffered_ms() const {
+  return impl_->cfg.sample_rate > 0 ? buffered_frames() * 1000 / impl_->cfg.sample_rate : 0;
+}
+
+DecodePrefetchStats DecodePrefetcher::stats() const {
+  const Impl& s = *impl_;
+  DecodePrefetchStats out;
+  out.buffered_frames = buffered_frames();
+  out.blocks_decoded = s.blocks_decoded.load(std::memory_order_relaxed);
+  out.refills = s.refills.load(std::memory_order_relaxed);
+  out.underruns = s.underruns.load(std::memory_order_relaxed);
+  return out;
+}
+
+}  // namespace sw
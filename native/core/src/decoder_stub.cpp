@@ -39,6 +39,18 @@ class DecoderStub : public Decoder {
     last_status_ = Status::kOk;
     return false;  // EOF immediately.
   }
+  bool Seek(int64_t frame) override {
+    if (!opened_) {
+      last_status_ = Status::kInvalidState;
+      return false;
+    }
+    if (frame < 0) {
+      last_status_ = Status::kInvalidArguments;
+      return false;
+    }
+    last_status_ = Status::kOk;
+    return true;  // 无内容可定位。
+  }
   void Close() override {
     opened_ = false;
     source_.clear();
@@ -0,0 +1,94 @@
+#include "decoder_util.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <system_error>
+
+#include "decoder.h"
+#include "flac_decoder.h"
+#include "pcm_file_decoder.h"
+#include "simd_kernels.h"
+
+namespace sw {
+
+std::string PathFromSource(const std::string& source) {
+  constexpr char kFileScheme[] = "file://";
+  if (source.compare(0, sizeof(kFileScheme) - 1, kFileScheme) == 0) {
+    return source.substr(sizeof(kFileScheme) - 1);
+  }
+  return source;
+}
+
+std::string LowerExtension(const std::string& path) {
+  const auto dot = path.find_last_of('.');
+  const auto slash = path.find_last_of('/');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return "";
+  std::string ext = path.substr(dot + 1);
+  std::transform(ext.begin(), ext.end(), ext.begin(),
+                 [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return ext;
+}
+
+void RemapChannels(const float* in, size_t frames, int src_channels, int dst_channels,
+                   float* out) {
+  const size_t src = static_cast<size_t>(src_channels);
+  const size_t dst = static_cast<size_t>(dst_channels);
+  if (dst == 1) {
+    ActiveSimdKernels().downmix(in, frames, src_channels, 1.0f / static_cast<float>(src), out);
+    return;
+  }
+  const size_t common = std::min(src, dst);
+  for (size_t f = 0; f < frames; ++f) {
+    const float* frame = in + f * src;
+    float* o = out + f * dst;
+    if (src == 1) {
+      std::fill(o, o + dst, frame[0]);
+      continue;
+    }
+    std::copy(frame, frame + common, o);
+    std::fill(o + common, o + dst, 0.0f);
+  }
+}
+
+bool ResampleStage::Configure(int source_rate, int target_rate, int channels,
+                              ResamplerQuality quality) {
+  active_ = false;
+  flushed_ = false;
+  source_rate_ = source_rate;
+  target_rate_ = target_rate > 0 ? target_rate : source_rate;
+  channels_ = channels;
+  if (target_rate_ == source_rate_) return true;
+  ResamplerConfig config;
+  config.input_rate = source_rate;
+  config.output_rate = target_rate_;
+  config.channels = channels;
+  config.quality = quality;
+  if (!resampler_.Configure(config)) return false;
+  active_ = true;
+  return true;
+}
+
+void ResampleStage::Reset() {
+  flushed_ = false;
+  resampler_.Reset();
+}
+
+int64_t ResampleStage::ToSourceFrame(int64_t frame) const {
+  if (!active_) return frame;
+  return frame * source_rate_ / target_rate_;
+}
+
+std::unique_ptr<Decoder> CreateDecoderForSource(const std::string& source) {
+  const std::string path = PathFromSource(source);
+  const std::string ext = LowerExtension(path);
+  const bool pcm = ext == "wav" || ext == "wave" || ext == "pcm" || ext == "raw";
+  std::error_code ec;
+  if ((pcm || ext == "flac") && std::filesystem::is_regular_file(path, ec)) {
+    if (pcm) return std::make_unique<PcmFileDecoder>();
+    return std::make_unique<FlacDecoder>();
+  }
+  return CreateStubDecoder();
+}
+
+}  // namespace sw
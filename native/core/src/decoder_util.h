@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "audio_engine.h"  // for Status
+#include "resampler.h"
+
+namespace sw {
+
+// 解码器共用的小工具（库内部使用）。
+
+// 去掉 file:// 前缀，得到本地路径。
+std::string PathFromSource(const std::string& source);
+
+// 路径最后一段的扩展名（小写，不含点）；没有扩展名时返回空串。
+std::string LowerExtension(const std::string& path);
+
+// 交错 float 的声道数换算：目标为单声道时 downmix，源为单声道时复制到各声道，其余取前
+// min(源, 目标) 个声道、多出的补零。in 与 out 不能重叠。
+void RemapChannels(const float* in, size_t frames, int src_channels, int dst_channels,
+                   float* out);
+
+// 解码器输出端的重采样级（PcmFileDecoder/FlacDecoder 共用）。源与目标采样率不同时把源块送进
+// Resampler，源读尽后 Flush 出尾部；相同时 active() 为 false，调用方直接输出源块。
+class ResampleStage {
+ public:
+  // target_rate 为 0 或等于 source_rate 时为直通。比例超出 sinc 模式支持范围时返回 false。
+  bool Configure(int source_rate, int target_rate, int channels, ResamplerQuality quality);
+  bool active() const { return active_; }
+  // 丢弃滤波器历史与尾部状态（Seek 后调用）。
+  void Reset();
+  // 输出帧号对应的源帧号（向下取整）。
+  int64_t ToSourceFrame(int64_t frame) const;
+
+  // read_source(std::vector<float>* block) 读一块源 PCM（交错、已换算到输出声道数）：返回
+  // kOk 且 block 非空为数据，kOk 且为空为 EOF，其余为错误。本函数按同样的约定把重采样后的块
+  // 写入 *out；源块不足以产出输出时会继续读。
+  template <typename ReadSource>
+  Status Read(ReadSource&& read_source, std::vector<float>* out) {
+    while (!flushed_) {
+      const Status status = read_source(&source_);
+      if (status != Status::kOk) {
+        out->clear();
+        return status;
+      }
+      if (source_.empty()) {
+        flushed_ = true;
+        resampler_.Flush(out);
+      } else {
+        resampler_.Process(source_.data(), source_.size() / static_cast<size_t>(channels_), out);
+      }
+      if (!out->empty()) return Status::kOk;
+    }
+    out->clear();
+    return Status::kOk;
+  }
+
+ private:
+  Resampler resampler_;
+  std::vector<float> source_;
+  bool active_ = false;
+  bool flushed_ = false;
+  int source_rate_ = 0;
+  int target_rate_ = 0;
+  int channels_ = 0;
+};
+
+}  // namespace sw
@@ -1,15 +1,28 @@
 #include "fft_spectrum.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
 #include <vector>
 
+#include "band_mapper.h"
 #include "kiss_fftr.h"
+#include "simd_kernels.h"
 
 namespace sw {
 namespace {
 
 constexpr float kPi = 3.14159265358979323846f;
+static_assert(sizeof(kiss_fft_cpx) == 2 * sizeof(float),
+              "SIMD kernels read kiss_fft_cpx as interleaved float pairs");
+// 每线程缓存的计划数量（不同窗长/窗型交替使用时避免反复重建）。
+constexpr size_t kThreadPlanCacheSize = 4;
+// 频谱图并行时每个线程至少处理的帧数，避免派发开销超过计算量。
+constexpr int kMinSpectrogramFramesPerThread = 16;
 
 inline float Hann(int n, int N) {
   return 0.5f * (1.0f - std::cos(2.0f * kPi * n / static_cast<float>(N - 1)));
@@ -19,78 +32,509 @@ inline float Hamming(int n, int N) {
   return 0.54f - 0.46f * std::cos(2.0f * kPi * n / static_cast<float>(N - 1));
 }
 
+inline float WindowValue(WindowType type, int n, int N) {
+  switch (type) {
+    case WindowType::kHann:
+      return Hann(n, N);
+    case WindowType::kHamming:
+      return Hamming(n, N);
+    default:
+      return 1.0f;
+  }
+}
+
+// 复数谱 → 幅度/功率谱（按窗系数和归一）。
+inline void SpectrumFromComplex(const SimdKernels& simd, const kiss_fft_cpx* freq, size_t bins,
+                                bool power_spectrum, float inv_window_sum, float* out) {
+  const float* complex = reinterpret_cast<const float*>(freq);
+  if (power_spectrum) {
+    simd.power(complex, bins, inv_window_sum * inv_window_sum, out);
+  } else {
+    simd.magnitude(complex, bins, inv_window_sum, out);
+  }
+}
+
 }  // namespace
 
+float FillWindow(WindowType type, int size, float* out) {
+  if (size <= 0 || out == nullptr) return 0.0f;
+  float sum = 0.0f;
+  for (int i = 0; i < size; ++i) {
+    out[i] = WindowValue(type, i, size);
+    sum += out[i];
+  }
+  return sum;
+}
+
+struct SpectrumAnalyzer::Impl {
+  SpectrumConfig cfg;
+  kiss_fftr_cfg plan = nullptr;
+  int planned_size = 0;
+  WindowType planned_window = WindowType::kHann;
+  std::vector<float> window;
+  float inv_window_sum = 0.0f;
+  std::vector<float> windowed;
+  std::vector<kiss_fft_cpx> freq;
+
+  ~Impl() { ReleasePlan(); }
+
+  void ReleasePlan() {
+    if (plan) {
+      kiss_fftr_free(plan);
+      plan = nullptr;
+    }
+    planned_size = 0;
+  }
+};
+
+SpectrumAnalyzer::SpectrumAnalyzer() : impl_(std::make_unique<Impl>()) {}
+
+SpectrumAnalyzer::SpectrumAnalyzer(const SpectrumConfig& cfg) : SpectrumAnalyzer() {
+  Configure(cfg);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() = default;
+
+SpectrumAnalyzer::SpectrumAnalyzer(SpectrumAnalyzer&& other) noexcept = default;
+SpectrumAnalyzer& SpectrumAnalyzer::operator=(SpectrumAnalyzer&& other) noexcept = default;
+
+bool SpectrumAnalyzer::Configure(const SpectrumConfig& cfg) {
+  Impl& s = *impl_;
+  s.cfg = cfg;
+  const int N = cfg.window_size;
+  if (N <= 0) {
+    s.ReleasePlan();
+    return false;
+  }
+  if (s.plan && s.planned_size == N && s.planned_window == cfg.window) {
+    return true;
+  }
+  if (!s.plan || s.planned_size != N) {
+    s.ReleasePlan();
+    s.plan = kiss_fftr_alloc(N, 0, nullptr, nullptr);
+    if (!s.plan) {
+      return false;
+    }
+    s.windowed.assign(static_cast<size_t>(N), 0.0f);
+    s.freq.assign(static_cast<size_t>(N / 2 + 1), kiss_fft_cpx{});
+  }
+  s.window.resize(static_cast<size_t>(N));
+  const float window_sum = FillWindow(cfg.window, N, s.window.data());
+  if (window_sum <= 0.0f) {
+    s.ReleasePlan();
+    return false;
+  }
+  s.inv_window_sum = 1.0f / window_sum;
+  s.planned_size = N;
+  s.planned_window = cfg.window;
+  return true;
+}
+
+const SpectrumConfig& SpectrumAnalyzer::config() const { return impl_->cfg; }
+
+int SpectrumAnalyzer::num_bins() const {
+  return impl_->plan ? impl_->planned_size / 2 + 1 : 0;
+}
+
+std::vector<float> SpectrumAnalyzer::Compute(const std::vector<float>& samples) {
+  std::vector<float> spectrum(static_cast<size_t>(num_bins()), 0.0f);
+  if (!Compute(samples.data(), samples.size(), spectrum.data(), spectrum.size())) {
+    return {};
+  }
+  return spectrum;
+}
+
+bool SpectrumAnalyzer::Compute(const float* samples, size_t count, float* out_bins,
+                               size_t out_capacity) {
+  Impl& s = *impl_;
+  const int N = s.planned_size;
+  if (!s.plan || samples == nullptr || out_bins == nullptr || count < static_cast<size_t>(N)) {
+    return false;
+  }
+  const size_t bins = static_cast<size_t>(N / 2 + 1);
+  if (out_capacity < bins) {
+    return false;
+  }
+  const SimdKernels& simd = ActiveSimdKernels();
+  simd.multiply(samples, s.window.data(), s.windowed.data(), static_cast<size_t>(N));
+  kiss_fftr(s.plan, s.windowed.data(), s.freq.data());
+  SpectrumFromComplex(simd, s.freq.data(), bins, s.cfg.power_spectrum, s.inv_window_sum,
+                      out_bins);
+  return true;
+}
+
 std::vector<float> DownmixToMono(const float* data, int num_frames, int num_channels,
                                  int window_size) {
   if (data == nullptr || num_frames <= 0 || num_channels <= 0) {
     return {};
   }
   const int window = window_size > 0 ? std::min(window_size, num_frames) : num_frames;
-  if (window <= 0) return {};
-
   std::vector<float> mono(static_cast<size_t>(window), 0.0f);
-  for (int i = 0; i < window; ++i) {
-    const int base = i * num_channels;
-    float sum = 0.0f;
-    for (int c = 0; c < num_channels; ++c) {
-      sum += data[static_cast<size_t>(base + c)];
+  DownmixToMono(data, num_frames, num_channels, window_size, mono.data(), window);
+  return mono;
+}
+
+int DownmixToMono(const float* data, int num_frames, int num_channels, int window_size,
+                  float* out, int out_capacity) {
+  if (data == nullptr || out == nullptr || num_frames <= 0 || num_channels <= 0) {
+    return 0;
+  }
+  int window = window_size > 0 ? std::min(window_size, num_frames) : num_frames;
+  window = std::min(window, out_capacity);
+  if (window <= 0) return 0;
+
+  ActiveSimdKernels().downmix(data, static_cast<size_t>(window), num_channels,
+                              1.0f / static_cast<float>(num_channels), out);
+  return window;
+}
+
+namespace {
+
+// 按 (window_size, window) 缓存计划；命中后移到队首，满时淘汰队尾。
+SpectrumAnalyzer* ThreadCachedAnalyzer(const SpectrumConfig& cfg) {
+  thread_local std::vector<SpectrumAnalyzer> cache;
+  const int N = cfg.window_size;
+  auto it = std::find_if(cache.begin(), cache.end(), [&](const SpectrumAnalyzer& a) {
+    return a.num_bins() > 0 && a.config().window_size == N && a.config().window == cfg.window;
+  });
+  if (it == cache.end()) {
+    SpectrumAnalyzer analyzer;
+    if (!analyzer.Configure(cfg)) {
+      return nullptr;
+    }
+    if (cache.empty()) {
+      cache.reserve(kThreadPlanCacheSize);
+    }
+    if (cache.size() >= kThreadPlanCacheSize) {
+      cache.pop_back();
     }
-    mono[static_cast<size_t>(i)] = sum / static_cast<float>(num_channels);
+    cache.insert(cache.begin(), std::move(analyzer));
+  } else if (it != cache.begin()) {
+    std::rotate(cache.begin(), it, it + 1);
   }
-  return mono;
+  SpectrumAnalyzer& analyzer = cache.front();
+  analyzer.Configure(cfg);  // 仅更新 power_spectrum 等非计划参数。
+  return &analyzer;
+}
+
+// 频带映射按线程缓存一份（配置不变时不重建权重），线性 bin 的中间结果也放在线程缓冲里。
+BandMapper* ThreadCachedBandMapper(const SpectrumConfig& cfg, int sample_rate) {
+  thread_local BandMapper mapper;
+  return mapper.Configure(cfg, sample_rate) ? &mapper : nullptr;
+}
+
+std::vector<float>& ThreadLinearBins() {
+  thread_local std::vector<float> bins;
+  return bins;
+}
+
+}  // namespace
+
+int SpectrumOutputSize(const SpectrumConfig& cfg, int sample_rate) {
+  if (cfg.window_size <= 0) return 0;
+  if (cfg.band_scale == BandScale::kNone) return cfg.window_size / 2 + 1;
+  const BandMapper* mapper = ThreadCachedBandMapper(cfg, sample_rate);
+  return mapper ? mapper->num_bands() : 0;
 }
 
 std::vector<float> ComputeSpectrum(const std::vector<float>& samples, int sample_rate,
                                    const SpectrumConfig& cfg) {
-  (void)sample_rate;
   const int N = cfg.window_size;
   if (N <= 0 || static_cast<int>(samples.size()) < N) {
     return {};
   }
+  std::vector<float> out(static_cast<size_t>(SpectrumOutputSize(cfg, sample_rate)));
+  if (out.empty() ||
+      !ComputeSpectrum(samples.data(), samples.size(), sample_rate, cfg, out.data(), out.size())) {
+    return {};
+  }
+  return out;
+}
 
-  std::vector<float> windowed(samples.begin(), samples.begin() + N);
-  float window_sum = 0.0f;
-  for (int i = 0; i < N; ++i) {
-    float w = 1.0f;
-    switch (cfg.window) {
-      case WindowType::kHann:
-        w = Hann(i, N);
-        break;
-      case WindowType::kHamming:
-        w = Hamming(i, N);
-        break;
-      default:
-        w = 1.0f;
-        break;
-    }
-    windowed[static_cast<size_t>(i)] *= w;
-    window_sum += w;
+bool ComputeSpectrum(const float* samples, size_t count, int sample_rate,
+                     const SpectrumConfig& cfg, float* out_bins, size_t out_capacity) {
+  const int N = cfg.window_size;
+  if (N <= 0 || samples == nullptr || count < static_cast<size_t>(N)) {
+    return false;
   }
-  if (window_sum <= 0.0f) {
-    return {};
+  SpectrumAnalyzer* analyzer = ThreadCachedAnalyzer(cfg);
+  if (!analyzer) {
+    return false;
+  }
+  if (cfg.band_scale == BandScale::kNone) {
+    return analyzer->Compute(samples, count, out_bins, out_capacity);
   }
-  const float inv_window_sum = 1.0f / window_sum;
+  const BandMapper* mapper = ThreadCachedBandMapper(cfg, sample_rate);
+  if (!mapper) {
+    return false;
+  }
+  std::vector<float>& bins = ThreadLinearBins();
+  const size_t num_bins = static_cast<size_t>(analyzer->num_bins());
+  if (bins.size() < num_bins) {
+    bins.resize(num_bins);
+  }
+  return analyzer->Compute(samples, count, bins.data(), num_bins) &&
+         mapper->Apply(bins.data(), num_bins, out_bins, out_capacity);
+}
 
-  std::vector<float> spectrum(static_cast<size_t>(N / 2 + 1), 0.0f);
-  kiss_fftr_cfg cfg_fft = kiss_fftr_alloc(N, 0, nullptr, nullptr);
-  if (!cfg_fft) {
-    return {};
+namespace {
+
+int EffectiveFftSize(const SpectrogramConfig& cfg) {
+  return cfg.fft_size > 0 ? cfg.fft_size : cfg.window_size;
+}
+
+bool ValidSpectrogramConfig(const SpectrogramConfig& cfg) {
+  const int fft_size = EffectiveFftSize(cfg);
+  return cfg.window_size > 0 && cfg.hop_size > 0 && fft_size >= cfg.window_size &&
+         fft_size % 2 == 0;
+}
+
+// 单线程的频谱图计算状态：计划、窗表与补零输入缓冲。每个线程缓存一份。
+class SpectrogramWorker {
+ public:
+  ~SpectrogramWorker() { Release(); }
+
+  bool Configure(const SpectrogramConfig& cfg) {
+    const int fft_size = EffectiveFftSize(cfg);
+    if (plan_ && window_size_ == cfg.window_size && fft_size_ == fft_size &&
+        window_ == cfg.window) {
+      return true;
+    }
+    Release();
+    plan_ = kiss_fftr_alloc(fft_size, 0, nullptr, nullptr);
+    if (!plan_) return false;
+    window_table_.resize(static_cast<size_t>(cfg.window_size));
+    const float window_sum = FillWindow(cfg.window, cfg.window_size, window_table_.data());
+    if (window_sum <= 0.0f) {
+      Release();
+      return false;
+    }
+    inv_window_sum_ = 1.0f / window_sum;
+    input_.assign(static_cast<size_t>(fft_size), 0.0f);  // [window_size, fft_size) 保持为 0。
+    freq_.assign(static_cast<size_t>(fft_size / 2 + 1), kiss_fft_cpx{});
+    window_size_ = cfg.window_size;
+    fft_size_ = fft_size;
+    window_ = cfg.window;
+    return true;
   }
-  std::vector<kiss_fft_cpx> freq(static_cast<size_t>(N / 2 + 1));
-  kiss_fftr(cfg_fft, windowed.data(), freq.data());
-  kiss_fftr_free(cfg_fft);
 
-  for (size_t k = 0; k < spectrum.size(); ++k) {
-    const float real = freq[k].r;
-    const float imag = freq[k].i;
-    const float mag2 = real * real + imag * imag;
-    spectrum[k] =
-        cfg.power_spectrum ? (mag2 * inv_window_sum * inv_window_sum)
-                           : (std::sqrt(mag2) * inv_window_sum);
+  // 计算 [first, last) 行。
+  void Run(const float* samples, int num_channels, const SpectrogramConfig& cfg, int first,
+           int last, float* out) {
+    const SimdKernels& simd = ActiveSimdKernels();
+    const size_t bins = static_cast<size_t>(fft_size_ / 2 + 1);
+    const size_t window = static_cast<size_t>(window_size_);
+    const float inv_channels = 1.0f / static_cast<float>(num_channels);
+    for (int row = first; row < last; ++row) {
+      const size_t start = static_cast<size_t>(row) * static_cast<size_t>(cfg.hop_size);
+      if (num_channels == 1) {
+        simd.multiply(samples + start, window_table_.data(), input_.data(), window);
+      } else {
+        simd.downmix(samples + start * static_cast<size_t>(num_channels), window, num_channels,
+                     inv_channels, input_.data());
+        simd.multiply(input_.data(), window_table_.data(), input_.data(), window);
+      }
+      kiss_fftr(plan_, input_.data(), freq_.data());
+      SpectrumFromComplex(simd, freq_.data(), bins, cfg.power_spectrum, inv_window_sum_,
+                          out + static_cast<size_t>(row) * bins);
+    }
   }
 
-  return spectrum;
+ private:
+  kiss_fftr_cfg plan_ = nullptr;
+  int window_size_ = 0;
+  int fft_size_ = 0;
+  WindowType window_ = WindowType::kHann;
+  std::vector<float> window_table_;
+  float inv_window_sum_ = 0.0f;
+  std::vector<float> input_;
+  std::vector<kiss_fft_cpx> freq_;
+
+  void Release() {
+    if (plan_) {
+      kiss_fftr_free(plan_);
+      plan_ = nullptr;
+    }
+    window_size_ = 0;
+    fft_size_ = 0;
+  }
+};
+
+SpectrogramWorker* ThreadCachedSpectrogramWorker(const SpectrogramConfig& cfg) {
+  thread_local SpectrogramWorker worker;
+  return worker.Configure(cfg) ? &worker : nullptr;
+}
+
+// 频谱图的进程级常驻线程池。线程按需创建后一直保留到进程退出，各自的 thread_local
+// SpectrogramWorker（计划、窗表、缓冲）因此跨调用复用，而不是每次调用随线程一起建了又拆。
+// 同一时刻只服务一个 ComputeSpectrogram：池被占用时其他调用方在自己的线程上算完全部块。
+class SpectrogramPool {
+ public:
+  using BlockFn = void (*)(void* ctx, int block);
+
+  static SpectrogramPool& Instance() {
+    static SpectrogramPool pool;
+    return pool;
+  }
+
+  ~SpectrogramPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+
+  // 用调用线程加至多 helpers 个池线程执行 blocks 个块，全部完成后返回。
+  void Run(int blocks, int helpers, BlockFn fn, void* ctx) {
+    std::unique_lock<std::mutex> run(run_mutex_, std::try_to_lock);
+    if (!run.owns_lock() || helpers <= 0 || Grow(helpers) == 0) {
+      for (int b = 0; b < blocks; ++b) fn(ctx, b);
+      return;
+    }
+    Job job{fn, ctx, blocks, {0}, 0};
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job.id = ++next_job_id_;
+      job_ = &job;
+    }
+    cv_.notify_all();
+    job.Drain();
+    // 领取过任务的池线程都在 active_ 里计数：归零即所有已领的块都已算完。
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return active_ == 0; });
+    job_ = nullptr;
+  }
+
+ private:
+  struct Job {
+    BlockFn fn;
+    void* ctx;
+    int blocks;
+    std::atomic<int> next;
+    uint64_t id;
+
+    void Drain() {
+      for (int b = next.fetch_add(1); b < blocks; b = next.fetch_add(1)) fn(ctx, b);
+    }
+  };
+
+  // 把池扩到至少 count 个线程；创建失败（std::system_error）时就用已有的线程。返回线程数。
+  size_t Grow(int count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    try {
+      while (threads_.size() < static_cast<size_t>(count)) {
+        threads_.emplace_back([this] { WorkerMain(); });
+      }
+    } catch (const std::system_error&) {
+    }
+    return threads_.size();
+  }
+
+  void WorkerMain() {
+    uint64_t seen = 0;
+    for (;;) {
+      Job* job = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return stop_ || (job_ != nullptr && job_->id != seen); });
+        if (stop_) return;
+        job = job_;
+        seen = job->id;
+        ++active_;
+      }
+      job->Drain();
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --active_;
+      }
+      done_cv_.notify_all();
+    }
+  }
+
+  std::mutex run_mutex_;  // 一次只跑一个任务
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable done_cv_;
+  std::vector<std::thread> threads_;
+  Job* job_ = nullptr;
+  uint64_t next_job_id_ = 0;
+  int active_ = 0;
+  bool stop_ = false;
+};
+
+}  // namespace
+
+int SpectrogramFrameCount(size_t num_frames, const SpectrogramConfig& cfg) {
+  if (!ValidSpectrogramConfig(cfg) || num_frames < static_cast<size_t>(cfg.window_size)) {
+    return 0;
+  }
+  return static_cast<int>((num_frames - static_cast<size_t>(cfg.window_size)) /
+                          static_cast<size_t>(cfg.hop_size)) +
+         1;
+}
+
+int SpectrogramBinCount(const SpectrogramConfig& cfg) {
+  return ValidSpectrogramConfig(cfg) ? EffectiveFftSize(cfg) / 2 + 1 : 0;
+}
+
+bool ComputeSpectrogram(const float* samples, size_t num_frames, int num_channels,
+                        const SpectrogramConfig& cfg, float* out, size_t out_capacity) {
+  if (samples == nullptr || out == nullptr || num_channels <= 0) {
+    return false;
+  }
+  const int rows = SpectrogramFrameCount(num_frames, cfg);
+  const int bins = SpectrogramBinCount(cfg);
+  if (rows <= 0 || bins <= 0 ||
+      out_capacity < static_cast<size_t>(rows) * static_cast<size_t>(bins)) {
+    return false;
+  }
+
+  int threads = cfg.num_threads > 0
+                    ? cfg.num_threads
+                    : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  threads = std::max(1, std::min(threads, (rows + kMinSpectrogramFramesPerThread - 1) /
+                                              kMinSpectrogramFramesPerThread));
+  const int rows_per_thread = (rows + threads - 1) / threads;
+
+  std::atomic<bool> ok{true};
+  auto run_block = [&](int block) {
+    const int first = block * rows_per_thread;
+    const int last = std::min(rows, first + rows_per_thread);
+    if (first >= last) return;
+    SpectrogramWorker* worker = ThreadCachedSpectrogramWorker(cfg);
+    if (worker == nullptr) {
+      ok.store(false);
+      return;
+    }
+    worker->Run(samples, num_channels, cfg, first, last, out);
+  };
+
+  if (threads == 1) {
+    run_block(0);
+  } else {
+    // 调用线程与常驻池线程一起领块；各线程复用自己缓存的计划。
+    SpectrogramPool::Instance().Run(
+        threads, threads - 1,
+        [](void* ctx, int block) { (*static_cast<decltype(run_block)*>(ctx))(block); },
+        &run_block);
+  }
+  return ok.load();
+}
+
+std::vector<float> ComputeSpectrogram(const float* samples, size_t num_frames, int num_channels,
+                                      const SpectrogramConfig& cfg) {
+  const size_t size = static_cast<size_t>(SpectrogramFrameCount(num_frames, cfg)) *
+                      static_cast<size_t>(SpectrogramBinCount(cfg));
+  if (size == 0) return {};
+  std::vector<float> out(size);
+  if (!ComputeSpectrogram(samples, num_frames, num_channels, cfg, out.data(), out.size())) {
+    return {};
+  }
+  return out;
 }
 
 }  // namespace sw
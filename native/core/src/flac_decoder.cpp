@@ -0,0 +1,818 @@
+#include "flac_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "decoder_util.h"
+#include "mapped_file.h"
+#include "simd_kernels.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace sw {
+
+namespace {
+
+constexpr int kMaxLpcOrder = 32;
+constexpr int kMinBitsPerSample = 4;
+constexpr int kMaxBitsPerSample = 24;  // side 声道 25 位，整条解码链都能留在 int32 内。
+constexpr size_t kStreamInfoSize = 34;
+constexpr size_t kMinFrameHeaderSize = 6;  // 同步码 2 + 参数 2 + 帧号 1 + CRC-8 1
+constexpr size_t kMinFrameStep = kMinFrameHeaderSize + 2;  // 帧头 + CRC-16 的最小帧长
+// 帧号跳跃时向后确认下一帧的扫描范围（远大于常见帧长，避免误判的帧头拖慢 Open）。
+constexpr size_t kResyncLookahead = size_t{1} << 20;
+
+int CountLeadingZeros64(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_clzll(v);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+  unsigned long index;
+  _BitScanReverse64(&index, v);
+  return 63 - static_cast<int>(index);
+#else
+  int n = 0;
+  for (uint64_t bit = uint64_t{1} << 63; (v & bit) == 0; bit >>= 1) ++n;
+  return n;
+#endif
+}
+
+// CRC-8（多项式 0x07，帧头）与 CRC-16（多项式 0x8005，整帧），均为 MSB 在前、初值 0。
+struct CrcTables {
+  uint8_t crc8[256];
+  uint16_t crc16[256];
+};
+
+const CrcTables& Crc() {
+  static const CrcTables tables = [] {
+    CrcTables t{};
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c8 = i;
+      uint32_t c16 = i << 8;
+      for (int bit = 0; bit < 8; ++bit) {
+        c8 = (c8 & 0x80) ? (c8 << 1) ^ 0x07 : c8 << 1;
+        c16 = (c16 & 0x8000) ? (c16 << 1) ^ 0x8005 : c16 << 1;
+      }
+      t.crc8[i] = static_cast<uint8_t>(c8);
+      t.crc16[i] = static_cast<uint16_t>(c16);
+    }
+    return t;
+  }();
+  return tables;
+}
+
+uint8_t Crc8(const uint8_t* p, size_t n) {
+  const CrcTables& t = Crc();
+  uint8_t crc = 0;
+  for (size_t i = 0; i < n; ++i) crc = t.crc8[crc ^ p[i]];
+  return crc;
+}
+
+uint16_t Crc16(const uint8_t* p, size_t n) {
+  const CrcTables& t = Crc();
+  uint16_t crc = 0;
+  for (size_t i = 0; i < n; ++i) {
+    crc = static_cast<uint16_t>((crc << 8) ^ t.crc16[(crc >> 8) ^ p[i]]);
+  }
+  return crc;
+}
+
+uint32_t ReadBe24(const uint8_t* p) {
+  return (uint32_t{p[0]} << 16) | (uint32_t{p[1]} << 8) | uint32_t{p[2]};
+}
+
+// MSB 优先的位读取器：64 位缓存左对齐，按 8 字节整块补充。缓存中有效位之后的低位要么为 0，
+// 要么就是后续字节的真实内容，所以补充时直接 OR 进去是幂等的。越界读返回 0 并置 overrun。
+class BitReader {
+ public:
+  BitReader(const uint8_t* data, size_t size) : begin_(data), p_(data), end_(data + size) {}
+
+  uint32_t Read(int bits) {
+    if (bits == 0) return 0;
+    if (bits_ < bits) {
+      Refill();
+      if (bits_ < bits) {
+        overrun_ = true;
+        return 0;
+      }
+    }
+    const uint32_t v = static_cast<uint32_t>(cache_ >> (64 - bits));
+    cache_ <<= bits;
+    bits_ -= bits;
+    return v;
+  }
+
+  int32_t ReadSigned(int bits) {
+    if (bits == 0) return 0;
+    const uint32_t v = Read(bits) << (32 - bits);
+    return static_cast<int32_t>(v) >> (32 - bits);
+  }
+
+  // 连续 0 的个数（消耗结尾的 1）。
+  uint32_t ReadUnary() {
+    uint32_t zeros = 0;
+    for (;;) {
+      if (bits_ == 0) {
+        Refill();
+        if (bits_ == 0) {
+          overrun_ = true;
+          return 0;
+        }
+      }
+      const int z = cache_ == 0 ? 64 : CountLeadingZeros64(cache_);
+      if (z < bits_) {
+        cache_ = (cache_ << z) << 1;
+        bits_ -= z + 1;
+        return zeros + static_cast<uint32_t>(z);
+      }
+      zeros += static_cast<uint32_t>(bits_);
+      cache_ = 0;
+      bits_ = 0;
+    }
+  }
+
+  void AlignToByte() {
+    const int drop = bits_ & 7;
+    cache_ <<= drop;
+    bits_ -= drop;
+  }
+
+  // 已消耗的字节数（须先 AlignToByte）。
+  size_t consumed_bytes() const {
+    return static_cast<size_t>(p_ - begin_) - static_cast<size_t>(bits_ / 8);
+  }
+  bool overrun() const { return overrun_; }
+
+ private:
+  void Refill() {
+    if (end_ - p_ >= 8) {
+      uint64_t w = 0;
+      for (int i = 0; i < 8; ++i) w = (w << 8) | p_[i];  // 编译为一次 load + bswap
+      cache_ |= bits_ == 64 ? 0 : w >> bits_;
+      const int take = (64 - bits_) >> 3;
+      p_ += take;
+      bits_ += take * 8;
+      return;
+    }
+    while (bits_ <= 56 && p_ < end_) {
+      cache_ |= uint64_t{*p_++} << (56 - bits_);
+      bits_ += 8;
+    }
+  }
+
+  const uint8_t* begin_;
+  const uint8_t* p_;
+  const uint8_t* end_;
+  uint64_t cache_ = 0;
+  int bits_ = 0;
+  bool overrun_ = false;
+};
+
+struct StreamInfo {
+  uint32_t min_block_size = 0;
+  uint32_t max_block_size = 0;
+  uint32_t min_frame_size = 0;  // 0 表示未知
+  uint32_t sample_rate = 0;
+  int channels = 0;
+  int bits_per_sample = 0;
+  uint64_t total_samples = 0;  // 0 表示未知
+};
+
+struct FrameHeader {
+  uint32_t block_size = 0;
+  uint32_t sample_rate = 0;
+  int channels = 0;
+  StereoDecorrelation decorrelation = StereoDecorrelation::kIndependent;
+  int bits_per_sample = 0;
+  uint64_t number = 0;  // 固定块长为帧号，可变块长为首样本号
+  bool variable_block_size = false;
+  size_t size = 0;  // 帧头字节数（含 CRC-8）
+};
+
+// 帧头里类 UTF-8 编码的帧号/样本号，最长 7 字节（36 位）。
+bool ReadCodedNumber(const uint8_t* p, size_t avail, uint64_t* value, size_t* length) {
+  if (avail == 0) return false;
+  const uint8_t first = p[0];
+  size_t len = 0;
+  uint64_t v = 0;
+  if (first < 0x80) {
+    len = 1;
+    v = first;
+  } else if ((first & 0xE0) == 0xC0) {
+    len = 2;
+    v = first & 0x1F;
+  } else if ((first & 0xF0) == 0xE0) {
+    len = 3;
+    v = first & 0x0F;
+  } else if ((first & 0xF8) == 0xF0) {
+    len = 4;
+    v = first & 0x07;
+  } else if ((first & 0xFC) == 0xF8) {
+    len = 5;
+    v = first & 0x03;
+  } else if ((first & 0xFE) == 0xFC) {
+    len = 6;
+    v = first & 0x01;
+  } else if (first == 0xFE) {
+    len = 7;
+  } else {
+    return false;
+  }
+  if (avail < len) return false;
+  for (size_t i = 1; i < len; ++i) {
+    if ((p[i] & 0xC0) != 0x80) return false;
+    v = (v << 6) | (p[i] & 0x3F);
+  }
+  *value = v;
+  *length = len;
+  return true;
+}
+
+// 解析并校验 p 处的帧头：同步码、保留位、CRC-8，以及位深/声道/采样率与 STREAMINFO 一致。
+// 扫描建索引时也用它甄别数据中偶然出现的同步码。
+bool ParseFrameHeader(const uint8_t* p, size_t avail, const StreamInfo& info, FrameHeader* h) {
+  if (avail < kMinFrameHeaderSize || p[0] != 0xFF || (p[1] & 0xFE) != 0xF8) return false;
+  h->variable_block_size = (p[1] & 0x01) != 0;
+  const int block_code = p[2] >> 4;
+  const int rate_code = p[2] & 0x0F;
+  const int channel_code = p[3] >> 4;
+  const int size_code = (p[3] >> 1) & 0x07;
+  if (block_code == 0 || rate_code == 15 || channel_code > 10 || size_code == 3 ||
+      (p[3] & 0x01) != 0) {
+    return false;
+  }
+  size_t pos = 4;
+  size_t len = 0;
+  if (!ReadCodedNumber(p + pos, avail - pos, &h->number, &len)) return false;
+  pos += len;
+
+  const size_t extra = (block_code == 6 ? 1 : block_code == 7 ? 2 : 0) +
+                       (rate_code == 12 ? 1 : rate_code == 13 || rate_code == 14 ? 2 : 0);
+  if (avail < pos + extra + 1) return false;
+  if (block_code == 1) {
+    h->block_size = 192;
+  } else if (block_code <= 5) {
+    h->block_size = 576u << (block_code - 2);
+  } else if (block_code == 6) {
+    h->block_size = uint32_t{p[pos++]} + 1;
+  } else if (block_code == 7) {
+    h->block_size = ((uint32_t{p[pos]} << 8) | p[pos + 1]) + 1;
+    pos += 2;
+  } else {
+    h->block_size = 256u << (block_code - 8);
+  }
+  static constexpr uint32_t kRates[12] = {0,     88200, 176400, 192000, 8000,  16000,
+                                          22050, 24000, 32000,  44100,  48000, 96000};
+  if (rate_code == 0) {
+    h->sample_rate = info.sample_rate;
+  } else if (rate_code < 12) {
+    h->sample_rate = kRates[rate_code];
+  } else if (rate_code == 12) {
+    h->sample_rate = uint32_t{p[pos++]} * 1000;
+  } else {
+    h->sample_rate = (uint32_t{p[pos]} << 8) | p[pos + 1];
+    if (rate_code == 14) h->sample_rate *= 10;
+    pos += 2;
+  }
+  if (Crc8(p, pos) != p[pos]) return false;
+  h->size = pos + 1;
+
+  static constexpr int kSampleSizes[8] = {0, 8, 12, 0, 16, 20, 24, 32};
+  h->bits_per_sample = size_code == 0 ? info.bits_per_sample : kSampleSizes[size_code];
+  if (channel_code < 8) {
+    h->channels = channel_code + 1;
+    h->decorrelation = StereoDecorrelation::kIndependent;
+  } else {
+    h->channels = 2;
+    h->decorrelation = channel_code == 8   ? StereoDecorrelation::kLeftSide
+                       : channel_code == 9 ? StereoDecorrelation::kSideRight
+                                           : StereoDecorrelation::kMidSide;
+  }
+  return h->bits_per_sample == info.bits_per_sample && h->channels == info.channels &&
+         h->sample_rate == info.sample_rate &&
+         (info.max_block_size == 0 || h->block_size <= info.max_block_size);
+}
+
+// 系数精度过高、32 位累加可能溢出时的 64 位还原（合法码流里很少见）。
+void LpcRestoreWide(int32_t* s, size_t n, const int32_t* coefs, int order, int shift) {
+  for (size_t i = 0; i < n; ++i) {
+    int64_t sum = 0;
+    for (int j = 0; j < order; ++j) {
+      sum += int64_t{coefs[j]} * s[static_cast<ptrdiff_t>(i) - j - 1];
+    }
+    s[i] = static_cast<int32_t>(s[i] + (sum >> shift));
+  }
+}
+
+int CeilLog2(int v) {
+  int bits = 0;
+  while ((1 << bits) < v) ++bits;
+  return bits;
+}
+
+// 固定预测器就是系数固定、移位为 0 的 LPC。
+constexpr int32_t kFixedCoefs[5][4] = {{0}, {1}, {2, -1}, {3, -3, 1}, {4, -6, 4, -1}};
+
+}  // namespace
+
+struct FlacDecoder::Impl {
+  // 帧索引：Open 时扫描帧头得到，按 first_sample 递增。
+  struct Frame {
+    int64_t first_sample;
+    size_t offset;
+    uint32_t block_size;
+  };
+
+  FlacDecoderConfig cfg;
+  int target_sample_rate = 0;  // 0：沿用源格式。
+  int target_channels = 0;
+  Status last_status = Status::kOk;
+
+  bool opened = false;
+  MappedFile file;
+  StreamInfo info;
+  std::vector<Frame> frames;
+  int64_t num_frames = 0;
+  int64_t missing_frames = 0;  // 帧头损坏、索引中缺失的样本帧数（解码时补静音）
+  int64_t position = 0;
+  int out_sample_rate = 0;
+  int out_channels = 0;
+  ResampleStage resample;
+
+  size_t next_frame = 0;  // 下一个要解码的索引项
+  std::vector<int32_t> planes;  // 各声道一段，每段 max_block 个样本
+  std::vector<float> decoded;  // 当前帧交错后的 float
+  int64_t decoded_first = 0;
+  int64_t decoded_frames = 0;
+  size_t max_block = 0;
+
+  bool Fail(Status status) {
+    last_status = status;
+    return false;
+  }
+
+  void Reset() {
+    opened = false;
+    file.Close();
+    info = StreamInfo();
+    frames.clear();
+    num_frames = 0;
+    missing_frames = 0;
+    position = 0;
+    out_channels = 0;
+    next_frame = 0;
+    decoded_first = 0;
+    decoded_frames = 0;
+    max_block = 0;
+  }
+
+  Status ParseStreamInfo(const uint8_t* p) {
+    BitReader br(p, kStreamInfoSize);
+    info.min_block_size = br.Read(16);
+    info.max_block_size = br.Read(16);
+    info.min_frame_size = br.Read(24);
+    br.Read(24);  // max_frame_size
+    info.sample_rate = br.Read(20);
+    info.channels = static_cast<int>(br.Read(3)) + 1;
+    info.bits_per_sample = static_cast<int>(br.Read(5)) + 1;
+    info.total_samples = (uint64_t{br.Read(4)} << 32) | br.Read(32);
+    if (info.sample_rate == 0 || info.max_block_size < 16 ||
+        info.min_block_size > info.max_block_size) {
+      return Status::kError;
+    }
+    if (info.bits_per_sample < kMinBitsPerSample || info.bits_per_sample > kMaxBitsPerSample) {
+      return Status::kNotSupported;
+    }
+    return Status::kOk;
+  }
+
+  // 跳过可能的 ID3v2 标签，解析元数据块，返回第一帧的偏移（0 表示失败，状态写入 *status）。
+  size_t ParseMetadata(const uint8_t* bytes, size_t size, Status* status) {
+    size_t pos = 0;
+    if (size >= 10 && std::memcmp(bytes, "ID3", 3) == 0) {
+      const size_t tag = (size_t{bytes[6] & 0x7Fu} << 21) | (size_t{bytes[7] & 0x7Fu} << 14) |
+                         (size_t{bytes[8] & 0x7Fu} << 7) | size_t{bytes[9] & 0x7Fu};
+      pos = 10 + tag + ((bytes[5] & 0x10) ? 10 : 0);
+    }
+    if (pos + 4 > size || std::memcmp(bytes + pos, "fLaC", 4) != 0) {
+      *status = Status::kNotSupported;
+      return 0;
+    }
+    pos += 4;
+    bool have_info = false;
+    for (bool last = false; !last;) {
+      if (pos + 4 > size) {
+        *status = Status::kError;
+        return 0;
+      }
+      last = (bytes[pos] & 0x80) != 0;
+      const int type = bytes[pos] & 0x7F;
+      const size_t length = ReadBe24(bytes + pos + 1);
+      pos += 4;
+      if (length > size - pos || (type == 0) != !have_info) {
+        *status = Status::kError;  // STREAMINFO 必须且只能是第一个块
+        return 0;
+      }
+      if (type == 0) {
+        if (length < kStreamInfoSize) {
+          *status = Status::kError;
+          return 0;
+        }
+        *status = ParseStreamInfo(bytes + pos);
+        if (*status != Status::kOk) return 0;
+        have_info = true;
+      }
+      // SEEKTABLE 等其余块跳过：帧索引由下面的帧头扫描精确建立。
+      pos += length;
+    }
+    return pos;
+  }
+
+  // 线性扫描帧头建立索引。固定块长要求帧号连续，可变块长要求首样本号与累计一致，从而排除
+  // 帧数据中 CRC-8 偶然吻合的伪同步码。
+  // 在 [from, to) 中找编号恰为 want 的帧头（定长块为帧号，变长块为首样本号）。
+  size_t FindFrame(const uint8_t* bytes, size_t size, size_t from, size_t to, uint64_t want,
+                   FrameHeader* h) const {
+    to = std::min(to, size);
+    while (from + kMinFrameHeaderSize <= to) {
+      const void* hit = std::memchr(bytes + from, 0xFF, to - from - 1);
+      if (hit == nullptr) break;
+      from = static_cast<size_t>(static_cast<const uint8_t*>(hit) - bytes);
+      if (ParseFrameHeader(bytes + from, size - from, info, h) && h->number == want) return from;
+      ++from;
+    }
+    return size;
+  }
+
+  // 顺序扫描帧头建立索引，每找到一帧向后跳 skip 字节。正常情况下每帧编号都等于期望值；
+  // 帧头损坏（或 skip 偏大、跳过了真实帧）时会遇到编号大于期望的帧头：确认其后紧跟下一个
+  // 编号的帧（或它恰是最后一帧），以防把音频数据里碰巧通过 CRC-8 的字节误当帧头，然后从该帧
+  // 继续，中间缺失的样本记入 missing_frames，解码时输出静音，时间轴与总长不变。
+  void BuildIndex(const uint8_t* bytes, size_t size, size_t pos, size_t skip) {
+    frames.clear();
+    max_block = 0;
+    missing_frames = 0;
+    int64_t expected_sample = 0;
+    uint64_t expected_number = 0;
+    FrameHeader h;
+    FrameHeader probe;
+    auto accept = [&](size_t at, const FrameHeader& header) {
+      frames.push_back({expected_sample, at, header.block_size});
+      expected_sample += header.block_size;
+      ++expected_number;
+      max_block = std::max<size_t>(max_block, header.block_size);
+    };
+    while (pos + kMinFrameHeaderSize <= size) {
+      const void* hit = std::memchr(bytes + pos, 0xFF, size - pos - 1);
+      if (hit == nullptr) break;
+      pos = static_cast<size_t>(static_cast<const uint8_t*>(hit) - bytes);
+      if (!ParseFrameHeader(bytes + pos, size - pos, info, &h)) {
+        ++pos;
+        continue;
+      }
+      const bool variable = h.variable_block_size;
+      const uint64_t want = variable ? static_cast<uint64_t>(expected_sample) : expected_number;
+      if (h.number == want) {
+        accept(pos, h);
+        pos += skip;
+        continue;
+      }
+      if (h.number < want) {
+        ++pos;
+        continue;
+      }
+      const int64_t first = variable ? static_cast<int64_t>(h.number)
+                                     : static_cast<int64_t>(h.number * info.max_block_size);
+      const int64_t end = first + static_cast<int64_t>(h.block_size);
+      const int64_t total = static_cast<int64_t>(info.total_samples);
+      if (total > 0 && end > total) {
+        ++pos;
+        continue;
+      }
+      const bool final_frame = total > 0 && end == total;
+      const uint64_t next = variable ? static_cast<uint64_t>(end) : h.number + 1;
+      if (!final_frame && FindFrame(bytes, size, pos + kMinFrameStep,
+                                    pos + kResyncLookahead, next, &probe) == size) {
+        ++pos;
+        continue;
+      }
+      missing_frames += first - expected_sample;
+      expected_sample = first;
+      expected_number = h.number;
+      accept(pos, h);
+      pos += skip;
+    }
+    num_frames = expected_sample;
+    if (info.total_samples > 0) {
+      // 末尾的帧头损坏时同样按 STREAMINFO 的总长补静音。
+      const int64_t total = static_cast<int64_t>(info.total_samples);
+      if (!frames.empty() && total > num_frames) missing_frames += total - num_frames;
+      num_frames = frames.empty() ? std::min<int64_t>(num_frames, total) : total;
+    }
+  }
+
+  Status OpenFile(const std::string& source) {
+    if (source.empty()) return Status::kInvalidArguments;
+    const Status status = file.Open(PathFromSource(source), /*sequential=*/true);
+    if (status != Status::kOk) return status;
+    const uint8_t* bytes = file.data();
+    const size_t size = file.size();
+    Status parsed = Status::kOk;
+    const size_t first = ParseMetadata(bytes, size, &parsed);
+    if (parsed != Status::kOk) return parsed;
+    // 按 STREAMINFO 的最小帧长跳跃扫描；出现缺失时可能是该值偏大跳过了真实帧，逐字节重扫一遍。
+    const size_t skip = std::max<size_t>(info.min_frame_size, kMinFrameStep);
+    BuildIndex(bytes, size, first, skip);
+    if (missing_frames > 0 && skip > kMinFrameStep) {
+      BuildIndex(bytes, size, first, kMinFrameStep);
+    }
+    if (frames.empty() && info.total_samples > 0) return Status::kError;
+    out_channels = target_channels > 0 ? target_channels : info.channels;
+    const int source_rate = static_cast<int>(info.sample_rate);
+    if (!resample.Configure(source_rate, target_sample_rate, out_channels, cfg.resample_quality)) {
+      return Status::kNotSupported;
+    }
+    out_sample_rate = target_sample_rate > 0 ? target_sample_rate : source_rate;
+    planes.resize(max_block * static_cast<size_t>(info.channels));
+    decoded.resize(max_block * static_cast<size_t>(info.channels));
+    position = 0;
+    next_frame = 0;
+    decoded_frames = 0;
+    opened = true;
+    return Status::kOk;
+  }
+
+  static bool DecodeResidual(BitReader& br, size_t block_size, int order, int32_t* out) {
+    const uint32_t method = br.Read(2);
+    if (method > 1) return false;
+    const int param_bits = method == 0 ? 4 : 5;
+    const uint32_t escape = method == 0 ? 15 : 31;
+    const int partition_order = static_cast<int>(br.Read(4));
+    const size_t partitions = size_t{1} << partition_order;
+    const size_t per_partition = block_size >> partition_order;
+    if (per_partition * partitions != block_size ||
+        per_partition < static_cast<size_t>(order)) {
+      return false;
+    }
+    size_t i = static_cast<size_t>(order);
+    for (size_t part = 0; part < partitions; ++part) {
+      const size_t end = (part + 1) * per_partition;
+      const uint32_t k = br.Read(param_bits);
+      if (k == escape) {
+        const int width = static_cast<int>(br.Read(5));
+        for (; i < end; ++i) out[i] = br.ReadSigned(width);
+      } else {
+        for (; i < end; ++i) {
+          const uint32_t v = (br.ReadUnary() << k) | br.Read(static_cast<int>(k));
+          out[i] = static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1);  // zigzag
+        }
+      }
+      if (br.overrun()) return false;
+    }
+    return true;
+  }
+
+  static bool DecodeSubframe(BitReader& br, size_t block_size, int bps, int32_t* out) {
+    if (br.Read(1) != 0) return false;
+    const uint32_t type = br.Read(6);
+    int wasted = 0;
+    if (br.Read(1) != 0) {
+      wasted = static_cast<int>(br.ReadUnary()) + 1;
+      if (wasted >= bps) return false;
+      bps -= wasted;
+    }
+    const SimdKernels& k = ActiveSimdKernels();
+    if (type == 0) {
+      std::fill(out, out + block_size, br.ReadSigned(bps));
+    } else if (type == 1) {
+      for (size_t i = 0; i < block_size; ++i) out[i] = br.ReadSigned(bps);
+    } else if (type >= 8 && type <= 12) {
+      const int order = static_cast<int>(type - 8);
+      if (static_cast<size_t>(order) > block_size) return false;
+      for (int i = 0; i < order; ++i) out[i] = br.ReadSigned(bps);
+      if (!DecodeResidual(br, block_size, order, out)) return false;
+      // 固定预测的系数绝对值和不超过 16，位深 <= 25 时 32 位累加不会溢出。
+      if (order > 0) {
+        k.lpc_restore(out + order, block_size - static_cast<size_t>(order), kFixedCoefs[order],
+                      order, 0);
+      }
+    } else if (type >= 32) {
+      const int order = static_cast<int>(type - 31);
+      if (static_cast<size_t>(order) > block_size) return false;
+      for (int i = 0; i < order; ++i) out[i] = br.ReadSigned(bps);
+      const int precision = static_cast<int>(br.Read(4)) + 1;
+      const int shift = br.ReadSigned(5);
+      if (precision == 16 || shift < 0) return false;
+      int32_t coefs[kMaxLpcOrder];
+      for (int j = 0; j < order; ++j) coefs[j] = br.ReadSigned(precision);
+      if (!DecodeResidual(br, block_size, order, out)) return false;
+      const size_t n = block_size - static_cast<size_t>(order);
+      if (bps + precision + CeilLog2(order) <= 32) {
+        k.lpc_restore(out + order, n, coefs, order, shift);
+      } else {
+        LpcRestoreWide(out + order, n, coefs, order, shift);
+      }
+    } else {
+      return false;  // 保留的子帧类型
+    }
+    if (wasted > 0) {
+      for (size_t i = 0; i < block_size; ++i) {
+        out[i] = static_cast<int32_t>(static_cast<uint32_t>(out[i]) << wasted);
+      }
+    }
+    return !br.overrun();
+  }
+
+  // 解码索引第 index 项到 decoded（交错 float）。
+  bool DecodeFrame(size_t index) {
+    const Frame& frame = frames[index];
+    const uint8_t* p = file.data() + frame.offset;
+    const size_t avail = file.size() - frame.offset;
+    FrameHeader h;
+    if (!ParseFrameHeader(p, avail, info, &h)) return false;
+    const size_t n = h.block_size;
+    const int channels = info.channels;
+    BitReader br(p + h.size, avail - h.size);
+    for (int c = 0; c < channels; ++c) {
+      const bool side = (c == 1 && (h.decorrelation == StereoDecorrelation::kLeftSide ||
+                                    h.decorrelation == StereoDecorrelation::kMidSide)) ||
+                        (c == 0 && h.decorrelation == StereoDecorrelation::kSideRight);
+      const int bps = info.bits_per_sample + (side ? 1 : 0);
+      if (!DecodeSubframe(br, n, bps, planes.data() + static_cast<size_t>(c) * max_block)) {
+        return false;
+      }
+    }
+    br.AlignToByte();
+    const size_t body = h.size + br.consumed_bytes();
+    const uint32_t crc = br.Read(16);
+    if (br.overrun()) return false;
+    if (cfg.verify_crc && Crc16(p, body) != crc) return false;
+
+    const float scale = 1.0f / static_cast<float>(1 << (info.bits_per_sample - 1));
+    if (channels == 2) {
+      ActiveSimdKernels().stereo_to_float(planes.data(), planes.data() + max_block, n,
+                                          h.decorrelation, scale, decoded.data());
+    } else {
+      for (int c = 0; c < channels; ++c) {
+        const int32_t* plane = planes.data() + static_cast<size_t>(c) * max_block;
+        float* out = decoded.data() + c;
+        for (size_t i = 0; i < n; ++i) {
+          out[i * static_cast<size_t>(channels)] = static_cast<float>(plane[i]) * scale;
+        }
+      }
+    }
+    decoded_first = frame.first_sample;
+    decoded_frames = static_cast<int64_t>(n);
+    return true;
+  }
+  // 从 position 起切出至多 frames_per_read 帧（已换算声道数）；读尽时 block 为空。
+  Status ReadSource(std::vector<float>* block) {
+    if (position >= num_frames) {
+      block->clear();
+      return Status::kOk;
+    }
+    // Seek 之后 next_frame 指向包含 position 的帧，解码后跳过帧内前面的样本。
+    while (position < decoded_first || position >= decoded_first + decoded_frames) {
+      const int64_t gap_end =
+          next_frame < frames.size() ? frames[next_frame].first_sample : num_frames;
+      if (position < gap_end) {
+        // 索引缺失的区段（帧头损坏）：输出静音。
+        const size_t n =
+            static_cast<size_t>(std::min<int64_t>(cfg.frames_per_read, gap_end - position));
+        block->resize(n * static_cast<size_t>(out_channels));
+        std::fill(block->begin(), block->end(), 0.0f);
+        position += static_cast<int64_t>(n);
+        return Status::kOk;
+      }
+      if (next_frame >= frames.size()) {
+        block->clear();
+        return Status::kOk;
+      }
+      const Frame& next = frames[next_frame];
+      if (position >= next.first_sample + static_cast<int64_t>(next.block_size)) {
+        ++next_frame;  // Seek 落在缺失区段之后的帧，前面的帧不必解码
+        continue;
+      }
+      if (!DecodeFrame(next_frame)) {
+        decoded_frames = 0;
+        block->clear();
+        return Status::kError;
+      }
+      ++next_frame;
+    }
+    const int64_t offset = position - decoded_first;
+    const size_t n = static_cast<size_t>(std::min<int64_t>(
+        {cfg.frames_per_read, decoded_frames - offset, num_frames - position}));
+    const size_t src_channels = static_cast<size_t>(info.channels);
+    const float* src = decoded.data() + static_cast<size_t>(offset) * src_channels;
+    block->resize(n * static_cast<size_t>(out_channels));
+    if (out_channels == info.channels) {
+      std::copy(src, src + n * src_channels, block->data());
+    } else {
+      RemapChannels(src, n, info.channels, out_channels, block->data());
+    }
+    position += static_cast<int64_t>(n);
+    return Status::kOk;
+  }
+};
+
+FlacDecoder::FlacDecoder(const FlacDecoderConfig& cfg) : impl_(std::make_unique<Impl>()) {
+  impl_->cfg = cfg;
+  if (impl_->cfg.frames_per_read <= 0) {
+    impl_->cfg.frames_per_read = FlacDecoderConfig().frames_per_read;
+  }
+}
+
+FlacDecoder::~FlacDecoder() = default;
+
+bool FlacDecoder::Open(const std::string& source) {
+  Impl& s = *impl_;
+  s.Reset();
+  const Status status = s.OpenFile(source);
+  if (status != Status::kOk) {
+    s.Reset();
+    return s.Fail(status);
+  }
+  s.last_status = Status::kOk;
+  return true;
+}
+
+bool FlacDecoder::Read(PcmBuffer& out_buffer) {
+  Impl& s = *impl_;
+  if (!s.opened) return s.Fail(Status::kInvalidState);
+  out_buffer.sample_rate = s.out_sample_rate;
+  out_buffer.channels = s.out_channels;
+  s.last_status =
+      s.resample.active()
+          ? s.resample.Read([&s](std::vector<float>* block) { return s.ReadSource(block); },
+                            &out_buffer.interleaved)
+          : s.ReadSource(&out_buffer.interleaved);
+  return s.last_status == Status::kOk && !out_buffer.interleaved.empty();  // 空块即 EOF
+}
+
+void FlacDecoder::Close() { impl_->Reset(); }
+
+bool FlacDecoder::Seek(int64_t frame) {
+  Impl& s = *impl_;
+  if (!s.opened) return s.Fail(Status::kInvalidState);
+  if (frame < 0) return s.Fail(Status::kInvalidArguments);
+  s.position = std::min(s.resample.ToSourceFrame(frame), s.num_frames);
+  s.resample.Reset();
+  s.last_status = Status::kOk;
+  if (s.position >= s.decoded_first && s.position < s.decoded_first + s.decoded_frames) {
+    return true;  // 仍在已解码的帧内
+  }
+  // 二分找到 first_sample <= position 的最后一帧。
+  const auto it = std::upper_bound(
+      s.frames.begin(), s.frames.end(), s.position,
+      [](int64_t pos, const Impl::Frame& f) { return pos < f.first_sample; });
+  s.next_frame = it == s.frames.begin() ? 0 : static_cast<size_t>(it - s.frames.begin()) - 1;
+  s.decoded_frames = 0;
+  return true;
+}
+
+int FlacDecoder::sample_rate() const {
+  return impl_->opened ? impl_->out_sample_rate : impl_->target_sample_rate;
+}
+
+int FlacDecoder::channels() const {
+  return impl_->opened ? impl_->out_channels : impl_->target_channels;
+}
+
+bool FlacDecoder::ConfigureOutput(int target_sample_rate, int target_channels) {
+  Impl& s = *impl_;
+  if (target_sample_rate <= 0 || target_channels <= 0) {
+    return s.Fail(Status::kInvalidArguments);
+  }
+  if (s.opened) {
+    if (target_channels != s.out_channels) return s.Fail(Status::kNotSupported);
+    if (target_sample_rate != s.out_sample_rate) {
+      // 重新配置重采样级；读位置不变，滤波器历史丢弃。
+      const int source_rate = static_cast<int>(s.info.sample_rate);
+      if (!s.resample.Configure(source_rate, target_sample_rate, s.out_channels,
+                                s.cfg.resample_quality)) {
+        s.resample.Configure(source_rate, s.out_sample_rate, s.out_channels,
+                             s.cfg.resample_quality);
+        return s.Fail(Status::kNotSupported);
+      }
+      s.out_sample_rate = target_sample_rate;
+    }
+  }
+  s.target_sample_rate = target_sample_rate;
+  s.target_channels = target_channels;
+  s.last_status = Status::kOk;
+  return true;
+}
+
+Status FlacDecoder::last_status() const { return impl_->last_status; }
+
+int64_t FlacDecoder::num_frames() const { return impl_->num_frames; }
+int64_t FlacDecoder::position() const { return impl_->position; }
+int FlacDecoder::bits_per_sample() const { return impl_->info.bits_per_sample; }
+int FlacDecoder::source_channels() const { return impl_->info.channels; }
+size_t FlacDecoder::index_size() const { return impl_->frames.size(); }
+int64_t FlacDecoder::missing_frames() const { return impl_->missing_frames; }
+
+}  // namespace sw
@@ -0,0 +1,5 @@
+/* 以 USE_SIMD（4 路 __m128）重新编译 kissfft，符号前缀见 kiss_fft_simd4.h。 */
+#include "kiss_fft_simd4.h"
+
+#include "kiss_fft.c"
+#include "kiss_fftr.c"
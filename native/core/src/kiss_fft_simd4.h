@@ -0,0 +1,22 @@
+/* kissfft 的 USE_SIMD 构建：kiss_fft_scalar 为 __m128，一次调用并行做 4 路独立 FFT（布局见
+ * third_party/kissfft/README.simd）。与库内的 float 构建共存，因此所有对外符号与类型名都加
+ * sw_simd4_ 前缀。依赖 GCC/Clang 对 __m128 的向量扩展运算符，仅在 x86-64 非 MSVC 下编译
+ * （CMake 定义 SW_KISSFFT_SIMD4）。只能被 kiss_fft_simd4.c 与 batch_spectrum.cpp 包含。 */
+#pragma once
+
+#define USE_SIMD 1
+#define kiss_fft_cpx sw_simd4_kiss_fft_cpx
+#define kiss_fft_state sw_simd4_kiss_fft_state
+#define kiss_fft_cfg sw_simd4_kiss_fft_cfg
+#define kiss_fft_alloc sw_simd4_kiss_fft_alloc
+#define kiss_fft sw_simd4_kiss_fft
+#define kiss_fft_stride sw_simd4_kiss_fft_stride
+#define kiss_fft_cleanup sw_simd4_kiss_fft_cleanup
+#define kiss_fft_next_fast_size sw_simd4_kiss_fft_next_fast_size
+#define kiss_fftr_state sw_simd4_kiss_fftr_state
+#define kiss_fftr_cfg sw_simd4_kiss_fftr_cfg
+#define kiss_fftr_alloc sw_simd4_kiss_fftr_alloc
+#define kiss_fftr sw_simd4_kiss_fftr
+#define kiss_fftri sw_simd4_kiss_fftri
+
+#include "kiss_fftr.h"
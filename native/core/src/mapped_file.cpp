@@ -0,0 +1,87 @@
+#include "mapped_file.h"
+
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SW_MAPPED_FILE_MMAP 1
+#endif
+
+namespace sw {
+
+MappedFile::MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    Close();
+    // vector 移动保留原缓冲，data_ 仍然有效。
+    copy_ = std::move(other.copy_);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    map_addr_ = std::exchange(other.map_addr_, nullptr);
+  }
+  return *this;
+}
+
+Status MappedFile::Open(const std::string& path, bool sequential) {
+  Close();
+  if (path.empty()) return Status::kInvalidArguments;
+#if defined(SW_MAPPED_FILE_MMAP)
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return Status::kIoError;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    ::close(fd);
+    return Status::kIoError;
+  }
+  if (st.st_size == 0) {
+    ::close(fd);
+    return Status::kOk;
+  }
+  const size_t size = static_cast<size_t>(st.st_size);
+  void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);  // 映射建立后不再需要描述符。
+  if (addr == MAP_FAILED) return Status::kIoError;
+  if (sequential) {
+    posix_madvise(addr, size, POSIX_MADV_SEQUENTIAL);
+  }
+  map_addr_ = addr;
+  data_ = static_cast<const uint8_t*>(addr);
+  size_ = size;
+#else
+  (void)sequential;
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) return Status::kIoError;
+  const std::streamoff size = in.tellg();
+  if (size < 0) return Status::kIoError;
+  if (size == 0) return Status::kOk;
+  copy_.resize(static_cast<size_t>(size));
+  in.seekg(0);
+  if (!in.read(reinterpret_cast<char*>(copy_.data()), size)) {
+    copy_.clear();
+    return Status::kIoError;
+  }
+  data_ = copy_.data();
+  size_ = copy_.size();
+#endif
+  return Status::kOk;
+}
+
+void MappedFile::Close() {
+#if defined(SW_MAPPED_FILE_MMAP)
+  if (map_addr_ != nullptr) {
+    munmap(map_addr_, size_);
+  }
+#endif
+  map_addr_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+  copy_.clear();
+  copy_.shrink_to_fit();
+}
+
+}  // namespace sw
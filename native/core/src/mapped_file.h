@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "audio_engine.h"  // for Status
+
+namespace sw {
+
+// 只读文件映射（库内部使用）。POSIX 平台 mmap(PROT_READ, MAP_PRIVATE)，其余平台整体读入内存；
+// 两种方式对调用方都表现为一段连续只读字节。不可拷贝，可移动。
+class MappedFile {
+ public:
+  MappedFile() = default;
+  ~MappedFile() { Close(); }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  // kIoError：无法打开/映射/读取。空文件也算成功（size 为 0、data 为 nullptr）。
+  // sequential 提示内核按顺序预读（解码场景）。
+  Status Open(const std::string& path, bool sequential = false);
+  void Close();
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  void* map_addr_ = nullptr;  // 非空表示 data_ 来自 mmap。
+  std::vector<uint8_t> copy_;
+};
+
+}  // namespace sw
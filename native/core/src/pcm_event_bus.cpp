@@ -1,46 +1,375 @@
 #include "pcm_event_bus.h"
 
 #include <algorithm>
-#include <memory>
+#include <chrono>
 
 namespace sw {
 
-PcmEventBus::PcmEventBus(const PcmIngressConfig& ingress_cfg, const SpectrumConfig& spectrum_cfg)
-    : ingress_(ingress_cfg), spectrum_cfg_(spectrum_cfg) {}
+namespace {
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void Record(PcmStageLatency& stage, int64_t ns) {
+  if (ns < 0) return;
+  ++stage.count;
+  stage.ns_total += ns;
+  stage.ns_max = std::max(stage.ns_max, ns);
+}
+
+PcmIngressConfig WithDispatchPoolSlack(PcmIngressConfig cfg, const PcmDispatchConfig& dispatch) {
+  // 异步模式下分发队列也持有负载，默认池容量需覆盖它，否则稳态会频繁未命中。
+  if (dispatch.mode == PcmDispatchMode::kAsync && cfg.pool_capacity == 0) {
+    cfg.pool_capacity =
+        cfg.throttle.max_pending + PcmIngress::kDefaultPoolSlack + dispatch.queue_capacity;
+  }
+  return cfg;
+}
+
+PcmThrottleConfig ToThrottleConfig(const PcmSubscriberConfig& config) {
+  PcmThrottleConfig out;
+  out.max_fps = config.max_fps;
+  out.max_pending = config.max_pending;
+  return out;
+}
+
+}  // namespace
+
+PcmEventBus::Subscriber::Subscriber(SubscriptionId sub_id, const PcmSubscriberConfig& cfg)
+    : id(sub_id), config(cfg), throttler(ToThrottleConfig(cfg)) {}
+
+PcmEventBus::PcmEventBus(const PcmIngressConfig& ingress_cfg, const SpectrumConfig& spectrum_cfg,
+                         const PcmDispatchConfig& dispatch_cfg,
+                         const WaveformConfig& waveform_cfg)
+    : ingress_(WithDispatchPoolSlack(ingress_cfg, dispatch_cfg)),
+      spectrum_cfg_(spectrum_cfg),
+      dispatch_cfg_(dispatch_cfg) {
+  dispatch_cfg_.queue_capacity = std::max<size_t>(dispatch_cfg_.queue_capacity, 1);
+  post_.Configure(spectrum_cfg_.post);  // 参数无效时 SpectrumFor 不产出频谱（同频带参数）。
+  decimator_.Configure(waveform_cfg);   // 同上：桶数无效时不产出波形。
+  if (dispatch_cfg_.mode == PcmDispatchMode::kAsync) {
+    dispatcher_ = std::thread([this]() { DispatcherMain(); });
+  }
+}
+
+PcmEventBus::~PcmEventBus() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (dispatcher_.joinable()) {
+    dispatcher_.join();
+  }
+}
+
+PcmSubscriberConfig PcmEventBus::DefaultSubscriberConfig() const {
+  PcmSubscriberConfig config;
+  config.max_fps = 0;  // 只受入口节流限制。
+  config.max_pending = dispatch_cfg_.queue_capacity;
+  config.overflow = dispatch_cfg_.overflow;
+  return config;
+}
+
+void PcmEventBus::SetPcmCallback(PcmCallback cb) {
+  RemoveSubscriber(default_pcm_id_);
+  default_pcm_id_ =
+      cb ? AddSubscriber(DefaultSubscriberConfig(), std::move(cb), nullptr, nullptr) : 0;
+}
+
+void PcmEventBus::SetSpectrumCallback(SpectrumCallback cb) {
+  RemoveSubscriber(default_spectrum_id_);
+  default_spectrum_id_ =
+      cb ? AddSubscriber(DefaultSubscriberConfig(), nullptr, std::move(cb), nullptr) : 0;
+}
+
+void PcmEventBus::SetWaveformCallback(WaveformCallback cb) {
+  RemoveSubscriber(default_waveform_id_);
+  default_waveform_id_ =
+      cb ? AddSubscriber(DefaultSubscriberConfig(), nullptr, nullptr, std::move(cb)) : 0;
+}
+
+SubscriptionId PcmEventBus::AddPcmSubscriber(const PcmSubscriberConfig& config, PcmCallback cb) {
+  if (!cb) return 0;
+  return AddSubscriber(config, std::move(cb), nullptr, nullptr);
+}
+
+SubscriptionId PcmEventBus::AddSpectrumSubscriber(const PcmSubscriberConfig& config,
+                                                  SpectrumCallback cb) {
+  if (!cb) return 0;
+  return AddSubscriber(config, nullptr, std::move(cb), nullptr);
+}
+
+SubscriptionId PcmEventBus::AddWaveformSubscriber(const PcmSubscriberConfig& config,
+                                                  WaveformCallback cb) {
+  if (!cb) return 0;
+  return AddSubscriber(config, nullptr, nullptr, std::move(cb));
+}
+
+SubscriptionId PcmEventBus::AddSubscriber(const PcmSubscriberConfig& config, PcmCallback pcm_cb,
+                                          SpectrumCallback spectrum_cb,
+                                          WaveformCallback waveform_cb) {
+  if (config.max_fps < 0 || config.max_pending == 0) return 0;
+  std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto sub = std::make_unique<Subscriber>(next_id_++, config);
+  sub->pcm_cb = std::move(pcm_cb);
+  sub->spectrum_cb = std::move(spectrum_cb);
+  sub->waveform_cb = std::move(waveform_cb);
+  if (dispatch_cfg_.mode == PcmDispatchMode::kAsync) {
+    sub->pending.resize(config.max_pending);
+  }
+  const SubscriptionId id = sub->id;
+  subscribers_.push_back(std::move(sub));
+  return id;
+}
+
+bool PcmEventBus::RemoveSubscriber(SubscriptionId id) {
+  if (id == 0) return false;
+  // 持有 dispatch_mutex_ 保证该订阅者没有正在执行的回调。
+  std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = std::find_if(subscribers_.begin(), subscribers_.end(),
+                         [id](const std::unique_ptr<Subscriber>& s) { return s->id == id; });
+  if (it == subscribers_.end()) return false;
+  pending_total_ -= (*it)->pending_size;
+  subscribers_.erase(it);
+  if (id == default_pcm_id_) default_pcm_id_ = 0;
+  if (id == default_spectrum_id_) default_spectrum_id_ = 0;
+  if (id == default_waveform_id_) default_waveform_id_ = 0;
+  if (pending_total_ == 0) {
+    idle_cv_.notify_all();
+  }
+  return true;
+}
+
+bool PcmEventBus::Admit(Subscriber& sub, const PcmFrame& frame, int64_t now_ms, PcmFrame* out) {
+  // 频谱/波形订阅者只接收有负载的帧，不关心丢帧标记。
+  const bool derived = !sub.pcm_cb;
+  if (derived && frame.dropped) {
+    return false;
+  }
+  PcmThrottleInput in;
+  in.sequence = frame.sequence;
+  in.timestamp_ms = frame.timestamp_ms;
+  in.num_frames = frame.num_frames;
+  in.num_channels = frame.num_channels;
+  PcmThrottleOutput o;
+  if (!sub.throttler.Push(in, now_ms, &o)) {
+    return false;
+  }
+  if (o.dropped && derived) {
+    return false;
+  }
+  *out = frame;  // 共享负载：仅增加 owner 引用计数。
+  out->dropped_before = frame.dropped_before + o.dropped_before;
+  if (o.dropped) {
+    out->dropped = true;
+    out->data = nullptr;
+    out->num_frames = 0;
+    out->owner.reset();
+  }
+  return true;
+}
 
 Status PcmEventBus::Push(const PcmInputFrame& frame, int64_t now_ms) {
   auto st = ingress_.Push(frame, now_ms);
   if (st != Status::kOk) return st;
 
+  PcmFrame in;
   PcmFrame out;
-  while (ingress_.Pop(out)) {
-    if (pcm_cb_) {
-      pcm_cb_(out);
-    }
-    if (spectrum_cb_ && !out.dropped) {
-      EmitSpectrumIfNeeded(out);
+  while (ingress_.Pop(in)) {
+    if (dispatch_cfg_.mode == PcmDispatchMode::kAsync) {
+      bool enqueued = false;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& sub : subscribers_) {
+          if (Admit(*sub, in, now_ms, &out)) {
+            EnqueueLocked(*sub, std::move(out));
+            out = PcmFrame{};
+            enqueued = true;
+          }
+        }
+      }
+      if (enqueued) {
+        cv_.notify_one();
+      }
+    } else {
+      std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+      for (auto& sub : subscribers_) {
+        if (!Admit(*sub, in, now_ms, &out)) continue;
+        const int64_t ns = Deliver(*sub, out);
+        out = PcmFrame{};
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++sub->stats.enqueued;
+        ++stats_.enqueued;
+        RecordDeliveryLocked(*sub, ns);
+      }
     }
+    in = PcmFrame{};
   }
   return Status::kOk;
 }
 
-void PcmEventBus::EmitSpectrumIfNeeded(const PcmFrame& frame) {
+void PcmEventBus::EnqueueLocked(Subscriber& sub, PcmFrame&& frame) {
+  ++sub.stats.enqueued;
+  ++stats_.enqueued;
+  const size_t capacity = sub.pending.size();
+  frame.dropped_before += sub.pending_overflow;
+  sub.pending_overflow = 0;
+  if (sub.pending_size == capacity) {
+    if (sub.config.overflow == PcmOverflowPolicy::kDropNewest) {
+      ++sub.stats.dropped_newest;
+      ++stats_.dropped_newest;
+      sub.pending_overflow = frame.dropped_before + 1;
+      return;  // frame 析构时释放对负载的引用。
+    }
+    // kDropOldest：淘汰队头，其丢帧计数转交给下一帧（队列容量为 1 时即新帧）。
+    PendingFrame& oldest = sub.pending[sub.pending_head];
+    const uint32_t carried = oldest.frame.dropped_before + 1;
+    oldest.frame = PcmFrame{};
+    sub.pending_head = (sub.pending_head + 1) % capacity;
+    --sub.pending_size;
+    --pending_total_;
+    ++sub.stats.dropped_oldest;
+    ++stats_.dropped_oldest;
+    if (sub.pending_size > 0) {
+      sub.pending[sub.pending_head].frame.dropped_before += carried;
+    } else {
+      frame.dropped_before += carried;
+    }
+  }
+  PendingFrame& slot = sub.pending[(sub.pending_head + sub.pending_size) % capacity];
+  slot.frame = std::move(frame);
+  slot.enqueue_ns = NowNs();
+  ++sub.pending_size;
+  ++pending_total_;
+  sub.stats.queue_high_water = std::max(sub.stats.queue_high_water, sub.pending_size);
+  stats_.queue_high_water = std::max(stats_.queue_high_water, sub.pending_size);
+}
+
+void PcmEventBus::DispatcherMain() {
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      // 入队与析构都在改完状态后 notify，无需定时唤醒。
+      cv_.wait(lock, [this]() { return stop_ || pending_total_ > 0; });
+      if (stop_) break;
+    }
+
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+    Subscriber* sub = nullptr;
+    PcmFrame frame;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const size_t n = subscribers_.size();
+      for (size_t i = 0; i < n && sub == nullptr; ++i) {
+        Subscriber& candidate = *subscribers_[(next_subscriber_ + i) % n];
+        if (candidate.pending_size == 0) continue;
+        sub = &candidate;
+        next_subscriber_ = (next_subscriber_ + i + 1) % n;
+      }
+      if (sub == nullptr) continue;  // 已被退订或 Reset 清空。
+      PendingFrame& head = sub->pending[sub->pending_head];
+      frame = std::move(head.frame);
+      head.frame = PcmFrame{};
+      Record(sub->stats.queue_wait, NowNs() - head.enqueue_ns);
+      Record(stats_.queue_wait, NowNs() - head.enqueue_ns);
+      sub->pending_head = (sub->pending_head + 1) % sub->pending.size();
+      --sub->pending_size;
+      --pending_total_;
+      dispatching_ = true;
+    }
+
+    const int64_t ns = Deliver(*sub, frame);
+    frame = PcmFrame{};  // 在锁外释放负载引用。
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    RecordDeliveryLocked(*sub, ns);
+    dispatching_ = false;
+    if (pending_total_ == 0) {
+      idle_cv_.notify_all();
+    }
+  }
+
+  // 丢弃剩余帧并唤醒可能在 Flush 中等待的线程。
+  std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& sub : subscribers_) {
+    for (auto& pending : sub->pending) {
+      pending.frame = PcmFrame{};
+    }
+    sub->pending_size = 0;
+  }
+  pending_total_ = 0;
+  idle_cv_.notify_all();
+}
+
+int64_t PcmEventBus::Deliver(const Subscriber& sub, const PcmFrame& frame) {
+  const int64_t start = NowNs();
+  if (sub.pcm_cb) {
+    sub.pcm_cb(frame);
+  } else if (sub.spectrum_cb) {
+    if (const SpectrumFrame* spec = SpectrumFor(frame)) {
+      sub.spectrum_cb(*spec);
+    }
+  } else if (const WaveformFrame* waveform = WaveformFor(frame)) {
+    sub.waveform_cb(*waveform);
+  }
+  return NowNs() - start;
+}
+
+void PcmEventBus::RecordDeliveryLocked(Subscriber& sub, int64_t ns) {
+  ++sub.stats.dispatched;
+  ++stats_.dispatched;
+  if (sub.pcm_cb) {
+    Record(sub.stats.pcm_callback, ns);
+    Record(stats_.pcm_callback, ns);
+  } else if (sub.spectrum_cb) {
+    Record(sub.stats.spectrum, ns);
+    Record(stats_.spectrum, ns);
+  } else {
+    Record(sub.stats.waveform, ns);
+    Record(stats_.waveform, ns);
+  }
+}
+
+const SpectrumFrame* PcmEventBus::SpectrumFor(const PcmFrame& frame) {
+  if (spectrum_cache_valid_ && spectrum_cache_seq_ == frame.sequence &&
+      spectrum_cache_data_ == frame.data) {
+    return &spectrum_cache_;
+  }
+  spectrum_cache_valid_ = false;
+
   SpectrumConfig cfg = spectrum_cfg_;
   cfg.window_size =
       cfg.window_size > 0 ? std::min(cfg.window_size, frame.num_frames) : frame.num_frames;
-  if (cfg.window_size <= 0 || frame.data == nullptr || frame.num_channels <= 0) return;
+  if (cfg.window_size <= 0 || frame.data == nullptr || frame.num_channels <= 0) return nullptr;
 
-  auto mono = DownmixToMono(frame.data, frame.num_frames, frame.num_channels, cfg.window_size);
-  cfg.window_size = static_cast<int>(mono.size());
-  if (mono.empty()) return;
+  if (mono_scratch_.size() < static_cast<size_t>(cfg.window_size)) {
+    mono_scratch_.resize(static_cast<size_t>(cfg.window_size));
+  }
+  cfg.window_size = DownmixToMono(frame.data, frame.num_frames, frame.num_channels,
+                                  cfg.window_size, mono_scratch_.data(),
+                                  static_cast<int>(mono_scratch_.size()));
+  if (cfg.window_size <= 0) return nullptr;
 
-  auto spectrum = ComputeSpectrum(mono, frame.sample_rate, cfg);
-  if (spectrum.empty()) return;
+  if (!analyzer_.Configure(cfg)) return nullptr;
+  const size_t num_bins = static_cast<size_t>(analyzer_.num_bins());
+  if (bins_scratch_.size() < num_bins) {
+    bins_scratch_.resize(num_bins);
+  }
+  if (!analyzer_.Compute(mono_scratch_.data(), static_cast<size_t>(cfg.window_size),
+                         bins_scratch_.data(), num_bins)) {
+    return nullptr;
+  }
 
-  auto bins = std::make_shared<std::vector<float>>(std::move(spectrum));
-  SpectrumFrame spec;
-  spec.bins = bins->data();
-  spec.num_bins = static_cast<int>(bins->size());
+  SpectrumFrame& spec = spectrum_cache_;
+  spec.bins = bins_scratch_.data();
+  spec.num_bins = static_cast<int>(num_bins);
   spec.window_size = cfg.window_size;
   spec.bin_hz = frame.sample_rate > 0 ? static_cast<float>(frame.sample_rate) / cfg.window_size
                                       : 0.0f;
@@ -48,12 +377,81 @@ void PcmEventBus::EmitSpectrumIfNeeded(const PcmFrame& frame) {
   spec.window = cfg.window;
   spec.power_spectrum = cfg.power_spectrum;
   spec.timestamp_ms = frame.timestamp_ms;
-  spectrum_cb_(spec);
+  spec.band_scale = BandScale::kNone;
+  spec.band_hz = nullptr;
+  spec.decibels = false;
+  spec.peaks = nullptr;
+  if (!MapSpectrumFrame(cfg, &band_mapper_, &bands_scratch_, &spec) || !post_.Process(&spec)) {
+    return nullptr;
+  }
+  spectrum_cache_seq_ = frame.sequence;
+  spectrum_cache_data_ = frame.data;
+  spectrum_cache_valid_ = true;
+  return &spec;
+}
+
+const WaveformFrame* PcmEventBus::WaveformFor(const PcmFrame& frame) {
+  if (waveform_cache_valid_ && waveform_cache_seq_ == frame.sequence &&
+      waveform_cache_data_ == frame.data) {
+    // 各订阅者的 dropped_before 不同，缓存只复用桶数据。
+    waveform_cache_.dropped_before = frame.dropped_before;
+    return &waveform_cache_;
+  }
+  waveform_cache_valid_ = false;
+  if (!decimator_.Process(frame, &waveform_cache_)) return nullptr;
+  waveform_cache_seq_ = frame.sequence;
+  waveform_cache_data_ = frame.data;
+  waveform_cache_valid_ = true;
+  return &waveform_cache_;
+}
+
+void PcmEventBus::Flush() {
+  if (dispatch_cfg_.mode != PcmDispatchMode::kAsync) return;
+  std::unique_lock<std::mutex> lock(mutex_);
+  // 派发完成、退订、Reset 与分发线程退出都会 notify idle_cv_。
+  idle_cv_.wait(lock, [this]() { return stop_ || (pending_total_ == 0 && !dispatching_); });
 }
 
 void PcmEventBus::Reset() {
+  {
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& sub : subscribers_) {
+      for (auto& pending : sub->pending) {
+        pending.frame = PcmFrame{};
+      }
+      sub->pending_head = 0;
+      sub->pending_size = 0;
+      sub->pending_overflow = 0;
+      sub->throttler.Reset();
+    }
+    pending_total_ = 0;
+    spectrum_cache_valid_ = false;
+    waveform_cache_valid_ = false;
+    post_.Reset();  // 频谱只在持有 dispatch_mutex_ 的分发中计算。
+  }
+  idle_cv_.notify_all();
   ingress_.Reset();
-  spectrum_seq_ = 0;
+}
+
+PcmDispatchStats PcmEventBus::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+bool PcmEventBus::subscriber_stats(SubscriptionId id, PcmDispatchStats* out) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const Subscriber* sub = FindLocked(id);
+  if (sub == nullptr || out == nullptr) return false;
+  *out = sub->stats;
+  return true;
+}
+
+PcmEventBus::Subscriber* PcmEventBus::FindLocked(SubscriptionId id) const {
+  for (const auto& sub : subscribers_) {
+    if (sub->id == id) return sub.get();
+  }
+  return nullptr;
 }
 
 }  // namespace sw
@@ -0,0 +1,316 @@
+#include "pcm_file_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "decoder_util.h"
+#include "mapped_file.h"
+#include "simd_kernels.h"
+
+namespace sw {
+
+namespace {
+
+constexpr uint16_t kWaveFormatPcm = 0x0001;
+constexpr uint16_t kWaveFormatIeeeFloat = 0x0003;
+constexpr uint16_t kWaveFormatExtensible = 0xFFFE;
+
+uint16_t ReadLe16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+
+uint32_t ReadLe32(const uint8_t* p) {
+  return uint32_t{p[0]} | (uint32_t{p[1]} << 8) | (uint32_t{p[2]} << 16) |
+         (uint32_t{p[3]} << 24);
+}
+
+bool HostIsLittleEndian() {
+  const uint16_t probe = 1;
+  uint8_t first;
+  std::memcpy(&first, &probe, 1);
+  return first == 1;
+}
+
+bool IsWavExtension(const std::string& ext) { return ext == "wav" || ext == "wave"; }
+bool IsRawExtension(const std::string& ext) { return ext == "pcm" || ext == "raw"; }
+
+int BytesPerSample(PcmEncoding encoding) {
+  switch (encoding) {
+    case PcmEncoding::kS16:
+      return 2;
+    case PcmEncoding::kS24:
+      return 3;
+    case PcmEncoding::kS32:
+    case PcmEncoding::kF32:
+      return 4;
+  }
+  return 0;
+}
+
+}  // namespace
+
+struct PcmFileDecoder::Impl {
+  PcmFileDecoderConfig cfg;
+  int target_sample_rate = 0;  // 0：沿用源格式。
+  int target_channels = 0;
+  Status last_status = Status::kOk;
+
+  bool opened = false;
+  MappedFile file;
+  const uint8_t* data = nullptr;  // 第 0 帧在映射区中的位置。
+  int64_t num_frames = 0;
+  int64_t position = 0;
+  int sample_rate = 0;
+  int out_sample_rate = 0;
+  int src_channels = 0;
+  int out_channels = 0;
+  PcmEncoding encoding = PcmEncoding::kS16;
+  size_t block_align = 0;  // 每帧字节数。
+  std::vector<float> scratch;  // 声道数需要换算时的中间缓冲。
+  ResampleStage resample;
+
+  bool Fail(Status status) {
+    last_status = status;
+    return false;
+  }
+
+  void Reset() {
+    opened = false;
+    file.Close();
+    data = nullptr;
+    num_frames = 0;
+    position = 0;
+    sample_rate = 0;
+    out_sample_rate = 0;
+    src_channels = 0;
+    out_channels = 0;
+    block_align = 0;
+  }
+
+  // 扫描 RIFF 块，定位 fmt 与 data。
+  Status ParseWav(const uint8_t* bytes, size_t size, size_t* data_offset, size_t* data_size) {
+    bool have_fmt = false;
+    bool have_data = false;
+    uint16_t format = 0;
+    uint16_t channels = 0;
+    uint32_t rate = 0;
+    uint16_t block = 0;
+    uint16_t bits = 0;
+    uint64_t pos = 12;
+    while (pos + 8 <= size && !(have_fmt && have_data)) {
+      const uint8_t* chunk = bytes + pos;
+      const uint64_t chunk_size = ReadLe32(chunk + 4);
+      const uint64_t body = pos + 8;
+      if (std::memcmp(chunk, "fmt ", 4) == 0) {
+        if (chunk_size < 16 || body + chunk_size > size) return Status::kError;
+        const uint8_t* f = bytes + body;
+        format = ReadLe16(f);
+        channels = ReadLe16(f + 2);
+        rate = ReadLe32(f + 4);
+        block = ReadLe16(f + 12);
+        bits = ReadLe16(f + 14);
+        if (format == kWaveFormatExtensible) {
+          // WAVEFORMATEXTENSIBLE：子格式 GUID 的前两个字节即实际格式码。
+          if (chunk_size < 40) return Status::kError;
+          format = ReadLe16(f + 24);
+        }
+        have_fmt = true;
+      } else if (std::memcmp(chunk, "data", 4) == 0) {
+        // 流式写出的文件可能把 data 大小留成 0xFFFFFFFF 或写不全：按实际文件长度截断。
+        *data_offset = static_cast<size_t>(body);
+        *data_size = static_cast<size_t>(std::min<uint64_t>(chunk_size, size - body));
+        have_data = true;
+      }
+      pos = body + chunk_size + (chunk_size & 1);  // 块按 2 字节对齐。
+    }
+    if (!have_fmt || !have_data) return Status::kError;
+    if (channels == 0 || rate == 0 ||
+        rate > static_cast<uint32_t>(std::numeric_limits<int>::max())) {
+      return Status::kError;
+    }
+    if (format == kWaveFormatPcm && bits == 16) {
+      encoding = PcmEncoding::kS16;
+    } else if (format == kWaveFormatPcm && bits == 24) {
+      encoding = PcmEncoding::kS24;
+    } else if (format == kWaveFormatPcm && bits == 32) {
+      encoding = PcmEncoding::kS32;
+    } else if (format == kWaveFormatIeeeFloat && bits == 32) {
+      encoding = PcmEncoding::kF32;
+    } else {
+      return Status::kNotSupported;
+    }
+    if (block != channels * BytesPerSample(encoding)) return Status::kError;
+    sample_rate = static_cast<int>(rate);
+    src_channels = channels;
+    return Status::kOk;
+  }
+
+  Status OpenFile(const std::string& source) {
+    if (source.empty()) return Status::kInvalidArguments;
+    if (!HostIsLittleEndian()) return Status::kNotSupported;
+    const std::string path = PathFromSource(source);
+    const std::string ext = LowerExtension(path);
+    const Status status = file.Open(path, /*sequential=*/true);
+    if (status != Status::kOk) return status;
+
+    const uint8_t* bytes = file.data();
+    const size_t size = file.size();
+    size_t data_offset = 0;
+    size_t data_size = 0;
+    const bool riff =
+        size >= 12 && std::memcmp(bytes, "RIFF", 4) == 0 && std::memcmp(bytes + 8, "WAVE", 4) == 0;
+    if (riff) {
+      const Status parsed = ParseWav(bytes, size, &data_offset, &data_size);
+      if (parsed != Status::kOk) return parsed;
+    } else if (IsRawExtension(ext)) {
+      sample_rate = cfg.raw.sample_rate > 0 ? cfg.raw.sample_rate : target_sample_rate;
+      src_channels = cfg.raw.channels > 0 ? cfg.raw.channels : target_channels;
+      encoding = cfg.raw.encoding;
+      if (sample_rate <= 0 || src_channels <= 0) return Status::kInvalidArguments;
+      data_offset = 0;
+      data_size = size;
+    } else {
+      return IsWavExtension(ext) ? Status::kError : Status::kNotSupported;
+    }
+    block_align =
+        static_cast<size_t>(src_channels) * static_cast<size_t>(BytesPerSample(encoding));
+    data = bytes + data_offset;
+    num_frames = static_cast<int64_t>(data_size / block_align);  // 末尾不完整的帧丢弃。
+    position = 0;
+    out_channels = target_channels > 0 ? target_channels : src_channels;
+    if (!resample.Configure(sample_rate, target_sample_rate, out_channels, cfg.resample_quality)) {
+      return Status::kNotSupported;
+    }
+    out_sample_rate = target_sample_rate > 0 ? target_sample_rate : sample_rate;
+    opened = true;
+    return Status::kOk;
+  }
+
+  // 从 position 起解出至多 frames_per_read 帧（已换算声道数）；读尽时 block 为空。
+  Status ReadSource(std::vector<float>* block) {
+    const size_t frames =
+        static_cast<size_t>(std::min<int64_t>(cfg.frames_per_read, num_frames - position));
+    if (frames == 0) {
+      block->clear();
+      return Status::kOk;
+    }
+    const uint8_t* src = data + static_cast<size_t>(position) * block_align;
+    const size_t src_samples = frames * static_cast<size_t>(src_channels);
+    block->resize(frames * static_cast<size_t>(out_channels));
+    if (out_channels == src_channels) {
+      Convert(src, src_samples, block->data());
+    } else {
+      if (scratch.size() < src_samples) {
+        scratch.resize(src_samples);
+      }
+      Convert(src, src_samples, scratch.data());
+      RemapChannels(scratch.data(), frames, src_channels, out_channels, block->data());
+    }
+    position += static_cast<int64_t>(frames);
+    return Status::kOk;
+  }
+
+  void Convert(const uint8_t* src, size_t samples, float* out) const {
+    const SimdKernels& k = ActiveSimdKernels();
+    switch (encoding) {
+      case PcmEncoding::kS16:
+        k.s16_to_float(src, samples, out);
+        break;
+      case PcmEncoding::kS24:
+        k.s24_to_float(src, samples, out);
+        break;
+      case PcmEncoding::kS32:
+        k.s32_to_float(src, samples, out);
+        break;
+      case PcmEncoding::kF32:
+        std::memcpy(out, src, samples * sizeof(float));
+        break;
+    }
+  }
+};
+
+PcmFileDecoder::PcmFileDecoder(const PcmFileDecoderConfig& cfg) : impl_(std::make_unique<Impl>()) {
+  impl_->cfg = cfg;
+  if (impl_->cfg.frames_per_read <= 0) {
+    impl_->cfg.frames_per_read = PcmFileDecoderConfig().frames_per_read;
+  }
+}
+
+PcmFileDecoder::~PcmFileDecoder() = default;
+
+bool PcmFileDecoder::Open(const std::string& source) {
+  Impl& s = *impl_;
+  s.Reset();
+  const Status status = s.OpenFile(source);
+  if (status != Status::kOk) {
+    s.Reset();
+    return s.Fail(status);
+  }
+  s.last_status = Status::kOk;
+  return true;
+}
+
+bool PcmFileDecoder::Read(PcmBuffer& out_buffer) {
+  Impl& s = *impl_;
+  if (!s.opened) return s.Fail(Status::kInvalidState);
+  out_buffer.sample_rate = s.out_sample_rate;
+  out_buffer.channels = s.out_channels;
+  s.last_status =
+      s.resample.active()
+          ? s.resample.Read([&s](std::vector<float>* block) { return s.ReadSource(block); },
+                            &out_buffer.interleaved)
+          : s.ReadSource(&out_buffer.interleaved);
+  return s.last_status == Status::kOk && !out_buffer.interleaved.empty();  // 空块即 EOF
+}
+
+void PcmFileDecoder::Close() { impl_->Reset(); }
+
+bool PcmFileDecoder::Seek(int64_t frame) {
+  Impl& s = *impl_;
+  if (!s.opened) return s.Fail(Status::kInvalidState);
+  if (frame < 0) return s.Fail(Status::kInvalidArguments);
+  s.position = std::min(s.resample.ToSourceFrame(frame), s.num_frames);
+  s.resample.Reset();
+  s.last_status = Status::kOk;
+  return true;
+}
+
+int PcmFileDecoder::sample_rate() const {
+  return impl_->opened ? impl_->out_sample_rate : impl_->target_sample_rate;
+}
+
+int PcmFileDecoder::channels() const {
+  return impl_->opened ? impl_->out_channels : impl_->target_channels;
+}
+
+bool PcmFileDecoder::ConfigureOutput(int target_sample_rate, int target_channels) {
+  Impl& s = *impl_;
+  if (target_sample_rate <= 0 || target_channels <= 0) {
+    return s.Fail(Status::kInvalidArguments);
+  }
+  if (s.opened) {
+    if (target_channels != s.out_channels) return s.Fail(Status::kNotSupported);
+    if (target_sample_rate != s.out_sample_rate) {
+      // 重新配置重采样级；读位置不变，滤波器历史丢弃。
+      if (!s.resample.Configure(s.sample_rate, target_sample_rate, s.out_channels,
+                                s.cfg.resample_quality)) {
+        s.resample.Configure(s.sample_rate, s.out_sample_rate, s.out_channels,
+                             s.cfg.resample_quality);
+        return s.Fail(Status::kNotSupported);
+      }
+      s.out_sample_rate = target_sample_rate;
+    }
+  }
+  s.target_sample_rate = target_sample_rate;
+  s.target_channels = target_channels;
+  s.last_status = Status::kOk;
+  return true;
+}
+
+Status PcmFileDecoder::last_status() const { return impl_->last_status; }
+
+int64_t PcmFileDecoder::num_frames() const { return impl_->num_frames; }
+int64_t PcmFileDecoder::position() const { return impl_->position; }
+PcmEncoding PcmFileDecoder::encoding() const { return impl_->encoding; }
+int PcmFileDecoder::source_channels() const { return impl_->src_channels; }
+
+}  // namespace sw
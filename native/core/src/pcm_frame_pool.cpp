@@ -0,0 +1,57 @@
+#include "pcm_frame_pool.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace sw {
+
+PcmFramePool::PcmFramePool(size_t capacity, size_t samples_hint) {
+  slots_.reserve(capacity);
+  for (size_t i = 0; i < capacity; ++i) {
+    auto buffer = std::make_shared<std::vector<float>>();
+    buffer->reserve(samples_hint);
+    slots_.push_back(std::move(buffer));
+  }
+}
+
+std::shared_ptr<std::vector<float>> PcmFramePool::Acquire(size_t samples) {
+  const size_t n = slots_.size();
+  for (size_t i = 0; i < n; ++i) {
+    auto& slot = slots_[(next_ + i) % n];
+    if (slot.use_count() != 1) {
+      continue;
+    }
+    // 与释放方的引用计数递减（release）配对，确保其对缓冲的读取先于此处复用。
+    std::atomic_thread_fence(std::memory_order_acquire);
+    next_ = (next_ + i + 1) % n;
+    if (slot->capacity() < samples) {
+      ++grows_;
+    }
+    slot->resize(samples);
+    ++hits_;
+    high_water_ = std::max(high_water_, CountInUse() + 1);
+    return slot;
+  }
+  ++misses_;
+  high_water_ = std::max(high_water_, n);
+  return std::make_shared<std::vector<float>>(samples);
+}
+
+size_t PcmFramePool::CountInUse() const {
+  return static_cast<size_t>(
+      std::count_if(slots_.begin(), slots_.end(),
+                    [](const std::shared_ptr<std::vector<float>>& s) { return s.use_count() > 1; }));
+}
+
+PcmFramePoolStats PcmFramePool::stats() const {
+  PcmFramePoolStats out;
+  out.capacity = slots_.size();
+  out.in_use = CountInUse();
+  out.high_water = high_water_;
+  out.hits = hits_;
+  out.misses = misses_;
+  out.grows = grows_;
+  return out;
+}
+
+}  // namespace sw
@@ -5,7 +5,12 @@
 namespace sw {
 
 PcmIngress::PcmIngress(const PcmIngressConfig& config)
-    : cfg_(config), throttler_(config.throttle) {}
+    : cfg_(config),
+      throttler_(config.throttle),
+      pool_(config.pool_capacity > 0 ? config.pool_capacity
+                                     : config.throttle.max_pending + kDefaultPoolSlack,
+            config.pool_samples_hint),
+      queue_(std::max<size_t>(config.throttle.max_pending + 1, 2)) {}
 
 Status PcmIngress::Push(const PcmInputFrame& in, int64_t now_ms) {
   if (in.data == nullptr || in.num_frames == 0 || in.sample_rate <= 0 || in.channels <= 0) {
@@ -24,50 +29,53 @@ Status PcmIngress::Push(const PcmInputFrame& in, int64_t now_ms) {
       static_cast<int>(in.num_frames),
       in.channels,
   };
-  auto outputs = throttler_.Push(input_meta, now_ms);
-  if (outputs.empty()) {
+  PcmThrottleOutput out;
+  if (!throttler_.Push(input_meta, now_ms, &out)) {
     return Status::kOk;
   }
 
-  for (const auto& out : outputs) {
-    OwnedFrame owned;
-    owned.frame.sequence = out.sequence;
-    owned.frame.timestamp_ms = out.timestamp_ms;
-    owned.frame.dropped_before = out.dropped_before;
-    owned.frame.dropped = out.dropped;
-    owned.frame.sample_rate = in.sample_rate;
-    owned.frame.num_channels = in.channels;
-    owned.frame.num_frames = static_cast<int>(in.num_frames);
+  OwnedFrame owned;
+  owned.frame.sequence = out.sequence;
+  owned.frame.timestamp_ms = out.timestamp_ms;
+  owned.frame.dropped_before = out.dropped_before + queue_overflow_pending_;
+  owned.frame.dropped = out.dropped;
+  owned.frame.sample_rate = in.sample_rate;
+  owned.frame.num_channels = in.channels;
+  owned.frame.num_frames = static_cast<int>(in.num_frames);
 
-    if (!out.dropped) {
-      const size_t samples = in.num_frames * static_cast<size_t>(in.channels);
-      auto buffer = std::make_shared<std::vector<float>>();
-      buffer->resize(samples);
-      std::copy(in.data, in.data + samples, buffer->begin());
-      owned.frame.owner = buffer;
-      owned.frame.data = buffer->data();
-    } else {
-      owned.frame.data = nullptr;
-      owned.frame.num_frames = 0;
-      owned.frame.owner.reset();
-    }
-    queue_.push_back(std::move(owned));
+  if (!out.dropped) {
+    const size_t samples = in.num_frames * static_cast<size_t>(in.channels);
+    auto buffer = pool_.Acquire(samples);
+    std::copy(in.data, in.data + samples, buffer->begin());
+    owned.frame.data = buffer->data();
+    owned.frame.owner = std::move(buffer);
+  } else {
+    owned.frame.data = nullptr;
+    owned.frame.num_frames = 0;
   }
+  if (!queue_.TryPush(std::move(owned))) {
+    // 消费端未及时取走：丢弃本帧（缓冲随 owned 析构回池），连同其 dropped_before
+    // 一并计入下一帧，保证丢帧计数不丢失。
+    queue_overflow_pending_ = owned.frame.dropped_before + 1;
+    queue_overflow_total_.fetch_add(1, std::memory_order_relaxed);
+    return Status::kOk;
+  }
+  queue_overflow_pending_ = 0;
 
   return Status::kOk;
 }
 
 bool PcmIngress::Pop(PcmFrame& out) {
-  if (queue_.empty()) return false;
-  OwnedFrame& front = queue_.front();
-  out = front.frame;
-  queue_.pop_front();
+  OwnedFrame front;
+  if (!queue_.TryPop(front)) return false;
+  out = std::move(front.frame);
   return true;
 }
 
 void PcmIngress::Reset() {
-  queue_.clear();
+  queue_.Clear();
   throttler_.Reset();
+  queue_overflow_pending_ = 0;
 }
 
 }  // namespace sw
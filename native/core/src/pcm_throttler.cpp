@@ -2,47 +2,52 @@
 
 namespace sw {
 
-PcmThrottler::PcmThrottler(const PcmThrottleConfig& config) : config_(config) {}
+PcmThrottler::PcmThrottler(const PcmThrottleConfig& config)
+    : config_(config),
+      min_interval_ms_(config.max_fps > 0 ? static_cast<int>(1000 / config.max_fps) : 0) {}
 
-std::vector<PcmThrottleOutput> PcmThrottler::Push(const PcmThrottleInput& input, int64_t now_ms) {
-  std::vector<PcmThrottleOutput> out;
-
-  if (config_.max_pending <= 0) {
-    return out;
+bool PcmThrottler::Push(const PcmThrottleInput& input, int64_t now_ms, PcmThrottleOutput* out) {
+  if (config_.max_pending <= 0 || out == nullptr) {
+    return false;
   }
 
-  const int min_interval_ms =
-      config_.max_fps > 0 ? static_cast<int>(1000 / config_.max_fps) : 0;
-
   const bool should_emit =
-      last_emit_ms_ < 0 || min_interval_ms <= 0 ||
-      (now_ms - last_emit_ms_) >= min_interval_ms;
+      last_emit_ms_ < 0 || min_interval_ms_ <= 0 || (now_ms - last_emit_ms_) >= min_interval_ms_;
 
   if (should_emit) {
-    out.push_back(PcmThrottleOutput{
+    *out = PcmThrottleOutput{
         input.sequence,
         input.timestamp_ms,
         pending_drops_,
         /*dropped=*/false,
-    });
+    };
     pending_drops_ = 0;
     pending_kept_ = 0;
     last_emit_ms_ = now_ms;
-  } else {
-    // 未到间隔：优先排队，超过上限则丢弃并发出 dropped 标记。
-    if (pending_kept_ < static_cast<int>(config_.max_pending)) {
-      pending_kept_++;
-    } else {
-      pending_drops_++;
-      out.push_back(PcmThrottleOutput{
-          input.sequence,
-          input.timestamp_ms,
-          pending_drops_,
-          /*dropped=*/true,
-      });
-    }
+    return true;
+  }
+
+  // 未到间隔：优先排队，超过上限则丢弃并发出 dropped 标记。
+  if (pending_kept_ < static_cast<int>(config_.max_pending)) {
+    pending_kept_++;
+    return false;
   }
+  pending_drops_++;
+  *out = PcmThrottleOutput{
+      input.sequence,
+      input.timestamp_ms,
+      pending_drops_,
+      /*dropped=*/true,
+  };
+  return true;
+}
 
+std::vector<PcmThrottleOutput> PcmThrottler::Push(const PcmThrottleInput& input, int64_t now_ms) {
+  std::vector<PcmThrottleOutput> out;
+  PcmThrottleOutput slot;
+  if (Push(input, now_ms, &slot)) {
+    out.push_back(slot);
+  }
   return out;
 }
 
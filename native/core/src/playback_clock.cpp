@@ -0,0 +1,57 @@
+#include "playback_clock.h"
+
+namespace sw {
+
+namespace {
+
+// frames * unit / sample_rate without overflowing the intermediate product.
+int64_t ScaleFrames(int64_t frames, int64_t unit, int sample_rate) {
+  if (sample_rate <= 0) {
+    return 0;
+  }
+  const int64_t sr = sample_rate;
+  const int64_t seconds = frames / sr;
+  const int64_t rem = frames % sr;
+  return seconds * unit + rem * unit / sr;
+}
+
+}  // namespace
+
+PlaybackClock::PlaybackClock(int sample_rate) : sample_rate_(sample_rate) {}
+
+void PlaybackClock::set_sample_rate(int sample_rate) {
+  sample_rate_.store(sample_rate, std::memory_order_relaxed);
+}
+
+int64_t PlaybackClock::Advance(int64_t frames) {
+  return frames_.fetch_add(frames, std::memory_order_acq_rel) + frames;
+}
+
+void PlaybackClock::Reset(int64_t position_frames) {
+  frames_.store(position_frames, std::memory_order_release);
+}
+
+void PlaybackClock::ResetMs(int64_t position_ms) { Reset(MsToFrames(position_ms, sample_rate())); }
+
+int64_t PlaybackClock::FramesToMs(int64_t frames, int sample_rate) {
+  return ScaleFrames(frames, 1000, sample_rate);
+}
+
+int64_t PlaybackClock::FramesToUs(int64_t frames, int sample_rate) {
+  return ScaleFrames(frames, 1000000, sample_rate);
+}
+
+int64_t PlaybackClock::FramesToNs(int64_t frames, int sample_rate) {
+  return ScaleFrames(frames, 1000000000, sample_rate);
+}
+
+int64_t PlaybackClock::MsToFrames(int64_t ms, int sample_rate) {
+  if (sample_rate <= 0) {
+    return 0;
+  }
+  const int64_t seconds = ms / 1000;
+  const int64_t rem = ms % 1000;
+  return seconds * sample_rate + rem * sample_rate / 1000;
+}
+
+}  // namespace sw
@@ -2,16 +2,17 @@
 
 #include <algorithm>
 #include <chrono>
-#include <vector>
 
 namespace sw {
 
 namespace {
 constexpr int kDefaultFramesPerBuffer = 256;
+// Upper bound for a single blocking wait; Stop() wakes the waiter earlier via WakeAll().
+constexpr auto kMaxIdleWait = std::chrono::milliseconds(100);
 }
 
 PlaybackThread::PlaybackThread(RingBuffer& buffer, PlaybackConfig config)
-    : buffer_(buffer), cfg_(config) {
+    : buffer_(buffer), cfg_(config), clock_(config.sample_rate) {
   if (cfg_.frames_per_buffer <= 0) {
     cfg_.frames_per_buffer = kDefaultFramesPerBuffer;
   }
@@ -33,6 +34,7 @@ bool PlaybackThread::Start() {
 
 void PlaybackThread::Stop() {
   running_.store(false);
+  buffer_.WakeAll();
   if (thread_.joinable()) {
     thread_.join();
   }
@@ -44,24 +46,39 @@ void PlaybackThread::SetPositionCallback(std::function<void(int64_t)> cb) {
 }
 
 void PlaybackThread::ThreadMain() {
-  std::vector<float> local;
-  local.resize(static_cast<size_t>(cfg_.frames_per_buffer * cfg_.channels));
   const int sample_rate = cfg_.sample_rate;
   const int frames_per_buffer = cfg_.frames_per_buffer;
-  auto next_deadline = std::chrono::steady_clock::now();
+  // Pacing deadlines are derived from frames consumed since start, not summed per buffer,
+  // so nanosecond truncation does not accumulate either.
+  auto pacing_start = std::chrono::steady_clock::now();
+  int64_t paced_frames = 0;
+  bool had_data = false;
 
   while (running_.load()) {
-    size_t frames = buffer_.Read(local.data(), static_cast<size_t>(frames_per_buffer));
+    // Consume in place from the ring (a real sink would render the region directly).
+    const RingBufferRegion region = buffer_.BeginRead(static_cast<size_t>(frames_per_buffer));
+    const size_t frames = region.total_frames();
+    buffer_.CommitRead(frames);
     if (frames == 0) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      if (had_data) {
+        underruns_.fetch_add(1, std::memory_order_relaxed);
+        had_data = false;
+      }
+      // Sleep until the producer has published a full buffer (low-water mark) or Stop().
+      buffer_.WaitForReadable(static_cast<size_t>(frames_per_buffer), kMaxIdleWait);
+      // Underrun: restart pacing from now instead of bursting to catch up.
+      pacing_start = std::chrono::steady_clock::now();
+      paced_frames = 0;
       continue;
     }
+    had_data = true;
     // Advance clock based on consumed frames to mimic real-time pacing.
-    const int64_t delta_ms = static_cast<int64_t>(frames * 1000 / sample_rate);
-    const auto delta_ns = std::chrono::nanoseconds(static_cast<int64_t>(
-        (1000000000LL * static_cast<int64_t>(frames)) / static_cast<int64_t>(sample_rate)));
-    next_deadline += delta_ns;
-    int64_t now = position_ms_.fetch_add(delta_ms) + delta_ms;
+    paced_frames += static_cast<int64_t>(frames);
+    const auto next_deadline =
+        pacing_start +
+        std::chrono::nanoseconds(PlaybackClock::FramesToNs(paced_frames, sample_rate));
+    clock_.Advance(static_cast<int64_t>(frames));
+    const int64_t now = clock_.ms();
     // Notify callback.
     std::function<void(int64_t)> cb_copy;
     {
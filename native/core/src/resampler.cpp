@@ -0,0 +1,270 @@
+#include "resampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <numeric>
+
+#include "simd_kernels.h"
+
+namespace sw {
+
+namespace {
+
+// 每次最多搬入这么多输入帧到平面历史缓冲；Process 的输入可以任意长。
+constexpr size_t kChunkFrames = 1024;
+// 截止频率相对较低 Nyquist 的比例与 Kaiser β：抽头数为 64 · ⌈M/L⌉ 时过渡带约 0.13·Nyquist，
+// 阻带从 ~0.98·Nyquist 开始，约 -70 dB；通带 0.85·Nyquist 内起伏 < 0.1 dB。
+constexpr double kCutoff = 0.915;
+constexpr double kKaiserBeta = 7.0;
+constexpr double kPi = 3.14159265358979323846;
+
+double BesselI0(double x) {
+  // 幂级数，x ≤ 20 时 30 项足以收敛到双精度。
+  double sum = 1.0;
+  double term = 1.0;
+  const double q = x * x / 4.0;
+  for (int k = 1; k < 30; ++k) {
+    term *= q / (static_cast<double>(k) * k);
+    sum += term;
+  }
+  return sum;
+}
+
+// 降采样时截止频率按 L/M 下移，抽头数按 ⌈M/L⌉ 同比例增加，过渡带相对输出 Nyquist 保持不变。
+int SincTaps(int phases, int decimation) {
+  const int factor = (decimation + phases - 1) / phases;
+  return Resampler::kSincTaps * std::max(factor, 1);
+}
+
+struct FilterBank {
+  int phases = 0;      // L
+  int decimation = 0;  // M
+  int taps = 0;
+  // phases × taps；第 p 相第 k 个系数作用于输入 i - taps/2 + 1 + k（i 为输出左侧最近的输入）。
+  std::vector<float> coefs;
+};
+
+std::shared_ptr<const FilterBank> BuildBank(int phases, int decimation) {
+  auto bank = std::make_shared<FilterBank>();
+  const int taps = SincTaps(phases, decimation);
+  bank->phases = phases;
+  bank->decimation = decimation;
+  bank->taps = taps;
+  bank->coefs.resize(static_cast<size_t>(phases) * static_cast<size_t>(taps));
+  // 降采样时截止频率跟随输出 Nyquist 下移（以输入采样间隔为单位）。
+  const double fc =
+      kCutoff * std::min(1.0, static_cast<double>(phases) / static_cast<double>(decimation));
+  const double half = taps / 2.0;
+  const double i0_beta = BesselI0(kKaiserBeta);
+  for (int p = 0; p < phases; ++p) {
+    float* row = bank->coefs.data() + static_cast<size_t>(p) * static_cast<size_t>(taps);
+    const double frac = static_cast<double>(p) / phases;
+    double sum = 0.0;
+    std::vector<double> h(static_cast<size_t>(taps));
+    for (int k = 0; k < taps; ++k) {
+      const double x = (k - (half - 1.0)) - frac;  // 输入样本相对输出时刻的距离
+      const double u = x / half;
+      const double window = std::fabs(u) < 1.0
+                                ? BesselI0(kKaiserBeta * std::sqrt(1.0 - u * u)) / i0_beta
+                                : 0.0;
+      const double arg = kPi * fc * x;
+      const double sinc = std::fabs(arg) < 1e-12 ? 1.0 : std::sin(arg) / arg;
+      h[static_cast<size_t>(k)] = fc * sinc * window;
+      sum += h[static_cast<size_t>(k)];
+    }
+    // 各相单独归一化到直流增益 1，避免相间增益差调制出杂散。
+    for (int k = 0; k < taps; ++k) {
+      row[k] = static_cast<float>(h[static_cast<size_t>(k)] / sum);
+    }
+  }
+  return bank;
+}
+
+// 滤波器组只与 (L, M) 有关，进程内共享；比例种类很少，线性查找即可。
+std::shared_ptr<const FilterBank> GetBank(int phases, int decimation) {
+  static std::mutex mutex;
+  static std::vector<std::shared_ptr<const FilterBank>> cache;
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const auto& bank : cache) {
+    if (bank->phases == phases && bank->decimation == decimation) return bank;
+  }
+  cache.push_back(BuildBank(phases, decimation));
+  return cache.back();
+}
+
+}  // namespace
+
+struct Resampler::Impl {
+  ResamplerConfig cfg;
+  bool configured = false;
+  int64_t interp = 1;  // L
+  int64_t decim = 1;   // M
+  size_t window = 2;   // 每个输出用到的输入帧数。
+  size_t prefill = 0;  // 开头补的零，使第 0 个输出对齐第 0 个输入。
+  std::shared_ptr<const FilterBank> bank;
+
+  // 平面历史：声道 c 占 planar[c·stride, (c+1)·stride)，有效帧 [0, buffered)。
+  std::vector<float> planar;
+  size_t stride = 0;
+  size_t buffered = 0;
+  int64_t pos = 0;  // 下一个输出在历史中的位置，单位 1/L 输入帧。
+
+  void Clear() {
+    std::fill(planar.begin(), planar.end(), 0.0f);
+    buffered = prefill;
+    pos = 0;
+  }
+
+  size_t PendingOutputs() const {
+    if (buffered < window) return 0;
+    const int64_t limit = static_cast<int64_t>(buffered - window) * interp + (interp - 1);
+    if (pos > limit) return 0;
+    return static_cast<size_t>((limit - pos) / decim + 1);
+  }
+
+  // 追加 n ≤ kChunkFrames 帧（interleaved 为空时补零）。
+  void Append(const float* interleaved, size_t n) {
+    const size_t ch = static_cast<size_t>(cfg.channels);
+    for (size_t c = 0; c < ch; ++c) {
+      float* dst = planar.data() + c * stride + buffered;
+      if (interleaved == nullptr) {
+        std::fill(dst, dst + n, 0.0f);
+      } else {
+        for (size_t i = 0; i < n; ++i) dst[i] = interleaved[i * ch + c];
+      }
+    }
+    buffered += n;
+  }
+
+  // 产出当前历史能支持的全部输出，写到 out（交错），再丢掉不再需要的历史。
+  size_t Run(float* out) {
+    const size_t count = PendingOutputs();
+    const size_t ch = static_cast<size_t>(cfg.channels);
+    size_t j = static_cast<size_t>(pos / interp);
+    int64_t phase = pos % interp;
+    const size_t step = static_cast<size_t>(decim / interp);
+    const int64_t step_phase = decim % interp;
+    if (bank) {
+      const SimdKernels& k = ActiveSimdKernels();
+      const size_t taps = static_cast<size_t>(bank->taps);
+      for (size_t n = 0; n < count; ++n) {
+        const float* h = bank->coefs.data() + static_cast<size_t>(phase) * taps;
+        for (size_t c = 0; c < ch; ++c) {
+          out[n * ch + c] = k.dot(planar.data() + c * stride + j, h, taps);
+        }
+        j += step;
+        phase += step_phase;
+        if (phase >= interp) {
+          phase -= interp;
+          ++j;
+        }
+      }
+    } else {
+      const double inv = 1.0 / static_cast<double>(interp);
+      for (size_t n = 0; n < count; ++n) {
+        const float frac = static_cast<float>(static_cast<double>(phase) * inv);
+        for (size_t c = 0; c < ch; ++c) {
+          const float* x = planar.data() + c * stride + j;
+          out[n * ch + c] = x[0] + (x[1] - x[0]) * frac;
+        }
+        j += step;
+        phase += step_phase;
+        if (phase >= interp) {
+          phase -= interp;
+          ++j;
+        }
+      }
+    }
+    // 大比例降采样时下一个输出可能已越过缓冲末尾，越过的部分留在 pos 里。
+    const size_t drop = std::min(j, buffered);
+    if (drop > 0) {
+      for (size_t c = 0; c < ch; ++c) {
+        float* row = planar.data() + c * stride;
+        std::copy(row + drop, row + buffered, row);
+      }
+      buffered -= drop;
+    }
+    pos = static_cast<int64_t>(j - drop) * interp + phase;
+    return count;
+  }
+
+  // 分块追加输入（interleaved 为空时追加 frames 帧零）并收集输出。
+  size_t Feed(const float* interleaved, size_t frames, std::vector<float>* out) {
+    const size_t ch = static_cast<size_t>(cfg.channels);
+    // 调用之间留存的历史不足一个窗口，frames 帧输入至多产出 ⌈frames · L / M⌉ 帧。上界只取决于
+    // frames，首次调用就按稳态块长分配好，之后 resize 不再分配。
+    const int64_t in = static_cast<int64_t>(frames);
+    const size_t bound = static_cast<size_t>((in * interp + decim - 1) / decim);
+    if (out->size() < bound * ch) out->resize(bound * ch);
+    size_t produced = 0;
+    while (frames > 0) {
+      const size_t n = std::min(frames, kChunkFrames);
+      Append(interleaved, n);
+      produced += Run(out->data() + produced * ch);
+      if (interleaved != nullptr) interleaved += n * ch;
+      frames -= n;
+    }
+    out->resize(produced * ch);
+    return produced;
+  }
+};
+
+Resampler::Resampler() : impl_(std::make_unique<Impl>()) {}
+
+Resampler::~Resampler() = default;
+
+bool Resampler::Configure(const ResamplerConfig& config) {
+  Impl& s = *impl_;
+  s.configured = false;
+  if (config.input_rate <= 0 || config.output_rate <= 0 || config.channels <= 0) return false;
+  const int g = std::gcd(config.input_rate, config.output_rate);
+  const int interp = config.output_rate / g;
+  const int decim = config.input_rate / g;
+  const bool sinc = config.quality == ResamplerQuality::kSinc;
+  if (sinc && (interp > kMaxPhases || SincTaps(interp, decim) > kMaxSincTaps)) return false;
+  s.cfg = config;
+  s.interp = interp;
+  s.decim = decim;
+  s.bank = sinc ? GetBank(interp, decim) : nullptr;
+  s.window = sinc ? static_cast<size_t>(s.bank->taps) : 2;
+  s.prefill = sinc ? s.window / 2 - 1 : 0;
+  s.stride = s.window + kChunkFrames;
+  s.planar.assign(s.stride * static_cast<size_t>(config.channels), 0.0f);
+  s.Clear();
+  s.configured = true;
+  return true;
+}
+
+const ResamplerConfig& Resampler::config() const { return impl_->cfg; }
+bool Resampler::configured() const { return impl_->configured; }
+
+size_t Resampler::Process(const float* interleaved, size_t frames, std::vector<float>* out) {
+  Impl& s = *impl_;
+  if (!s.configured || (interleaved == nullptr && frames > 0)) {
+    out->clear();
+    return 0;
+  }
+  return s.Feed(interleaved, frames, out);
+}
+
+size_t Resampler::Flush(std::vector<float>* out) {
+  Impl& s = *impl_;
+  if (!s.configured) {
+    out->clear();
+    return 0;
+  }
+  // sinc 补半个窗口的零，线性补一帧，恰好让最后一个输入参与输出。
+  const size_t produced = s.Feed(nullptr, s.window - s.prefill - 1, out);
+  s.Clear();
+  return produced;
+}
+
+void Resampler::Reset() {
+  if (impl_->configured) impl_->Clear();
+}
+
+int Resampler::interpolation() const { return static_cast<int>(impl_->interp); }
+int Resampler::decimation() const { return static_cast<int>(impl_->decim); }
+
+}  // namespace sw
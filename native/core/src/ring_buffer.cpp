@@ -1,25 +1,340 @@
 #include "ring_buffer.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
 #include <mutex>
 #include <vector>
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#endif
+
 namespace sw {
 
+namespace {
+constexpr size_t kCacheLineSize = 64;
+
+size_t Gcd(size_t a, size_t b) {
+  while (b != 0) {
+    const size_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+// 同一组物理页连续映射两次：[base, base+bytes) 与 [base+bytes, base+2*bytes) 内容一致。
+class MirroredMapping {
+ public:
+  MirroredMapping() = default;
+  ~MirroredMapping() { Reset(); }
+
+  MirroredMapping(const MirroredMapping&) = delete;
+  MirroredMapping& operator=(const MirroredMapping&) = delete;
+
+  static size_t PageSize() {
+#if defined(__linux__)
+    const long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? static_cast<size_t>(page) : 4096;
+#else
+    return 4096;
+#endif
+  }
+
+  bool Map(size_t bytes) {
+    Reset();
+#if defined(__linux__) && defined(SYS_memfd_create)
+    if (bytes == 0 || bytes % PageSize() != 0) {
+      return false;
+    }
+    const int fd = static_cast<int>(syscall(SYS_memfd_create, "sw_ring_buffer", MFD_CLOEXEC));
+    if (fd < 0) {
+      return false;
+    }
+    bool ok = ftruncate(fd, static_cast<off_t>(bytes)) == 0;
+    void* reserve = MAP_FAILED;
+    if (ok) {
+      reserve = mmap(nullptr, bytes * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      ok = reserve != MAP_FAILED;
+    }
+    if (ok) {
+      auto* base = static_cast<char*>(reserve);
+      ok = mmap(base, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+           mmap(base + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) !=
+               MAP_FAILED;
+      if (!ok) {
+        munmap(reserve, bytes * 2);
+      }
+    }
+    close(fd);
+    if (!ok) {
+      return false;
+    }
+    base_ = reserve;
+    bytes_ = bytes;
+    return true;
+#else
+    (void)bytes;
+    return false;
+#endif
+  }
+
+  void Reset() {
+#if defined(__linux__)
+    if (base_) {
+      munmap(base_, bytes_ * 2);
+    }
+#endif
+    base_ = nullptr;
+    bytes_ = 0;
+  }
+
+  float* data() const { return static_cast<float*>(base_); }
+
+ private:
+  void* base_ = nullptr;
+  size_t bytes_ = 0;
+};
+
+}  // namespace
+
+// 读写位置为单调递增的帧计数（对容量取模得到下标）。生产者只写 write_idx，消费者只写
+// read_idx；各自独占缓存行，避免伪共享。
 struct RingBuffer::Impl {
   size_t capacity_frames = 0;
   int channels = 0;
-  size_t read_pos = 0;
-  size_t write_pos = 0;
-  size_t size_frames = 0;
-  std::vector<float> storage;
-  mutable std::mutex mu;
+  RingBufferMode mode = RingBufferMode::kLocked;
+  std::vector<float> storage;  // kContiguous（或镜像映射失败时的回退）。
+  MirroredMapping mirror;
+  float* base = nullptr;        // storage.data() 或镜像映射起点。
+  bool mirrored = false;
+  mutable std::mutex mu;  // kLocked only.
+
+  alignas(kCacheLineSize) std::atomic<uint64_t> write_idx{0};
+  alignas(kCacheLineSize) std::atomic<uint64_t> read_idx{0};
+  uint64_t read_begin = 0;  // 消费者私有：最近一次 ReadRegion 的起点。
+  // kSpsc: Clear() 记录的目标读位置，由消费者在下一次 Read 时应用。
+  alignas(kCacheLineSize) std::atomic<uint64_t> clear_to{0};
+
+  // 阻塞等待：等待方登记水位后在 wait_mu 下检查条件；通知方发布索引后仅在有等待者且达到
+  // 其水位时加锁通知，避免空唤醒。
+  std::mutex wait_mu;
+  std::condition_variable readable_cv;
+  std::condition_variable writable_cv;
+  std::atomic<int> readers_waiting{0};
+  std::atomic<int> writers_waiting{0};
+  std::atomic<size_t> reader_low_water{0};
+  std::atomic<size_t> writer_low_water{0};
+  uint64_t wake_generation = 0;  // guarded by wait_mu.
+
+  struct WaitCounters {
+    std::atomic<uint64_t> waits{0};
+    std::atomic<uint64_t> wakeups{0};
+    std::atomic<uint64_t> timeouts{0};
+    std::atomic<int64_t> wait_ns_total{0};
+    std::atomic<int64_t> wait_ns_max{0};
+  };
+  WaitCounters reader_stats;
+  WaitCounters writer_stats;
+
+  size_t frame_bytes() const { return static_cast<size_t>(channels) * sizeof(float); }
+
+  uint64_t ConsumerReadIndex() {
+    uint64_t r = read_idx.load(std::memory_order_relaxed);
+    const uint64_t target = clear_to.load(std::memory_order_acquire);
+    if (target > r) {
+      r = target;
+      read_idx.store(r, std::memory_order_release);
+      NotifyWriter();
+    }
+    return r;
+  }
+
+  void NotifyReader() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (readers_waiting.load(std::memory_order_relaxed) > 0 &&
+        Readable() >= reader_low_water.load(std::memory_order_relaxed)) {
+      { std::lock_guard<std::mutex> lock(wait_mu); }
+      readable_cv.notify_all();
+    }
+  }
+
+  void NotifyWriter() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writers_waiting.load(std::memory_order_relaxed) > 0 &&
+        Writable() >= writer_low_water.load(std::memory_order_relaxed)) {
+      { std::lock_guard<std::mutex> lock(wait_mu); }
+      writable_cv.notify_all();
+    }
+  }
+
+  template <typename Ready>
+  bool Wait(std::condition_variable& cv, std::atomic<int>& waiting,
+            std::atomic<size_t>& low_water, size_t min_frames, WaitCounters& stats,
+            std::chrono::nanoseconds timeout, Ready ready) {
+    if (ready()) {
+      return true;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + timeout;
+    std::unique_lock<std::mutex> lock(wait_mu);
+    low_water.store(min_frames, std::memory_order_relaxed);
+    waiting.fetch_add(1, std::memory_order_seq_cst);
+    const uint64_t generation = wake_generation;
+    bool ok = ready();
+    if (!ok) {
+      stats.waits.fetch_add(1, std::memory_order_relaxed);
+      while (!ok && generation == wake_generation) {
+        const bool timed_out = cv.wait_until(lock, deadline) == std::cv_status::timeout;
+        stats.wakeups.fetch_add(1, std::memory_order_relaxed);
+        ok = ready();
+        if (timed_out) {
+          if (!ok) stats.timeouts.fetch_add(1, std::memory_order_relaxed);
+          break;
+        }
+      }
+      const int64_t waited_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now() - start)
+                                    .count();
+      stats.wait_ns_total.fetch_add(waited_ns, std::memory_order_relaxed);
+      if (waited_ns > stats.wait_ns_max.load(std::memory_order_relaxed)) {
+        stats.wait_ns_max.store(waited_ns, std::memory_order_relaxed);
+      }
+    }
+    waiting.fetch_sub(1, std::memory_order_seq_cst);
+    return ok;
+  }
+
+  size_t Readable() const {
+    uint64_t r = read_idx.load(std::memory_order_acquire);
+    r = std::max(r, clear_to.load(std::memory_order_acquire));
+    const uint64_t w = write_idx.load(std::memory_order_acquire);
+    return w > r ? static_cast<size_t>(w - r) : 0;
+  }
+
+  size_t Writable() const {
+    const uint64_t w = write_idx.load(std::memory_order_acquire);
+    const uint64_t r = read_idx.load(std::memory_order_acquire);
+    const uint64_t used = w > r ? std::min<uint64_t>(w - r, capacity_frames) : 0;
+    return capacity_frames - static_cast<size_t>(used);
+  }
+
+  // 计算 [start, start + frames) 在存储中的（最多两段）连续区域。
+  RingBufferRegion RegionAt(uint64_t start, size_t frames) {
+    RingBufferRegion region;
+    if (frames == 0) {
+      return region;
+    }
+    const size_t pos = static_cast<size_t>(start % capacity_frames);
+    const size_t ch = static_cast<size_t>(channels);
+    region.data[0] = base + pos * ch;
+    if (mirrored) {
+      // 第二份映射紧随其后，跨尾部的区域仍是一段连续内存。
+      region.frames[0] = frames;
+      return region;
+    }
+    const size_t first = std::min(frames, capacity_frames - pos);
+    region.frames[0] = first;
+    if (frames > first) {
+      region.data[1] = base;
+      region.frames[1] = frames - first;
+    }
+    return region;
+  }
+
+  RingBufferRegion WriteRegion(size_t frames) {
+    const uint64_t w = write_idx.load(std::memory_order_relaxed);
+    const uint64_t r = read_idx.load(std::memory_order_acquire);
+    const size_t free_frames = capacity_frames - static_cast<size_t>(w - r);
+    return RegionAt(w, std::min(frames, free_frames));
+  }
+
+  void PublishWrite(size_t frames) {
+    const uint64_t w = write_idx.load(std::memory_order_relaxed);
+    const uint64_t r = read_idx.load(std::memory_order_acquire);
+    frames = std::min(frames, capacity_frames - static_cast<size_t>(w - r));
+    write_idx.store(w + frames, std::memory_order_release);
+    NotifyReader();
+  }
+
+  RingBufferRegion ReadRegion(size_t frames) {
+    const uint64_t r = ConsumerReadIndex();
+    const uint64_t w = write_idx.load(std::memory_order_acquire);
+    read_begin = r;
+    return RegionAt(r, std::min(frames, static_cast<size_t>(w - r)));
+  }
+
+  void ReleaseRead(size_t frames) {
+    // 若期间发生 Clear（读位置已被推进），以 Clear 为准。
+    const uint64_t r = read_idx.load(std::memory_order_relaxed);
+    if (r != read_begin) {
+      return;
+    }
+    const uint64_t w = write_idx.load(std::memory_order_acquire);
+    frames = std::min(frames, static_cast<size_t>(w - r));
+    read_idx.store(r + frames, std::memory_order_release);
+    NotifyWriter();
+  }
+
+  size_t DoWrite(const float* src, size_t frames) {
+    const RingBufferRegion region = WriteRegion(frames);
+    if (region.total_frames() == 0) {
+      return 0;
+    }
+    const size_t ch = static_cast<size_t>(channels);
+    std::memcpy(region.data[0], src, region.frames[0] * frame_bytes());
+    if (region.frames[1] > 0) {
+      std::memcpy(region.data[1], src + region.frames[0] * ch, region.frames[1] * frame_bytes());
+    }
+    PublishWrite(region.total_frames());
+    return region.total_frames();
+  }
+
+  size_t DoRead(float* dst, size_t frames) {
+    const RingBufferRegion region = ReadRegion(frames);
+    if (region.total_frames() == 0) {
+      return 0;
+    }
+    const size_t ch = static_cast<size_t>(channels);
+    std::memcpy(dst, region.data[0], region.frames[0] * frame_bytes());
+    if (region.frames[1] > 0) {
+      std::memcpy(dst + region.frames[0] * ch, region.data[1], region.frames[1] * frame_bytes());
+    }
+    ReleaseRead(region.total_frames());
+    return region.total_frames();
+  }
 };
 
-RingBuffer::RingBuffer(size_t capacity_frames, int channels) : impl_(std::make_unique<Impl>()) {
+RingBuffer::RingBuffer(size_t capacity_frames, int channels, RingBufferMode mode,
+                       RingBufferLayout layout)
+    : impl_(std::make_unique<Impl>()) {
   impl_->capacity_frames = capacity_frames;
   impl_->channels = std::max(1, channels);
+  impl_->mode = mode;
+  const size_t frame_bytes = impl_->frame_bytes();
+  if (layout == RingBufferLayout::kMirrored && capacity_frames > 0) {
+    // 容量向上取整，使映射大小同时是页大小与帧大小的整数倍。
+    const size_t page = MirroredMapping::PageSize();
+    const size_t frames_per_unit = page / Gcd(page, frame_bytes);
+    const size_t rounded =
+        (capacity_frames + frames_per_unit - 1) / frames_per_unit * frames_per_unit;
+    if (impl_->mirror.Map(rounded * frame_bytes)) {
+      impl_->capacity_frames = rounded;
+      impl_->base = impl_->mirror.data();
+      impl_->mirrored = true;
+      return;
+    }
+  }
   impl_->storage.resize(capacity_frames * static_cast<size_t>(impl_->channels));
+  impl_->base = impl_->storage.data();
 }
 
 RingBuffer::~RingBuffer() = default;
@@ -31,14 +346,24 @@ size_t RingBuffer::capacity_frames() const { return impl_->capacity_frames; }
 
 int RingBuffer::channels() const { return impl_->channels; }
 
+RingBufferMode RingBuffer::mode() const { return impl_->mode; }
+
+bool RingBuffer::mirrored() const { return impl_->mirrored; }
+
 size_t RingBuffer::readable_frames() const {
-  std::lock_guard<std::mutex> lock(impl_->mu);
-  return impl_->size_frames;
+  if (impl_->mode == RingBufferMode::kLocked) {
+    std::lock_guard<std::mutex> lock(impl_->mu);
+    return impl_->Readable();
+  }
+  return impl_->Readable();
 }
 
 size_t RingBuffer::writable_frames() const {
-  std::lock_guard<std::mutex> lock(impl_->mu);
-  return impl_->capacity_frames - impl_->size_frames;
+  if (impl_->mode == RingBufferMode::kLocked) {
+    std::lock_guard<std::mutex> lock(impl_->mu);
+    return impl_->Writable();
+  }
+  return impl_->Writable();
 }
 
 bool RingBuffer::empty() const { return readable_frames() == 0; }
@@ -49,89 +374,125 @@ size_t RingBuffer::Write(const float* interleaved, size_t frames) {
   if (!interleaved || frames == 0 || impl_->capacity_frames == 0) {
     return 0;
   }
-  std::lock_guard<std::mutex> lock(impl_->mu);
-  const size_t writable = impl_->capacity_frames - impl_->size_frames;
-  const size_t to_write = std::min(frames, writable);
-  if (to_write == 0) {
+  if (impl_->mode == RingBufferMode::kLocked) {
+    std::lock_guard<std::mutex> lock(impl_->mu);
+    return impl_->DoWrite(interleaved, frames);
+  }
+  return impl_->DoWrite(interleaved, frames);
+}
+
+size_t RingBuffer::Read(float* interleaved_out, size_t frames) {
+  if (!interleaved_out || frames == 0 || impl_->capacity_frames == 0) {
     return 0;
   }
+  if (impl_->mode == RingBufferMode::kLocked) {
+    std::lock_guard<std::mutex> lock(impl_->mu);
+    return impl_->DoRead(interleaved_out, frames);
+  }
+  return impl_->DoRead(interleaved_out, frames);
+}
 
-  const int ch = impl_->channels;
-  const size_t cap = impl_->capacity_frames;
+RingBufferRegion RingBuffer::BeginWrite(size_t frames) {
+  if (frames == 0 || impl_->capacity_frames == 0) {
+    return {};
+  }
+  if (impl_->mode == RingBufferMode::kLocked) {
+    std::lock_guard<std::mutex> lock(impl_->mu);
+    return impl_->WriteRegion(frames);
+  }
+  return impl_->WriteRegion(frames);
+}
 
-  size_t first = std::min(to_write, cap - impl_->write_pos);
-  for (size_t i = 0; i < first; ++i) {
-    const size_t dst_frame = impl_->write_pos + i;
-    const size_t dst_offset = dst_frame * ch;
-    const size_t src_offset = i * ch;
-    for (int c = 0; c < ch; ++c) {
-      impl_->storage[dst_offset + c] = interleaved[src_offset + c];
-    }
+void RingBuffer::CommitWrite(size_t frames) {
+  if (frames == 0) {
+    return;
+  }
+  if (impl_->mode == RingBufferMode::kLocked) {
+    std::lock_guard<std::mutex> lock(impl_->mu);
+    impl_->PublishWrite(frames);
+    return;
   }
+  impl_->PublishWrite(frames);
+}
 
-  size_t second = to_write - first;
-  if (second > 0) {
-    for (size_t i = 0; i < second; ++i) {
-      const size_t dst_frame = i;
-      const size_t dst_offset = dst_frame * ch;
-      const size_t src_offset = (first + i) * ch;
-      for (int c = 0; c < ch; ++c) {
-        impl_->storage[dst_offset + c] = interleaved[src_offset + c];
-      }
-    }
+RingBufferRegion RingBuffer::BeginRead(size_t frames) {
+  if (frames == 0 || impl_->capacity_frames == 0) {
+    return {};
   }
+  if (impl_->mode == RingBufferMode::kLocked) {
+    std::lock_guard<std::mutex> lock(impl_->mu);
+    return impl_->ReadRegion(frames);
+  }
+  return impl_->ReadRegion(frames);
+}
 
-  impl_->write_pos = (impl_->write_pos + to_write) % cap;
-  impl_->size_frames += to_write;
-  return to_write;
+void RingBuffer::CommitRead(size_t frames) {
+  if (frames == 0) {
+    return;
+  }
+  if (impl_->mode == RingBufferMode::kLocked) {
+    std::lock_guard<std::mutex> lock(impl_->mu);
+    impl_->ReleaseRead(frames);
+    return;
+  }
+  impl_->ReleaseRead(frames);
 }
 
-size_t RingBuffer::Read(float* interleaved_out, size_t frames) {
-  if (!interleaved_out || frames == 0 || impl_->capacity_frames == 0) {
-    return 0;
+void RingBuffer::Clear() {
+  if (impl_->mode == RingBufferMode::kLocked) {
+    std::lock_guard<std::mutex> lock(impl_->mu);
+    const uint64_t w = impl_->write_idx.load(std::memory_order_relaxed);
+    impl_->read_idx.store(w, std::memory_order_relaxed);
+    impl_->clear_to.store(w, std::memory_order_relaxed);
+    impl_->NotifyWriter();
+    return;
   }
-  std::lock_guard<std::mutex> lock(impl_->mu);
-  const size_t readable = impl_->size_frames;
-  const size_t to_read = std::min(frames, readable);
-  if (to_read == 0) {
-    return 0;
+  // 仅记录目标位置（取最大值），由消费者应用，避免与正在进行的 Read 竞争。
+  const uint64_t w = impl_->write_idx.load(std::memory_order_acquire);
+  uint64_t prev = impl_->clear_to.load(std::memory_order_relaxed);
+  while (prev < w &&
+         !impl_->clear_to.compare_exchange_weak(prev, w, std::memory_order_release,
+                                                std::memory_order_relaxed)) {
   }
+}
 
-  const int ch = impl_->channels;
-  const size_t cap = impl_->capacity_frames;
+bool RingBuffer::WaitForReadable(size_t min_frames, std::chrono::nanoseconds timeout) {
+  Impl& s = *impl_;
+  min_frames = std::max<size_t>(1, std::min(min_frames, s.capacity_frames));
+  return s.Wait(s.readable_cv, s.readers_waiting, s.reader_low_water, min_frames, s.reader_stats,
+                timeout, [&] { return s.Readable() >= min_frames; });
+}
 
-  size_t first = std::min(to_read, cap - impl_->read_pos);
-  for (size_t i = 0; i < first; ++i) {
-    const size_t src_frame = impl_->read_pos + i;
-    const size_t src_offset = src_frame * ch;
-    const size_t dst_offset = i * ch;
-    for (int c = 0; c < ch; ++c) {
-      interleaved_out[dst_offset + c] = impl_->storage[src_offset + c];
-    }
-  }
+bool RingBuffer::WaitForWritable(size_t min_frames, std::chrono::nanoseconds timeout) {
+  Impl& s = *impl_;
+  min_frames = std::max<size_t>(1, std::min(min_frames, s.capacity_frames));
+  return s.Wait(s.writable_cv, s.writers_waiting, s.writer_low_water, min_frames, s.writer_stats,
+                timeout, [&] { return s.Writable() >= min_frames; });
+}
 
-  size_t second = to_read - first;
-  if (second > 0) {
-    for (size_t i = 0; i < second; ++i) {
-      const size_t src_frame = i;
-      const size_t src_offset = src_frame * ch;
-      const size_t dst_offset = (first + i) * ch;
-      for (int c = 0; c < ch; ++c) {
-        interleaved_out[dst_offset + c] = impl_->storage[src_offset + c];
-      }
-    }
+void RingBuffer::WakeAll() {
+  {
+    std::lock_guard<std::mutex> lock(impl_->wait_mu);
+    ++impl_->wake_generation;
   }
-
-  impl_->read_pos = (impl_->read_pos + to_read) % cap;
-  impl_->size_frames -= to_read;
-  return to_read;
+  impl_->readable_cv.notify_all();
+  impl_->writable_cv.notify_all();
 }
 
-void RingBuffer::Clear() {
-  std::lock_guard<std::mutex> lock(impl_->mu);
-  impl_->read_pos = 0;
-  impl_->write_pos = 0;
-  impl_->size_frames = 0;
+RingBufferWaitStats RingBuffer::wait_stats() const {
+  const Impl& s = *impl_;
+  RingBufferWaitStats out;
+  out.reader_waits = s.reader_stats.waits.load(std::memory_order_relaxed);
+  out.reader_wakeups = s.reader_stats.wakeups.load(std::memory_order_relaxed);
+  out.reader_timeouts = s.reader_stats.timeouts.load(std::memory_order_relaxed);
+  out.reader_wait_ns_total = s.reader_stats.wait_ns_total.load(std::memory_order_relaxed);
+  out.reader_wait_ns_max = s.reader_stats.wait_ns_max.load(std::memory_order_relaxed);
+  out.writer_waits = s.writer_stats.waits.load(std::memory_order_relaxed);
+  out.writer_wakeups = s.writer_stats.wakeups.load(std::memory_order_relaxed);
+  out.writer_timeouts = s.writer_stats.timeouts.load(std::memory_order_relaxed);
+  out.writer_wait_ns_total = s.writer_stats.wait_ns_total.load(std::memory_order_relaxed);
+  out.writer_wait_ns_max = s.writer_stats.wait_ns_max.load(std::memory_order_relaxed);
+  return out;
 }
 
 }  // namespace sw
@@ -0,0 +1,1319 @@
+#include "simd_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SW_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+// 仅 aarch64：armv7 NEON 没有 vsqrtq_f32，且移动端 32 位目标走标量即可。
+#define SW_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// AVX2 内核以函数级 target 属性编译，库其余部分仍保持 SSE2 基线，旧 CPU 上不会误执行。
+#if defined(SW_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SW_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SW_TARGET_AVX2
+#endif
+
+// LPC 递推的内层点积很短，且刚写回的样本下一步就要读：GCC -O3 自动向量化后每个样本都会
+// 撞上 store-forwarding 失败，实测比不向量化慢 2~3 倍。这几个函数单独关掉自动向量化。
+#if defined(__GNUC__) && !defined(__clang__)
+#define SW_NO_AUTOVEC __attribute__((optimize("no-tree-vectorize")))
+#else
+#define SW_NO_AUTOVEC
+#endif
+
+namespace sw {
+namespace {
+
+// 快速 log：x = m · 2^e，m ∈ [√½, √2)，ln m = 2·atanh(t)，t = (m-1)/(m+1) ∈ [-0.172, 0.172]，
+// 取级数前四项（截断误差 ~3e-8）。各 SIMD 版本逐条对应此标量实现。
+constexpr float kLn2 = 0.69314718056f;
+constexpr float kInvLn10 = 0.43429448190f;
+constexpr float kSqrt2 = 1.41421356237f;
+constexpr float kMinPositive = 1e-30f;  // 0 与负数先钳到此值（≈ -300 dB），再由 floor 截断。
+
+// min/max/Σx² 归约按编译期声道数展开的上限（覆盖到 7.1）。
+constexpr int kMaxReduceChannels = 8;
+using MinMaxSumSqFixedFn = void (*)(const float*, size_t, float*, float*, float*);
+
+// 整型 PCM → float 的满量程系数（均为 2 的幂，SIMD 与标量结果逐位一致）。24 位样本先放到
+// int32 的高 24 位，与 32 位共用 2^-31。
+constexpr float kS16Scale = 1.0f / 32768.0f;
+constexpr float kS32Scale = 1.0f / 2147483648.0f;
+
+// LPC 还原走向量分块的最低阶数（flac_decode_bench 实测：4 阶以下标量递推更快）。NEON 未实测，
+// 沿用 SSE2 的取值。
+constexpr int kLpcSimdMinOrderSse2 = 6;
+constexpr int kLpcSimdMinOrderAvx2 = 6;
+constexpr int kLpcSimdMinOrderNeon = 6;
+
+inline float FastLn(float x) {
+  uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  int e = static_cast<int>((bits >> 23) & 0xffu) - 127;
+  bits = (bits & 0x007fffffu) | 0x3f800000u;
+  float m;
+  std::memcpy(&m, &bits, sizeof(m));
+  if (m > kSqrt2) {
+    m *= 0.5f;
+    ++e;
+  }
+  const float t = (m - 1.0f) / (m + 1.0f);
+  const float t2 = t * t;
+  const float series = 1.0f + t2 * (1.0f / 3.0f + t2 * (1.0f / 5.0f + t2 * (1.0f / 7.0f)));
+  return 2.0f * t * series + static_cast<float>(e) * kLn2;
+}
+
+// ---- 标量实现（所有平台的回退，也负责 SIMD 循环的尾部） ----
+
+void MultiplyScalar(const float* a, const float* b, float* out, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = a[i] * b[i];
+  }
+}
+
+void DownmixScalar(const float* interleaved, size_t frames, int channels, float scale,
+                   float* out) {
+  const size_t ch = static_cast<size_t>(channels);
+  for (size_t i = 0; i < frames; ++i) {
+    const float* frame = interleaved + i * ch;
+    float sum = 0.0f;
+    for (size_t c = 0; c < ch; ++c) {
+      sum += frame[c];
+    }
+    out[i] = sum * scale;
+  }
+}
+
+void PowerScalar(const float* complex, size_t bins, float scale, float* out) {
+  for (size_t k = 0; k < bins; ++k) {
+    const float re = complex[2 * k];
+    const float im = complex[2 * k + 1];
+    out[k] = (re * re + im * im) * scale;
+  }
+}
+
+void MagnitudeScalar(const float* complex, size_t bins, float scale, float* out) {
+  for (size_t k = 0; k < bins; ++k) {
+    const float re = complex[2 * k];
+    const float im = complex[2 * k + 1];
+    out[k] = std::sqrt(re * re + im * im) * scale;
+  }
+}
+
+void DecibelsScalar(const float* in, size_t n, float db_per_decade, float floor_db,
+                    float* out) {
+  const float scale = db_per_decade * kInvLn10;
+  for (size_t i = 0; i < n; ++i) {
+    const float x = in[i] > kMinPositive ? in[i] : kMinPositive;  // NaN 也落到此分支
+    const float db = scale * FastLn(x);
+    out[i] = db > floor_db ? db : floor_db;
+  }
+}
+
+void MinMaxSumSqBegin(size_t channels, float* out_min, float* out_max, float* out_sumsq) {
+  for (size_t c = 0; c < channels; ++c) {
+    out_min[c] = std::numeric_limits<float>::infinity();
+    out_max[c] = -std::numeric_limits<float>::infinity();
+    out_sumsq[c] = 0.0f;
+  }
+}
+
+// 在已有结果上继续累积（SIMD 路径的尾部也走这里）。
+void MinMaxSumSqAccumulate(const float* interleaved, size_t frames, size_t channels,
+                           float* out_min, float* out_max, float* out_sumsq) {
+  for (size_t i = 0; i < frames; ++i) {
+    const float* frame = interleaved + i * channels;
+    for (size_t c = 0; c < channels; ++c) {
+      const float v = frame[c];
+      out_min[c] = v < out_min[c] ? v : out_min[c];
+      out_max[c] = v > out_max[c] ? v : out_max[c];
+      out_sumsq[c] += v * v;
+    }
+  }
+}
+
+void MinMaxSumSqEnd(size_t frames, size_t channels, float* out_min, float* out_max) {
+  if (frames > 0) return;
+  for (size_t c = 0; c < channels; ++c) {
+    out_min[c] = 0.0f;
+    out_max[c] = 0.0f;
+  }
+}
+
+void MinMaxSumSqScalar(const float* interleaved, size_t frames, int channels, float* out_min,
+                       float* out_max, float* out_sumsq) {
+  if (channels <= 0) return;
+  const size_t ch = static_cast<size_t>(channels);
+  MinMaxSumSqBegin(ch, out_min, out_max, out_sumsq);
+  MinMaxSumSqAccumulate(interleaved, frames, ch, out_min, out_max, out_sumsq);
+  MinMaxSumSqEnd(frames, ch, out_min, out_max);
+}
+
+// 输入来自文件映射，可能不按样本对齐：一律按字节读取（小端）。
+void S16ToFloatScalar(const void* in, size_t n, float* out) {
+  const uint8_t* p = static_cast<const uint8_t*>(in);
+  for (size_t i = 0; i < n; ++i) {
+    const int16_t v = static_cast<int16_t>(p[2 * i] | (p[2 * i + 1] << 8));
+    out[i] = static_cast<float>(v) * kS16Scale;
+  }
+}
+
+void S24ToFloatScalar(const void* in, size_t n, float* out) {
+  const uint8_t* p = static_cast<const uint8_t*>(in);
+  for (size_t i = 0; i < n; ++i) {
+    const uint32_t bits = (uint32_t{p[3 * i]} << 8) | (uint32_t{p[3 * i + 1]} << 16) |
+                          (uint32_t{p[3 * i + 2]} << 24);
+    out[i] = static_cast<float>(static_cast<int32_t>(bits)) * kS32Scale;
+  }
+}
+
+void S32ToFloatScalar(const void* in, size_t n, float* out) {
+  const uint8_t* p = static_cast<const uint8_t*>(in);
+  for (size_t i = 0; i < n; ++i) {
+    const uint32_t bits = uint32_t{p[4 * i]} | (uint32_t{p[4 * i + 1]} << 8) |
+                          (uint32_t{p[4 * i + 2]} << 16) | (uint32_t{p[4 * i + 3]} << 24);
+    out[i] = static_cast<float>(static_cast<int32_t>(bits)) * kS32Scale;
+  }
+}
+
+// LPC 按 uint32 回绕累加：合法码流的预测值不会溢出，损坏码流也只得到错误样本而不是未定义行为。
+SW_NO_AUTOVEC inline void LpcRestoreOne(int32_t* s, const int32_t* coefs, int order, int shift,
+                                        uint32_t sum) {
+  for (int j = 0; j < order; ++j) {
+    sum += static_cast<uint32_t>(coefs[j]) * static_cast<uint32_t>(s[-j - 1]);
+  }
+  *s = static_cast<int32_t>(static_cast<uint32_t>(*s) +
+                            static_cast<uint32_t>(static_cast<int32_t>(sum) >> shift));
+}
+
+SW_NO_AUTOVEC void LpcRestoreScalar(int32_t* samples, size_t n, const int32_t* coefs, int order,
+                                    int shift) {
+  for (size_t i = 0; i < n; ++i) {
+    LpcRestoreOne(samples + i, coefs, order, shift, 0);
+  }
+}
+
+// ---- LPC 还原（SSE2/AVX2/NEON 共用的分块思路） ----
+// 递推本身是串行的，但一块 W 个输出里，每个输出的预测和可以拆成两部分：引用块前历史的项
+// （与块内结果无关，W 路并行）和引用块内更早输出的项（串行补齐）。向量部分按系数 j 累加
+// coefs[j] · samples[i + t - j - 1]，t > j 的 lane 引用的是尚未还原的块内残差，用掩码清零；
+// 之后逐个 t 补上 j < t 的项再右移累加。每块串行开销 W(W-1)/2 次乘加，与阶数无关，阶数低时
+// 不划算，低于 kLpcSimdMinOrder* 的直接走标量。
+constexpr int kLpcMaxOrder = 32;
+
+template <int W>
+SW_NO_AUTOVEC inline void LpcFixupBlock(int32_t* s, const int32_t* partial, const int32_t* coefs,
+                                        int order, int shift) {
+  for (int t = 0; t < W; ++t) {
+    LpcRestoreOne(s + t, coefs, std::min(t, order), shift, static_cast<uint32_t>(partial[t]));
+  }
+}
+
+template <StereoDecorrelation M>
+inline void Decorrelate(int32_t a, int32_t b, int32_t* l, int32_t* r) {
+  switch (M) {
+    case StereoDecorrelation::kIndependent:
+      *l = a;
+      *r = b;
+      break;
+    case StereoDecorrelation::kLeftSide:
+      *l = a;
+      *r = a - b;
+      break;
+    case StereoDecorrelation::kSideRight:
+      *l = a + b;
+      *r = b;
+      break;
+    case StereoDecorrelation::kMidSide: {
+      const int32_t mid = static_cast<int32_t>(static_cast<uint32_t>(a) << 1) | (b & 1);
+      *l = (mid + b) >> 1;
+      *r = (mid - b) >> 1;
+      break;
+    }
+  }
+}
+
+template <StereoDecorrelation M>
+void StereoToFloatScalarT(const int32_t* a, const int32_t* b, size_t n, float scale, float* out) {
+  for (size_t i = 0; i < n; ++i) {
+    int32_t l;
+    int32_t r;
+    Decorrelate<M>(a[i], b[i], &l, &r);
+    out[2 * i] = static_cast<float>(l) * scale;
+    out[2 * i + 1] = static_cast<float>(r) * scale;
+  }
+}
+
+// 去相关方式在整块上不变：分派到按 mode 实例化的循环，内层没有分支。
+template <template <StereoDecorrelation> class Fn>
+void DispatchStereo(const int32_t* a, const int32_t* b, size_t n, StereoDecorrelation mode,
+                    float scale, float* out) {
+  switch (mode) {
+    case StereoDecorrelation::kIndependent:
+      Fn<StereoDecorrelation::kIndependent>::Run(a, b, n, scale, out);
+      break;
+    case StereoDecorrelation::kLeftSide:
+      Fn<StereoDecorrelation::kLeftSide>::Run(a, b, n, scale, out);
+      break;
+    case StereoDecorrelation::kSideRight:
+      Fn<StereoDecorrelation::kSideRight>::Run(a, b, n, scale, out);
+      break;
+    case StereoDecorrelation::kMidSide:
+      Fn<StereoDecorrelation::kMidSide>::Run(a, b, n, scale, out);
+      break;
+  }
+}
+
+template <StereoDecorrelation M>
+struct StereoScalarFn {
+  static void Run(const int32_t* a, const int32_t* b, size_t n, float scale, float* out) {
+    StereoToFloatScalarT<M>(a, b, n, scale, out);
+  }
+};
+
+void StereoToFloatScalar(const int32_t* a, const int32_t* b, size_t n, StereoDecorrelation mode,
+                         float scale, float* out) {
+  DispatchStereo<StereoScalarFn>(a, b, n, mode, scale, out);
+}
+
+// 四路部分和：与向量实现的累加顺序接近，也让编译器不必保持严格的串行依赖。
+float DotScalar(const float* a, const float* b, size_t n) {
+  float s0 = 0.0f;
+  float s1 = 0.0f;
+  float s2 = 0.0f;
+  float s3 = 0.0f;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    s0 += a[i] * b[i];
+    s1 += a[i + 1] * b[i + 1];
+    s2 += a[i + 2] * b[i + 2];
+    s3 += a[i + 3] * b[i + 3];
+  }
+  for (; i < n; ++i) s0 += a[i] * b[i];
+  return (s0 + s1) + (s2 + s3);
+}
+
+constexpr SimdKernels kScalarKernels{SimdLevel::kScalar, &MultiplyScalar, &DownmixScalar,
+                                     &PowerScalar, &MagnitudeScalar, &DecibelsScalar,
+                                     &MinMaxSumSqScalar, &S16ToFloatScalar, &S24ToFloatScalar,
+                                     &S32ToFloatScalar, &LpcRestoreScalar, &StereoToFloatScalar,
+                                     &DotScalar};
+
+#if defined(SW_SIMD_X86)
+
+// ---- SSE2（x86-64 基线） ----
+
+void MultiplySse2(const float* a, const float* b, float* out, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+  }
+  MultiplyScalar(a + i, b + i, out + i, n - i);
+}
+
+void DownmixSse2(const float* interleaved, size_t frames, int channels, float scale,
+                 float* out) {
+  const __m128 vscale = _mm_set1_ps(scale);
+  size_t i = 0;
+  if (channels == 1) {
+    for (; i + 4 <= frames; i += 4) {
+      _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(interleaved + i), vscale));
+    }
+  } else if (channels == 2) {
+    for (; i + 4 <= frames; i += 4) {
+      const __m128 a = _mm_loadu_ps(interleaved + 2 * i);      // L0 R0 L1 R1
+      const __m128 b = _mm_loadu_ps(interleaved + 2 * i + 4);  // L2 R2 L3 R3
+      const __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+      const __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+      _mm_storeu_ps(out + i, _mm_mul_ps(_mm_add_ps(left, right), vscale));
+    }
+  }
+  DownmixScalar(interleaved + i * static_cast<size_t>(channels), frames - i, channels, scale,
+                out + i);
+}
+
+template <bool kSqrt>
+void SquaredMagnitudeSse2(const float* complex, size_t bins, float scale, float* out) {
+  const __m128 vscale = _mm_set1_ps(scale);
+  size_t k = 0;
+  for (; k + 4 <= bins; k += 4) {
+    const __m128 a = _mm_loadu_ps(complex + 2 * k);      // r0 i0 r1 i1
+    const __m128 b = _mm_loadu_ps(complex + 2 * k + 4);  // r2 i2 r3 i3
+    const __m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    __m128 mag2 = _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+    if (kSqrt) mag2 = _mm_sqrt_ps(mag2);
+    _mm_storeu_ps(out + k, _mm_mul_ps(mag2, vscale));
+  }
+  if (kSqrt) {
+    MagnitudeScalar(complex + 2 * k, bins - k, scale, out + k);
+  } else {
+    PowerScalar(complex + 2 * k, bins - k, scale, out + k);
+  }
+}
+
+void PowerSse2(const float* complex, size_t bins, float scale, float* out) {
+  SquaredMagnitudeSse2<false>(complex, bins, scale, out);
+}
+
+void MagnitudeSse2(const float* complex, size_t bins, float scale, float* out) {
+  SquaredMagnitudeSse2<true>(complex, bins, scale, out);
+}
+
+inline __m128 FastLnSse2(__m128 x) {
+  const __m128i bits = _mm_castps_si128(x);
+  __m128i e = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+  __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)),
+                                           _mm_set1_epi32(0x3f800000)));
+  const __m128 big = _mm_cmpgt_ps(m, _mm_set1_ps(kSqrt2));
+  m = _mm_or_ps(_mm_and_ps(big, _mm_mul_ps(m, _mm_set1_ps(0.5f))), _mm_andnot_ps(big, m));
+  e = _mm_sub_epi32(e, _mm_castps_si128(big));  // 掩码为 -1，减去即 +1
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 t = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+  const __m128 t2 = _mm_mul_ps(t, t);
+  __m128 series = _mm_add_ps(_mm_set1_ps(1.0f / 5.0f), _mm_mul_ps(t2, _mm_set1_ps(1.0f / 7.0f)));
+  series = _mm_add_ps(_mm_set1_ps(1.0f / 3.0f), _mm_mul_ps(t2, series));
+  series = _mm_add_ps(one, _mm_mul_ps(t2, series));
+  return _mm_add_ps(_mm_mul_ps(_mm_add_ps(t, t), series),
+                    _mm_mul_ps(_mm_cvtepi32_ps(e), _mm_set1_ps(kLn2)));
+}
+
+void DecibelsSse2(const float* in, size_t n, float db_per_decade, float floor_db, float* out) {
+  const __m128 scale = _mm_set1_ps(db_per_decade * kInvLn10);
+  const __m128 floor = _mm_set1_ps(floor_db);
+  const __m128 min_positive = _mm_set1_ps(kMinPositive);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    // maxps 在任一操作数为 NaN 时返回第二个操作数，因此 NaN 也被钳到 kMinPositive。
+    const __m128 x = _mm_max_ps(_mm_loadu_ps(in + i), min_positive);
+    _mm_storeu_ps(out + i, _mm_max_ps(_mm_mul_ps(scale, FastLnSse2(x)), floor));
+  }
+  DecibelsScalar(in + i, n - i, db_per_decade, floor_db, out + i);
+}
+
+// C 整除 4 时 lane l 恒属于声道 l % C：在寄存器内对折到 C 个 lane 后写出，避免逐 lane 合并
+// （桶很小时归约开销占主导）。
+template <int C>
+inline void FoldToChannelsSse2(__m128 vmin, __m128 vmax, __m128 vsum, float* out_min,
+                               float* out_max, float* out_sumsq) {
+  static_assert(4 % C == 0, "lanes must map to channels");
+  if (C <= 2) {
+    vmin = _mm_min_ps(vmin, _mm_movehl_ps(vmin, vmin));
+    vmax = _mm_max_ps(vmax, _mm_movehl_ps(vmax, vmax));
+    vsum = _mm_add_ps(vsum, _mm_movehl_ps(vsum, vsum));
+  }
+  if (C == 1) {
+    vmin = _mm_min_ss(vmin, _mm_shuffle_ps(vmin, vmin, 1));
+    vmax = _mm_max_ss(vmax, _mm_shuffle_ps(vmax, vmax, 1));
+    vsum = _mm_add_ss(vsum, _mm_shuffle_ps(vsum, vsum, 1));
+  }
+  alignas(16) float lanes[3][4];
+  _mm_store_ps(lanes[0], vmin);
+  _mm_store_ps(lanes[1], vmax);
+  _mm_store_ps(lanes[2], vsum);
+  for (int c = 0; c < C; ++c) {
+    out_min[c] = lanes[0][c];
+    out_max[c] = lanes[1][c];
+    out_sumsq[c] = lanes[2][c];
+  }
+}
+
+// 其余声道数：lane 与声道的对应随向量变化，逐 lane 合并。
+template <int C>
+inline void MergeLanes(const float (*lanes)[4], int j, float* out_min, float* out_max,
+                       float* out_sumsq) {
+  for (int l = 0; l < 4; ++l) {
+    const int c = (4 * j + l) % C;
+    out_min[c] = std::min(out_min[c], lanes[0][l]);
+    out_max[c] = std::max(out_max[c], lanes[1][l]);
+    out_sumsq[c] += lanes[2][l];
+  }
+}
+
+// 每次处理 C 个向量 = 4 帧：第 j 个向量的第 l 个 lane 属于声道 (4j + l) % C，各向量独立累积，
+// 最后按声道合并 lane。min/max 把新样本放在第一个操作数，NaN 样本因此不会污染累积值。
+template <int C>
+void MinMaxSumSqSse2T(const float* interleaved, size_t frames, float* out_min, float* out_max,
+                      float* out_sumsq) {
+  __m128 vmin[C];
+  __m128 vmax[C];
+  __m128 vsum[C];
+  for (int j = 0; j < C; ++j) {
+    vmin[j] = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    vmax[j] = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+    vsum[j] = _mm_setzero_ps();
+  }
+  size_t i = 0;
+  for (; i + 4 <= frames; i += 4) {
+    const float* block = interleaved + i * C;
+    for (int j = 0; j < C; ++j) {
+      const __m128 v = _mm_loadu_ps(block + 4 * j);
+      vmin[j] = _mm_min_ps(v, vmin[j]);
+      vmax[j] = _mm_max_ps(v, vmax[j]);
+      vsum[j] = _mm_add_ps(vsum[j], _mm_mul_ps(v, v));
+    }
+  }
+  if constexpr (4 % C == 0) {
+    for (int j = 1; j < C; ++j) {  // 各向量 lane 布局相同，先逐元素合并
+      vmin[0] = _mm_min_ps(vmin[0], vmin[j]);
+      vmax[0] = _mm_max_ps(vmax[0], vmax[j]);
+      vsum[0] = _mm_add_ps(vsum[0], vsum[j]);
+    }
+    FoldToChannelsSse2<C>(vmin[0], vmax[0], vsum[0], out_min, out_max, out_sumsq);
+  } else {
+    MinMaxSumSqBegin(C, out_min, out_max, out_sumsq);
+    alignas(16) float lanes[3][4];
+    for (int j = 0; j < C; ++j) {
+      _mm_store_ps(lanes[0], vmin[j]);
+      _mm_store_ps(lanes[1], vmax[j]);
+      _mm_store_ps(lanes[2], vsum[j]);
+      MergeLanes<C>(lanes, j, out_min, out_max, out_sumsq);
+    }
+  }
+  MinMaxSumSqAccumulate(interleaved + i * C, frames - i, C, out_min, out_max, out_sumsq);
+  MinMaxSumSqEnd(frames, C, out_min, out_max);
+}
+
+constexpr MinMaxSumSqFixedFn kMinMaxSumSqSse2[kMaxReduceChannels] = {
+    &MinMaxSumSqSse2T<1>, &MinMaxSumSqSse2T<2>, &MinMaxSumSqSse2T<3>, &MinMaxSumSqSse2T<4>,
+    &MinMaxSumSqSse2T<5>, &MinMaxSumSqSse2T<6>, &MinMaxSumSqSse2T<7>, &MinMaxSumSqSse2T<8>};
+
+void MinMaxSumSqSse2(const float* interleaved, size_t frames, int channels, float* out_min,
+                     float* out_max, float* out_sumsq) {
+  if (channels < 1 || channels > kMaxReduceChannels) {
+    MinMaxSumSqScalar(interleaved, frames, channels, out_min, out_max, out_sumsq);
+    return;
+  }
+  kMinMaxSumSqSse2[channels - 1](interleaved, frames, out_min, out_max, out_sumsq);
+}
+
+void S16ToFloatSse2(const void* in, size_t n, float* out) {
+  const uint8_t* p = static_cast<const uint8_t*>(in);
+  const __m128 scale = _mm_set1_ps(kS16Scale);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 2 * i));
+    // 复制到 32 位的高半部再算术右移，完成符号扩展。
+    const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+    const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+  }
+  S16ToFloatScalar(p + 2 * i, n - i, out + i);
+}
+
+void S32ToFloatSse2(const void* in, size_t n, float* out) {
+  const uint8_t* p = static_cast<const uint8_t*>(in);
+  const __m128 scale = _mm_set1_ps(kS32Scale);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 4 * i));
+    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+  }
+  S32ToFloatScalar(p + 4 * i, n - i, out + i);
+}
+
+// SSE2 没有 32 位低位乘法（pmulld 是 SSE4.1）：用两次 pmuludq 拼出来，c 为广播值。
+inline __m128i MulLo32Sse2(__m128i a, __m128i c) {
+  const __m128i even = _mm_mul_epu32(a, c);
+  const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), c);
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+SW_NO_AUTOVEC void LpcRestoreSse2(int32_t* samples, size_t n, const int32_t* coefs, int order,
+                                  int shift) {
+  if (order < kLpcSimdMinOrderSse2) {
+    LpcRestoreScalar(samples, n, coefs, order, shift);
+    return;
+  }
+  __m128i c[kLpcMaxOrder];
+  for (int j = 0; j < order; ++j) c[j] = _mm_set1_epi32(coefs[j]);
+  // mask[j]：lane t <= j 有效。
+  const __m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+  const __m128i mask[3] = {_mm_cmplt_epi32(lane, _mm_set1_epi32(1)),
+                           _mm_cmplt_epi32(lane, _mm_set1_epi32(2)),
+                           _mm_cmplt_epi32(lane, _mm_set1_epi32(3))};
+  alignas(16) int32_t partial[4];
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    int32_t* s = samples + i;
+    __m128i acc = _mm_setzero_si128();
+    int j = 0;
+    for (; j < std::min(order, 3); ++j) {
+      const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s - j - 1));
+      acc = _mm_add_epi32(acc, _mm_and_si128(MulLo32Sse2(h, c[j]), mask[j]));
+    }
+    for (; j < order; ++j) {
+      const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s - j - 1));
+      acc = _mm_add_epi32(acc, MulLo32Sse2(h, c[j]));
+    }
+    _mm_store_si128(reinterpret_cast<__m128i*>(partial), acc);
+    LpcFixupBlock<4>(s, partial, coefs, order, shift);
+  }
+  LpcRestoreScalar(samples + i, n - i, coefs, order, shift);
+}
+
+template <StereoDecorrelation M>
+inline void DecorrelateSse2(__m128i a, __m128i b, __m128i* l, __m128i* r) {
+  switch (M) {
+    case StereoDecorrelation::kIndependent:
+      *l = a;
+      *r = b;
+      break;
+    case StereoDecorrelation::kLeftSide:
+      *l = a;
+      *r = _mm_sub_epi32(a, b);
+      break;
+    case StereoDecorrelation::kSideRight:
+      *l = _mm_add_epi32(a, b);
+      *r = b;
+      break;
+    case StereoDecorrelation::kMidSide: {
+      const __m128i mid =
+          _mm_or_si128(_mm_slli_epi32(a, 1), _mm_and_si128(b, _mm_set1_epi32(1)));
+      *l = _mm_srai_epi32(_mm_add_epi32(mid, b), 1);
+      *r = _mm_srai_epi32(_mm_sub_epi32(mid, b), 1);
+      break;
+    }
+  }
+}
+
+template <StereoDecorrelation M>
+struct StereoSse2Fn {
+  static void Run(const int32_t* a, const int32_t* b, size_t n, float scale, float* out) {
+    const __m128 vscale = _mm_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      __m128i l;
+      __m128i r;
+      DecorrelateSse2<M>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)), &l, &r);
+      const __m128 lf = _mm_mul_ps(_mm_cvtepi32_ps(l), vscale);
+      const __m128 rf = _mm_mul_ps(_mm_cvtepi32_ps(r), vscale);
+      _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(lf, rf));
+      _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(lf, rf));
+    }
+    StereoToFloatScalarT<M>(a + i, b + i, n - i, scale, out + 2 * i);
+  }
+};
+
+void StereoToFloatSse2(const int32_t* a, const int32_t* b, size_t n, StereoDecorrelation mode,
+                       float scale, float* out) {
+  DispatchStereo<StereoSse2Fn>(a, b, n, mode, scale, out);
+}
+
+float HorizontalSumSse2(__m128 v) {
+  v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 0x55));
+  return _mm_cvtss_f32(v);
+}
+
+float DotSse2(const float* a, const float* b, size_t n) {
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  if (i + 4 <= n) {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    i += 4;
+  }
+  float sum = HorizontalSumSse2(_mm_add_ps(acc0, acc1));
+  for (; i < n; ++i) sum += a[i] * b[i];
+  return sum;
+}
+
+// 24 位解包需要字节级 shuffle（SSSE3 起才有），SSE2 基线直接用标量。
+constexpr SimdKernels kSse2Kernels{SimdLevel::kSse2, &MultiplySse2, &DownmixSse2, &PowerSse2,
+                                   &MagnitudeSse2, &DecibelsSse2, &MinMaxSumSqSse2,
+                                   &S16ToFloatSse2, &S24ToFloatScalar, &S32ToFloatSse2,
+                                   &LpcRestoreSse2, &StereoToFloatSse2, &DotSse2};
+
+// ---- AVX2 ----
+// 尾部交给非 VEX 编码的 SSE2 实现前必须 vzeroupper：编译器对尾调用不会自动插入，
+// 脏的高 128 位会让随后的 SSE 指令付出状态切换代价。
+
+// 256 位 shuffle 只在各自 128 位 lane 内进行：把 (q0 q1 q2 q3) 的 64 位块重排为 (q0 q2 q1 q3)
+// 恢复顺序。
+SW_TARGET_AVX2 inline __m256 FixLaneOrder(__m256 v) {
+  return _mm256_castpd_ps(
+      _mm256_permute4x64_pd(_mm256_castps_pd(v), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+SW_TARGET_AVX2 void MultiplyAvx2(const float* a, const float* b, float* out, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+  }
+  _mm256_zeroupper();
+  MultiplySse2(a + i, b + i, out + i, n - i);
+}
+
+SW_TARGET_AVX2 void DownmixAvx2(const float* interleaved, size_t frames, int channels,
+                                float scale, float* out) {
+  const __m256 vscale = _mm256_set1_ps(scale);
+  size_t i = 0;
+  if (channels == 1) {
+    for (; i + 8 <= frames; i += 8) {
+      _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(interleaved + i), vscale));
+    }
+  } else if (channels == 2) {
+    for (; i + 8 <= frames; i += 8) {
+      const __m256 a = _mm256_loadu_ps(interleaved + 2 * i);
+      const __m256 b = _mm256_loadu_ps(interleaved + 2 * i + 8);
+      const __m256 left = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+      const __m256 right = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+      const __m256 sum = FixLaneOrder(_mm256_add_ps(left, right));
+      _mm256_storeu_ps(out + i, _mm256_mul_ps(sum, vscale));
+    }
+  }
+  _mm256_zeroupper();
+  DownmixSse2(interleaved + i * static_cast<size_t>(channels), frames - i, channels, scale,
+              out + i);
+}
+
+template <bool kSqrt>
+SW_TARGET_AVX2 void SquaredMagnitudeAvx2(const float* complex, size_t bins, float scale,
+                                         float* out) {
+  const __m256 vscale = _mm256_set1_ps(scale);
+  size_t k = 0;
+  for (; k + 8 <= bins; k += 8) {
+    const __m256 a = _mm256_loadu_ps(complex + 2 * k);
+    const __m256 b = _mm256_loadu_ps(complex + 2 * k + 8);
+    const __m256 re = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m256 im = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    __m256 mag2 = _mm256_add_ps(_mm256_mul_ps(re, re), _mm256_mul_ps(im, im));
+    if (kSqrt) mag2 = _mm256_sqrt_ps(mag2);
+    _mm256_storeu_ps(out + k, _mm256_mul_ps(FixLaneOrder(mag2), vscale));
+  }
+  _mm256_zeroupper();
+  SquaredMagnitudeSse2<kSqrt>(complex + 2 * k, bins - k, scale, out + k);
+}
+
+SW_TARGET_AVX2 void PowerAvx2(const float* complex, size_t bins, float scale, float* out) {
+  SquaredMagnitudeAvx2<false>(complex, bins, scale, out);
+}
+
+SW_TARGET_AVX2 void MagnitudeAvx2(const float* complex, size_t bins, float scale, float* out) {
+  SquaredMagnitudeAvx2<true>(complex, bins, scale, out);
+}
+
+SW_TARGET_AVX2 inline __m256 FastLnAvx2(__m256 x) {
+  const __m256i bits = _mm256_castps_si256(x);
+  __m256i e = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127));
+  __m256 m = _mm256_castsi256_ps(_mm256_or_si256(
+      _mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f800000)));
+  const __m256 big = _mm256_cmp_ps(m, _mm256_set1_ps(kSqrt2), _CMP_GT_OQ);
+  m = _mm256_blendv_ps(m, _mm256_mul_ps(m, _mm256_set1_ps(0.5f)), big);
+  e = _mm256_sub_epi32(e, _mm256_castps_si256(big));
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 t = _mm256_div_ps(_mm256_sub_ps(m, one), _mm256_add_ps(m, one));
+  const __m256 t2 = _mm256_mul_ps(t, t);
+  __m256 series =
+      _mm256_add_ps(_mm256_set1_ps(1.0f / 5.0f), _mm256_mul_ps(t2, _mm256_set1_ps(1.0f / 7.0f)));
+  series = _mm256_add_ps(_mm256_set1_ps(1.0f / 3.0f), _mm256_mul_ps(t2, series));
+  series = _mm256_add_ps(one, _mm256_mul_ps(t2, series));
+  return _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(t, t), series),
+                       _mm256_mul_ps(_mm256_cvtepi32_ps(e), _mm256_set1_ps(kLn2)));
+}
+
+SW_TARGET_AVX2 void DecibelsAvx2(const float* in, size_t n, float db_per_decade, float floor_db,
+                                 float* out) {
+  const __m256 scale = _mm256_set1_ps(db_per_decade * kInvLn10);
+  const __m256 floor = _mm256_set1_ps(floor_db);
+  const __m256 min_positive = _mm256_set1_ps(kMinPositive);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256 x = _mm256_max_ps(_mm256_loadu_ps(in + i), min_positive);
+    _mm256_storeu_ps(out + i, _mm256_max_ps(_mm256_mul_ps(scale, FastLnAvx2(x)), floor));
+  }
+  _mm256_zeroupper();
+  DecibelsSse2(in + i, n - i, db_per_decade, floor_db, out + i);
+}
+
+// 同 SSE2 版本，每次 C 个向量 = 8 帧。
+template <int C>
+SW_TARGET_AVX2 void MinMaxSumSqAvx2T(const float* interleaved, size_t frames, float* out_min,
+                                     float* out_max, float* out_sumsq) {
+  __m256 vmin[C];
+  __m256 vmax[C];
+  __m256 vsum[C];
+  for (int j = 0; j < C; ++j) {
+    vmin[j] = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    vmax[j] = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+    vsum[j] = _mm256_setzero_ps();
+  }
+  size_t i = 0;
+  for (; i + 8 <= frames; i += 8) {
+    const float* block = interleaved + i * C;
+    for (int j = 0; j < C; ++j) {
+      const __m256 v = _mm256_loadu_ps(block + 8 * j);
+      vmin[j] = _mm256_min_ps(v, vmin[j]);
+      vmax[j] = _mm256_max_ps(v, vmax[j]);
+      vsum[j] = _mm256_add_ps(vsum[j], _mm256_mul_ps(v, v));
+    }
+  }
+  if constexpr (4 % C == 0) {
+    // 两个 128 位半边的 lane 布局也相同：对折成 __m128 后复用 SSE2 的折叠。
+    for (int j = 1; j < C; ++j) {
+      vmin[0] = _mm256_min_ps(vmin[0], vmin[j]);
+      vmax[0] = _mm256_max_ps(vmax[0], vmax[j]);
+      vsum[0] = _mm256_add_ps(vsum[0], vsum[j]);
+    }
+    const __m128 lo_min = _mm256_castps256_ps128(vmin[0]);
+    const __m128 lo_max = _mm256_castps256_ps128(vmax[0]);
+    const __m128 lo_sum = _mm256_castps256_ps128(vsum[0]);
+    FoldToChannelsSse2<C>(_mm_min_ps(lo_min, _mm256_extractf128_ps(vmin[0], 1)),
+                          _mm_max_ps(lo_max, _mm256_extractf128_ps(vmax[0], 1)),
+                          _mm_add_ps(lo_sum, _mm256_extractf128_ps(vsum[0], 1)), out_min,
+                          out_max, out_sumsq);
+  } else {
+    MinMaxSumSqBegin(C, out_min, out_max, out_sumsq);
+    alignas(32) float lanes[3][8];
+    for (int j = 0; j < C; ++j) {
+      _mm256_store_ps(lanes[0], vmin[j]);
+      _mm256_store_ps(lanes[1], vmax[j]);
+      _mm256_store_ps(lanes[2], vsum[j]);
+      for (int l = 0; l < 8; ++l) {
+        const int c = (8 * j + l) % C;
+        out_min[c] = std::min(out_min[c], lanes[0][l]);
+        out_max[c] = std::max(out_max[c], lanes[1][l]);
+        out_sumsq[c] += lanes[2][l];
+      }
+    }
+  }
+  _mm256_zeroupper();
+  MinMaxSumSqAccumulate(interleaved + i * C, frames - i, C, out_min, out_max, out_sumsq);
+  MinMaxSumSqEnd(frames, C, out_min, out_max);
+}
+
+// 3/5/6/7 声道每块 8 帧、逐 lane 合并，在常见的小桶上反而慢于 SSE2，直接复用 SSE2 版本。
+constexpr MinMaxSumSqFixedFn kMinMaxSumSqAvx2[kMaxReduceChannels] = {
+    &MinMaxSumSqAvx2T<1>, &MinMaxSumSqAvx2T<2>, &MinMaxSumSqSse2T<3>, &MinMaxSumSqAvx2T<4>,
+    &MinMaxSumSqSse2T<5>, &MinMaxSumSqSse2T<6>, &MinMaxSumSqSse2T<7>, &MinMaxSumSqAvx2T<8>};
+
+void MinMaxSumSqAvx2(const float* interleaved, size_t frames, int channels, float* out_min,
+                     float* out_max, float* out_sumsq) {
+  if (channels < 1 || channels > kMaxReduceChannels) {
+    MinMaxSumSqScalar(interleaved, frames, channels, out_min, out_max, out_sumsq);
+    return;
+  }
+  kMinMaxSumSqAvx2[channels - 1](interleaved, frames, out_min, out_max, out_sumsq);
+}
+
+SW_TARGET_AVX2 void S16ToFloatAvx2(const void* in, size_t n, float* out) {
+  const uint8_t* p = static_cast<const uint8_t*>(in);
+  const __m256 scale = _mm256_set1_ps(kS16Scale);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 2 * i));
+    _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v)), scale));
+  }
+  _mm256_zeroupper();
+  S16ToFloatSse2(p + 2 * i, n - i, out + i);
+}
+
+// 每次取 32 字节、处理 8 个样本（24 字节）：先按 32 位重排让高 lane 从第 12 字节开始，再在各
+// lane 内把每个样本的 3 字节放到 int32 的高 3 字节。循环条件保证 32 字节读取不越过输入末尾。
+SW_TARGET_AVX2 void S24ToFloatAvx2(const void* in, size_t n, float* out) {
+  const uint8_t* p = static_cast<const uint8_t*>(in);
+  const __m256 scale = _mm256_set1_ps(kS32Scale);
+  const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+  const __m256i unpack = _mm256_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+                                          -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+  size_t i = 0;
+  for (; i + 11 <= n; i += 8) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 3 * i));
+    v = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(v, lanes), unpack);
+    _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+  }
+  _mm256_zeroupper();
+  S24ToFloatScalar(p + 3 * i, n - i, out + i);
+}
+
+SW_TARGET_AVX2 void S32ToFloatAvx2(const void* in, size_t n, float* out) {
+  const uint8_t* p = static_cast<const uint8_t*>(in);
+  const __m256 scale = _mm256_set1_ps(kS32Scale);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 4 * i));
+    _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+  }
+  _mm256_zeroupper();
+  S32ToFloatSse2(p + 4 * i, n - i, out + i);
+}
+
+SW_TARGET_AVX2 SW_NO_AUTOVEC void LpcRestoreAvx2(int32_t* samples, size_t n,
+                                                 const int32_t* coefs, int order, int shift) {
+  if (order < kLpcSimdMinOrderAvx2) {
+    LpcRestoreScalar(samples, n, coefs, order, shift);
+    return;
+  }
+  const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  __m256i mask[7];
+  for (int j = 0; j < 7; ++j) mask[j] = _mm256_cmpgt_epi32(_mm256_set1_epi32(j + 1), lane);
+  alignas(32) int32_t partial[8];
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    int32_t* s = samples + i;
+    __m256i acc = _mm256_setzero_si256();
+    int j = 0;
+    for (; j < std::min(order, 7); ++j) {
+      const __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s - j - 1));
+      const __m256i p = _mm256_mullo_epi32(h, _mm256_set1_epi32(coefs[j]));
+      acc = _mm256_add_epi32(acc, _mm256_and_si256(p, mask[j]));
+    }
+    for (; j < order; ++j) {
+      const __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s - j - 1));
+      acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(h, _mm256_set1_epi32(coefs[j])));
+    }
+    _mm256_store_si256(reinterpret_cast<__m256i*>(partial), acc);
+    LpcFixupBlock<8>(s, partial, coefs, order, shift);
+  }
+  _mm256_zeroupper();
+  LpcRestoreScalar(samples + i, n - i, coefs, order, shift);
+}
+
+template <StereoDecorrelation M>
+SW_TARGET_AVX2 inline void DecorrelateAvx2(__m256i a, __m256i b, __m256i* l, __m256i* r) {
+  switch (M) {
+    case StereoDecorrelation::kIndependent:
+      *l = a;
+      *r = b;
+      break;
+    case StereoDecorrelation::kLeftSide:
+      *l = a;
+      *r = _mm256_sub_epi32(a, b);
+      break;
+    case StereoDecorrelation::kSideRight:
+      *l = _mm256_add_epi32(a, b);
+      *r = b;
+      break;
+    case StereoDecorrelation::kMidSide: {
+      const __m256i mid =
+          _mm256_or_si256(_mm256_slli_epi32(a, 1), _mm256_and_si256(b, _mm256_set1_epi32(1)));
+      *l = _mm256_srai_epi32(_mm256_add_epi32(mid, b), 1);
+      *r = _mm256_srai_epi32(_mm256_sub_epi32(mid, b), 1);
+      break;
+    }
+  }
+}
+
+template <StereoDecorrelation M>
+struct StereoAvx2Fn {
+  SW_TARGET_AVX2 static void Run(const int32_t* a, const int32_t* b, size_t n, float scale,
+                                 float* out) {
+    const __m256 vscale = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      __m256i l;
+      __m256i r;
+      DecorrelateAvx2<M>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)), &l, &r);
+      const __m256 lf = _mm256_mul_ps(_mm256_cvtepi32_ps(l), vscale);
+      const __m256 rf = _mm256_mul_ps(_mm256_cvtepi32_ps(r), vscale);
+      // unpack 在各 128 位 lane 内交错，再按 lane 拼回 (0..3) (4..7) 的顺序。
+      const __m256 lo = _mm256_unpacklo_ps(lf, rf);
+      const __m256 hi = _mm256_unpackhi_ps(lf, rf);
+      _mm256_storeu_ps(out + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+      _mm256_storeu_ps(out + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    _mm256_zeroupper();
+    StereoSse2Fn<M>::Run(a + i, b + i, n - i, scale, out + 2 * i);
+  }
+};
+
+void StereoToFloatAvx2(const int32_t* a, const int32_t* b, size_t n, StereoDecorrelation mode,
+                       float scale, float* out) {
+  DispatchStereo<StereoAvx2Fn>(a, b, n, mode, scale, out);
+}
+
+SW_TARGET_AVX2 float DotAvx2(const float* a, const float* b, size_t n) {
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    acc1 = _mm256_add_ps(acc1,
+                         _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+  }
+  if (i + 8 <= n) {
+    acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    i += 8;
+  }
+  const __m256 acc = _mm256_add_ps(acc0, acc1);
+  const __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+  _mm256_zeroupper();
+  float sum = HorizontalSumSse2(half);
+  for (; i < n; ++i) sum += a[i] * b[i];
+  return sum;
+}
+
+constexpr SimdKernels kAvx2Kernels{SimdLevel::kAvx2, &MultiplyAvx2, &DownmixAvx2, &PowerAvx2,
+                                   &MagnitudeAvx2, &DecibelsAvx2, &MinMaxSumSqAvx2,
+                                   &S16ToFloatAvx2, &S24ToFloatAvx2, &S32ToFloatAvx2,
+                                   &LpcRestoreAvx2, &StereoToFloatAvx2, &DotAvx2};
+
+bool CpuHasAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) return false;
+  __cpuid(info, 1);
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  const bool avx = (info[2] & (1 << 28)) != 0;
+  // 还需操作系统保存 YMM 状态（XCR0 的 SSE/AVX 位）。
+  if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return false;
+#endif
+}
+
+#endif  // SW_SIMD_X86
+
+#if defined(SW_SIMD_NEON)
+
+// ---- NEON（aarch64 基线） ----
+
+void MultiplyNeon(const float* a, const float* b, float* out, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vst1q_f32(out + i, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+  }
+  MultiplyScalar(a + i, b + i, out + i, n - i);
+}
+
+void DownmixNeon(const float* interleaved, size_t frames, int channels, float scale,
+                 float* out) {
+  const float32x4_t vscale = vdupq_n_f32(scale);
+  size_t i = 0;
+  if (channels == 1) {
+    for (; i + 4 <= frames; i += 4) {
+      vst1q_f32(out + i, vmulq_f32(vld1q_f32(interleaved + i), vscale));
+    }
+  } else if (channels == 2) {
+    for (; i + 4 <= frames; i += 4) {
+      const float32x4x2_t lr = vld2q_f32(interleaved + 2 * i);  // 加载时即解交错
+      vst1q_f32(out + i, vmulq_f32(vaddq_f32(lr.val[0], lr.val[1]), vscale));
+    }
+  }
+  DownmixScalar(interleaved + i * static_cast<size_t>(channels), frames - i, channels, scale,
+                out + i);
+}
+
+template <bool kSqrt>
+void SquaredMagnitudeNeon(const float* complex, size_t bins, float scale, float* out) {
+  const float32x4_t vscale = vdupq_n_f32(scale);
+  size_t k = 0;
+  for (; k + 4 <= bins; k += 4) {
+    const float32x4x2_t ri = vld2q_f32(complex + 2 * k);
+    float32x4_t mag2 =
+        vaddq_f32(vmulq_f32(ri.val[0], ri.val[0]), vmulq_f32(ri.val[1], ri.val[1]));
+    if (kSqrt) mag2 = vsqrtq_f32(mag2);
+    vst1q_f32(out + k, vmulq_f32(mag2, vscale));
+  }
+  if (kSqrt) {
+    MagnitudeScalar(complex + 2 * k, bins - k, scale, out + k);
+  } else {
+    PowerScalar(complex + 2 * k, bins - k, scale, out + k);
+  }
+}
+
+void PowerNeon(const float* complex, size_t bins, float scale, float* out) {
+  SquaredMagnitudeNeon<false>(complex, bins, scale, out);
+}
+
+void MagnitudeNeon(const float* complex, size_t bins, float scale, float* out) {
+  SquaredMagnitudeNeon<true>(complex, bins, scale, out);
+}
+
+inline float32x4_t FastLnNeon(float32x4_t x) {
+  const uint32x4_t bits = vreinterpretq_u32_f32(x);
+  int32x4_t e = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127));
+  float32x4_t m = vreinterpretq_f32_u32(
+      vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f800000)));
+  const uint32x4_t big = vcgtq_f32(m, vdupq_n_f32(kSqrt2));
+  m = vbslq_f32(big, vmulq_n_f32(m, 0.5f), m);
+  e = vsubq_s32(e, vreinterpretq_s32_u32(big));
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  const float32x4_t t = vdivq_f32(vsubq_f32(m, one), vaddq_f32(m, one));
+  const float32x4_t t2 = vmulq_f32(t, t);
+  float32x4_t series = vaddq_f32(vdupq_n_f32(1.0f / 5.0f), vmulq_n_f32(t2, 1.0f / 7.0f));
+  series = vaddq_f32(vdupq_n_f32(1.0f / 3.0f), vmulq_f32(t2, series));
+  series = vaddq_f32(one, vmulq_f32(t2, series));
+  return vaddq_f32(vmulq_f32(vaddq_f32(t, t), series), vmulq_n_f32(vcvtq_f32_s32(e), kLn2));
+}
+
+void DecibelsNeon(const float* in, size_t n, float db_per_decade, float floor_db, float* out) {
+  const float32x4_t floor = vdupq_n_f32(floor_db);
+  const float32x4_t min_positive = vdupq_n_f32(kMinPositive);
+  const float scale = db_per_decade * kInvLn10;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    // vmaxnmq 遇到 NaN 返回另一操作数。
+    const float32x4_t x = vmaxnmq_f32(vld1q_f32(in + i), min_positive);
+    vst1q_f32(out + i, vmaxq_f32(vmulq_n_f32(FastLnNeon(x), scale), floor));
+  }
+  DecibelsScalar(in + i, n - i, db_per_decade, floor_db, out + i);
+}
+
+// 同 SSE2 版本（vminnmq/vmaxnmq 忽略 NaN 样本）。
+template <int C>
+void MinMaxSumSqNeonT(const float* interleaved, size_t frames, float* out_min, float* out_max,
+                      float* out_sumsq) {
+  float32x4_t vmin[C];
+  float32x4_t vmax[C];
+  float32x4_t vsum[C];
+  for (int j = 0; j < C; ++j) {
+    vmin[j] = vdupq_n_f32(std::numeric_limits<float>::infinity());
+    vmax[j] = vdupq_n_f32(-std::numeric_limits<float>::infinity());
+    vsum[j] = vdupq_n_f32(0.0f);
+  }
+  size_t i = 0;
+  for (; i + 4 <= frames; i += 4) {
+    const float* block = interleaved + i * C;
+    for (int j = 0; j < C; ++j) {
+      const float32x4_t v = vld1q_f32(block + 4 * j);
+      vmin[j] = vminnmq_f32(v, vmin[j]);
+      vmax[j] = vmaxnmq_f32(v, vmax[j]);
+      vsum[j] = vmlaq_f32(vsum[j], v, v);
+    }
+  }
+  MinMaxSumSqBegin(C, out_min, out_max, out_sumsq);
+  float lanes[3][4];
+  for (int j = 0; j < C; ++j) {
+    vst1q_f32(lanes[0], vmin[j]);
+    vst1q_f32(lanes[1], vmax[j]);
+    vst1q_f32(lanes[2], vsum[j]);
+    for (int l = 0; l < 4; ++l) {
+      const int c = (4 * j + l) % C;
+      out_min[c] = std::min(out_min[c], lanes[0][l]);
+      out_max[c] = std::max(out_max[c], lanes[1][l]);
+      out_sumsq[c] += lanes[2][l];
+    }
+  }
+  MinMaxSumSqAccumulate(interleaved + i * C, frames - i, C, out_min, out_max, out_sumsq);
+  MinMaxSumSqEnd(frames, C, out_min, out_max);
+}
+
+constexpr MinMaxSumSqFixedFn kMinMaxSumSqNeon[kMaxReduceChannels] = {
+    &MinMaxSumSqNeonT<1>, &MinMaxSumSqNeonT<2>, &MinMaxSumSqNeonT<3>, &MinMaxSumSqNeonT<4>,
+    &MinMaxSumSqNeonT<5>, &MinMaxSumSqNeonT<6>, &MinMaxSumSqNeonT<7>, &MinMaxSumSqNeonT<8>};
+
+void MinMaxSumSqNeon(const float* interleaved, size_t frames, int channels, float* out_min,
+                     float* out_max, float* out_sumsq) {
+  if (channels < 1 || channels > kMaxReduceChannels) {
+    MinMaxSumSqScalar(interleaved, frames, channels, out_min, out_max, out_sumsq);
+    return;
+  }
+  kMinMaxSumSqNeon[channels - 1](interleaved, frames, out_min, out_max, out_sumsq);
+}
+
+void S16ToFloatNeon(const void* in, size_t n, float* out) {
+  const uint8_t* p = static_cast<const uint8_t*>(in);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const int16x8_t v = vreinterpretq_s16_u8(vld1q_u8(p + 2 * i));
+    vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), kS16Scale));
+    vst1q_f32(out + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), kS16Scale));
+  }
+  S16ToFloatScalar(p + 2 * i, n - i, out + i);
+}
+
+// vld3 加载时即把 8 个样本的 3 个字节分别解交错到三个向量。
+void S24ToFloatNeon(const void* in, size_t n, float* out) {
+  const uint8_t* p = static_cast<const uint8_t*>(in);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const uint8x8x3_t b = vld3_u8(p + 3 * i);
+    const uint16x8_t lo16 = vorrq_u16(vmovl_u8(b.val[0]), vshlq_n_u16(vmovl_u8(b.val[1]), 8));
+    const uint16x8_t hi16 = vmovl_u8(b.val[2]);
+    const uint32x4_t a = vorrq_u32(vshlq_n_u32(vmovl_u16(vget_low_u16(hi16)), 24),
+                                   vshlq_n_u32(vmovl_u16(vget_low_u16(lo16)), 8));
+    const uint32x4_t c = vorrq_u32(vshlq_n_u32(vmovl_u16(vget_high_u16(hi16)), 24),
+                                   vshlq_n_u32(vmovl_u16(vget_high_u16(lo16)), 8));
+    vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(a)), kS32Scale));
+    vst1q_f32(out + i + 4, vmulq_n_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(c)), kS32Scale));
+  }
+  S24ToFloatScalar(p + 3 * i, n - i, out + i);
+}
+
+void S32ToFloatNeon(const void* in, size_t n, float* out) {
+  const uint8_t* p = static_cast<const uint8_t*>(in);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const int32x4_t v = vreinterpretq_s32_u8(vld1q_u8(p + 4 * i));
+    vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(v), kS32Scale));
+  }
+  S32ToFloatScalar(p + 4 * i, n - i, out + i);
+}
+
+void LpcRestoreNeon(int32_t* samples, size_t n, const int32_t* coefs, int order, int shift) {
+  if (order < kLpcSimdMinOrderNeon) {
+    LpcRestoreScalar(samples, n, coefs, order, shift);
+    return;
+  }
+  const int32x4_t lane = {0, 1, 2, 3};
+  const int32x4_t mask[3] = {vreinterpretq_s32_u32(vcltq_s32(lane, vdupq_n_s32(1))),
+                             vreinterpretq_s32_u32(vcltq_s32(lane, vdupq_n_s32(2))),
+                             vreinterpretq_s32_u32(vcltq_s32(lane, vdupq_n_s32(3)))};
+  int32_t partial[4];
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    int32_t* s = samples + i;
+    int32x4_t acc = vdupq_n_s32(0);
+    int j = 0;
+    for (; j < std::min(order, 3); ++j) {
+      acc = vaddq_s32(acc, vandq_s32(vmulq_n_s32(vld1q_s32(s - j - 1), coefs[j]), mask[j]));
+    }
+    for (; j < order; ++j) {
+      acc = vmlaq_n_s32(acc, vld1q_s32(s - j - 1), coefs[j]);
+    }
+    vst1q_s32(partial, acc);
+    LpcFixupBlock<4>(s, partial, coefs, order, shift);
+  }
+  LpcRestoreScalar(samples + i, n - i, coefs, order, shift);
+}
+
+template <StereoDecorrelation M>
+inline void DecorrelateNeon(int32x4_t a, int32x4_t b, int32x4_t* l, int32x4_t* r) {
+  switch (M) {
+    case StereoDecorrelation::kIndependent:
+      *l = a;
+      *r = b;
+      break;
+    case StereoDecorrelation::kLeftSide:
+      *l = a;
+      *r = vsubq_s32(a, b);
+      break;
+    case StereoDecorrelation::kSideRight:
+      *l = vaddq_s32(a, b);
+      *r = b;
+      break;
+    case StereoDecorrelation::kMidSide: {
+      const int32x4_t mid = vorrq_s32(vshlq_n_s32(a, 1), vandq_s32(b, vdupq_n_s32(1)));
+      *l = vshrq_n_s32(vaddq_s32(mid, b), 1);
+      *r = vshrq_n_s32(vsubq_s32(mid, b), 1);
+      break;
+    }
+  }
+}
+
+// vst2 存储时直接交错左右声道。
+template <StereoDecorrelation M>
+struct StereoNeonFn {
+  static void Run(const int32_t* a, const int32_t* b, size_t n, float scale, float* out) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      int32x4_t l;
+      int32x4_t r;
+      DecorrelateNeon<M>(vld1q_s32(a + i), vld1q_s32(b + i), &l, &r);
+      float32x4x2_t v;
+      v.val[0] = vmulq_n_f32(vcvtq_f32_s32(l), scale);
+      v.val[1] = vmulq_n_f32(vcvtq_f32_s32(r), scale);
+      vst2q_f32(out + 2 * i, v);
+    }
+    StereoToFloatScalarT<M>(a + i, b + i, n - i, scale, out + 2 * i);
+  }
+};
+
+void StereoToFloatNeon(const int32_t* a, const int32_t* b, size_t n, StereoDecorrelation mode,
+                       float scale, float* out) {
+  DispatchStereo<StereoNeonFn>(a, b, n, mode, scale, out);
+}
+
+float DotNeon(const float* a, const float* b, size_t n) {
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  if (i + 4 <= n) {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    i += 4;
+  }
+  float sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+  for (; i < n; ++i) sum += a[i] * b[i];
+  return sum;
+}
+
+constexpr SimdKernels kNeonKernels{SimdLevel::kNeon, &MultiplyNeon, &DownmixNeon, &PowerNeon,
+                                   &MagnitudeNeon, &DecibelsNeon, &MinMaxSumSqNeon,
+                                   &S16ToFloatNeon, &S24ToFloatNeon, &S32ToFloatNeon,
+                                   &LpcRestoreNeon, &StereoToFloatNeon, &DotNeon};
+
+#endif  // SW_SIMD_NEON
+
+const SimdKernels* SelectKernels() {
+#if defined(SW_SIMD_X86)
+  return CpuHasAvx2() ? &kAvx2Kernels : &kSse2Kernels;
+#elif defined(SW_SIMD_NEON)
+  return &kNeonKernels;
+#else
+  return &kScalarKernels;
+#endif
+}
+
+}  // namespace
+
+const SimdKernels& ActiveSimdKernels() {
+  static const SimdKernels* const kernels = SelectKernels();
+  return *kernels;
+}
+
+const SimdKernels* SimdKernelsFor(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kScalar:
+      return &kScalarKernels;
+#if defined(SW_SIMD_X86)
+    case SimdLevel::kSse2:
+      return &kSse2Kernels;
+    case SimdLevel::kAvx2:
+      return CpuHasAvx2() ? &kAvx2Kernels : nullptr;
+#endif
+#if defined(SW_SIMD_NEON)
+    case SimdLevel::kNeon:
+      return &kNeonKernels;
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+const char* SimdLevelName(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kScalar:
+      return "scalar";
+    case SimdLevel::kSse2:
+      return "sse2";
+    case SimdLevel::kAvx2:
+      return "avx2";
+    case SimdLevel::kNeon:
+      return "neon";
+  }
+  return "unknown";
+}
+
+}  // namespace sw
@@ -0,0 +1,111 @@
+#include "spectrum_post.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "simd_kernels.h"
+
+namespace sw {
+namespace {
+
+// 相邻两帧间隔超过该值视为断流，状态从新帧重新开始。
+constexpr int64_t kMaxFrameGapMs = 1000;
+
+// τ <= 0 表示立即跟随。
+inline float SmoothingAlpha(float tau_ms, float dt_ms) {
+  return tau_ms > 0.0f ? 1.0f - std::exp(-dt_ms / tau_ms) : 1.0f;
+}
+
+}  // namespace
+
+bool SpectrumPostProcessor::Configure(const SpectrumPostConfig& cfg) {
+  cfg_ = cfg;
+  valid_ = cfg.attack_ms >= 0.0f && cfg.release_ms >= 0.0f && cfg.peak_hold_ms >= 0.0f &&
+           cfg.peak_decay_db_per_s >= 0.0f && std::isfinite(cfg.db_floor);
+  active_ = cfg.decibels || cfg.attack_ms > 0.0f || cfg.release_ms > 0.0f || cfg.peak_hold;
+  Reset();
+  return valid_;
+}
+
+void SpectrumPostProcessor::Reset() { has_state_ = false; }
+
+bool SpectrumPostProcessor::Process(SpectrumFrame* frame) {
+  if (!valid_) return false;
+  if (!active_) return true;
+  if (frame == nullptr || frame->bins == nullptr || frame->num_bins <= 0) return false;
+
+  const size_t n = static_cast<size_t>(frame->num_bins);
+  if (values_.size() != n) {
+    input_.resize(n);
+    values_.resize(n);
+    peaks_.resize(n);
+    peak_age_ms_.resize(n);
+    has_state_ = false;
+  }
+
+  const float* in = frame->bins;
+  if (cfg_.decibels) {
+    ActiveSimdKernels().decibels(in, n, frame->power_spectrum ? 10.0f : 20.0f, cfg_.db_floor,
+                                 input_.data());
+    in = input_.data();
+  }
+
+  const int64_t dt = frame->timestamp_ms - last_timestamp_ms_;
+  if (has_state_ && (frame->power_spectrum != last_power_ || dt < 0 || dt > kMaxFrameGapMs)) {
+    has_state_ = false;
+  }
+  last_timestamp_ms_ = frame->timestamp_ms;
+  last_power_ = frame->power_spectrum;
+
+  if (!has_state_) {
+    std::copy(in, in + n, values_.begin());
+    std::copy(in, in + n, peaks_.begin());
+    std::fill(peak_age_ms_.begin(), peak_age_ms_.end(), 0.0f);
+    has_state_ = true;
+  } else {
+    const float dt_ms = static_cast<float>(dt);
+    const float attack = SmoothingAlpha(cfg_.attack_ms, dt_ms);
+    const float release = SmoothingAlpha(cfg_.release_ms, dt_ms);
+    float* v = values_.data();
+    for (size_t i = 0; i < n; ++i) {
+      const float delta = in[i] - v[i];
+      v[i] += delta * (delta > 0.0f ? attack : release);
+    }
+
+    if (cfg_.peak_hold) {
+      // dB 域按差值衰减；线性域换算为每毫秒的乘法因子（功率 10、幅度 20 dB/十倍）。
+      const float db_per_ms = cfg_.peak_decay_db_per_s / 1000.0f;
+      const float db_per_decade = frame->power_spectrum ? 10.0f : 20.0f;
+      const float hold = cfg_.peak_hold_ms;
+      const float full_step_factor = std::pow(10.0f, -db_per_ms * dt_ms / db_per_decade);
+      float* peaks = peaks_.data();
+      float* age = peak_age_ms_.data();
+      for (size_t i = 0; i < n; ++i) {
+        if (v[i] >= peaks[i]) {
+          peaks[i] = v[i];
+          age[i] = 0.0f;
+          continue;
+        }
+        age[i] += dt_ms;
+        if (age[i] > hold) {
+          const float decay_ms = std::min(dt_ms, age[i] - hold);
+          if (cfg_.decibels) {
+            peaks[i] -= db_per_ms * decay_ms;
+          } else {
+            // 仅刚越过保持期的那一帧是部分衰减，其余复用整帧因子。
+            peaks[i] *= decay_ms < dt_ms ? std::pow(10.0f, -db_per_ms * decay_ms / db_per_decade)
+                                         : full_step_factor;
+          }
+          peaks[i] = std::max(peaks[i], v[i]);
+        }
+      }
+    }
+  }
+
+  frame->bins = values_.data();
+  frame->decibels = cfg_.decibels;
+  frame->peaks = cfg_.peak_hold ? peaks_.data() : nullptr;
+  return true;
+}
+
+}  // namespace sw
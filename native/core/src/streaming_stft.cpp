@@ -0,0 +1,109 @@
+#include "streaming_stft.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "playback_clock.h"
+
+namespace sw {
+
+bool StreamingStft::Configure(const SpectrumConfig& cfg, int sample_rate) {
+  hop_ = 0;
+  if (cfg.window_size <= 0 || cfg.overlap < 0 || cfg.overlap >= cfg.window_size ||
+      sample_rate <= 0) {
+    return false;
+  }
+  if (!analyzer_.Configure(cfg)) {
+    return false;
+  }
+  if (cfg.band_scale != BandScale::kNone) {
+    if (!band_mapper_.Configure(cfg, sample_rate)) {
+      return false;
+    }
+    bands_.assign(static_cast<size_t>(band_mapper_.num_bands()), 0.0f);
+  }
+  if (!post_.Configure(cfg.post)) {
+    return false;
+  }
+  cfg_ = cfg;
+  sample_rate_ = sample_rate;
+  hop_ = cfg.window_size - cfg.overlap;
+  bins_.assign(static_cast<size_t>(analyzer_.num_bins()), 0.0f);
+  // 预留两个窗口的历史，常见块大小下无需再扩容。
+  history_.reserve(static_cast<size_t>(cfg.window_size) * 2);
+  Reset(0);
+  return true;
+}
+
+void StreamingStft::Reset(int64_t next_input_frame) {
+  read_pos_ = 0;
+  size_ = 0;
+  history_start_frame_ = next_input_frame;
+  post_.Reset();
+}
+
+void StreamingStft::Compact() {
+  if (read_pos_ == 0) return;
+  const size_t remaining = size_ - read_pos_;
+  if (remaining > 0) {
+    std::memmove(history_.data(), history_.data() + read_pos_, remaining * sizeof(float));
+  }
+  history_start_frame_ += static_cast<int64_t>(read_pos_);
+  read_pos_ = 0;
+  size_ = remaining;
+}
+
+void StreamingStft::Push(const float* interleaved, int num_frames, int num_channels) {
+  if (!configured() || interleaved == nullptr || num_frames <= 0 || num_channels <= 0) {
+    return;
+  }
+  const size_t n = static_cast<size_t>(num_frames);
+  if (size_ + n > history_.capacity()) {
+    Compact();
+  }
+  if (size_ + n > history_.size()) {
+    history_.resize(size_ + n);
+  }
+  DownmixToMono(interleaved, num_frames, num_channels, num_frames, history_.data() + size_,
+                num_frames);
+  size_ += n;
+}
+
+bool StreamingStft::ready() const {
+  return configured() && size_ - read_pos_ >= static_cast<size_t>(cfg_.window_size);
+}
+
+bool StreamingStft::Skip() {
+  if (!ready()) return false;
+  read_pos_ += static_cast<size_t>(hop_);
+  return true;
+}
+
+bool StreamingStft::Next(StftFrame* out) {
+  if (out == nullptr || !ready()) return false;
+  const size_t window = static_cast<size_t>(cfg_.window_size);
+  if (!analyzer_.Compute(history_.data() + read_pos_, window, bins_.data(), bins_.size())) {
+    return false;
+  }
+  out->start_frame = next_window_frame();
+  SpectrumFrame& spec = out->spectrum;
+  spec.bins = bins_.data();
+  spec.num_bins = static_cast<int>(bins_.size());
+  spec.window_size = cfg_.window_size;
+  spec.bin_hz = static_cast<float>(sample_rate_) / static_cast<float>(cfg_.window_size);
+  spec.sample_rate = sample_rate_;
+  spec.window = cfg_.window;
+  spec.power_spectrum = cfg_.power_spectrum;
+  spec.timestamp_ms = PlaybackClock::FramesToMs(out->start_frame, sample_rate_);
+  spec.band_scale = BandScale::kNone;
+  spec.band_hz = nullptr;
+  spec.decibels = false;
+  spec.peaks = nullptr;
+  if (!MapSpectrumFrame(cfg_, &band_mapper_, &bands_, &spec) || !post_.Process(&spec)) {
+    return false;
+  }
+  read_pos_ += static_cast<size_t>(hop_);
+  return true;
+}
+
+}  // namespace sw
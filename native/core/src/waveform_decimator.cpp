@@ -0,0 +1,63 @@
+#include "waveform_decimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "simd_kernels.h"
+
+namespace sw {
+
+bool WaveformDecimator::Configure(const WaveformConfig& cfg) {
+  cfg_ = cfg;
+  valid_ = cfg.num_buckets >= 1;
+  return valid_;
+}
+
+bool WaveformDecimator::Process(const PcmFrame& frame, WaveformFrame* out) {
+  if (!valid_ || out == nullptr || frame.dropped || frame.data == nullptr ||
+      frame.num_frames <= 0 || frame.num_channels <= 0) {
+    return false;
+  }
+  const int64_t frames = frame.num_frames;
+  const int buckets = static_cast<int>(std::min<int64_t>(cfg_.num_buckets, frames));
+  const size_t channels = static_cast<size_t>(frame.num_channels);
+  const size_t needed = static_cast<size_t>(buckets) * channels;
+  if (buckets_.size() < needed) {
+    buckets_.resize(needed);
+  }
+  if (scratch_.size() < channels * 3) {
+    scratch_.resize(channels * 3);
+  }
+  float* mins = scratch_.data();
+  float* maxs = mins + channels;
+  float* sumsq = maxs + channels;
+
+  const SimdKernels& k = ActiveSimdKernels();
+  int64_t begin = 0;
+  for (int b = 0; b < buckets; ++b) {
+    const int64_t end = (b + 1) * frames / buckets;
+    const size_t count = static_cast<size_t>(end - begin);
+    k.min_max_sumsq(frame.data + static_cast<size_t>(begin) * channels, count,
+                    frame.num_channels, mins, maxs, sumsq);
+    const float inv_count = 1.0f / static_cast<float>(count);
+    WaveformBucket* row = buckets_.data() + static_cast<size_t>(b) * channels;
+    for (size_t c = 0; c < channels; ++c) {
+      row[c].min = mins[c];
+      row[c].max = maxs[c];
+      row[c].rms = std::sqrt(sumsq[c] * inv_count);
+    }
+    begin = end;
+  }
+
+  out->buckets = buckets_.data();
+  out->num_buckets = buckets;
+  out->num_channels = frame.num_channels;
+  out->num_frames = frame.num_frames;
+  out->sample_rate = frame.sample_rate;
+  out->timestamp_ms = frame.timestamp_ms;
+  out->sequence = frame.sequence;
+  out->dropped_before = frame.dropped_before;
+  return true;
+}
+
+}  // namespace sw
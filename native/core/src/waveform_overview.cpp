@@ -0,0 +1,441 @@
+#include "waveform_overview.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include "mapped_file.h"
+#include "simd_kernels.h"
+
+namespace sw {
+
+namespace {
+
+// 文件布局：FileHeader | LevelEntry × num_levels | 各层数据（16 字节对齐，WaveformBucket 数组）。
+constexpr char kMagic[8] = {'S', 'W', 'W', 'A', 'V', 'O', 'V', 'W'};
+constexpr uint32_t kFileVersion = 1;
+constexpr uint32_t kEndianTag = 0x01020304u;  // 按主机字节序写入，读到不同值说明字节序不符。
+constexpr uint64_t kDataAlignment = 16;
+constexpr int kMaxLevels = 64;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t endian_tag;
+  uint32_t sample_rate;
+  uint32_t channels;
+  uint64_t num_frames;
+  uint32_t base_bucket_frames;
+  uint32_t num_levels;
+};
+static_assert(sizeof(FileHeader) == 40, "overview header layout");
+
+struct LevelEntry {
+  uint64_t offset;  // 相对文件起始的字节偏移。
+  uint64_t num_buckets;
+};
+static_assert(sizeof(LevelEntry) == 16, "overview level table layout");
+static_assert(sizeof(WaveformBucket) == 3 * sizeof(float), "WaveformBucket must stay packed");
+
+uint64_t AlignUp(uint64_t v) { return (v + kDataAlignment - 1) / kDataAlignment * kDataAlignment; }
+
+int64_t CeilDiv(int64_t a, int64_t b) { return (a + b - 1) / b; }
+
+// 各层桶数：ceil(frames / (base << level))，直到只剩一个桶；空轨道没有层。
+std::vector<int64_t> LevelCounts(int64_t frames, int64_t base) {
+  std::vector<int64_t> counts;
+  if (frames <= 0 || base <= 0) return counts;
+  for (int64_t bucket = base;; bucket *= 2) {
+    counts.push_back(CeilDiv(frames, bucket));
+    if (counts.back() <= 1 || static_cast<int>(counts.size()) >= kMaxLevels) break;
+  }
+  return counts;
+}
+
+// 跨桶合并：RMS 按各桶实际帧数加权（末尾的桶可能不满）。
+struct Accumulator {
+  float min = std::numeric_limits<float>::infinity();
+  float max = -std::numeric_limits<float>::infinity();
+  double sumsq = 0.0;
+  int64_t frames = 0;
+
+  void Add(const WaveformBucket& b, int64_t n) {
+    min = std::min(min, b.min);
+    max = std::max(max, b.max);
+    sumsq += static_cast<double>(b.rms) * b.rms * static_cast<double>(n);
+    frames += n;
+  }
+
+  WaveformBucket Result() const {
+    WaveformBucket out;
+    if (frames > 0) {
+      out.min = min;
+      out.max = max;
+      out.rms = static_cast<float>(std::sqrt(sumsq / static_cast<double>(frames)));
+    }
+    return out;
+  }
+};
+
+}  // namespace
+
+struct WaveformOverview::Impl {
+  bool valid = false;
+  int sample_rate = 0;
+  int channels = 0;
+  int64_t num_frames = 0;
+  int base_bucket_frames = 0;
+  std::vector<int64_t> counts;
+  std::vector<const WaveformBucket*> levels;
+
+  // 数据来源二选一：内存构建 / 文件映射。
+  std::vector<WaveformBucket> owned;
+  MappedFile file;
+
+  void Reset() {
+    file.Close();
+    owned.clear();
+    owned.shrink_to_fit();
+    counts.clear();
+    levels.clear();
+    valid = false;
+    sample_rate = 0;
+    channels = 0;
+    num_frames = 0;
+    base_bucket_frames = 0;
+  }
+
+  int64_t BucketFrames(int level) const {
+    return static_cast<int64_t>(base_bucket_frames) << level;
+  }
+
+  // 第 level 层第 b 个桶实际覆盖的帧数。
+  int64_t FramesIn(int level, int64_t b) const {
+    const int64_t bf = BucketFrames(level);
+    return std::min(bf, num_frames - b * bf);
+  }
+
+  // 校验 [bytes, bytes + size) 中的文件内容并让各层指向其中。
+  bool Parse(const uint8_t* bytes, size_t size) {
+    if (size < sizeof(FileHeader)) return false;
+    FileHeader h;
+    std::memcpy(&h, bytes, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kFileVersion ||
+        h.endian_tag != kEndianTag || h.sample_rate == 0 || h.channels == 0 ||
+        h.channels > static_cast<uint32_t>(std::numeric_limits<int>::max()) ||
+        h.sample_rate > static_cast<uint32_t>(std::numeric_limits<int>::max()) ||
+        h.base_bucket_frames == 0 ||
+        h.base_bucket_frames > static_cast<uint32_t>(std::numeric_limits<int>::max()) ||
+        h.num_frames > static_cast<uint64_t>(std::numeric_limits<int64_t>::max() / 2)) {
+      return false;
+    }
+    const std::vector<int64_t> expected =
+        LevelCounts(static_cast<int64_t>(h.num_frames), h.base_bucket_frames);
+    if (h.num_levels != expected.size()) return false;
+    const uint64_t table_end = sizeof(FileHeader) + uint64_t{h.num_levels} * sizeof(LevelEntry);
+    if (table_end > size) return false;
+
+    const uint64_t bucket_bytes = uint64_t{h.channels} * sizeof(WaveformBucket);
+    levels.assign(h.num_levels, nullptr);
+    for (uint32_t l = 0; l < h.num_levels; ++l) {
+      LevelEntry e;
+      std::memcpy(&e, bytes + sizeof(FileHeader) + l * sizeof(LevelEntry), sizeof(e));
+      if (e.num_buckets != static_cast<uint64_t>(expected[l]) || e.offset < table_end ||
+          e.offset % alignof(WaveformBucket) != 0 || e.offset > size ||
+          e.num_buckets > (size - e.offset) / bucket_bytes) {
+        levels.clear();
+        return false;
+      }
+      levels[l] = reinterpret_cast<const WaveformBucket*>(bytes + e.offset);
+    }
+    counts = expected;
+    sample_rate = static_cast<int>(h.sample_rate);
+    channels = static_cast<int>(h.channels);
+    num_frames = static_cast<int64_t>(h.num_frames);
+    base_bucket_frames = static_cast<int>(h.base_bucket_frames);
+    valid = true;
+    return true;
+  }
+};
+
+WaveformOverview::WaveformOverview() : impl_(std::make_unique<Impl>()) {}
+WaveformOverview::~WaveformOverview() = default;
+WaveformOverview::WaveformOverview(WaveformOverview&&) noexcept = default;
+WaveformOverview& WaveformOverview::operator=(WaveformOverview&&) noexcept = default;
+
+bool WaveformOverview::valid() const { return impl_->valid; }
+int WaveformOverview::sample_rate() const { return impl_->sample_rate; }
+int WaveformOverview::channels() const { return impl_->channels; }
+int64_t WaveformOverview::num_frames() const { return impl_->num_frames; }
+int WaveformOverview::base_bucket_frames() const { return impl_->base_bucket_frames; }
+int WaveformOverview::num_levels() const { return static_cast<int>(impl_->levels.size()); }
+
+int64_t WaveformOverview::bucket_frames(int level) const {
+  return level >= 0 && level < num_levels() ? impl_->BucketFrames(level) : 0;
+}
+
+int64_t WaveformOverview::level_buckets(int level) const {
+  return level >= 0 && level < num_levels() ? impl_->counts[static_cast<size_t>(level)] : 0;
+}
+
+const WaveformBucket* WaveformOverview::level_data(int level) const {
+  return level >= 0 && level < num_levels() ? impl_->levels[static_cast<size_t>(level)] : nullptr;
+}
+
+void WaveformOverview::Close() { impl_->Reset(); }
+
+Status WaveformOverview::Open(const std::string& path) {
+  Impl& s = *impl_;
+  s.Reset();
+  const Status status = s.file.Open(path);
+  if (status != Status::kOk) return status;
+  if (!s.Parse(s.file.data(), s.file.size())) {
+    s.Reset();
+    return Status::kError;
+  }
+  return Status::kOk;
+}
+
+Status WaveformOverview::Save(const std::string& path) const {
+  const Impl& s = *impl_;
+  if (!s.valid) return Status::kInvalidState;
+  if (path.empty()) return Status::kInvalidArguments;
+
+  FileHeader h{};
+  std::memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.version = kFileVersion;
+  h.endian_tag = kEndianTag;
+  h.sample_rate = static_cast<uint32_t>(s.sample_rate);
+  h.channels = static_cast<uint32_t>(s.channels);
+  h.num_frames = static_cast<uint64_t>(s.num_frames);
+  h.base_bucket_frames = static_cast<uint32_t>(s.base_bucket_frames);
+  h.num_levels = static_cast<uint32_t>(s.levels.size());
+
+  const uint64_t bucket_bytes = static_cast<uint64_t>(s.channels) * sizeof(WaveformBucket);
+  std::vector<LevelEntry> table(s.levels.size());
+  uint64_t offset = AlignUp(sizeof(FileHeader) + table.size() * sizeof(LevelEntry));
+  for (size_t l = 0; l < table.size(); ++l) {
+    table[l].offset = offset;
+    table[l].num_buckets = static_cast<uint64_t>(s.counts[l]);
+    offset = AlignUp(offset + table[l].num_buckets * bucket_bytes);
+  }
+
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  if (f == nullptr) return Status::kIoError;
+  static const char kZeros[kDataAlignment] = {};
+  uint64_t written = 0;
+  auto write = [&](const void* data, uint64_t bytes) {
+    if (bytes == 0) return true;
+    written += bytes;
+    return std::fwrite(data, 1, static_cast<size_t>(bytes), f) == bytes;
+  };
+  bool ok = write(&h, sizeof(h)) && write(table.data(), table.size() * sizeof(LevelEntry));
+  for (size_t l = 0; ok && l < table.size(); ++l) {
+    ok = write(kZeros, table[l].offset - written) &&
+         write(s.levels[l], table[l].num_buckets * bucket_bytes);
+  }
+  ok = std::fclose(f) == 0 && ok;
+  if (!ok) {
+    std::remove(path.c_str());
+    return Status::kIoError;
+  }
+  return Status::kOk;
+}
+
+int WaveformOverview::LevelFor(double frames_per_column) const {
+  const int levels = num_levels();
+  int level = 0;
+  while (level + 1 < levels &&
+         static_cast<double>(impl_->BucketFrames(level + 1)) <= frames_per_column) {
+    ++level;
+  }
+  return level;
+}
+
+bool WaveformOverview::Query(int64_t start_frame, int64_t end_frame, int columns,
+                             WaveformBucket* out, size_t out_capacity) const {
+  const Impl& s = *impl_;
+  if (!s.valid || s.levels.empty() || columns <= 0 || out == nullptr ||
+      out_capacity < static_cast<size_t>(columns) * static_cast<size_t>(s.channels)) {
+    return false;
+  }
+  start_frame = std::max<int64_t>(start_frame, 0);
+  end_frame = std::min(end_frame, s.num_frames);
+  if (start_frame >= end_frame) return false;
+
+  const int64_t span = end_frame - start_frame;
+  const int level = LevelFor(static_cast<double>(span) / columns);
+  const int64_t bf = s.BucketFrames(level);
+  const int64_t buckets = s.counts[static_cast<size_t>(level)];
+  const WaveformBucket* data = s.levels[static_cast<size_t>(level)];
+  const size_t channels = static_cast<size_t>(s.channels);
+
+  // 所选层满足 桶长 <= 列宽 < 2×桶长（最高层除外），因此每列只跨 1~3 个桶。
+  for (int col = 0; col < columns; ++col) {
+    const int64_t col_start = start_frame + span * col / columns;
+    const int64_t col_end = std::max(start_frame + span * (col + 1) / columns, col_start + 1);
+    const int64_t first = col_start / bf;
+    const int64_t last = std::min(std::max(CeilDiv(col_end, bf), first + 1), buckets);
+    WaveformBucket* dst = out + static_cast<size_t>(col) * channels;
+    for (size_t c = 0; c < channels; ++c) {
+      Accumulator acc;
+      for (int64_t b = first; b < last; ++b) {
+        acc.Add(data[static_cast<size_t>(b) * channels + c], s.FramesIn(level, b));
+      }
+      dst[c] = acc.Result();
+    }
+  }
+  return true;
+}
+
+bool WaveformOverviewBuilder::Begin(int sample_rate, int channels,
+                                    const WaveformOverviewConfig& cfg) {
+  channels_ = 0;
+  if (sample_rate <= 0 || channels <= 0 || cfg.base_bucket_frames < 1) {
+    return false;
+  }
+  sample_rate_ = sample_rate;
+  channels_ = channels;
+  base_bucket_frames_ = cfg.base_bucket_frames;
+  num_frames_ = 0;
+  level0_.clear();
+  pending_.assign(static_cast<size_t>(channels) * 3, 0.0f);
+  scratch_.assign(static_cast<size_t>(channels) * 3, 0.0f);
+  pending_frames_ = 0;
+  return true;
+}
+
+bool WaveformOverviewBuilder::Append(const float* interleaved, size_t frames) {
+  if (channels_ <= 0) return false;
+  if (frames == 0) return true;
+  if (interleaved == nullptr) return false;
+
+  const SimdKernels& k = ActiveSimdKernels();
+  const size_t ch = static_cast<size_t>(channels_);
+  float* pmin = pending_.data();
+  float* pmax = pmin + ch;
+  float* psum = pmax + ch;
+  float* smin = scratch_.data();
+  float* smax = smin + ch;
+  float* ssum = smax + ch;
+  while (frames > 0) {
+    const size_t n = std::min(frames, static_cast<size_t>(base_bucket_frames_ - pending_frames_));
+    k.min_max_sumsq(interleaved, n, channels_, smin, smax, ssum);
+    if (pending_frames_ == 0) {
+      std::copy(scratch_.begin(), scratch_.end(), pending_.begin());
+    } else {
+      for (size_t c = 0; c < ch; ++c) {
+        pmin[c] = std::min(pmin[c], smin[c]);
+        pmax[c] = std::max(pmax[c], smax[c]);
+        psum[c] += ssum[c];
+      }
+    }
+    pending_frames_ += static_cast<int64_t>(n);
+    num_frames_ += static_cast<int64_t>(n);
+    interleaved += n * ch;
+    frames -= n;
+    if (pending_frames_ == base_bucket_frames_) {
+      FlushPending();
+    }
+  }
+  return true;
+}
+
+void WaveformOverviewBuilder::FlushPending() {
+  if (pending_frames_ == 0) return;
+  const size_t ch = static_cast<size_t>(channels_);
+  const float inv = 1.0f / static_cast<float>(pending_frames_);
+  for (size_t c = 0; c < ch; ++c) {
+    WaveformBucket b;
+    b.min = pending_[c];
+    b.max = pending_[ch + c];
+    b.rms = std::sqrt(pending_[2 * ch + c] * inv);
+    level0_.push_back(b);
+  }
+  pending_frames_ = 0;
+}
+
+bool WaveformOverviewBuilder::Finish(WaveformOverview* out) {
+  if (channels_ <= 0 || out == nullptr) return false;
+  FlushPending();
+
+  WaveformOverview::Impl& s = *out->impl_;
+  s.Reset();
+  s.sample_rate = sample_rate_;
+  s.channels = channels_;
+  s.num_frames = num_frames_;
+  s.base_bucket_frames = base_bucket_frames_;
+  s.counts = LevelCounts(num_frames_, base_bucket_frames_);
+
+  // 所有层放在同一块连续内存里，第 0 层直接接管构建缓冲。
+  const size_t ch = static_cast<size_t>(channels_);
+  std::vector<size_t> offsets(s.counts.size());
+  size_t total = 0;
+  for (size_t l = 0; l < s.counts.size(); ++l) {
+    offsets[l] = total;
+    total += static_cast<size_t>(s.counts[l]) * ch;
+  }
+  s.owned = std::move(level0_);
+  s.owned.resize(total);
+  for (size_t l = 1; l < s.counts.size(); ++l) {
+    const WaveformBucket* src = s.owned.data() + offsets[l - 1];
+    WaveformBucket* dst = s.owned.data() + offsets[l];
+    const int64_t src_count = s.counts[l - 1];
+    for (int64_t j = 0; j < s.counts[l]; ++j) {
+      const int64_t a = 2 * j;
+      const int64_t b = a + 1;
+      for (size_t c = 0; c < ch; ++c) {
+        Accumulator acc;
+        acc.Add(src[static_cast<size_t>(a) * ch + c], s.FramesIn(static_cast<int>(l) - 1, a));
+        if (b < src_count) {
+          acc.Add(src[static_cast<size_t>(b) * ch + c], s.FramesIn(static_cast<int>(l) - 1, b));
+        }
+        dst[static_cast<size_t>(j) * ch + c] = acc.Result();
+      }
+    }
+  }
+  s.levels.resize(s.counts.size());
+  for (size_t l = 0; l < s.counts.size(); ++l) {
+    s.levels[l] = s.owned.data() + offsets[l];
+  }
+  s.valid = true;
+
+  channels_ = 0;
+  level0_ = std::vector<WaveformBucket>();
+  num_frames_ = 0;
+  pending_frames_ = 0;
+  return true;
+}
+
+Status BuildWaveformOverview(Decoder& decoder, const WaveformOverviewConfig& cfg,
+                             WaveformOverview* out) {
+  if (out == nullptr || cfg.base_bucket_frames < 1) return Status::kInvalidArguments;
+  WaveformOverviewBuilder builder;
+  PcmBuffer buffer;
+  bool begun = false;
+  int sample_rate = 0;
+  int channels = 0;
+  while (decoder.Read(buffer)) {
+    if (buffer.channels <= 0 || buffer.sample_rate <= 0) return Status::kError;
+    if (!begun) {
+      sample_rate = buffer.sample_rate;
+      channels = buffer.channels;
+      if (!builder.Begin(sample_rate, channels, cfg)) return Status::kInvalidArguments;
+      begun = true;
+    } else if (buffer.sample_rate != sample_rate || buffer.channels != channels) {
+      return Status::kError;
+    }
+    builder.Append(buffer.interleaved.data(),
+                   buffer.interleaved.size() / static_cast<size_t>(channels));
+  }
+  if (decoder.last_status() != Status::kOk) return decoder.last_status();
+  if (!begun && !builder.Begin(decoder.sample_rate(), decoder.channels(), cfg)) {
+    return Status::kError;
+  }
+  builder.Finish(out);
+  return Status::kOk;
+}
+
+}  // namespace sw
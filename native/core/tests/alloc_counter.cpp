@@ -0,0 +1,42 @@
+#include "alloc_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local bool g_counting = false;
+thread_local size_t g_allocs = 0;
+
+void* CountedAlloc(std::size_t size) {
+  if (g_counting) {
+    ++g_allocs;
+  }
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) { return CountedAlloc(size); }
+void* operator new[](std::size_t size) { return CountedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace sw {
+namespace testing {
+
+ScopedAllocCounter::ScopedAllocCounter() : start_(g_allocs), prev_enabled_(g_counting) {
+  g_counting = true;
+}
+
+ScopedAllocCounter::~ScopedAllocCounter() { g_counting = prev_enabled_; }
+
+size_t ScopedAllocCounter::count() const { return g_allocs - start_; }
+
+}  // namespace testing
+}  // namespace sw
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+namespace sw {
+namespace testing {
+
+// Counts global operator new calls made on the current thread while alive.
+// Backed by replacement operator new/delete in alloc_counter.cpp.
+class ScopedAllocCounter {
+ public:
+  ScopedAllocCounter();
+  ~ScopedAllocCounter();
+
+  ScopedAllocCounter(const ScopedAllocCounter&) = delete;
+  ScopedAllocCounter& operator=(const ScopedAllocCounter&) = delete;
+
+  size_t count() const;
+
+ private:
+  size_t start_ = 0;
+  bool prev_enabled_ = false;
+};
+
+}  // namespace testing
+}  // namespace sw
@@ -2,13 +2,18 @@
 #include "decoder.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace sw {
@@ -51,6 +56,35 @@ TEST_F(AudioEngineTest, InitRejectsInvalidConfig) {
   bad.sample_rate = 0;
   bad.channels = 0;
   EXPECT_EQ(engine_->Init(bad), Status::kInvalidArguments);
+
+  AudioConfig bad_bands;
+  bad_bands.spectrum_cfg.band_scale = BandScale::kOctave;
+  bad_bands.spectrum_cfg.octave_fraction = 0;
+  EXPECT_EQ(engine_->Init(bad_bands), Status::kInvalidArguments);
+  AudioConfig bad_post;
+  bad_post.spectrum_cfg.post.attack_ms = -1.0f;
+  EXPECT_EQ(engine_->Init(bad_post), Status::kInvalidArguments);
+  AudioConfig bad_prefetch;
+  bad_prefetch.prefetch_ms = 0;
+  EXPECT_EQ(engine_->Init(bad_prefetch), Status::kInvalidArguments);
+  bad_prefetch.prefetch_ms = 100;
+  bad_prefetch.prefetch_refill_ms = 200;
+  EXPECT_EQ(engine_->Init(bad_prefetch), Status::kInvalidArguments);
+  // 越界的 overlap 不能悄悄退回逐块频谱。
+  AudioConfig bad_overlap;
+  bad_overlap.spectrum_cfg.overlap = -1;
+  EXPECT_EQ(engine_->Init(bad_overlap), Status::kInvalidArguments);
+  bad_overlap.spectrum_cfg.window_size = 1024;
+  bad_overlap.spectrum_cfg.overlap = 1024;
+  EXPECT_EQ(engine_->Init(bad_overlap), Status::kInvalidArguments);
+  bad_overlap.spectrum_cfg.window_size = 0;  // 取 frames_per_buffer
+  bad_overlap.frames_per_buffer = 480;
+  bad_overlap.spectrum_cfg.overlap = 480;
+  EXPECT_EQ(engine_->Init(bad_overlap), Status::kInvalidArguments);
+  bad_overlap.spectrum_cfg.overlap = 240;
+  EXPECT_EQ(engine_->Init(bad_overlap), Status::kOk);
+  bad_bands.spectrum_cfg.octave_fraction = 3;
+  EXPECT_EQ(engine_->Init(bad_bands), Status::kOk);
 }
 
 TEST_F(AudioEngineTest, CallbacksCanBeSet) {
@@ -332,6 +366,448 @@ TEST_F(AudioEngineTest, SeekClearsBufferAndResetsClocks) {
   EXPECT_NEAR(after_seek_ts, 800, 300);  // loose guard for stub pacing.
 }
 
+TEST_F(AudioEngineTest, SubscribersAreThrottledIndependently) {
+  ASSERT_NE(engine_, nullptr);
+  AudioConfig cfg;
+  cfg.sample_rate = 48000;
+  cfg.channels = 2;
+  cfg.frames_per_buffer = 240;
+  cfg.pcm_frames_per_push = 240;  // 5ms per chunk → ~200 chunks/s.
+  ASSERT_EQ(engine_->Init(cfg), Status::kOk);
+  ASSERT_EQ(engine_->Load("file:///tmp/sample.mp3"), Status::kOk);
+
+  struct Counter {
+    std::atomic<int> frames{0};
+    std::atomic<int> markers{0};
+  };
+  Counter fast;
+  Counter slow;
+  std::atomic<int> spectra{0};
+  auto count_pcm = [](const PcmFrame& frame, void* ud) {
+    auto* c = static_cast<Counter*>(ud);
+    (frame.dropped ? c->markers : c->frames).fetch_add(1);
+  };
+
+  PcmSubscriberConfig fast_cfg;
+  fast_cfg.max_fps = 0;  // every chunk.
+  PcmSubscriberConfig slow_cfg;
+  slow_cfg.max_fps = 10;
+  slow_cfg.max_pending = 1000;  // never emit drop markers.
+  const SubscriptionId fast_id = engine_->AddPcmSubscriber(fast_cfg, count_pcm, &fast);
+  const SubscriptionId slow_id = engine_->AddPcmSubscriber(slow_cfg, count_pcm, &slow);
+  const SubscriptionId spectrum_id = engine_->AddSpectrumSubscriber(
+      slow_cfg,
+      [](const SpectrumFrame& spectrum, void* ud) {
+        EXPECT_GT(spectrum.num_bins, 0);
+        static_cast<std::atomic<int>*>(ud)->fetch_add(1);
+      },
+      &spectra);
+  ASSERT_NE(fast_id, 0u);
+  ASSERT_NE(slow_id, 0u);
+  ASSERT_NE(spectrum_id, 0u);
+  EXPECT_NE(fast_id, slow_id);
+  EXPECT_EQ(engine_->AddPcmSubscriber(fast_cfg, nullptr, nullptr), 0u);
+
+  ASSERT_EQ(engine_->Play(), Status::kOk);
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  ASSERT_EQ(engine_->Pause(), Status::kOk);
+
+  EXPECT_GT(fast.frames.load(), 3 * slow.frames.load());
+  EXPECT_GE(slow.frames.load(), 1);
+  EXPECT_LE(slow.frames.load(), 6);
+  EXPECT_EQ(slow.markers.load(), 0);
+  EXPECT_GE(spectra.load(), 1);
+  EXPECT_LE(spectra.load(), 6);
+
+  EXPECT_TRUE(engine_->RemoveSubscriber(fast_id));
+  EXPECT_FALSE(engine_->RemoveSubscriber(fast_id));
+  const int fast_before = fast.frames.load();
+  ASSERT_EQ(engine_->Play(), Status::kOk);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_EQ(engine_->Stop(), Status::kOk);
+  EXPECT_EQ(fast.frames.load(), fast_before);
+}
+
+TEST_F(AudioEngineTest, OverlapSpectrumEmitsPerHopWithHopAccurateTimestamps) {
+  ASSERT_NE(engine_, nullptr);
+  AudioConfig cfg;
+  cfg.sample_rate = 48000;
+  cfg.channels = 2;
+  cfg.frames_per_buffer = 256;
+  cfg.pcm_frames_per_push = 300;  // not a multiple of the hop.
+  cfg.spectrum_max_fps = 1000;    // 1 ms interval: every 10 ms hop passes.
+  cfg.spectrum_max_pending = 8;
+  cfg.spectrum_cfg.window_size = 1024;
+  cfg.spectrum_cfg.overlap = 544;  // hop = 480 frames = 10 ms.
+  ASSERT_EQ(engine_->Init(cfg), Status::kOk);
+  ASSERT_EQ(engine_->Load("file:///tmp/sample.mp3"), Status::kOk);
+
+  struct Capture {
+    std::mutex mu;
+    std::vector<int64_t> timestamps;
+  } capture;
+  engine_->SetSpectrumCallback(
+      [](const SpectrumFrame& spectrum, void* ud) {
+        auto* c = static_cast<Capture*>(ud);
+        EXPECT_EQ(spectrum.window_size, 1024);
+        EXPECT_EQ(spectrum.num_bins, 513);
+        std::lock_guard<std::mutex> lock(c->mu);
+        c->timestamps.push_back(spectrum.timestamp_ms);
+      },
+      &capture);
+
+  ASSERT_EQ(engine_->Play(), Status::kOk);
+  std::this_thread::sleep_for(std::chrono::milliseconds(250));
+  ASSERT_EQ(engine_->Stop(), Status::kOk);
+
+  std::lock_guard<std::mutex> lock(capture.mu);
+  ASSERT_GE(capture.timestamps.size(), 5u);
+  EXPECT_EQ(capture.timestamps[0], 0);
+  for (size_t i = 1; i < capture.timestamps.size(); ++i) {
+    EXPECT_EQ(capture.timestamps[i] - capture.timestamps[i - 1], 10) << "hop " << i;
+  }
+}
+
+namespace {
+
+// 写一段 s16 双声道裸 PCM（格式取自引擎配置）：L 为 0..32767 循环的斜坡，R 取反。
+std::string WriteRampRaw(const char* name, int frames) {
+  const std::string path = (std::filesystem::temp_directory_path() / name).string();
+  std::vector<int16_t> samples(static_cast<size_t>(frames) * 2);
+  for (int i = 0; i < frames; ++i) {
+    samples[static_cast<size_t>(i) * 2] = static_cast<int16_t>(i % 32768);
+    samples[static_cast<size_t>(i) * 2 + 1] = static_cast<int16_t>(-(i % 32768));
+  }
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(samples.data()),
+            static_cast<std::streamsize>(samples.size() * sizeof(int16_t)));
+  return path;
+}
+
+}  // namespace
+
+TEST_F(AudioEngineTest, FeederPushesEveryDecodedFrameExactlyOnce) {
+  // 推送块 300 帧与解码块 1024 帧互不整除：每个解码块都会在推送块中途用完。
+  constexpr int kFrames = 20000;
+  const std::string path = WriteRampRaw("sw_engine_feeder_ramp.raw", kFrames);
+  AudioConfig cfg;
+  cfg.sample_rate = 48000;
+  cfg.channels = 2;
+  cfg.frames_per_buffer = 480;
+  cfg.pcm_frames_per_push = 300;
+  cfg.pcm_max_fps = 0;
+  ASSERT_EQ(engine_->Init(cfg), Status::kOk);
+  ASSERT_EQ(engine_->Load(path), Status::kOk);
+
+  struct Seen {
+    std::mutex mu;
+    std::vector<float> samples;
+    std::vector<int> sizes;
+  };
+  Seen seen;
+  engine_->SetPcmCallback(
+      [](const PcmFrame& f, void* ud) {
+        auto* s = static_cast<Seen*>(ud);
+        std::lock_guard<std::mutex> lock(s->mu);
+        s->samples.insert(s->samples.end(), f.data, f.data + f.num_frames * f.num_channels);
+        s->sizes.push_back(f.num_frames);
+      },
+      &seen);
+  ASSERT_EQ(engine_->Play(), Status::kOk);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  // 暂停/恢复不应丢掉暂存区里尚未推送的帧。
+  ASSERT_EQ(engine_->Pause(), Status::kOk);
+  ASSERT_EQ(engine_->Play(), Status::kOk);
+  for (int i = 0; i < 200; ++i) {
+    {
+      std::lock_guard<std::mutex> lock(seen.mu);
+      if (seen.samples.size() >= static_cast<size_t>(kFrames) * 2 + 600) break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(engine_->Stop(), Status::kOk);
+
+  std::lock_guard<std::mutex> lock(seen.mu);
+  ASSERT_GE(seen.samples.size(), static_cast<size_t>(kFrames) * 2);
+  for (int i = 0; i < kFrames; ++i) {
+    const float expected = static_cast<float>(i % 32768) / 32768.0f;
+    ASSERT_EQ(seen.samples[static_cast<size_t>(i) * 2], expected) << "frame " << i;
+    ASSERT_EQ(seen.samples[static_cast<size_t>(i) * 2 + 1], -expected) << "frame " << i;
+  }
+  // 流中只有最后一块（20000 = 66 × 300 + 200）可以短于推送块，随后是整块静音。
+  int64_t total = 0;
+  for (size_t i = 0; i < seen.sizes.size() && total < kFrames; ++i) {
+    if (total + seen.sizes[i] < kFrames) {
+      EXPECT_EQ(seen.sizes[i], 300) << "push " << i;
+    }
+    total += seen.sizes[i];
+  }
+  EXPECT_EQ(total, kFrames);
+  for (size_t i = static_cast<size_t>(kFrames) * 2; i < seen.samples.size(); ++i) {
+    ASSERT_EQ(seen.samples[i], 0.0f);
+  }
+  std::remove(path.c_str());
+}
+
+TEST_F(AudioEngineTest, RejectedReInitKeepsRunningConfig) {
+  // 已 Init/Load 的引擎再次 Init 被拒绝时不能改动任何状态：之后 Play 仍按原来的双声道配置
+  // 从头推送（此前 cfg_ 已改成单声道而环形缓冲仍是双声道，喂数线程会越界读暂存区）。
+  const std::string path = WriteRampRaw("sw_engine_reinit.raw", 48000);
+  AudioConfig cfg;
+  cfg.sample_rate = 48000;
+  cfg.channels = 2;
+  cfg.frames_per_buffer = 480;
+  cfg.pcm_frames_per_push = 300;
+  cfg.pcm_max_fps = 0;
+  ASSERT_EQ(engine_->Init(cfg), Status::kOk);
+  ASSERT_EQ(engine_->Load(path), Status::kOk);
+
+  std::vector<AudioConfig> rejected;
+  AudioConfig bad_bands = cfg;
+  bad_bands.channels = 1;
+  bad_bands.sample_rate = 44100;
+  bad_bands.spectrum_cfg.band_scale = BandScale::kMel;
+  bad_bands.spectrum_cfg.min_hz = 0.0f;
+  rejected.push_back(bad_bands);
+  AudioConfig bad_post = bad_bands;
+  bad_post.spectrum_cfg.band_scale = BandScale::kNone;
+  bad_post.spectrum_cfg.post.release_ms = -1.0f;
+  rejected.push_back(bad_post);
+  AudioConfig bad_waveform = bad_bands;
+  bad_waveform.spectrum_cfg.band_scale = BandScale::kNone;
+  bad_waveform.waveform_cfg.num_buckets = 0;
+  rejected.push_back(bad_waveform);
+  AudioConfig bad_overlap = bad_bands;
+  bad_overlap.spectrum_cfg.band_scale = BandScale::kNone;
+  bad_overlap.spectrum_cfg.overlap = bad_overlap.spectrum_cfg.window_size;
+  rejected.push_back(bad_overlap);
+  for (const AudioConfig& bad : rejected) {
+    EXPECT_EQ(engine_->Init(bad), Status::kInvalidArguments);
+  }
+
+  struct Seen {
+    std::mutex mu;
+    std::vector<float> samples;
+    std::vector<int> channels;
+  };
+  Seen seen;
+  engine_->SetPcmCallback(
+      [](const PcmFrame& f, void* ud) {
+        auto* s = static_cast<Seen*>(ud);
+        std::lock_guard<std::mutex> lock(s->mu);
+        s->samples.insert(s->samples.end(), f.data, f.data + f.num_frames * f.num_channels);
+        s->channels.push_back(f.num_channels);
+      },
+      &seen);
+  ASSERT_EQ(engine_->Play(), Status::kOk);
+  for (int i = 0; i < 200; ++i) {
+    {
+      std::lock_guard<std::mutex> lock(seen.mu);
+      if (seen.samples.size() >= 4800 * 2) break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_EQ(engine_->Stop(), Status::kOk);
+
+  std::lock_guard<std::mutex> lock(seen.mu);
+  ASSERT_GE(seen.samples.size(), 4800u * 2);
+  for (int channels : seen.channels) {
+    EXPECT_EQ(channels, 2);
+  }
+  for (size_t i = 0; i < 4800; ++i) {
+    const float expected = static_cast<float>(i) / 32768.0f;
+    ASSERT_EQ(seen.samples[i * 2], expected) << "frame " << i;
+    ASSERT_EQ(seen.samples[i * 2 + 1], -expected) << "frame " << i;
+  }
+  std::remove(path.c_str());
+}
+
+TEST_F(AudioEngineTest, ReInitRebuildsPlaybackWithNewConfig) {
+  // 再次 Init 会重建环形缓冲与回放线程，旧回放线程必须先于旧缓冲释放。
+  const std::string path = WriteRampRaw("sw_engine_reinit_ok.raw", 48000);
+  AudioConfig cfg;
+  cfg.sample_rate = 48000;
+  cfg.channels = 2;
+  cfg.frames_per_buffer = 480;
+  cfg.pcm_max_fps = 0;
+  ASSERT_EQ(engine_->Init(cfg), Status::kOk);
+  ASSERT_EQ(engine_->Load(path), Status::kOk);
+  ASSERT_EQ(engine_->Play(), Status::kOk);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  cfg.channels = 1;
+  ASSERT_EQ(engine_->Init(cfg), Status::kOk);
+  std::atomic<int> bad_channels{0};
+  std::atomic<int> pushes{0};
+  auto ctx = std::make_pair(&bad_channels, &pushes);
+  engine_->SetPcmCallback(
+      [](const PcmFrame& f, void* ud) {
+        auto* c = static_cast<std::pair<std::atomic<int>*, std::atomic<int>*>*>(ud);
+        if (f.num_channels != 1) c->first->fetch_add(1);
+        c->second->fetch_add(1);
+      },
+      &ctx);
+  ASSERT_EQ(engine_->Load(path), Status::kOk);
+  ASSERT_EQ(engine_->Play(), Status::kOk);
+  for (int i = 0; i < 200 && pushes.load() < 5; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_EQ(engine_->Stop(), Status::kOk);
+  EXPECT_GE(pushes.load(), 5);
+  EXPECT_EQ(bad_channels.load(), 0);
+  std::remove(path.c_str());
+}
+
+TEST_F(AudioEngineTest, SeekResetsSpectrumPeakHold) {
+  // 前 300 ms 为 1 kHz 音调，之后静音。峰值保持 5 秒：不足 1 秒的向前 Seek 若不复位后处理
+  // 状态，静音位置的第一帧频谱仍会带着音调的峰值。
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "sw_engine_seek_peaks.raw").string();
+  {
+    std::vector<int16_t> samples(48000 * 2 * 2, 0);
+    for (size_t i = 0; i < 14400; ++i) {
+      const auto v = static_cast<int16_t>(
+          16000.0 * std::sin(2.0 * 3.14159265358979 * 1000.0 * static_cast<double>(i) / 48000));
+      samples[i * 2] = v;
+      samples[i * 2 + 1] = v;
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(samples.data()),
+              static_cast<std::streamsize>(samples.size() * sizeof(int16_t)));
+  }
+  AudioConfig cfg;
+  cfg.sample_rate = 48000;
+  cfg.channels = 2;
+  cfg.frames_per_buffer = 480;
+  cfg.pcm_max_fps = 0;
+  cfg.spectrum_cfg.post.peak_hold = true;
+  cfg.spectrum_cfg.post.peak_hold_ms = 5000.0f;
+  ASSERT_EQ(engine_->Init(cfg), Status::kOk);
+  ASSERT_EQ(engine_->Load(path), Status::kOk);
+
+  struct Peaks {
+    std::mutex mu;
+    std::vector<std::pair<int64_t, float>> frames;  // (timestamp_ms, 最大峰值)
+  };
+  Peaks peaks;
+  // 逐块频谱随 PCM 回调一起节流产出。
+  engine_->SetPcmCallback([](const PcmFrame&, void*) {}, nullptr);
+  engine_->SetSpectrumCallback(
+      [](const SpectrumFrame& s, void* ud) {
+        auto* p = static_cast<Peaks*>(ud);
+        float peak = 0.0f;
+        for (int i = 0; s.peaks != nullptr && i < s.num_bins; ++i) {
+          peak = std::max(peak, s.peaks[i]);
+        }
+        std::lock_guard<std::mutex> lock(p->mu);
+        p->frames.emplace_back(s.timestamp_ms, peak);
+      },
+      &peaks);
+  const auto wait_for = [&peaks](int64_t min_ts) {
+    for (int i = 0; i < 200; ++i) {
+      {
+        std::lock_guard<std::mutex> lock(peaks.mu);
+        for (const auto& f : peaks.frames) {
+          if (f.first >= min_ts) return true;
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+  };
+
+  ASSERT_EQ(engine_->Play(), Status::kOk);
+  ASSERT_TRUE(wait_for(50));
+  ASSERT_EQ(engine_->Seek(700), Status::kOk);
+  ASSERT_TRUE(wait_for(700));
+  ASSERT_EQ(engine_->Stop(), Status::kOk);
+
+  std::lock_guard<std::mutex> lock(peaks.mu);
+  ASSERT_GT(peaks.frames.front().second, 1e-3f);  // 音调段的峰值。
+  for (const auto& f : peaks.frames) {
+    if (f.first >= 700) {
+      EXPECT_EQ(f.second, 0.0f) << "spectrum at " << f.first << " ms";
+    }
+  }
+  std::remove(path.c_str());
+}
+
+TEST_F(AudioEngineTest, SeekWhileFeedingStartsExactlyAtTarget) {
+  // 播放中反复 Seek：每次 Seek 之后的第一块（sequence 重新从 1 开始）必须正好是目标位置的
+  // 样本、时间戳等于目标毫秒，之后各块首尾相接；不能混入 Seek 之前的数据。
+  const std::string path = WriteRampRaw("sw_engine_feeder_seek.raw", 48000 * 6);
+  AudioConfig cfg;
+  cfg.sample_rate = 48000;
+  cfg.channels = 2;
+  cfg.frames_per_buffer = 480;
+  cfg.pcm_frames_per_push = 300;
+  cfg.pcm_max_fps = 0;
+  ASSERT_EQ(engine_->Init(cfg), Status::kOk);
+  ASSERT_EQ(engine_->Load(path), Status::kOk);
+
+  struct Push {
+    uint32_t sequence;
+    int64_t timestamp_ms;
+    float first;
+    int frames;
+  };
+  struct Seen {
+    std::mutex mu;
+    std::vector<Push> pushes;
+    int restarts = 0;  // sequence == 1 的块数。
+  };
+  Seen seen;
+  engine_->SetPcmCallback(
+      [](const PcmFrame& f, void* ud) {
+        auto* s = static_cast<Seen*>(ud);
+        std::lock_guard<std::mutex> lock(s->mu);
+        s->pushes.push_back(Push{f.sequence, f.timestamp_ms, f.data[0], f.num_frames});
+        if (f.sequence == 1) ++s->restarts;
+      },
+      &seen);
+  const auto wait_restarts = [&seen](int n) {
+    for (int i = 0; i < 200; ++i) {
+      {
+        std::lock_guard<std::mutex> lock(seen.mu);
+        if (seen.restarts >= n) return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+  };
+
+  constexpr int kSeeks = 12;
+  std::vector<int64_t> targets = {0};
+  ASSERT_EQ(engine_->Play(), Status::kOk);
+  ASSERT_TRUE(wait_restarts(1));
+  for (int i = 0; i < kSeeks; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5 + 7 * (i % 3)));
+    targets.push_back(500 + 337 * i);
+    ASSERT_EQ(engine_->Seek(targets.back()), Status::kOk);
+    ASSERT_TRUE(wait_restarts(i + 2)) << "seek " << i;
+  }
+  ASSERT_EQ(engine_->Stop(), Status::kOk);
+
+  std::lock_guard<std::mutex> lock(seen.mu);
+  size_t segment = 0;
+  int64_t frame = 0;
+  for (size_t i = 0; i < seen.pushes.size(); ++i) {
+    const Push& p = seen.pushes[i];
+    if (p.sequence == 1) {
+      ASSERT_LT(segment, targets.size());
+      frame = targets[segment] * 48;
+      EXPECT_EQ(p.timestamp_ms, targets[segment]) << "segment " << segment;
+      ++segment;
+    }
+    ASSERT_GT(segment, 0u);
+    ASSERT_EQ(p.first, static_cast<float>(frame % 32768) / 32768.0f)
+        << "push " << i << " in segment " << segment - 1;
+    frame += p.frames;
+  }
+  EXPECT_EQ(segment, targets.size());
+  std::remove(path.c_str());
+}
+
 TEST(DecoderStubTest, OpenAndRead) {
   std::unique_ptr<Decoder> dec = CreateStubDecoder();
   ASSERT_TRUE(dec->Open("file:///tmp/sample.mp3"));
@@ -0,0 +1,207 @@
+#include "band_mapper.h"
+
+#include <gtest/gtest.h>
+
+#include "alloc_counter.h"
+#include "pcm_event_bus.h"
+#include "streaming_stft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace sw {
+
+namespace {
+
+constexpr float kPi = 3.14159265358979323846f;
+
+SpectrumConfig BandConfig(BandScale scale, int window_size, int num_bands = 32) {
+  SpectrumConfig cfg;
+  cfg.window_size = window_size;
+  cfg.band_scale = scale;
+  cfg.num_bands = num_bands;
+  return cfg;
+}
+
+std::vector<float> Sine(float hz, int sample_rate, int length) {
+  std::vector<float> v(static_cast<size_t>(length));
+  for (int n = 0; n < length; ++n) {
+    v[static_cast<size_t>(n)] = std::sin(2.0f * kPi * hz * n / static_cast<float>(sample_rate));
+  }
+  return v;
+}
+
+void ExpectWellFormed(const BandMapper& mapper) {
+  ASSERT_TRUE(mapper.configured());
+  for (int b = 0; b < mapper.num_bands(); ++b) {
+    ASSERT_GE(mapper.bin_count(b), 1) << "band " << b;
+    ASSERT_LE(mapper.first_bin(b) + mapper.bin_count(b), mapper.num_bins()) << "band " << b;
+    float sum = 0.0f;
+    for (int i = 0; i < mapper.bin_count(b); ++i) {
+      EXPECT_GT(mapper.weights(b)[i], 0.0f);
+      sum += mapper.weights(b)[i];
+    }
+    EXPECT_NEAR(sum, 1.0f, 1e-5f) << "band " << b;
+    if (b > 0) {
+      EXPECT_GT(mapper.center_hz()[b], mapper.center_hz()[b - 1]);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(BandMapperTest, MelFiltersAreNormalisedAndIncreasing) {
+  BandMapper mapper;
+  ASSERT_TRUE(mapper.Configure(BandConfig(BandScale::kMel, 2048, 40), 48000));
+  EXPECT_EQ(mapper.num_bands(), 40);
+  EXPECT_EQ(mapper.num_bins(), 1025);
+  ExpectWellFormed(mapper);
+  EXPECT_GT(mapper.center_hz()[0], 20.0f);
+  EXPECT_LT(mapper.center_hz()[39], 24000.0f);
+}
+
+TEST(BandMapperTest, ThirdOctaveBandsFollowNominalCentres) {
+  SpectrumConfig cfg = BandConfig(BandScale::kOctave, 4096);
+  cfg.octave_fraction = 3;
+  cfg.min_hz = 20.0f;
+  cfg.max_hz = 20000.0f;
+  BandMapper mapper;
+  ASSERT_TRUE(mapper.Configure(cfg, 48000));
+  // 1000 * 2^(k/3)，k ∈ [-16, 12]：约 25 Hz … 16 kHz，共 29 个频带。
+  EXPECT_EQ(mapper.num_bands(), 29);
+  ExpectWellFormed(mapper);
+  EXPECT_NEAR(mapper.center_hz()[16], 1000.0f, 1e-3f);
+}
+
+TEST(BandMapperTest, NarrowLogBandsInterpolateBetweenBins) {
+  // 256 点 @ 48 kHz 的 bin 间距为 187.5 Hz，低频的对数频带远窄于一个 bin。
+  BandMapper mapper;
+  ASSERT_TRUE(mapper.Configure(BandConfig(BandScale::kLog, 256, 64), 48000));
+  EXPECT_EQ(mapper.num_bands(), 64);
+  ExpectWellFormed(mapper);
+  EXPECT_LE(mapper.bin_count(0), 2);
+}
+
+TEST(BandMapperTest, ToneLandsInMatchingBand) {
+  constexpr int kRate = 48000;
+  SpectrumConfig cfg = BandConfig(BandScale::kOctave, 4096);
+  const auto tone = Sine(1000.0f, kRate, cfg.window_size);
+  const auto bands = ComputeSpectrum(tone, kRate, cfg);
+  ASSERT_EQ(static_cast<int>(bands.size()), SpectrumOutputSize(cfg, kRate));
+
+  BandMapper mapper;
+  ASSERT_TRUE(mapper.Configure(cfg, kRate));
+  const auto peak = std::max_element(bands.begin(), bands.end()) - bands.begin();
+  EXPECT_NEAR(mapper.center_hz()[peak], 1000.0f, 1e-3f);
+}
+
+TEST(BandMapperTest, ComputeSpectrumMatchesManualMapping) {
+  constexpr int kRate = 44100;
+  SpectrumConfig linear;
+  linear.window_size = 1024;
+  SpectrumConfig mel = linear;
+  mel.band_scale = BandScale::kMel;
+  mel.num_bands = 48;
+
+  auto signal = Sine(440.0f, kRate, 1024);
+  const auto overtone = Sine(3100.0f, kRate, 1024);
+  for (size_t i = 0; i < signal.size(); ++i) signal[i] += 0.3f * overtone[i];
+
+  const auto bins = ComputeSpectrum(signal, kRate, linear);
+  BandMapper mapper;
+  ASSERT_TRUE(mapper.Configure(mel, kRate));
+  std::vector<float> expected(static_cast<size_t>(mapper.num_bands()));
+  ASSERT_TRUE(mapper.Apply(bins.data(), bins.size(), expected.data(), expected.size()));
+
+  EXPECT_EQ(SpectrumOutputSize(mel, kRate), 48);
+  EXPECT_EQ(SpectrumOutputSize(linear, kRate), 513);
+  const auto bands = ComputeSpectrum(signal, kRate, mel);
+  ASSERT_EQ(bands.size(), expected.size());
+  for (size_t b = 0; b < bands.size(); ++b) {
+    EXPECT_FLOAT_EQ(bands[b], expected[b]);
+  }
+
+  std::vector<float> out(48);
+  EXPECT_FALSE(ComputeSpectrum(signal.data(), signal.size(), kRate, mel, out.data(), 47));
+  EXPECT_FALSE(ComputeSpectrum(signal.data(), signal.size(), 0, mel, out.data(), out.size()));
+}
+
+TEST(BandMapperTest, ApplyDoesNotAllocate) {
+  BandMapper mapper;
+  ASSERT_TRUE(mapper.Configure(BandConfig(BandScale::kMel, 1024, 64), 48000));
+  std::vector<float> bins(513, 1.0f);
+  std::vector<float> bands(64);
+
+  sw::testing::ScopedAllocCounter allocs;
+  for (int i = 0; i < 32; ++i) {
+    ASSERT_TRUE(mapper.Apply(bins.data(), bins.size(), bands.data(), bands.size()));
+  }
+  ASSERT_TRUE(mapper.Configure(BandConfig(BandScale::kMel, 1024, 64), 48000));  // 参数未变
+  EXPECT_EQ(allocs.count(), 0u);
+  for (float v : bands) EXPECT_NEAR(v, 1.0f, 1e-5f);  // 权重和为 1：平坦谱保持不变
+}
+
+TEST(BandMapperTest, RejectsInvalidConfig) {
+  BandMapper mapper;
+  EXPECT_FALSE(mapper.Configure(BandConfig(BandScale::kNone, 1024), 48000));
+  EXPECT_FALSE(mapper.Configure(BandConfig(BandScale::kMel, 1024, 0), 48000));
+  EXPECT_FALSE(mapper.Configure(BandConfig(BandScale::kMel, 1024), 0));
+
+  SpectrumConfig cfg = BandConfig(BandScale::kLog, 1024);
+  cfg.min_hz = 0.0f;
+  EXPECT_FALSE(mapper.Configure(cfg, 48000));
+  cfg.min_hz = 30000.0f;  // 高于 Nyquist
+  EXPECT_FALSE(mapper.Configure(cfg, 48000));
+
+  cfg = BandConfig(BandScale::kOctave, 1024);
+  cfg.octave_fraction = 0;
+  EXPECT_FALSE(mapper.Configure(cfg, 48000));
+  cfg.octave_fraction = 25;
+  EXPECT_FALSE(mapper.Configure(cfg, 48000));
+  EXPECT_FALSE(mapper.configured());
+
+  std::vector<float> bins(513);
+  std::vector<float> bands(8);
+  EXPECT_FALSE(mapper.Apply(bins.data(), bins.size(), bands.data(), bands.size()));
+}
+
+TEST(BandMapperTest, EventBusAndStftEmitBands) {
+  SpectrumConfig cfg = BandConfig(BandScale::kLog, 256, 16);
+
+  PcmIngressConfig ingress;
+  ingress.expected_sample_rate = 48000;
+  ingress.expected_channels = 2;
+  ingress.throttle.max_fps = 0;
+  PcmEventBus bus(ingress, cfg);
+  int bus_bins = 0;
+  BandScale bus_scale = BandScale::kNone;
+  bool bus_has_hz = false;
+  bus.SetSpectrumCallback([&](const SpectrumFrame& s) {
+    bus_bins = s.num_bins;
+    bus_scale = s.band_scale;
+    bus_has_hz = s.band_hz != nullptr;
+  });
+  std::vector<float> samples(256 * 2, 0.25f);
+  PcmInputFrame frame{samples.data(), 256, 48000, 2, 0, 1};
+  ASSERT_EQ(bus.Push(frame, 0), Status::kOk);
+  EXPECT_EQ(bus_bins, 16);
+  EXPECT_EQ(bus_scale, BandScale::kLog);
+  EXPECT_TRUE(bus_has_hz);
+
+  cfg.overlap = 128;
+  StreamingStft stft;
+  ASSERT_TRUE(stft.Configure(cfg, 48000));
+  EXPECT_EQ(stft.num_bins(), 16);
+  stft.Push(samples.data(), 256, 2);
+  StftFrame out;
+  ASSERT_TRUE(stft.Next(&out));
+  EXPECT_EQ(out.spectrum.num_bins, 16);
+  EXPECT_EQ(out.spectrum.band_scale, BandScale::kLog);
+  ASSERT_NE(out.spectrum.band_hz, nullptr);
+
+  cfg.min_hz = -1.0f;
+  EXPECT_FALSE(stft.Configure(cfg, 48000));
+}
+
+}  // namespace sw
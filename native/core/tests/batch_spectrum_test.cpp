@@ -0,0 +1,127 @@
+#include "fft_spectrum.h"
+
+#include <gtest/gtest.h>
+
+#include "alloc_counter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr float kPi = 3.14159265358979323846f;
+
+// 每路不同频率/相位/幅度，避免各 lane 结果相同掩盖打包错误。
+std::vector<std::vector<float>> MakeStreams(int count, int length) {
+  std::vector<std::vector<float>> streams(static_cast<size_t>(count));
+  for (int s = 0; s < count; ++s) {
+    auto& v = streams[static_cast<size_t>(s)];
+    v.resize(static_cast<size_t>(length));
+    const float freq = 0.01f + 0.013f * static_cast<float>(s);
+    const float amp = 0.2f + 0.1f * static_cast<float>(s);
+    for (int n = 0; n < length; ++n) {
+      v[static_cast<size_t>(n)] =
+          amp * std::sin(2.0f * kPi * freq * static_cast<float>(n) + 0.3f * s) +
+          0.05f * std::cos(0.17f * static_cast<float>(n * (s + 1)));
+    }
+  }
+  return streams;
+}
+
+}  // namespace
+
+namespace sw {
+
+TEST(BatchSpectrumTest, MatchesPerStreamAnalyzerForAnyStreamCount) {
+#if defined(__x86_64__) && !defined(_MSC_VER)
+  EXPECT_EQ(BatchSpectrumAnalyzer::lanes(), 4);
+#endif
+  for (WindowType window : {WindowType::kHann, WindowType::kHamming}) {
+    for (bool power : {true, false}) {
+      for (int window_size : {64, 1024, 1030}) {  // 1030: 打包/解包都有非 4 对齐尾部
+        SpectrumConfig cfg;
+        cfg.window_size = window_size;
+        cfg.window = window;
+        cfg.power_spectrum = power;
+        BatchSpectrumAnalyzer batch(cfg);
+        SpectrumAnalyzer single(cfg);
+        ASSERT_EQ(batch.num_bins(), window_size / 2 + 1);
+
+        for (int streams = 1; streams <= 9; ++streams) {
+          const auto input = MakeStreams(streams, window_size);
+          std::vector<const float*> in_ptrs;
+          std::vector<std::vector<float>> out(static_cast<size_t>(streams),
+                                              std::vector<float>(batch.num_bins(), -1.0f));
+          std::vector<float*> out_ptrs;
+          for (int s = 0; s < streams; ++s) {
+            in_ptrs.push_back(input[static_cast<size_t>(s)].data());
+            out_ptrs.push_back(out[static_cast<size_t>(s)].data());
+          }
+          ASSERT_TRUE(batch.Compute(in_ptrs.data(), static_cast<size_t>(window_size), streams,
+                                    out_ptrs.data(), static_cast<size_t>(batch.num_bins())));
+
+          for (int s = 0; s < streams; ++s) {
+            const auto expected = single.Compute(input[static_cast<size_t>(s)]);
+            ASSERT_EQ(expected.size(), out[static_cast<size_t>(s)].size());
+            const float peak = *std::max_element(expected.begin(), expected.end());
+            for (size_t k = 0; k < expected.size(); ++k) {
+              ASSERT_NEAR(out[static_cast<size_t>(s)][k], expected[k], 1e-5f * peak + 1e-9f)
+                  << "window=" << window_size << " streams=" << streams << " s=" << s
+                  << " k=" << k;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(BatchSpectrumTest, ComputeDoesNotAllocate) {
+  SpectrumConfig cfg;
+  cfg.window_size = 512;
+  BatchSpectrumAnalyzer batch(cfg);
+  const auto input = MakeStreams(8, 512);
+  std::vector<std::vector<float>> out(8, std::vector<float>(batch.num_bins()));
+  const float* in_ptrs[8];
+  float* out_ptrs[8];
+  for (int s = 0; s < 8; ++s) {
+    in_ptrs[s] = input[static_cast<size_t>(s)].data();
+    out_ptrs[s] = out[static_cast<size_t>(s)].data();
+  }
+  ASSERT_TRUE(batch.Compute(in_ptrs, 512, 8, out_ptrs, out[0].size()));
+
+  sw::testing::ScopedAllocCounter allocs;
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_TRUE(batch.Compute(in_ptrs, 512, 8, out_ptrs, out[0].size()));
+  }
+  EXPECT_EQ(allocs.count(), 0u);
+}
+
+TEST(BatchSpectrumTest, RejectsInvalidArguments) {
+  BatchSpectrumAnalyzer unconfigured;
+  EXPECT_EQ(unconfigured.num_bins(), 0);
+
+  SpectrumConfig odd;
+  odd.window_size = 255;
+  BatchSpectrumAnalyzer batch;
+  EXPECT_FALSE(batch.Configure(odd));
+  EXPECT_EQ(batch.num_bins(), 0);
+
+  SpectrumConfig cfg;
+  cfg.window_size = 256;
+  ASSERT_TRUE(batch.Configure(cfg));
+  std::vector<float> samples(256, 0.1f);
+  std::vector<float> bins(static_cast<size_t>(batch.num_bins()));
+  const float* in_ptrs[2] = {samples.data(), nullptr};
+  float* out_ptrs[2] = {bins.data(), bins.data()};
+
+  EXPECT_FALSE(batch.Compute(in_ptrs, 256, 0, out_ptrs, bins.size()));
+  EXPECT_FALSE(batch.Compute(in_ptrs, 255, 1, out_ptrs, bins.size()));
+  EXPECT_FALSE(batch.Compute(in_ptrs, 256, 1, out_ptrs, bins.size() - 1));
+  EXPECT_FALSE(batch.Compute(in_ptrs, 256, 2, out_ptrs, bins.size()));  // 第 2 路为空
+  EXPECT_FALSE(batch.Compute(nullptr, 256, 1, out_ptrs, bins.size()));
+  EXPECT_TRUE(batch.Compute(in_ptrs, 256, 1, out_ptrs, bins.size()));
+}
+
+}  // namespace sw
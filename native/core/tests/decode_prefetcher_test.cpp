@@ -0,0 +1,328 @@
+#include "decode_prefetcher.h"
+
+#include <gtest/gtest.h>
+
+#include "alloc_counter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sw {
+
+namespace {
+
+constexpr int kRate = 48000;
+
+// 单声道斜坡：第 n 帧的值为 n。available 之后的帧在放行前不交付（Read 轮询等待，等待期间
+// blocked_at 为当前位置），fail_at 处返回 kError。
+class RampDecoder : public Decoder {
+ public:
+  RampDecoder(int64_t total, int block) : total_(total), block_(block) {}
+
+  bool Open(const std::string&) override { return true; }
+  bool Read(PcmBuffer& out) override {
+    while (position_ >= available.load() && position_ < total_ && !release.load()) {
+      blocked_at.store(position_);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    blocked_at.store(-1);
+    if (position_ >= fail_at) {
+      status_ = Status::kError;
+      return false;
+    }
+    status_ = Status::kOk;
+    const int64_t frames = std::min<int64_t>(block_, total_ - position_);
+    if (frames <= 0) return false;
+    out.sample_rate = kRate;
+    out.channels = 1;
+    out.interleaved.resize(static_cast<size_t>(frames));
+    for (int64_t i = 0; i < frames; ++i) {
+      out.interleaved[static_cast<size_t>(i)] = static_cast<float>(position_ + i);
+    }
+    position_ += frames;
+    reads.fetch_add(1);
+    return true;
+  }
+  void Close() override {}
+  bool Seek(int64_t frame) override {
+    position_ = std::min(frame, total_);
+    return true;
+  }
+  int sample_rate() const override { return kRate; }
+  int channels() const override { return 1; }
+  bool ConfigureOutput(int, int) override { return true; }
+  Status last_status() const override { return status_; }
+
+  std::atomic<int64_t> available{INT64_MAX};
+  std::atomic<bool> release{false};
+  std::atomic<int> reads{0};
+  std::atomic<int64_t> blocked_at{-1};
+  int64_t fail_at = INT64_MAX;
+
+ private:
+  int64_t total_;
+  int block_;
+  int64_t position_ = 0;
+  Status status_ = Status::kOk;
+};
+
+DecodePrefetcherConfig Config(int read_ahead_ms, int refill_ms, int block) {
+  DecodePrefetcherConfig cfg;
+  cfg.sample_rate = kRate;
+  cfg.channels = 1;
+  cfg.read_ahead_ms = read_ahead_ms;
+  cfg.refill_ms = refill_ms;
+  cfg.block_frames_hint = block;
+  return cfg;
+}
+
+// 轮询直到 done() 成立。期限只防止测试挂死，结果不取决于机器快慢。
+template <typename Fn>
+bool WaitUntil(Fn&& done) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline) return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+// 预解码线程已在解码器的 Read 里等待 position 处的数据：此前解码的块都已入队。
+bool WaitUntilBlockedAt(const RampDecoder& decoder, int64_t position) {
+  return WaitUntil([&] { return decoder.blocked_at.load() == position; });
+}
+
+PrefetchResult PopWait(DecodePrefetcher& prefetcher, PcmBuffer* out, Status* status) {
+  for (int i = 0; i < 200; ++i) {
+    const PrefetchResult result = prefetcher.Pop(out, status);
+    if (result != PrefetchResult::kEmpty) return result;
+    prefetcher.WaitForData(std::chrono::milliseconds(10));
+  }
+  return PrefetchResult::kEmpty;
+}
+
+}  // namespace
+
+TEST(DecodePrefetcherTest, RejectsInvalidConfig) {
+  RampDecoder decoder(1000, 100);
+  EXPECT_FALSE(DecodePrefetcher(Config(0, 0, 100)).Start(&decoder));
+  EXPECT_FALSE(DecodePrefetcher(Config(100, 200, 100)).Start(&decoder));
+  EXPECT_FALSE(DecodePrefetcher(Config(100, -1, 100)).Start(&decoder));
+  DecodePrefetcher ok(Config(100, 0, 100));
+  EXPECT_FALSE(ok.Start(nullptr));
+  EXPECT_TRUE(ok.Start(&decoder));
+  EXPECT_FALSE(ok.Start(&decoder));
+  ok.Stop();
+  EXPECT_FALSE(ok.running());
+}
+
+TEST(DecodePrefetcherTest, DeliversEveryFrameInOrderThenEnds) {
+  RampDecoder decoder(100000, 333);
+  DecodePrefetcher prefetcher(Config(50, 0, 333));
+  ASSERT_TRUE(prefetcher.Start(&decoder));
+  PcmBuffer block;
+  Status status = Status::kError;
+  int64_t next = 0;
+  PrefetchResult result;
+  while ((result = PopWait(prefetcher, &block, &status)) == PrefetchResult::kBlock) {
+    ASSERT_EQ(block.channels, 1);
+    for (float v : block.interleaved) {
+      ASSERT_EQ(v, static_cast<float>(next));
+      ++next;
+    }
+  }
+  EXPECT_EQ(result, PrefetchResult::kEnd);
+  EXPECT_EQ(status, Status::kOk);
+  EXPECT_EQ(next, 100000);
+  EXPECT_EQ(prefetcher.buffered_frames(), 0);
+  prefetcher.Stop();
+}
+
+TEST(DecodePrefetcherTest, PausesAtHighWaterAndRefillsBelowLowWater) {
+  // 解码器只放行 15 块：预解码线程若在高水位之后继续解码，会停在 Read 里而不是越过去。
+  RampDecoder decoder(10 * kRate, 480);
+  decoder.available = 15 * 480;
+  DecodePrefetcher prefetcher(Config(100, 40, 480));  // 高水位 4800 帧，低水位 1920 帧。
+  ASSERT_TRUE(prefetcher.Start(&decoder));
+  ASSERT_TRUE(WaitUntil([&] { return prefetcher.buffered_frames() >= 4800; }));
+  // 恰好 10 块达到高水位后暂停。
+  EXPECT_EQ(prefetcher.buffered_frames(), 4800);
+  EXPECT_EQ(prefetcher.buffered_ms(), 100);
+  EXPECT_EQ(prefetcher.stats().blocks_decoded, 10u);
+
+  // 取到低水位之上（4 块，余 2880 帧）：不恢复解码。
+  PcmBuffer block;
+  Status status;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(prefetcher.Pop(&block, &status), PrefetchResult::kBlock);
+  }
+  EXPECT_EQ(prefetcher.stats().refills, 0u);
+  EXPECT_EQ(prefetcher.stats().blocks_decoded, 10u);
+
+  // 跌破低水位（再取 2 块，余 1920 帧）：成批补到放行上限，正好补回 5 块后停在 Read 里。
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_EQ(prefetcher.Pop(&block, &status), PrefetchResult::kBlock);
+  }
+  ASSERT_TRUE(WaitUntilBlockedAt(decoder, 15 * 480));
+  EXPECT_EQ(prefetcher.stats().refills, 1u);
+  EXPECT_EQ(prefetcher.stats().blocks_decoded, 15u);
+  EXPECT_EQ(prefetcher.buffered_frames(), 1920 + 5 * 480);
+
+  decoder.release = true;
+  prefetcher.Stop();
+}
+
+TEST(DecodePrefetcherTest, SeekDiscardsQueuedBlocks) {
+  RampDecoder decoder(10 * kRate, 256);
+  DecodePrefetcher prefetcher(Config(200, 0, 256));
+  ASSERT_TRUE(prefetcher.Start(&decoder));
+  ASSERT_TRUE(WaitUntil([&] { return prefetcher.buffered_frames() >= 9600; }));
+  PcmBuffer block;
+  Status status;
+  ASSERT_EQ(prefetcher.Pop(&block, &status), PrefetchResult::kBlock);
+  EXPECT_EQ(block.interleaved[0], 0.0f);
+
+  prefetcher.Seek(123456);
+  ASSERT_EQ(PopWait(prefetcher, &block, &status), PrefetchResult::kBlock);
+  EXPECT_EQ(block.interleaved[0], 123456.0f);
+
+  // 停止期间的 Seek 在下次 Start 时生效，之前解码的块同样作废。
+  prefetcher.Stop();
+  prefetcher.Seek(1000);
+  ASSERT_TRUE(prefetcher.Start(&decoder));
+  ASSERT_EQ(PopWait(prefetcher, &block, &status), PrefetchResult::kBlock);
+  EXPECT_EQ(block.interleaved[0], 1000.0f);
+  prefetcher.Stop();
+
+  // Reset 丢弃一切，从解码器当前位置继续。
+  prefetcher.Reset();
+  EXPECT_EQ(prefetcher.buffered_frames(), 0);
+  decoder.Seek(0);
+  ASSERT_TRUE(prefetcher.Start(&decoder));
+  ASSERT_EQ(PopWait(prefetcher, &block, &status), PrefetchResult::kBlock);
+  EXPECT_EQ(block.interleaved[0], 0.0f);
+  prefetcher.Stop();
+}
+
+TEST(DecodePrefetcherTest, ReportsDecoderErrorAfterQueuedBlocks) {
+  RampDecoder decoder(10000, 100);
+  decoder.fail_at = 1000;
+  DecodePrefetcher prefetcher(Config(500, 0, 100));
+  ASSERT_TRUE(prefetcher.Start(&decoder));
+  PcmBuffer block;
+  Status status = Status::kOk;
+  int blocks = 0;
+  PrefetchResult result;
+  while ((result = PopWait(prefetcher, &block, &status)) == PrefetchResult::kBlock) ++blocks;
+  EXPECT_EQ(result, PrefetchResult::kEnd);
+  EXPECT_EQ(status, Status::kError);
+  EXPECT_EQ(blocks, 10);
+
+  // Seek 之后重新解码，结尾状态不再沿用。
+  decoder.fail_at = INT64_MAX;
+  prefetcher.Seek(9900);
+  ASSERT_EQ(PopWait(prefetcher, &block, &status), PrefetchResult::kBlock);
+  EXPECT_EQ(block.interleaved[0], 9900.0f);
+  EXPECT_EQ(PopWait(prefetcher, &block, &status), PrefetchResult::kEnd);
+  EXPECT_EQ(status, Status::kOk);
+  prefetcher.Stop();
+}
+
+TEST(DecodePrefetcherTest, CountsUnderrunsOnlyAfterDataWasDelivered) {
+  RampDecoder decoder(kRate, 480);
+  decoder.available = 0;
+  DecodePrefetcher prefetcher(Config(100, 0, 480));
+  ASSERT_TRUE(prefetcher.Start(&decoder));
+  PcmBuffer block;
+  Status status;
+  // 启动时还没有数据：不算欠载。
+  EXPECT_EQ(prefetcher.Pop(&block, &status), PrefetchResult::kEmpty);
+  EXPECT_FALSE(prefetcher.WaitForData(std::chrono::milliseconds(5)));
+  EXPECT_EQ(prefetcher.stats().underruns, 0u);
+
+  // 放行两块，等它们都入队再取，取空才只会发生在两块之后。
+  decoder.available = 960;
+  ASSERT_TRUE(WaitUntilBlockedAt(decoder, 960));
+  ASSERT_EQ(prefetcher.Pop(&block, &status), PrefetchResult::kBlock);
+  ASSERT_EQ(prefetcher.Pop(&block, &status), PrefetchResult::kBlock);
+  // 供给中断：连续取空只计一次。
+  EXPECT_EQ(prefetcher.Pop(&block, &status), PrefetchResult::kEmpty);
+  EXPECT_EQ(prefetcher.Pop(&block, &status), PrefetchResult::kEmpty);
+  EXPECT_EQ(prefetcher.stats().underruns, 1u);
+
+  decoder.available = 1440;
+  ASSERT_TRUE(WaitUntilBlockedAt(decoder, 1440));
+  ASSERT_EQ(prefetcher.Pop(&block, &status), PrefetchResult::kBlock);
+  EXPECT_EQ(prefetcher.Pop(&block, &status), PrefetchResult::kEmpty);
+  EXPECT_EQ(prefetcher.stats().underruns, 2u);
+  EXPECT_EQ(prefetcher.stats().blocks_decoded, 3u);
+
+  decoder.release = true;
+  prefetcher.Stop();
+}
+
+TEST(DecodePrefetcherTest, SteadyStatePopDoesNotAllocate) {
+  RampDecoder decoder(60 * kRate, 1024);
+  DecodePrefetcher prefetcher(Config(100, 0, 1024));
+  ASSERT_TRUE(prefetcher.Start(&decoder));
+  PcmBuffer block;
+  Status status;
+  // 预热：让消费端缓冲与池里各块都长到块大小。
+  for (int i = 0; i < 64; ++i) {
+    ASSERT_EQ(PopWait(prefetcher, &block, &status), PrefetchResult::kBlock);
+  }
+  int64_t frames = 0;
+  sw::testing::ScopedAllocCounter allocs;
+  for (int i = 0; i < 256; ++i) {
+    if (PopWait(prefetcher, &block, &status) != PrefetchResult::kBlock) break;
+    frames += static_cast<int64_t>(block.interleaved.size());
+  }
+  EXPECT_EQ(allocs.count(), 0u);
+  EXPECT_EQ(frames, 256 * 1024);
+  prefetcher.Stop();
+}
+
+TEST(DecodePrefetcherTest, EngineReportsBufferedAheadAndUnderruns) {
+  // 10 秒静音的 s16 双声道裸 PCM（格式取自 AudioConfig）。解码器 mmap 该文件，文件名带上
+  // 时钟计数，避免并发运行的测试互相截断对方映射着的文件。
+  const std::string path =
+      (std::filesystem::temp_directory_path() /
+       ("sw_decode_prefetcher_engine_" +
+        std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".raw"))
+          .string();
+  {
+    const std::vector<char> silence(static_cast<size_t>(10 * kRate * 2 * 2), 0);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(silence.data(), static_cast<std::streamsize>(silence.size()));
+  }
+  auto engine = CreateAudioEngineStub();
+  EXPECT_EQ(engine->GetBufferStats().buffered_ahead_ms, 0);
+  AudioConfig cfg;
+  cfg.sample_rate = kRate;
+  cfg.channels = 2;
+  cfg.frames_per_buffer = 480;
+  cfg.prefetch_ms = 300;
+  ASSERT_EQ(engine->Init(cfg), Status::kOk);
+  ASSERT_EQ(engine->Load(path), Status::kOk);
+  ASSERT_EQ(engine->Play(), Status::kOk);
+
+  // 实时播放中欠载与否取决于机器负载，这里只检查快照的一致性，不断言欠载次数。
+  BufferStats stats;
+  ASSERT_TRUE(WaitUntil([&] {
+    stats = engine->GetBufferStats();
+    return stats.prefetched_ms > 0 && stats.ring_ms > 0;
+  }));
+  EXPECT_LE(stats.prefetched_ms, 300 + 1024 * 1000 / kRate);
+  EXPECT_EQ(stats.buffered_ahead_ms, stats.prefetched_ms + stats.ring_ms);
+  ASSERT_EQ(engine->Stop(), Status::kOk);
+  std::remove(path.c_str());
+}
+
+}  // namespace sw
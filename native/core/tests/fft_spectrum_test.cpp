@@ -2,8 +2,11 @@
 
 #include <gtest/gtest.h>
 
+#include "alloc_counter.h"
+
 #include <cmath>
 #include <limits>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -253,4 +256,263 @@ TEST(FftSpectrumTest, CrossPlatformAlignmentMatchesNaiveReference) {
   }
 }
 
+TEST(FftSpectrumTest, AnalyzerMatchesComputeSpectrumAcrossReconfigure) {
+  const int sample_rate = 48000;
+  std::vector<float> samples(1024);
+  float val = 0.37f;
+  for (auto& s : samples) {
+    val = std::fmod(val * 2.713f + 0.021f, 1.0f);
+    s = val * 2.0f - 1.0f;
+  }
+
+  SpectrumAnalyzer analyzer;
+  EXPECT_EQ(analyzer.num_bins(), 0);
+  EXPECT_TRUE(analyzer.Compute(samples).empty());
+
+  const int sizes[] = {256, 1024, 256};
+  const WindowType windows[] = {WindowType::kHann, WindowType::kHamming};
+  for (int size : sizes) {
+    for (WindowType window : windows) {
+      for (bool power : {true, false}) {
+        SpectrumConfig cfg;
+        cfg.window_size = size;
+        cfg.window = window;
+        cfg.power_spectrum = power;
+        ASSERT_TRUE(analyzer.Configure(cfg));
+        EXPECT_EQ(analyzer.num_bins(), size / 2 + 1);
+        const auto ref = ComputeSpectrum(samples, sample_rate, cfg);
+        // Run twice to make sure cached scratch state does not leak between frames.
+        analyzer.Compute(samples);
+        const auto sut = analyzer.Compute(samples);
+        ASSERT_EQ(ref.size(), sut.size());
+        for (size_t i = 0; i < ref.size(); ++i) {
+          EXPECT_FLOAT_EQ(ref[i], sut[i]) << "size " << size << " bin " << i;
+        }
+      }
+    }
+  }
+
+  SpectrumConfig bad;
+  bad.window_size = 0;
+  EXPECT_FALSE(analyzer.Configure(bad));
+  EXPECT_EQ(analyzer.num_bins(), 0);
+  EXPECT_TRUE(analyzer.Compute(samples).empty());
+}
+
+TEST(FftSpectrumTest, AnalyzerRejectsShortInput) {
+  SpectrumConfig cfg;
+  cfg.window_size = 512;
+  SpectrumAnalyzer analyzer(cfg);
+  std::vector<float> samples(256);
+  EXPECT_TRUE(analyzer.Compute(samples).empty());
+}
+
+TEST(FftSpectrumTest, SpanOverloadsMatchVectorApi) {
+  const int sample_rate = 48000;
+  const int frames = 300;
+  const int channels = 2;
+  std::vector<float> interleaved(static_cast<size_t>(frames * channels));
+  for (int i = 0; i < frames; ++i) {
+    interleaved[static_cast<size_t>(i * channels)] = std::sin(0.05f * i);
+    interleaved[static_cast<size_t>(i * channels + 1)] = std::cos(0.11f * i);
+  }
+
+  const auto mono_ref = DownmixToMono(interleaved.data(), frames, channels, 256);
+  std::vector<float> mono(512, -1.0f);
+  ASSERT_EQ(DownmixToMono(interleaved.data(), frames, channels, 256, mono.data(), 512), 256);
+  for (size_t i = 0; i < mono_ref.size(); ++i) {
+    EXPECT_FLOAT_EQ(mono_ref[i], mono[i]);
+  }
+  EXPECT_FLOAT_EQ(mono[256], -1.0f);  // untouched beyond window.
+  EXPECT_EQ(DownmixToMono(interleaved.data(), frames, channels, 256, mono.data(), 100), 100);
+  EXPECT_EQ(DownmixToMono(nullptr, frames, channels, 256, mono.data(), 512), 0);
+
+  SpectrumConfig cfg;
+  cfg.window_size = 256;
+  const auto ref = ComputeSpectrum(mono_ref, sample_rate, cfg);
+  std::vector<float> bins(static_cast<size_t>(cfg.window_size / 2 + 1));
+  ASSERT_TRUE(ComputeSpectrum(mono_ref.data(), mono_ref.size(), sample_rate, cfg, bins.data(),
+                              bins.size()));
+  for (size_t i = 0; i < ref.size(); ++i) {
+    EXPECT_FLOAT_EQ(ref[i], bins[i]);
+  }
+  // Too-small output or input is rejected.
+  EXPECT_FALSE(ComputeSpectrum(mono_ref.data(), mono_ref.size(), sample_rate, cfg, bins.data(),
+                               bins.size() - 1));
+  EXPECT_FALSE(ComputeSpectrum(mono_ref.data(), 10, sample_rate, cfg, bins.data(), bins.size()));
+}
+
+TEST(FftSpectrumTest, SteadyStateSpanPathDoesNotAllocate) {
+  const int sample_rate = 48000;
+  const int frames = 1024;
+  const int channels = 2;
+  std::vector<float> interleaved(static_cast<size_t>(frames * channels));
+  for (size_t i = 0; i < interleaved.size(); ++i) {
+    interleaved[i] = std::sin(0.013f * static_cast<float>(i));
+  }
+
+  SpectrumConfig cfg;
+  cfg.window_size = frames;
+  SpectrumAnalyzer analyzer(cfg);
+  std::vector<float> mono(static_cast<size_t>(frames));
+  std::vector<float> bins(static_cast<size_t>(analyzer.num_bins()));
+
+  // Warm the per-thread plan cache used by the free function.
+  ASSERT_TRUE(ComputeSpectrum(mono.data(), mono.size(), sample_rate, cfg, bins.data(),
+                              bins.size()));
+
+  sw::testing::ScopedAllocCounter allocs;
+  for (int iter = 0; iter < 100; ++iter) {
+    const int n = DownmixToMono(interleaved.data(), frames, channels, cfg.window_size,
+                                mono.data(), static_cast<int>(mono.size()));
+    ASSERT_EQ(n, frames);
+    ASSERT_TRUE(analyzer.Compute(mono.data(), mono.size(), bins.data(), bins.size()));
+    ASSERT_TRUE(ComputeSpectrum(mono.data(), mono.size(), sample_rate, cfg, bins.data(),
+                                bins.size()));
+  }
+  EXPECT_EQ(allocs.count(), 0u);
+}
+
+TEST(FftSpectrumTest, SpectrogramRowsMatchPerWindowComputeSpectrum) {
+  const int sample_rate = 48000;
+  std::vector<float> mono(10000);
+  for (size_t i = 0; i < mono.size(); ++i) {
+    mono[i] = std::sin(2.0f * static_cast<float>(M_PI) * 1500.0f * i / sample_rate) +
+              0.25f * std::sin(2.0f * static_cast<float>(M_PI) * 7000.0f * i / sample_rate);
+  }
+
+  SpectrogramConfig cfg;
+  cfg.window_size = 512;
+  cfg.hop_size = 128;
+  cfg.power_spectrum = false;
+  cfg.num_threads = 1;
+  const int rows = SpectrogramFrameCount(mono.size(), cfg);
+  const int bins = SpectrogramBinCount(cfg);
+  ASSERT_EQ(rows, (10000 - 512) / 128 + 1);
+  ASSERT_EQ(bins, 257);
+
+  const std::vector<float> matrix = ComputeSpectrogram(mono.data(), mono.size(), 1, cfg);
+  ASSERT_EQ(matrix.size(), static_cast<size_t>(rows) * bins);
+
+  SpectrumConfig single;
+  single.window_size = cfg.window_size;
+  single.window = cfg.window;
+  single.power_spectrum = cfg.power_spectrum;
+  std::vector<float> expected(static_cast<size_t>(bins));
+  for (int row = 0; row < rows; row += 7) {
+    ASSERT_TRUE(ComputeSpectrum(mono.data() + row * cfg.hop_size, 512, sample_rate, single,
+                                expected.data(), expected.size()));
+    for (int k = 0; k < bins; ++k) {
+      EXPECT_NEAR(matrix[static_cast<size_t>(row) * bins + k], expected[static_cast<size_t>(k)],
+                  1e-5f);
+    }
+  }
+}
+
+TEST(FftSpectrumTest, SpectrogramThreadCountDoesNotChangeResult) {
+  std::vector<float> stereo(2 * 48000);
+  for (size_t i = 0; i < stereo.size() / 2; ++i) {
+    stereo[i * 2] = std::sin(0.01f * static_cast<float>(i));
+    stereo[i * 2 + 1] = std::cos(0.003f * static_cast<float>(i));
+  }
+  SpectrogramConfig cfg;
+  cfg.window_size = 1024;
+  cfg.hop_size = 256;
+  cfg.num_threads = 1;
+  const std::vector<float> serial = ComputeSpectrogram(stereo.data(), 48000, 2, cfg);
+  ASSERT_FALSE(serial.empty());
+  for (int threads : {2, 3, 8}) {
+    cfg.num_threads = threads;
+    const std::vector<float> parallel = ComputeSpectrogram(stereo.data(), 48000, 2, cfg);
+    ASSERT_EQ(parallel.size(), serial.size());
+    EXPECT_EQ(parallel, serial) << threads << " threads";
+  }
+}
+
+TEST(FftSpectrumTest, SpectrogramConcurrentCallersShareWorkerPool) {
+  // 两个调用方同时请求多线程：一个占用常驻线程池，另一个在自己线程上算完；结果都与串行一致。
+  std::vector<float> mono(48000);
+  for (size_t i = 0; i < mono.size(); ++i) mono[i] = std::sin(0.02f * static_cast<float>(i));
+  SpectrogramConfig cfg;
+  cfg.window_size = 512;
+  cfg.hop_size = 128;
+  cfg.num_threads = 1;
+  const std::vector<float> serial = ComputeSpectrogram(mono.data(), mono.size(), 1, cfg);
+  ASSERT_FALSE(serial.empty());
+  cfg.num_threads = 4;
+  int mismatches[2] = {0, 0};
+  auto caller = [&](int id) {
+    for (int i = 0; i < 20; ++i) {
+      if (ComputeSpectrogram(mono.data(), mono.size(), 1, cfg) != serial) ++mismatches[id];
+    }
+  };
+  std::thread other(caller, 1);
+  caller(0);
+  other.join();
+  EXPECT_EQ(mismatches[0], 0);
+  EXPECT_EQ(mismatches[1], 0);
+}
+
+TEST(FftSpectrumTest, SpectrogramDownmixesInterleavedInput) {
+  std::vector<float> mono(4096);
+  std::vector<float> stereo(mono.size() * 2);
+  for (size_t i = 0; i < mono.size(); ++i) {
+    const float l = std::sin(0.05f * static_cast<float>(i));
+    const float r = 0.5f * std::sin(0.2f * static_cast<float>(i));
+    stereo[i * 2] = l;
+    stereo[i * 2 + 1] = r;
+    mono[i] = (l + r) * 0.5f;
+  }
+  SpectrogramConfig cfg;
+  cfg.window_size = 256;
+  cfg.hop_size = 200;
+  const auto from_mono = ComputeSpectrogram(mono.data(), mono.size(), 1, cfg);
+  const auto from_stereo = ComputeSpectrogram(stereo.data(), mono.size(), 2, cfg);
+  ASSERT_EQ(from_mono.size(), from_stereo.size());
+  for (size_t i = 0; i < from_mono.size(); ++i) {
+    EXPECT_NEAR(from_mono[i], from_stereo[i], 1e-6f);
+  }
+}
+
+TEST(FftSpectrumTest, SpectrogramZeroPadsToFftSize) {
+  const int sample_rate = 48000;
+  const float freq = 3000.0f;
+  std::vector<float> mono(4096);
+  for (size_t i = 0; i < mono.size(); ++i) {
+    mono[i] = std::sin(2.0f * static_cast<float>(M_PI) * freq * i / sample_rate);
+  }
+  SpectrogramConfig cfg;
+  cfg.window_size = 1000;
+  cfg.hop_size = 1000;
+  cfg.fft_size = 4096;
+  EXPECT_EQ(SpectrogramBinCount(cfg), 2049);
+  const int rows = SpectrogramFrameCount(mono.size(), cfg);
+  ASSERT_EQ(rows, 4);
+  const auto matrix = ComputeSpectrogram(mono.data(), mono.size(), 1, cfg);
+  ASSERT_EQ(matrix.size(), static_cast<size_t>(rows) * 2049);
+  for (int row = 0; row < rows; ++row) {
+    const float* r = matrix.data() + static_cast<size_t>(row) * 2049;
+    const int peak = static_cast<int>(std::max_element(r, r + 2049) - r);
+    EXPECT_NEAR(peak, freq * cfg.fft_size / sample_rate, 1.0f);
+  }
+}
+
+TEST(FftSpectrumTest, SpectrogramRejectsInvalidArguments) {
+  std::vector<float> mono(1024, 0.0f);
+  std::vector<float> out(4096);
+  SpectrogramConfig cfg;
+  cfg.window_size = 256;
+  cfg.hop_size = 0;
+  EXPECT_EQ(SpectrogramFrameCount(mono.size(), cfg), 0);
+  EXPECT_FALSE(ComputeSpectrogram(mono.data(), mono.size(), 1, cfg, out.data(), out.size()));
+  cfg.hop_size = 128;
+  cfg.fft_size = 128;  // smaller than the window.
+  EXPECT_EQ(SpectrogramBinCount(cfg), 0);
+  cfg.fft_size = 0;
+  EXPECT_EQ(SpectrogramFrameCount(100, cfg), 0);  // shorter than one window.
+  EXPECT_FALSE(ComputeSpectrogram(mono.data(), mono.size(), 1, cfg, out.data(), 10));
+  EXPECT_FALSE(ComputeSpectrogram(nullptr, mono.size(), 1, cfg, out.data(), out.size()));
+  EXPECT_TRUE(ComputeSpectrogram(mono.data(), mono.size(), 1, cfg, out.data(), out.size()));
+}
+
 }  // namespace sw
@@ -0,0 +1,716 @@
+#include "flac_decoder.h"
+
+#include <gtest/gtest.h>
+
+#include "alloc_counter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sw {
+
+namespace {
+
+std::string TempPath(const char* name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void WriteBytes(const std::string& path, const std::vector<uint8_t>& bytes) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+}
+
+// ---- 测试用的最小 FLAC 编码器 ----
+// 不追求压缩率，只求覆盖解码器的各条路径：每帧轮换子帧类型（constant/verbatim/fixed/LPC）、
+// 双声道去相关方式、Rice 参数位宽与 escape 分区，可选 wasted bits 与可变块长。
+
+class BitWriter {
+ public:
+  void Put(uint64_t value, int bits) {
+    for (int i = bits - 1; i >= 0; --i) PutBit(static_cast<int>((value >> i) & 1));
+  }
+  void PutSigned(int64_t value, int bits) { Put(static_cast<uint64_t>(value), bits); }
+  void PutUnary(uint32_t zeros) {
+    for (uint32_t i = 0; i < zeros; ++i) PutBit(0);
+    PutBit(1);
+  }
+  void AlignToByte() {
+    while (fill_ != 0) PutBit(0);
+  }
+  std::vector<uint8_t>& bytes() { return bytes_; }
+
+ private:
+  void PutBit(int bit) {
+    if (fill_ == 0) bytes_.push_back(0);
+    bytes_.back() = static_cast<uint8_t>(bytes_.back() | (bit << (7 - fill_)));
+    fill_ = (fill_ + 1) & 7;
+  }
+
+  std::vector<uint8_t> bytes_;
+  int fill_ = 0;
+};
+
+uint8_t RefCrc8(const uint8_t* p, size_t n) {
+  uint32_t crc = 0;
+  for (size_t i = 0; i < n; ++i) {
+    crc ^= p[i];
+    for (int b = 0; b < 8; ++b) crc = (crc & 0x80) ? ((crc << 1) ^ 0x07) & 0xFF : crc << 1;
+  }
+  return static_cast<uint8_t>(crc);
+}
+
+uint16_t RefCrc16(const uint8_t* p, size_t n) {
+  uint32_t crc = 0;
+  for (size_t i = 0; i < n; ++i) {
+    crc ^= uint32_t{p[i]} << 8;
+    for (int b = 0; b < 8; ++b) {
+      crc = (crc & 0x8000) ? ((crc << 1) ^ 0x8005) & 0xFFFF : crc << 1;
+    }
+  }
+  return static_cast<uint16_t>(crc);
+}
+
+int SignedBitsFor(int64_t v) {
+  int bits = 1;
+  while (v < -(int64_t{1} << (bits - 1)) || v >= (int64_t{1} << (bits - 1))) ++bits;
+  return bits;
+}
+
+struct FlacSpec {
+  int sample_rate = 44100;
+  int bits = 16;
+  std::vector<uint32_t> block_sizes = {4096};  // 循环使用；只有一个时为固定块长
+  bool wasted_bits = false;  // 有公共低位 0 时按 wasted bits 编码
+  bool id3_and_padding = false;  // 前置 ID3v2 标签，并在 STREAMINFO 后插入 SEEKTABLE/PADDING
+};
+
+void PutCodedNumber(BitWriter* w, uint64_t v) {
+  if (v < 0x80) {
+    w->Put(v, 8);
+    return;
+  }
+  int len = 2;
+  while (len < 7 && v >= (uint64_t{1} << (5 * len + 1))) ++len;
+  w->Put(((0xFF00u >> len) & 0xFF) | (v >> (6 * (len - 1))), 8);  // len 个前导 1
+  for (int i = len - 2; i >= 0; --i) w->Put(0x80 | ((v >> (6 * i)) & 0x3F), 8);
+}
+
+void PutResidual(BitWriter* w, const std::vector<int64_t>& res, size_t order, int variant) {
+  const size_t n = res.size();
+  int partition_order = 0;
+  while (partition_order < 3 && n % (size_t{2} << partition_order) == 0 &&
+         (n >> (partition_order + 1)) >= order) {
+    ++partition_order;
+  }
+  const bool five_bit = variant % 2 == 1;
+  w->Put(five_bit ? 1 : 0, 2);
+  w->Put(static_cast<uint32_t>(partition_order), 4);
+  const size_t per = n >> partition_order;
+  for (size_t part = 0; part < (size_t{1} << partition_order); ++part) {
+    const size_t begin = part == 0 ? order : part * per;
+    const size_t end = (part + 1) * per;
+    if (part == 0 && variant % 3 == 0) {
+      int width = 0;
+      for (size_t i = begin; i < end; ++i) width = std::max(width, SignedBitsFor(res[i]));
+      if (begin == end) width = 0;
+      w->Put(five_bit ? 31 : 15, five_bit ? 5 : 4);
+      w->Put(static_cast<uint32_t>(width), 5);
+      for (size_t i = begin; i < end; ++i) w->PutSigned(res[i], width);
+      continue;
+    }
+    uint64_t sum = 0;
+    for (size_t i = begin; i < end; ++i) {
+      sum += static_cast<uint64_t>(res[i] < 0 ? -2 * res[i] - 1 : 2 * res[i]);
+    }
+    int k = 0;
+    const uint64_t mean = end > begin ? sum / (end - begin) : 0;
+    while (k < (five_bit ? 30 : 14) && (uint64_t{1} << (k + 1)) <= mean) ++k;
+    w->Put(static_cast<uint32_t>(k), five_bit ? 5 : 4);
+    for (size_t i = begin; i < end; ++i) {
+      const uint64_t z = static_cast<uint64_t>(res[i] < 0 ? -2 * res[i] - 1 : 2 * res[i]);
+      w->PutUnary(static_cast<uint32_t>(z >> k));
+      w->Put(z & ((uint64_t{1} << k) - 1), k);
+    }
+  }
+}
+
+// variant 决定子帧类型：0 verbatim，1..5 fixed 0..4 阶，6/7 LPC（阶数随 variant 变化）。
+void PutSubframe(BitWriter* w, const std::vector<int64_t>& x, int bps, int variant,
+                 bool allow_wasted) {
+  const size_t n = x.size();
+  w->Put(0, 1);
+  if (std::all_of(x.begin(), x.end(), [&](int64_t v) { return v == x[0]; })) {
+    w->Put(0, 6);
+    w->Put(0, 1);
+    w->PutSigned(x[0], bps);
+    return;
+  }
+  int64_t bits_or = 0;
+  for (int64_t v : x) bits_or |= v;
+  int wasted = 0;
+  while (allow_wasted && ((bits_or >> wasted) & 1) == 0) ++wasted;
+  std::vector<int64_t> s(n);
+  for (size_t i = 0; i < n; ++i) s[i] = x[i] >> wasted;
+  const int sbps = bps - wasted;
+
+  const int kind = variant % 8;
+  size_t order = 0;
+  int shift = 0;
+  std::vector<int64_t> coefs;
+  if (kind >= 1 && kind <= 5) {
+    static const int64_t kFixed[5][4] = {{0}, {1}, {2, -1}, {3, -3, 1}, {4, -6, 4, -1}};
+    order = std::min<size_t>(static_cast<size_t>(kind - 1), n);
+    coefs.assign(kFixed[order], kFixed[order] + order);
+  } else if (kind >= 6) {
+    // LPC：二阶外推加小扰动；阶数与位深组合覆盖 32 位内核与 64 位回退两条路径。
+    order = std::min<size_t>(1 + static_cast<size_t>(variant * 7) % 32, n);
+    shift = 10;
+    coefs.resize(order);
+    std::mt19937 rng(static_cast<uint32_t>(variant));
+    for (int64_t& c : coefs) c = static_cast<int64_t>(rng() % 7) - 3;
+    coefs[0] += order >= 2 ? 2 << shift : 1 << shift;
+    if (order >= 2) coefs[1] -= 1 << shift;
+  }
+  w->Put(kind == 0 ? 1 : kind <= 5 ? 8 + order : 32 + order - 1, 6);
+  if (wasted > 0) {
+    w->Put(1, 1);
+    w->PutUnary(static_cast<uint32_t>(wasted - 1));
+  } else {
+    w->Put(0, 1);
+  }
+  if (kind == 0) {
+    for (int64_t v : s) w->PutSigned(v, sbps);
+    return;
+  }
+  for (size_t i = 0; i < order; ++i) w->PutSigned(s[i], sbps);
+  if (kind >= 6) {
+    int precision = 0;
+    for (int64_t c : coefs) precision = std::max(precision, SignedBitsFor(c));
+    w->Put(static_cast<uint32_t>(precision - 1), 4);
+    w->PutSigned(shift, 5);
+    for (int64_t c : coefs) w->PutSigned(c, precision);
+  }
+  std::vector<int64_t> res(n, 0);
+  for (size_t i = order; i < n; ++i) {
+    int64_t pred = 0;
+    for (size_t j = 0; j < order; ++j) pred += coefs[j] * s[i - j - 1];
+    res[i] = s[i] - (pred >> shift);
+  }
+  PutResidual(w, res, order, variant);
+}
+
+int BlockSizeCode(uint32_t n) {
+  if (n == 192) return 1;
+  for (int c = 2; c <= 5; ++c) {
+    if (n == (576u << (c - 2))) return c;
+  }
+  for (int c = 8; c <= 15; ++c) {
+    if (n == (256u << (c - 8))) return c;
+  }
+  return n <= 256 ? 6 : 7;
+}
+
+// channels[c][i]：声道 c 的样本（bits 位有符号）。
+std::vector<uint8_t> EncodeFlac(const FlacSpec& spec,
+                                const std::vector<std::vector<int32_t>>& channels) {
+  const int num_channels = static_cast<int>(channels.size());
+  const size_t total = channels[0].size();
+  const bool variable = spec.block_sizes.size() > 1;
+  BitWriter w;
+  if (spec.id3_and_padding) {
+    const uint8_t id3[] = {'I', 'D', '3', 4, 0, 0, 0, 0, 0, 5, 1, 2, 3, 4, 5};
+    for (uint8_t b : id3) w.Put(b, 8);
+  }
+  for (char c : std::string("fLaC")) w.Put(static_cast<uint8_t>(c), 8);
+  const size_t info_at = w.bytes().size();
+  w.Put(spec.id3_and_padding ? 0 : 1, 1);
+  w.Put(0, 7);
+  w.Put(34, 24);
+  uint32_t max_block = *std::max_element(spec.block_sizes.begin(), spec.block_sizes.end());
+  w.Put(variable ? 16 : max_block, 16);
+  w.Put(max_block, 16);
+  w.Put(0, 24);  // min_frame_size：稍后回填
+  w.Put(0, 24);
+  w.Put(static_cast<uint32_t>(spec.sample_rate), 20);
+  w.Put(static_cast<uint32_t>(num_channels - 1), 3);
+  w.Put(static_cast<uint32_t>(spec.bits - 1), 5);
+  w.Put(total, 36);
+  for (int i = 0; i < 16; ++i) w.Put(0, 8);  // MD5 不校验
+  if (spec.id3_and_padding) {
+    w.Put(0, 1);
+    w.Put(3, 7);  // SEEKTABLE：内容被忽略
+    w.Put(18, 24);
+    for (int i = 0; i < 18; ++i) w.Put(0xFF, 8);
+    w.Put(1, 1);
+    w.Put(1, 7);  // PADDING
+    w.Put(7, 24);
+    for (int i = 0; i < 7; ++i) w.Put(0, 8);
+  }
+
+  size_t min_frame = SIZE_MAX;
+  size_t pos = 0;
+  for (size_t frame = 0; pos < total; ++frame) {
+    const uint32_t block = static_cast<uint32_t>(
+        std::min<size_t>(spec.block_sizes[frame % spec.block_sizes.size()], total - pos));
+    const size_t start = w.bytes().size();
+    w.Put(0xFFF8 | (variable ? 1 : 0), 16);
+    const int block_code = BlockSizeCode(block);
+    w.Put(static_cast<uint32_t>(block_code), 4);
+    const int rate_code = spec.sample_rate == 44100 ? 9 : spec.sample_rate == 48000 ? 10 : 0;
+    w.Put(static_cast<uint32_t>(rate_code), 4);
+    // 双声道按帧轮换 独立/左侧/侧右/中侧。
+    const int mode = num_channels == 2 ? static_cast<int>(frame % 4) : 0;
+    w.Put(static_cast<uint32_t>(num_channels == 2 && mode > 0 ? 7 + mode : num_channels - 1), 4);
+    const int size_code = spec.bits == 16 ? 4 : spec.bits == 24 ? 6 : spec.bits == 12 ? 2 : 0;
+    w.Put(static_cast<uint32_t>(size_code), 3);
+    w.Put(0, 1);
+    PutCodedNumber(&w, variable ? pos : frame);
+    if (block_code == 6) w.Put(block - 1, 8);
+    if (block_code == 7) w.Put(block - 1, 16);
+    w.Put(RefCrc8(w.bytes().data() + start, w.bytes().size() - start), 8);
+
+    std::vector<std::vector<int64_t>> sub(static_cast<size_t>(num_channels));
+    for (int c = 0; c < num_channels; ++c) {
+      sub[c].assign(channels[c].begin() + static_cast<ptrdiff_t>(pos),
+                    channels[c].begin() + static_cast<ptrdiff_t>(pos + block));
+    }
+    std::vector<int> bps(static_cast<size_t>(num_channels), spec.bits);
+    if (mode > 0) {
+      std::vector<int64_t> side(block);
+      std::vector<int64_t> mid(block);
+      for (uint32_t i = 0; i < block; ++i) {
+        side[i] = sub[0][i] - sub[1][i];
+        mid[i] = (sub[0][i] + sub[1][i]) >> 1;
+      }
+      if (mode == 1) {
+        sub[1] = side;
+        bps[1] += 1;
+      } else if (mode == 2) {
+        sub[0] = side;
+        bps[0] += 1;
+      } else {
+        sub[0] = mid;
+        sub[1] = side;
+        bps[1] += 1;
+      }
+    }
+    for (int c = 0; c < num_channels; ++c) {
+      const int variant = static_cast<int>(frame * 3 + static_cast<size_t>(c) * 5);
+      PutSubframe(&w, sub[c], bps[c], variant, spec.wasted_bits);
+    }
+    w.AlignToByte();
+    w.Put(RefCrc16(w.bytes().data() + start, w.bytes().size() - start), 16);
+    min_frame = std::min(min_frame, w.bytes().size() - start);
+    pos += block;
+  }
+  std::vector<uint8_t> out = w.bytes();
+  if (min_frame != SIZE_MAX) {
+    uint8_t* p = out.data() + info_at + 4 + 4;
+    p[0] = static_cast<uint8_t>(min_frame >> 16);
+    p[1] = static_cast<uint8_t>(min_frame >> 8);
+    p[2] = static_cast<uint8_t>(min_frame);
+  }
+  return out;
+}
+
+// 正弦叠加少量噪声，再按 bits 量化；step > 1 时样本为 step 的整数倍（产生 wasted bits）。
+std::vector<std::vector<int32_t>> MakeSignal(int channels, size_t frames, int bits,
+                                             int32_t step = 1) {
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<int32_t> noise(-3, 3);
+  const double full = std::ldexp(1.0, bits - 1) - 1.0;
+  std::vector<std::vector<int32_t>> out(static_cast<size_t>(channels));
+  for (int c = 0; c < channels; ++c) {
+    out[c].resize(frames);
+    for (size_t i = 0; i < frames; ++i) {
+      const double v = 0.6 * std::sin(0.013 * static_cast<double>(i) * (c + 1)) +
+                       0.2 * std::sin(0.17 * static_cast<double>(i) + c);
+      int32_t q = static_cast<int32_t>(std::lround(v * full)) + noise(rng);
+      q = std::max<int32_t>(std::min<int32_t>(q, static_cast<int32_t>(full)),
+                            static_cast<int32_t>(-full));
+      out[c][i] = q / step * step;
+    }
+    // 开头一小段静音，让首帧出现 constant 子帧。
+    const size_t silence = std::min<size_t>(frames, 4096);
+    std::fill(out[c].begin(), out[c].begin() + static_cast<ptrdiff_t>(silence), 0);
+  }
+  return out;
+}
+
+float Expected(const std::vector<std::vector<int32_t>>& pcm, size_t frame, int c, int bits) {
+  return static_cast<float>(pcm[c][frame]) / static_cast<float>(1 << (bits - 1));
+}
+
+// 解码到 EOF，与原始样本逐个比对。
+void ExpectLossless(FlacDecoder& dec, const std::vector<std::vector<int32_t>>& pcm, int bits) {
+  const int channels = static_cast<int>(pcm.size());
+  PcmBuffer buf;
+  size_t frame = 0;
+  while (dec.Read(buf)) {
+    ASSERT_EQ(buf.channels, channels);
+    const size_t frames = buf.interleaved.size() / static_cast<size_t>(channels);
+    for (size_t i = 0; i < frames; ++i, ++frame) {
+      for (int c = 0; c < channels; ++c) {
+        ASSERT_EQ(buf.interleaved[i * static_cast<size_t>(channels) + c],
+                  Expected(pcm, frame, c, bits))
+            << "frame " << frame << " ch " << c;
+      }
+    }
+  }
+  EXPECT_EQ(dec.last_status(), Status::kOk);
+  EXPECT_EQ(frame, pcm[0].size());
+}
+
+// tests/data/reference_*.flac 由参考编码器 libFLAC 1.4.3（经 libsndfile，默认压缩级别）生成，
+// 源 PCM 即下面两个整数公式；这里重新生成，逐样本比对。
+uint32_t NextLcg(uint32_t* state) {
+  *state = *state * 1664525u + 1013904223u;
+  return *state >> 24;
+}
+
+// reference_stereo16.flac：44.1 kHz、16 bit、10000 帧。左声道锯齿 + 噪声，右声道与左相关。
+std::vector<std::vector<int32_t>> ReferenceStereo16() {
+  std::vector<std::vector<int32_t>> pcm(2, std::vector<int32_t>(10000));
+  uint32_t state = 1;
+  for (size_t i = 0; i < pcm[0].size(); ++i) {
+    const int32_t n = static_cast<int32_t>(i);
+    const int32_t l = n * 97 % 4001 - 2000 + static_cast<int32_t>(NextLcg(&state) & 15) - 8;
+    pcm[0][i] = l;
+    pcm[1][i] = -(l / 2) + n % 13 * 5;
+  }
+  return pcm;
+}
+
+// reference_mono24.flac：48 kHz、24 bit、5000 帧。
+std::vector<std::vector<int32_t>> ReferenceMono24() {
+  std::vector<std::vector<int32_t>> pcm(1, std::vector<int32_t>(5000));
+  uint32_t state = 1;
+  for (size_t i = 0; i < pcm[0].size(); ++i) {
+    const int32_t n = static_cast<int32_t>(i);
+    pcm[0][i] = n % 2400 * 600 - 720000 + static_cast<int32_t>(NextLcg(&state) & 255) - 128;
+  }
+  return pcm;
+}
+
+// 定长 4096 块、44.1 kHz、帧号 < 128 时的帧头（5 字节 + CRC-8）在 bytes 中的位置。
+size_t FindFixedFrameHeader(const std::vector<uint8_t>& bytes, uint8_t number) {
+  for (size_t i = 0; i + 6 <= bytes.size(); ++i) {
+    if (bytes[i] == 0xFF && bytes[i + 1] == 0xF8 && bytes[i + 4] == number &&
+        RefCrc8(bytes.data() + i, 5) == bytes[i + 5]) {
+      return i;
+    }
+  }
+  return bytes.size();
+}
+
+}  // namespace
+
+TEST(FlacDecoderTest, DecodesStereoLosslesslyAcrossSubframeTypes) {
+  const std::string path = TempPath("sw_flac_decoder_stereo.flac");
+  const auto pcm = MakeSignal(2, 4096 * 24 + 1000, 16);
+  WriteBytes(path, EncodeFlac(FlacSpec{}, pcm));
+
+  FlacDecoder dec;
+  ASSERT_TRUE(dec.Open("file://" + path));
+  EXPECT_EQ(dec.sample_rate(), 44100);
+  EXPECT_EQ(dec.channels(), 2);
+  EXPECT_EQ(dec.bits_per_sample(), 16);
+  EXPECT_EQ(dec.num_frames(), static_cast<int64_t>(pcm[0].size()));
+  EXPECT_EQ(dec.index_size(), 25u);
+  ExpectLossless(dec, pcm, 16);
+  std::remove(path.c_str());
+}
+
+TEST(FlacDecoderTest, DecodesVariableBlocksHighBitDepthAndWastedBits) {
+  const std::string path = TempPath("sw_flac_decoder_variable.flac");
+  FlacSpec spec;
+  spec.sample_rate = 32000;
+  spec.bits = 24;
+  spec.block_sizes = {4096, 1152, 777, 4608, 192, 16, 2000};
+  spec.id3_and_padding = true;
+  const auto pcm = MakeSignal(3, 50000, 24);
+  WriteBytes(path, EncodeFlac(spec, pcm));
+  FlacDecoder dec;
+  ASSERT_TRUE(dec.Open(path));
+  EXPECT_EQ(dec.source_channels(), 3);
+  EXPECT_EQ(dec.bits_per_sample(), 24);
+  ExpectLossless(dec, pcm, 24);
+
+  FlacSpec wasted;
+  wasted.bits = 12;
+  wasted.wasted_bits = true;
+  wasted.block_sizes = {1152};
+  const auto stepped = MakeSignal(2, 20000, 12, 8);
+  WriteBytes(path, EncodeFlac(wasted, stepped));
+  FlacDecoder twelve;
+  ASSERT_TRUE(twelve.Open(path));
+  ExpectLossless(twelve, stepped, 12);
+  std::remove(path.c_str());
+}
+
+TEST(FlacDecoderTest, SeekLandsOnExactSample) {
+  const std::string path = TempPath("sw_flac_decoder_seek.flac");
+  FlacSpec spec;
+  spec.block_sizes = {4096, 1000, 3333};
+  const auto pcm = MakeSignal(2, 60000, 16);
+  WriteBytes(path, EncodeFlac(spec, pcm));
+  FlacDecoder dec;
+  ASSERT_TRUE(dec.Open(path));
+  PcmBuffer buf;
+  for (int64_t target : {int64_t{30000}, int64_t{0}, int64_t{4096}, int64_t{5095},
+                         int64_t{5096}, int64_t{5100}, int64_t{59999}, int64_t{12345}}) {
+    ASSERT_TRUE(dec.Seek(target));
+    EXPECT_EQ(dec.position(), target);
+    ASSERT_TRUE(dec.Read(buf)) << target;
+    const size_t f = static_cast<size_t>(target);
+    EXPECT_EQ(buf.interleaved[0], Expected(pcm, f, 0, 16)) << target;
+    EXPECT_EQ(buf.interleaved[1], Expected(pcm, f, 1, 16)) << target;
+  }
+  // 越过末尾：定位到 EOF。
+  ASSERT_TRUE(dec.Seek(1 << 30));
+  EXPECT_EQ(dec.position(), 60000);
+  EXPECT_FALSE(dec.Read(buf));
+  EXPECT_EQ(dec.last_status(), Status::kOk);
+  EXPECT_FALSE(dec.Seek(-1));
+  EXPECT_EQ(dec.last_status(), Status::kInvalidArguments);
+  std::remove(path.c_str());
+}
+
+TEST(FlacDecoderTest, RejectsMissingCorruptAndUnsupportedFiles) {
+  FlacDecoder dec;
+  EXPECT_FALSE(dec.Open(TempPath("sw_flac_decoder_missing.flac")));
+  EXPECT_EQ(dec.last_status(), Status::kIoError);
+
+  const std::string path = TempPath("sw_flac_decoder_bad.flac");
+  WriteBytes(path, {'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E'});
+  EXPECT_FALSE(dec.Open(path));
+  EXPECT_EQ(dec.last_status(), Status::kNotSupported);
+
+  const auto pcm = MakeSignal(2, 20000, 16);
+  std::vector<uint8_t> flac = EncodeFlac(FlacSpec{}, pcm);
+  WriteBytes(path, std::vector<uint8_t>(flac.begin(), flac.begin() + 20));
+  EXPECT_FALSE(dec.Open(path));
+  EXPECT_EQ(dec.last_status(), Status::kError);
+
+  // 帧数据里翻转一个字节：帧头仍有效（进索引），解码该帧时 CRC-16 不符。
+  std::vector<uint8_t> damaged = flac;
+  damaged[damaged.size() - 300] ^= 0x10;
+  WriteBytes(path, damaged);
+  ASSERT_TRUE(dec.Open(path));
+  PcmBuffer buf;
+  while (dec.Read(buf)) {
+  }
+  EXPECT_EQ(dec.last_status(), Status::kError);
+
+  // 采样率比例超出 sinc 重采样支持范围。
+  WriteBytes(path, flac);
+  FlacDecoder resample;
+  ASSERT_TRUE(resample.ConfigureOutput(48001, 2));
+  EXPECT_FALSE(resample.Open(path));
+  EXPECT_EQ(resample.last_status(), Status::kNotSupported);
+
+  // 把 STREAMINFO 的位深改成 32：不支持。
+  std::vector<uint8_t> header = EncodeFlac(FlacSpec{}, MakeSignal(1, 16, 16));
+  header[8 + 12] = static_cast<uint8_t>(header[8 + 12] | 0x01);
+  header[8 + 13] = static_cast<uint8_t>(header[8 + 13] | 0xF0);
+  WriteBytes(path, header);
+  EXPECT_FALSE(dec.Open(path));
+  EXPECT_EQ(dec.last_status(), Status::kNotSupported);
+  std::remove(path.c_str());
+}
+
+TEST(FlacDecoderTest, DecodesReferenceEncoderFixturesBitExact) {
+  const std::string dir = SW_TEST_DATA_DIR;
+  {
+    FlacDecoder dec;
+    ASSERT_TRUE(dec.Open(dir + "/reference_stereo16.flac"));
+    EXPECT_EQ(dec.sample_rate(), 44100);
+    EXPECT_EQ(dec.channels(), 2);
+    EXPECT_EQ(dec.num_frames(), 10000);
+    EXPECT_EQ(dec.missing_frames(), 0);
+    ExpectLossless(dec, ReferenceStereo16(), 16);
+  }
+  {
+    FlacDecoder dec;
+    ASSERT_TRUE(dec.Open(dir + "/reference_mono24.flac"));
+    EXPECT_EQ(dec.sample_rate(), 48000);
+    EXPECT_EQ(dec.channels(), 1);
+    EXPECT_EQ(dec.num_frames(), 5000);
+    ExpectLossless(dec, ReferenceMono24(), 24);
+  }
+}
+
+TEST(FlacDecoderTest, IndexResyncsPastDamagedFrameHeaders) {
+  const std::string path = TempPath("sw_flac_decoder_resync.flac");
+  const auto pcm = MakeSignal(2, 4096 * 6, 16);
+  std::vector<uint8_t> flac = EncodeFlac(FlacSpec{}, pcm);
+  // 破坏第 2 帧与最后一帧（第 5 帧）的帧头 CRC-8。
+  for (uint8_t number : {uint8_t{2}, uint8_t{5}}) {
+    const size_t at = FindFixedFrameHeader(flac, number);
+    ASSERT_LT(at, flac.size());
+    flac[at + 5] ^= 0x5A;
+  }
+  WriteBytes(path, flac);
+  FlacDecoder dec;
+  ASSERT_TRUE(dec.Open(path));
+  EXPECT_EQ(dec.index_size(), 4u);
+  EXPECT_EQ(dec.num_frames(), 4096 * 6);
+  EXPECT_EQ(dec.missing_frames(), 4096 * 2);
+
+  // 完好的帧逐样本一致，缺失的帧为静音，总长不变。
+  PcmBuffer buf;
+  size_t frame = 0;
+  while (dec.Read(buf)) {
+    const size_t frames = buf.interleaved.size() / 2;
+    for (size_t i = 0; i < frames; ++i, ++frame) {
+      const bool missing = frame / 4096 == 2 || frame / 4096 == 5;
+      for (int c = 0; c < 2; ++c) {
+        ASSERT_EQ(buf.interleaved[i * 2 + static_cast<size_t>(c)],
+                  missing ? 0.0f : Expected(pcm, frame, c, 16))
+            << "frame " << frame;
+      }
+    }
+  }
+  EXPECT_EQ(dec.last_status(), Status::kOk);
+  EXPECT_EQ(frame, pcm[0].size());
+
+  // Seek 进缺失区段输出静音，跨过它之后恢复正常解码。
+  ASSERT_TRUE(dec.Seek(4096 * 2 + 100));
+  ASSERT_TRUE(dec.Read(buf));
+  EXPECT_EQ(buf.interleaved[0], 0.0f);
+  ASSERT_TRUE(dec.Seek(4096 * 3 + 7));
+  ASSERT_TRUE(dec.Read(buf));
+  EXPECT_EQ(buf.interleaved[1], Expected(pcm, 4096 * 3 + 7, 1, 16));
+  std::remove(path.c_str());
+}
+
+TEST(FlacDecoderTest, IndexIgnoresOversizedMinFrameSize) {
+  // STREAMINFO 的 min_frame_size 大于整个文件：按它跳跃会漏掉首帧之后的所有帧。
+  const std::string path = TempPath("sw_flac_decoder_min_frame.flac");
+  const auto pcm = MakeSignal(2, 4096 * 5 + 300, 16);
+  std::vector<uint8_t> flac = EncodeFlac(FlacSpec{}, pcm);
+  flac[8 + 4] = 0xFF;
+  flac[8 + 5] = 0xFF;
+  flac[8 + 6] = 0xFF;
+  WriteBytes(path, flac);
+  FlacDecoder dec;
+  ASSERT_TRUE(dec.Open(path));
+  EXPECT_EQ(dec.index_size(), 6u);
+  EXPECT_EQ(dec.missing_frames(), 0);
+  ExpectLossless(dec, pcm, 16);
+  std::remove(path.c_str());
+}
+
+TEST(FlacDecoderTest, ConvertsChannelsWithoutSteadyStateAllocation) {
+  const std::string path = TempPath("sw_flac_decoder_alloc.flac");
+  const auto pcm = MakeSignal(2, 48000, 16);
+  WriteBytes(path, EncodeFlac(FlacSpec{}, pcm));
+  FlacDecoder dec;
+  ASSERT_TRUE(dec.ConfigureOutput(44100, 1));
+  ASSERT_TRUE(dec.Open(path));
+  PcmBuffer buf;
+  ASSERT_TRUE(dec.Read(buf));
+  ASSERT_EQ(buf.channels, 1);
+  ASSERT_EQ(buf.interleaved.size(), 1024u);
+  EXPECT_FLOAT_EQ(buf.interleaved[1000],
+                  0.5f * (Expected(pcm, 1000, 0, 16) + Expected(pcm, 1000, 1, 16)));
+
+  sw::testing::ScopedAllocCounter allocs;
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_TRUE(dec.Read(buf));
+  }
+  ASSERT_TRUE(dec.Seek(30000));
+  ASSERT_TRUE(dec.Read(buf));
+  EXPECT_EQ(allocs.count(), 0u);
+  std::remove(path.c_str());
+}
+
+TEST(FlacDecoderTest, ResamplesToConfiguredRateWithoutSteadyStateAllocation) {
+  const std::string path = TempPath("sw_flac_decoder_resample.flac");
+  const auto pcm = MakeSignal(2, 20000, 16);
+  WriteBytes(path, EncodeFlac(FlacSpec{}, pcm));
+  FlacDecoder dec;
+  ASSERT_TRUE(dec.ConfigureOutput(48000, 2));
+  ASSERT_TRUE(dec.Open(path));
+  EXPECT_EQ(dec.sample_rate(), 48000);
+  PcmBuffer buf;
+  ASSERT_TRUE(dec.Read(buf));
+  EXPECT_EQ(buf.sample_rate, 48000);
+  size_t frames = buf.interleaved.size() / 2;
+  {
+    sw::testing::ScopedAllocCounter allocs;
+    for (int i = 0; i < 8; ++i) {
+      ASSERT_TRUE(dec.Read(buf));
+      frames += buf.interleaved.size() / 2;
+    }
+    EXPECT_EQ(allocs.count(), 0u);
+  }
+  while (dec.Read(buf)) frames += buf.interleaved.size() / 2;
+  EXPECT_EQ(dec.last_status(), Status::kOk);
+  // ⌈20000 · 160 / 147⌉
+  EXPECT_EQ(frames, 21769u);
+
+  // Seek 以输出帧计，落到对应的源帧。
+  ASSERT_TRUE(dec.Seek(16000));
+  EXPECT_EQ(dec.position(), 14700);
+  ASSERT_TRUE(dec.Read(buf));
+  std::remove(path.c_str());
+}
+
+TEST(FlacDecoderTest, EnginePlaysFlacAndSeeks) {
+  const std::string path = TempPath("sw_flac_decoder_engine.flac");
+  FlacSpec spec;
+  spec.sample_rate = 48000;
+  const auto pcm = MakeSignal(2, 48000, 16);
+  WriteBytes(path, EncodeFlac(spec, pcm));
+  EXPECT_NE(dynamic_cast<FlacDecoder*>(CreateDecoderForSource("file://" + path).get()), nullptr);
+
+  auto engine = CreateAudioEngineStub();
+  AudioConfig cfg;
+  cfg.sample_rate = 48000;
+  cfg.channels = 2;
+  cfg.frames_per_buffer = 480;
+  cfg.pcm_max_fps = 0;
+  ASSERT_EQ(engine->Init(cfg), Status::kOk);
+  ASSERT_EQ(engine->Load(path), Status::kOk);
+
+  struct Seen {
+    std::mutex mu;
+    std::vector<float> first;
+    std::atomic<int> frames{0};
+  };
+  Seen seen;
+  engine->SetPcmCallback(
+      [](const PcmFrame& f, void* ud) {
+        auto* s = static_cast<Seen*>(ud);
+        std::lock_guard<std::mutex> lock(s->mu);
+        if (s->first.empty()) s->first.assign(f.data, f.data + 4);
+        s->frames.fetch_add(1);
+      },
+      &seen);
+  ASSERT_EQ(engine->Seek(250), Status::kOk);
+  ASSERT_EQ(engine->Play(), Status::kOk);
+  for (int i = 0; i < 200 && seen.frames.load() < 1; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_EQ(engine->Stop(), Status::kOk);
+  std::lock_guard<std::mutex> lock(seen.mu);
+  ASSERT_EQ(seen.first.size(), 4u);
+  EXPECT_EQ(seen.first[0], Expected(pcm, 12000, 0, 16));
+  EXPECT_EQ(seen.first[1], Expected(pcm, 12000, 1, 16));
+  EXPECT_EQ(seen.first[2], Expected(pcm, 12001, 0, 16));
+  std::remove(path.c_str());
+}
+
+}  // namespace sw
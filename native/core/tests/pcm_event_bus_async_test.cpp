@@ -0,0 +1,207 @@
+#include "pcm_event_bus.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sw {
+
+namespace {
+
+PcmIngressConfig UnthrottledIngress() {
+  PcmIngressConfig cfg;
+  cfg.expected_sample_rate = 48000;
+  cfg.expected_channels = 2;
+  cfg.throttle.max_fps = 0;  // every push emits.
+  cfg.throttle.max_pending = 4;
+  return cfg;
+}
+
+SpectrumConfig SmallSpectrum() {
+  SpectrumConfig cfg;
+  cfg.window_size = 64;
+  cfg.window = WindowType::kHann;
+  return cfg;
+}
+
+// Blocks the dispatcher inside the first pcm callback until Release() is called.
+class CallbackGate {
+ public:
+  void Enter() {
+    entered_.store(true);
+    while (!released_.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  void WaitEntered() {
+    while (!entered_.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  void Release() { released_.store(true); }
+
+ private:
+  std::atomic<bool> entered_{false};
+  std::atomic<bool> released_{false};
+};
+
+struct Received {
+  uint32_t sequence;
+  uint32_t dropped_before;
+};
+
+}  // namespace
+
+TEST(PcmEventBusAsyncTest, CallbacksRunOnDispatcherThread) {
+  PcmDispatchConfig dispatch;
+  dispatch.mode = PcmDispatchMode::kAsync;
+  PcmEventBus bus(UnthrottledIngress(), SmallSpectrum(), dispatch);
+
+  const std::thread::id pusher = std::this_thread::get_id();
+  std::atomic<int> pcm_events{0};
+  std::atomic<int> spectrum_events{0};
+  std::atomic<bool> same_thread{false};
+  bus.SetPcmCallback([&](const PcmFrame& f) {
+    if (std::this_thread::get_id() == pusher) same_thread.store(true);
+    EXPECT_TRUE(f.owner);
+    pcm_events.fetch_add(1);
+  });
+  bus.SetSpectrumCallback([&](const SpectrumFrame& s) {
+    EXPECT_EQ(s.num_bins, 33);
+    spectrum_events.fetch_add(1);
+  });
+
+  std::vector<float> samples(128 * 2, 0.5f);
+  for (uint32_t i = 0; i < 4; ++i) {
+    PcmInputFrame frame{samples.data(), 128, 48000, 2, static_cast<int64_t>(i), i + 1};
+    ASSERT_EQ(bus.Push(frame, i), Status::kOk);
+    bus.Flush();  // one at a time so nothing is dropped.
+  }
+
+  EXPECT_EQ(pcm_events.load(), 4);
+  EXPECT_EQ(spectrum_events.load(), 4);
+  EXPECT_FALSE(same_thread.load());
+
+  // 统计以“投递给订阅者的一帧”为单位：pcm 与频谱各 4 次。
+  const PcmDispatchStats stats = bus.stats();
+  EXPECT_EQ(stats.enqueued, 8u);
+  EXPECT_EQ(stats.dispatched, 8u);
+  EXPECT_EQ(stats.queue_wait.count, 8u);
+  EXPECT_EQ(stats.pcm_callback.count, 4u);
+  EXPECT_EQ(stats.spectrum.count, 4u);
+  EXPECT_EQ(stats.dropped_oldest + stats.dropped_newest, 0u);
+}
+
+TEST(PcmEventBusAsyncTest, SlowConsumerDoesNotBlockPushAndDropsOldest) {
+  PcmDispatchConfig dispatch;
+  dispatch.mode = PcmDispatchMode::kAsync;
+  dispatch.queue_capacity = 2;
+  dispatch.overflow = PcmOverflowPolicy::kDropOldest;
+  PcmEventBus bus(UnthrottledIngress(), SpectrumConfig(), dispatch);
+
+  CallbackGate gate;
+  std::mutex mu;
+  std::vector<Received> received;
+  bus.SetPcmCallback([&](const PcmFrame& f) {
+    {
+      std::lock_guard<std::mutex> lock(mu);
+      received.push_back({f.sequence, f.dropped_before});
+    }
+    if (f.sequence == 1) gate.Enter();
+  });
+
+  std::vector<float> samples(8, 0.25f);
+  PcmInputFrame frame{samples.data(), 4, 48000, 2, 0, 1};
+  ASSERT_EQ(bus.Push(frame, 0), Status::kOk);
+  gate.WaitEntered();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t seq = 2; seq <= 10; ++seq) {
+    frame.sequence = seq;
+    ASSERT_EQ(bus.Push(frame, seq), Status::kOk);
+  }
+  // 回调仍被阻塞，Push 不应等待消费者。
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+
+  gate.Release();
+  bus.Flush();
+
+  ASSERT_EQ(received.size(), 3u);
+  EXPECT_EQ(received[0].sequence, 1u);
+  EXPECT_EQ(received[1].sequence, 9u);
+  EXPECT_EQ(received[1].dropped_before, 7u);  // 2..8 evicted.
+  EXPECT_EQ(received[2].sequence, 10u);
+  EXPECT_EQ(received[2].dropped_before, 0u);
+
+  const PcmDispatchStats stats = bus.stats();
+  EXPECT_EQ(stats.enqueued, 10u);
+  EXPECT_EQ(stats.dispatched, 3u);
+  EXPECT_EQ(stats.dropped_oldest, 7u);
+  EXPECT_EQ(stats.queue_high_water, 2u);
+  EXPECT_GE(stats.pcm_callback.ns_max, 0);
+}
+
+TEST(PcmEventBusAsyncTest, DropNewestCarriesCountToNextFrame) {
+  PcmDispatchConfig dispatch;
+  dispatch.mode = PcmDispatchMode::kAsync;
+  dispatch.queue_capacity = 2;
+  dispatch.overflow = PcmOverflowPolicy::kDropNewest;
+  PcmEventBus bus(UnthrottledIngress(), SpectrumConfig(), dispatch);
+
+  CallbackGate gate;
+  std::mutex mu;
+  std::vector<Received> received;
+  bus.SetPcmCallback([&](const PcmFrame& f) {
+    {
+      std::lock_guard<std::mutex> lock(mu);
+      received.push_back({f.sequence, f.dropped_before});
+    }
+    if (f.sequence == 1) gate.Enter();
+  });
+
+  std::vector<float> samples(8, 0.25f);
+  PcmInputFrame frame{samples.data(), 4, 48000, 2, 0, 1};
+  ASSERT_EQ(bus.Push(frame, 0), Status::kOk);
+  gate.WaitEntered();
+  for (uint32_t seq = 2; seq <= 10; ++seq) {
+    frame.sequence = seq;
+    ASSERT_EQ(bus.Push(frame, seq), Status::kOk);
+  }
+  gate.Release();
+  bus.Flush();
+
+  frame.sequence = 11;
+  ASSERT_EQ(bus.Push(frame, 11), Status::kOk);
+  bus.Flush();
+
+  ASSERT_EQ(received.size(), 4u);
+  EXPECT_EQ(received[1].sequence, 2u);
+  EXPECT_EQ(received[2].sequence, 3u);
+  EXPECT_EQ(received[3].sequence, 11u);
+  EXPECT_EQ(received[3].dropped_before, 7u);  // 4..10 rejected.
+  EXPECT_EQ(bus.stats().dropped_newest, 7u);
+}
+
+TEST(PcmEventBusAsyncTest, SyncModeRecordsCallbackLatency) {
+  PcmEventBus bus(UnthrottledIngress(), SmallSpectrum());
+  int events = 0;
+  bus.SetPcmCallback([&](const PcmFrame&) { ++events; });
+  bus.SetSpectrumCallback([](const SpectrumFrame&) {});
+
+  std::vector<float> samples(128 * 2, 0.5f);
+  PcmInputFrame frame{samples.data(), 128, 48000, 2, 0, 1};
+  ASSERT_EQ(bus.Push(frame, 0), Status::kOk);
+  EXPECT_EQ(events, 1);  // delivered before Push returns.
+
+  const PcmDispatchStats stats = bus.stats();
+  EXPECT_EQ(stats.dispatched, 2u);  // pcm + spectrum subscriber.
+  EXPECT_EQ(stats.pcm_callback.count, 1u);
+  EXPECT_EQ(stats.spectrum.count, 1u);
+  EXPECT_EQ(stats.queue_wait.count, 0u);
+}
+
+}  // namespace sw
@@ -0,0 +1,192 @@
+#include "pcm_event_bus.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sw {
+
+namespace {
+
+PcmIngressConfig UnthrottledIngress() {
+  PcmIngressConfig cfg;
+  cfg.expected_sample_rate = 48000;
+  cfg.expected_channels = 2;
+  cfg.throttle.max_fps = 0;
+  cfg.throttle.max_pending = 4;
+  return cfg;
+}
+
+PcmSubscriberConfig Subscriber(int fps, size_t max_pending,
+                               PcmOverflowPolicy overflow = PcmOverflowPolicy::kDropOldest) {
+  PcmSubscriberConfig cfg;
+  cfg.max_fps = fps;
+  cfg.max_pending = max_pending;
+  cfg.overflow = overflow;
+  return cfg;
+}
+
+}  // namespace
+
+TEST(PcmEventBusSubscriberTest, EachSubscriberIsThrottledIndependently) {
+  PcmEventBus bus(UnthrottledIngress(), SpectrumConfig());
+
+  std::vector<uint32_t> all;
+  std::vector<uint32_t> slow;
+  std::vector<uint32_t> slow_markers;
+  ASSERT_NE(bus.AddPcmSubscriber(Subscriber(0, 1),
+                                 [&](const PcmFrame& f) { all.push_back(f.sequence); }),
+            0u);
+  // 10 fps：间隔 100ms，排队上限 2，超出后发丢帧标记。
+  const SubscriptionId slow_id =
+      bus.AddPcmSubscriber(Subscriber(10, 2), [&](const PcmFrame& f) {
+        (f.dropped ? slow_markers : slow).push_back(f.sequence);
+      });
+  ASSERT_NE(slow_id, 0u);
+
+  std::vector<float> samples(16, 0.5f);
+  for (uint32_t i = 0; i < 20; ++i) {
+    PcmInputFrame frame{samples.data(), 8, 48000, 2, static_cast<int64_t>(i) * 10, i + 1};
+    ASSERT_EQ(bus.Push(frame, static_cast<int64_t>(i) * 10), Status::kOk);
+  }
+
+  EXPECT_EQ(all.size(), 20u);
+  EXPECT_EQ(slow, (std::vector<uint32_t>{1, 11}));
+  EXPECT_FALSE(slow_markers.empty());
+
+  PcmDispatchStats slow_stats;
+  ASSERT_TRUE(bus.subscriber_stats(slow_id, &slow_stats));
+  EXPECT_EQ(slow_stats.dispatched, slow.size() + slow_markers.size());
+  EXPECT_FALSE(bus.subscriber_stats(9999, &slow_stats));
+}
+
+TEST(PcmEventBusSubscriberTest, PayloadIsSharedNotCopied) {
+  PcmEventBus bus(UnthrottledIngress(), SpectrumConfig());
+
+  std::vector<const float*> seen_data;
+  std::vector<long> seen_refs;
+  for (int i = 0; i < 3; ++i) {
+    bus.AddPcmSubscriber(Subscriber(0, 1), [&](const PcmFrame& f) {
+      seen_data.push_back(f.data);
+      seen_refs.push_back(f.owner.use_count());
+    });
+  }
+
+  std::vector<float> samples(16, 0.5f);
+  PcmInputFrame frame{samples.data(), 8, 48000, 2, 0, 1};
+  ASSERT_EQ(bus.Push(frame, 0), Status::kOk);
+
+  ASSERT_EQ(seen_data.size(), 3u);
+  EXPECT_NE(seen_data[0], samples.data());  // copied once at ingress...
+  EXPECT_EQ(seen_data[1], seen_data[0]);    // ...then shared by every subscriber.
+  EXPECT_EQ(seen_data[2], seen_data[0]);
+  for (long refs : seen_refs) {
+    EXPECT_GE(refs, 2);  // pool slot + the delivered frame.
+  }
+}
+
+TEST(PcmEventBusSubscriberTest, SpectrumComputedOncePerFrameForAllSubscribers) {
+  SpectrumConfig spectrum_cfg;
+  spectrum_cfg.window_size = 64;
+  PcmEventBus bus(UnthrottledIngress(), spectrum_cfg);
+
+  std::vector<const float*> bins_ptrs;
+  std::vector<float> dc;
+  for (int i = 0; i < 2; ++i) {
+    bus.AddSpectrumSubscriber(Subscriber(0, 1), [&](const SpectrumFrame& s) {
+      bins_ptrs.push_back(s.bins);
+      dc.push_back(s.bins[0]);
+    });
+  }
+  bool got_pcm = false;
+  bus.SetPcmCallback([&](const PcmFrame&) { got_pcm = true; });
+
+  std::vector<float> samples(64 * 2, 0.5f);
+  PcmInputFrame frame{samples.data(), 64, 48000, 2, 0, 1};
+  ASSERT_EQ(bus.Push(frame, 0), Status::kOk);
+
+  EXPECT_TRUE(got_pcm);
+  ASSERT_EQ(bins_ptrs.size(), 2u);
+  EXPECT_EQ(bins_ptrs[0], bins_ptrs[1]);
+  EXPECT_FLOAT_EQ(dc[0], dc[1]);
+  EXPECT_EQ(bus.stats().spectrum.count, 2u);
+}
+
+TEST(PcmEventBusSubscriberTest, AsyncSlowSubscriberDoesNotStarveOthers) {
+  PcmDispatchConfig dispatch;
+  dispatch.mode = PcmDispatchMode::kAsync;
+  PcmEventBus bus(UnthrottledIngress(), SpectrumConfig(), dispatch);
+
+  std::atomic<bool> entered{false};
+  std::atomic<bool> release{false};
+  std::mutex mu;
+  std::vector<uint32_t> slow;
+  std::vector<uint32_t> fast;
+  const SubscriptionId slow_id = bus.AddPcmSubscriber(
+      Subscriber(0, 2, PcmOverflowPolicy::kDropOldest), [&](const PcmFrame& f) {
+        {
+          std::lock_guard<std::mutex> lock(mu);
+          slow.push_back(f.sequence);
+        }
+        if (f.sequence == 1) {
+          entered.store(true);
+          while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          }
+        }
+      });
+  const SubscriptionId fast_id =
+      bus.AddPcmSubscriber(Subscriber(0, 16, PcmOverflowPolicy::kDropNewest),
+                           [&](const PcmFrame& f) {
+                             std::lock_guard<std::mutex> lock(mu);
+                             fast.push_back(f.sequence);
+                           });
+
+  std::vector<float> samples(16, 0.5f);
+  PcmInputFrame frame{samples.data(), 8, 48000, 2, 0, 1};
+  ASSERT_EQ(bus.Push(frame, 0), Status::kOk);
+  while (!entered.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  for (uint32_t seq = 2; seq <= 10; ++seq) {
+    frame.sequence = seq;
+    ASSERT_EQ(bus.Push(frame, seq), Status::kOk);
+  }
+  release.store(true);
+  bus.Flush();
+
+  EXPECT_EQ(slow, (std::vector<uint32_t>{1, 9, 10}));
+  EXPECT_EQ(fast.size(), 10u);  // 各自队列独立，快订阅者不受慢订阅者的丢弃影响。
+
+  PcmDispatchStats stats;
+  ASSERT_TRUE(bus.subscriber_stats(slow_id, &stats));
+  EXPECT_EQ(stats.dropped_oldest, 7u);
+  ASSERT_TRUE(bus.subscriber_stats(fast_id, &stats));
+  EXPECT_EQ(stats.dropped_oldest + stats.dropped_newest, 0u);
+}
+
+TEST(PcmEventBusSubscriberTest, RemovedSubscriberIsNotCalled) {
+  PcmEventBus bus(UnthrottledIngress(), SpectrumConfig());
+  int calls = 0;
+  const SubscriptionId id =
+      bus.AddPcmSubscriber(Subscriber(0, 1), [&](const PcmFrame&) { ++calls; });
+  EXPECT_EQ(bus.AddPcmSubscriber(Subscriber(0, 0), [](const PcmFrame&) {}), 0u);
+  EXPECT_EQ(bus.AddPcmSubscriber(Subscriber(0, 1), nullptr), 0u);
+
+  std::vector<float> samples(16, 0.5f);
+  PcmInputFrame frame{samples.data(), 8, 48000, 2, 0, 1};
+  ASSERT_EQ(bus.Push(frame, 0), Status::kOk);
+  EXPECT_EQ(calls, 1);
+
+  EXPECT_TRUE(bus.RemoveSubscriber(id));
+  EXPECT_FALSE(bus.RemoveSubscriber(id));
+  frame.sequence = 2;
+  ASSERT_EQ(bus.Push(frame, 1), Status::kOk);
+  EXPECT_EQ(calls, 1);
+}
+
+}  // namespace sw
@@ -0,0 +1,394 @@
+#include "pcm_file_decoder.h"
+
+#include <gtest/gtest.h>
+
+#include "alloc_counter.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sw {
+
+namespace {
+
+std::string TempPath(const char* name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void PutLe(std::vector<uint8_t>* out, uint32_t v, int bytes) {
+  for (int i = 0; i < bytes; ++i) out->push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+void WriteBytes(const std::string& path, const std::vector<uint8_t>& bytes) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+}
+
+struct WavSpec {
+  uint16_t format = 1;  // 1 PCM、3 float
+  int bits = 16;
+  int channels = 2;
+  int sample_rate = 48000;
+  bool extensible = false;
+  bool list_chunk = false;  // 在 fmt 与 data 之间插入一个奇数长度的 LIST 块。
+};
+
+std::vector<uint8_t> MakeWav(const WavSpec& spec, const std::vector<uint8_t>& payload) {
+  const int block = spec.channels * spec.bits / 8;
+  std::vector<uint8_t> fmt;
+  PutLe(&fmt, spec.extensible ? 0xFFFEu : spec.format, 2);
+  PutLe(&fmt, static_cast<uint32_t>(spec.channels), 2);
+  PutLe(&fmt, static_cast<uint32_t>(spec.sample_rate), 4);
+  PutLe(&fmt, static_cast<uint32_t>(spec.sample_rate * block), 4);
+  PutLe(&fmt, static_cast<uint32_t>(block), 2);
+  PutLe(&fmt, static_cast<uint32_t>(spec.bits), 2);
+  if (spec.extensible) {
+    PutLe(&fmt, 22, 2);
+    PutLe(&fmt, static_cast<uint32_t>(spec.bits), 2);
+    PutLe(&fmt, 3, 4);
+    PutLe(&fmt, spec.format, 2);
+    const uint8_t guid_tail[14] = {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80,
+                                   0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+    fmt.insert(fmt.end(), guid_tail, guid_tail + 14);
+  }
+  std::vector<uint8_t> wav = {'R', 'I', 'F', 'F', 0,   0,   0,   0,
+                              'W', 'A', 'V', 'E', 'f', 'm', 't', ' '};
+  PutLe(&wav, static_cast<uint32_t>(fmt.size()), 4);
+  wav.insert(wav.end(), fmt.begin(), fmt.end());
+  if (spec.list_chunk) {
+    const uint8_t list[] = {'L', 'I', 'S', 'T', 3, 0, 0, 0, 'a', 'b', 'c', 0};
+    wav.insert(wav.end(), list, list + sizeof(list));
+  }
+  const uint8_t data[] = {'d', 'a', 't', 'a'};
+  wav.insert(wav.end(), data, data + 4);
+  PutLe(&wav, static_cast<uint32_t>(payload.size()), 4);
+  wav.insert(wav.end(), payload.begin(), payload.end());
+  const uint32_t riff_size = static_cast<uint32_t>(wav.size() - 8);
+  std::memcpy(wav.data() + 4, &riff_size, 4);
+  return wav;
+}
+
+// 帧 f、声道 c 的 PCM16 样本：可由位置唯一还原，便于校验 Seek。
+int16_t SampleS16(int f, int c) { return static_cast<int16_t>(f * 4 + c - 20000); }
+
+std::vector<uint8_t> S16Payload(int frames, int channels) {
+  std::vector<uint8_t> payload;
+  for (int f = 0; f < frames; ++f) {
+    for (int c = 0; c < channels; ++c) {
+      PutLe(&payload, static_cast<uint16_t>(SampleS16(f, c)), 2);
+    }
+  }
+  return payload;
+}
+
+float ExpectedS16(int f, int c) { return static_cast<float>(SampleS16(f, c)) / 32768.0f; }
+
+}  // namespace
+
+TEST(PcmFileDecoderTest, DecodesPcm16StereoInChunks) {
+  const std::string path = TempPath("sw_pcm_decoder_s16.wav");
+  WavSpec spec;
+  spec.list_chunk = true;
+  WriteBytes(path, MakeWav(spec, S16Payload(2500, 2)));
+
+  PcmFileDecoderConfig cfg;
+  cfg.frames_per_read = 1000;
+  PcmFileDecoder dec(cfg);
+  ASSERT_TRUE(dec.Open("file://" + path));
+  EXPECT_EQ(dec.sample_rate(), 48000);
+  EXPECT_EQ(dec.channels(), 2);
+  EXPECT_EQ(dec.num_frames(), 2500);
+  EXPECT_EQ(dec.encoding(), PcmEncoding::kS16);
+
+  PcmBuffer buf;
+  int frame = 0;
+  std::vector<size_t> chunk_frames;
+  while (dec.Read(buf)) {
+    ASSERT_EQ(buf.channels, 2);
+    ASSERT_EQ(buf.sample_rate, 48000);
+    const size_t frames = buf.interleaved.size() / 2;
+    chunk_frames.push_back(frames);
+    for (size_t i = 0; i < frames; ++i, ++frame) {
+      ASSERT_EQ(buf.interleaved[2 * i], ExpectedS16(frame, 0)) << frame;
+      ASSERT_EQ(buf.interleaved[2 * i + 1], ExpectedS16(frame, 1)) << frame;
+    }
+  }
+  EXPECT_EQ(dec.last_status(), Status::kOk);
+  EXPECT_EQ(frame, 2500);
+  EXPECT_EQ(chunk_frames, (std::vector<size_t>{1000, 1000, 500}));
+  EXPECT_TRUE(buf.interleaved.empty());
+  std::remove(path.c_str());
+}
+
+TEST(PcmFileDecoderTest, DecodesEveryEncoding) {
+  // 同一组值分别以 24/32 位整型、float32（含 EXTENSIBLE 头）写出。
+  const float values[] = {-1.0f, -0.5f, 0.0f, 0.25f, 0.75f};
+  struct Case {
+    uint16_t format;
+    int bits;
+    bool extensible;
+    PcmEncoding encoding;
+  };
+  const Case cases[] = {{1, 24, false, PcmEncoding::kS24},
+                        {1, 32, false, PcmEncoding::kS32},
+                        {3, 32, false, PcmEncoding::kF32},
+                        {1, 24, true, PcmEncoding::kS24},
+                        {3, 32, true, PcmEncoding::kF32}};
+  const std::string path = TempPath("sw_pcm_decoder_formats.wav");
+  for (const Case& c : cases) {
+    SCOPED_TRACE(c.bits);
+    std::vector<uint8_t> payload;
+    for (int rep = 0; rep < 7; ++rep) {
+      for (float v : values) {
+        if (c.format == 3) {
+          uint32_t bits;
+          std::memcpy(&bits, &v, 4);
+          PutLe(&payload, bits, 4);
+        } else {
+          const double full = c.bits == 24 ? 8388608.0 : 2147483648.0;
+          PutLe(&payload, static_cast<uint32_t>(static_cast<int32_t>(v * full)), c.bits / 8);
+        }
+      }
+    }
+    WavSpec spec;
+    spec.format = c.format;
+    spec.bits = c.bits;
+    spec.channels = 1;
+    spec.extensible = c.extensible;
+    WriteBytes(path, MakeWav(spec, payload));
+
+    PcmFileDecoder dec;
+    ASSERT_TRUE(dec.Open(path));
+    EXPECT_EQ(dec.encoding(), c.encoding);
+    PcmBuffer buf;
+    ASSERT_TRUE(dec.Read(buf));
+    ASSERT_EQ(buf.interleaved.size(), 35u);
+    for (size_t i = 0; i < buf.interleaved.size(); ++i) {
+      EXPECT_EQ(buf.interleaved[i], values[i % 5]) << i;
+    }
+  }
+  std::remove(path.c_str());
+}
+
+TEST(PcmFileDecoderTest, SeekIsSampleAccurate) {
+  const std::string path = TempPath("sw_pcm_decoder_seek.wav");
+  WriteBytes(path, MakeWav(WavSpec{}, S16Payload(4000, 2)));
+  PcmFileDecoderConfig cfg;
+  cfg.frames_per_read = 64;
+  PcmFileDecoder dec(cfg);
+  EXPECT_FALSE(dec.Seek(0));
+  EXPECT_EQ(dec.last_status(), Status::kInvalidState);
+  ASSERT_TRUE(dec.Open(path));
+
+  PcmBuffer buf;
+  for (int64_t target : {3001, 17, 0, 3999, 2048}) {
+    ASSERT_TRUE(dec.Seek(target));
+    EXPECT_EQ(dec.position(), target);
+    ASSERT_TRUE(dec.Read(buf));
+    EXPECT_EQ(buf.interleaved[0], ExpectedS16(static_cast<int>(target), 0));
+    EXPECT_EQ(buf.interleaved[1], ExpectedS16(static_cast<int>(target), 1));
+  }
+  ASSERT_TRUE(dec.Seek(3999));
+  ASSERT_TRUE(dec.Read(buf));
+  EXPECT_EQ(buf.interleaved.size(), 2u);  // 只剩最后一帧。
+
+  ASSERT_TRUE(dec.Seek(1 << 30));  // 越界截断到末尾：下一次 Read 即 EOF。
+  EXPECT_EQ(dec.position(), 4000);
+  EXPECT_FALSE(dec.Read(buf));
+  EXPECT_EQ(dec.last_status(), Status::kOk);
+  EXPECT_FALSE(dec.Seek(-1));
+  EXPECT_EQ(dec.last_status(), Status::kInvalidArguments);
+  std::remove(path.c_str());
+}
+
+TEST(PcmFileDecoderTest, ConvertsChannelCountToOutputFormat) {
+  const std::string path = TempPath("sw_pcm_decoder_channels.wav");
+  WriteBytes(path, MakeWav(WavSpec{}, S16Payload(100, 2)));
+
+  PcmFileDecoder mono;
+  ASSERT_TRUE(mono.ConfigureOutput(48000, 1));
+  ASSERT_TRUE(mono.Open(path));
+  EXPECT_EQ(mono.channels(), 1);
+  EXPECT_EQ(mono.source_channels(), 2);
+  PcmBuffer buf;
+  ASSERT_TRUE(mono.Read(buf));
+  ASSERT_EQ(buf.interleaved.size(), 100u);
+  EXPECT_FLOAT_EQ(buf.interleaved[10], 0.5f * (ExpectedS16(10, 0) + ExpectedS16(10, 1)));
+  // 打开后只接受当前输出格式。
+  EXPECT_TRUE(mono.ConfigureOutput(48000, 1));
+  EXPECT_FALSE(mono.ConfigureOutput(48000, 2));
+  EXPECT_EQ(mono.last_status(), Status::kNotSupported);
+
+  PcmFileDecoder quad;
+  ASSERT_TRUE(quad.ConfigureOutput(48000, 4));
+  ASSERT_TRUE(quad.Open(path));
+  ASSERT_TRUE(quad.Read(buf));
+  ASSERT_EQ(buf.interleaved.size(), 400u);
+  EXPECT_EQ(buf.interleaved[4 * 7 + 0], ExpectedS16(7, 0));
+  EXPECT_EQ(buf.interleaved[4 * 7 + 1], ExpectedS16(7, 1));
+  EXPECT_EQ(buf.interleaved[4 * 7 + 2], 0.0f);
+
+  // 采样率不一致：经重采样输出 ⌈100 · 147 / 160⌉ = 92 帧。
+  PcmFileDecoder resample;
+  ASSERT_TRUE(resample.ConfigureOutput(44100, 2));
+  ASSERT_TRUE(resample.Open(path));
+  EXPECT_EQ(resample.sample_rate(), 44100);
+  size_t resampled = 0;
+  while (resample.Read(buf)) {
+    EXPECT_EQ(buf.sample_rate, 44100);
+    resampled += buf.interleaved.size() / 2;
+  }
+  EXPECT_EQ(resample.last_status(), Status::kOk);
+  EXPECT_EQ(resampled, 92u);
+  // sinc 模式不支持相数过多的比例（44101/48000 化简后 L = 44101）。
+  PcmFileDecoder odd_ratio;
+  ASSERT_TRUE(odd_ratio.ConfigureOutput(44101, 2));
+  EXPECT_FALSE(odd_ratio.Open(path));
+  EXPECT_EQ(odd_ratio.last_status(), Status::kNotSupported);
+  std::remove(path.c_str());
+}
+
+TEST(PcmFileDecoderTest, DecodesRawPcm) {
+  const std::string path = TempPath("sw_pcm_decoder_raw.pcm");
+  std::vector<uint8_t> payload = S16Payload(300, 2);
+  payload.push_back(0x12);  // 不完整的尾帧被丢弃。
+  WriteBytes(path, payload);
+
+  // 未指定格式时沿用输出格式。
+  PcmFileDecoder dec;
+  ASSERT_TRUE(dec.ConfigureOutput(22050, 2));
+  ASSERT_TRUE(dec.Open(path));
+  EXPECT_EQ(dec.num_frames(), 300);
+  EXPECT_EQ(dec.sample_rate(), 22050);
+  PcmBuffer buf;
+  ASSERT_TRUE(dec.Read(buf));
+  EXPECT_EQ(buf.interleaved[2 * 299 + 1], ExpectedS16(299, 1));
+
+  PcmFileDecoderConfig cfg;
+  cfg.raw.sample_rate = 8000;
+  cfg.raw.channels = 1;
+  PcmFileDecoder explicit_format(cfg);
+  ASSERT_TRUE(explicit_format.Open(path));
+  EXPECT_EQ(explicit_format.num_frames(), 600);
+  EXPECT_EQ(explicit_format.sample_rate(), 8000);
+
+  PcmFileDecoder unknown;
+  EXPECT_FALSE(unknown.Open(path));
+  EXPECT_EQ(unknown.last_status(), Status::kInvalidArguments);
+  std::remove(path.c_str());
+}
+
+TEST(PcmFileDecoderTest, RejectsMissingCorruptAndUnsupportedFiles) {
+  PcmFileDecoder dec;
+  EXPECT_FALSE(dec.Open(""));
+  EXPECT_EQ(dec.last_status(), Status::kInvalidArguments);
+  EXPECT_FALSE(dec.Open(TempPath("sw_pcm_decoder_missing.wav")));
+  EXPECT_EQ(dec.last_status(), Status::kIoError);
+  PcmBuffer buf;
+  EXPECT_FALSE(dec.Read(buf));
+  EXPECT_EQ(dec.last_status(), Status::kInvalidState);
+
+  const std::string path = TempPath("sw_pcm_decoder_bad.wav");
+  WriteBytes(path, {'n', 'o', 't', ' ', 'a', ' ', 'w', 'a', 'v', 'e', 'f', 'i', 'l', 'e'});
+  EXPECT_FALSE(dec.Open(path));
+  EXPECT_EQ(dec.last_status(), Status::kError);
+
+  std::vector<uint8_t> no_data = MakeWav(WavSpec{}, {});
+  no_data.resize(no_data.size() - 8);  // 去掉 data 块头。
+  WriteBytes(path, no_data);
+  EXPECT_FALSE(dec.Open(path));
+  EXPECT_EQ(dec.last_status(), Status::kError);
+
+  WavSpec eight_bit;
+  eight_bit.bits = 8;
+  WriteBytes(path, MakeWav(eight_bit, std::vector<uint8_t>(16, 0x80)));
+  EXPECT_FALSE(dec.Open(path));
+  EXPECT_EQ(dec.last_status(), Status::kNotSupported);
+
+  // data 大小超出文件（流式写出未回填）：按实际长度截断。
+  std::vector<uint8_t> streaming = MakeWav(WavSpec{}, S16Payload(10, 2));
+  std::memset(streaming.data() + streaming.size() - 40 - 4, 0xff, 4);
+  WriteBytes(path, streaming);
+  ASSERT_TRUE(dec.Open(path));
+  EXPECT_EQ(dec.num_frames(), 10);
+  std::remove(path.c_str());
+}
+
+TEST(PcmFileDecoderTest, SteadyStateReadDoesNotAllocate) {
+  const std::string path = TempPath("sw_pcm_decoder_alloc.wav");
+  WriteBytes(path, MakeWav(WavSpec{}, S16Payload(48000, 2)));
+  PcmFileDecoder dec;
+  ASSERT_TRUE(dec.ConfigureOutput(48000, 1));
+  ASSERT_TRUE(dec.Open(path));
+  PcmBuffer buf;
+  ASSERT_TRUE(dec.Read(buf));
+
+  sw::testing::ScopedAllocCounter allocs;
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_TRUE(dec.Read(buf));
+  }
+  ASSERT_TRUE(dec.Seek(0));
+  ASSERT_TRUE(dec.Read(buf));
+  EXPECT_EQ(allocs.count(), 0u);
+  std::remove(path.c_str());
+}
+
+TEST(PcmFileDecoderTest, EnginePlaysRealFileAndSeeks) {
+  const std::string path = TempPath("sw_pcm_decoder_engine.wav");
+  WriteBytes(path, MakeWav(WavSpec{}, S16Payload(48000, 2)));
+  EXPECT_NE(dynamic_cast<PcmFileDecoder*>(CreateDecoderForSource("file://" + path).get()),
+            nullptr);
+  EXPECT_EQ(dynamic_cast<PcmFileDecoder*>(CreateDecoderForSource("file:///tmp/x.mp3").get()),
+            nullptr);
+
+  auto engine = CreateAudioEngineStub();
+  AudioConfig cfg;
+  cfg.sample_rate = 48000;
+  cfg.channels = 2;
+  cfg.frames_per_buffer = 480;
+  cfg.pcm_max_fps = 0;
+  ASSERT_EQ(engine->Init(cfg), Status::kOk);
+  ASSERT_EQ(engine->Load("file://" + path), Status::kOk);
+
+  struct Seen {
+    std::mutex mu;
+    std::vector<float> first;
+    std::atomic<int> frames{0};
+  };
+  Seen seen;
+  engine->SetPcmCallback(
+      [](const PcmFrame& f, void* ud) {
+        auto* s = static_cast<Seen*>(ud);
+        std::lock_guard<std::mutex> lock(s->mu);
+        if (s->first.empty()) s->first.assign(f.data, f.data + 4);
+        s->frames.fetch_add(1);
+      },
+      &seen);
+  // 先定位再播放：首个推送块应从 500ms（第 24000 帧）开始。
+  ASSERT_EQ(engine->Seek(500), Status::kOk);
+  ASSERT_EQ(engine->Play(), Status::kOk);
+  for (int i = 0; i < 200 && seen.frames.load() < 1; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_EQ(engine->Stop(), Status::kOk);
+  std::lock_guard<std::mutex> lock(seen.mu);
+  ASSERT_EQ(seen.first.size(), 4u);
+  EXPECT_EQ(seen.first[0], ExpectedS16(24000, 0));
+  EXPECT_EQ(seen.first[1], ExpectedS16(24000, 1));
+  EXPECT_EQ(seen.first[2], ExpectedS16(24001, 0));
+
+  // 其他来源回退占位解码器。
+  EXPECT_EQ(engine->Load(TempPath("sw_pcm_decoder_absent.mp3")), Status::kOk);
+  std::remove(path.c_str());
+}
+
+}  // namespace sw
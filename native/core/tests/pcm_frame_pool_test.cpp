@@ -0,0 +1,80 @@
+#include "pcm_frame_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "alloc_counter.h"
+
+namespace sw {
+
+TEST(PcmFramePoolTest, RecyclesReleasedBuffers) {
+  PcmFramePool pool(2, 64);
+  auto a = pool.Acquire(32);
+  ASSERT_EQ(a->size(), 32u);
+  const float* a_data = a->data();
+  auto b = pool.Acquire(64);
+  EXPECT_NE(b->data(), a_data);
+  EXPECT_EQ(pool.stats().in_use, 2u);
+
+  a.reset();
+  auto c = pool.Acquire(16);
+  EXPECT_EQ(c->data(), a_data);  // same storage, no reallocation.
+  EXPECT_EQ(c->size(), 16u);
+
+  const PcmFramePoolStats stats = pool.stats();
+  EXPECT_EQ(stats.capacity, 2u);
+  EXPECT_EQ(stats.hits, 3u);
+  EXPECT_EQ(stats.misses, 0u);
+  EXPECT_EQ(stats.grows, 0u);
+  EXPECT_EQ(stats.high_water, 2u);
+}
+
+TEST(PcmFramePoolTest, ExhaustionFallsBackToHeapAndCountsMiss) {
+  PcmFramePool pool(1);
+  auto a = pool.Acquire(8);
+  auto b = pool.Acquire(8);  // pool exhausted.
+  ASSERT_TRUE(b);
+  EXPECT_EQ(b->size(), 8u);
+  PcmFramePoolStats stats = pool.stats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.grows, 1u);  // no samples_hint: first use grows.
+  EXPECT_EQ(stats.high_water, 1u);
+
+  b.reset();  // unpooled buffer simply frees.
+  a.reset();
+  EXPECT_EQ(pool.stats().in_use, 0u);
+}
+
+TEST(PcmFramePoolTest, SteadyStateAcquireDoesNotAllocate) {
+  PcmFramePool pool(4, 512);
+  std::vector<std::shared_ptr<std::vector<float>>> held;
+  held.reserve(4);
+  sw::testing::ScopedAllocCounter allocs;
+  for (int i = 0; i < 1000; ++i) {
+    held.push_back(pool.Acquire(512));
+    if (held.size() == 3) {
+      held.clear();
+    }
+  }
+  EXPECT_EQ(allocs.count(), 0u);
+  EXPECT_EQ(pool.stats().misses, 0u);
+  EXPECT_EQ(pool.stats().high_water, 3u);
+}
+
+TEST(PcmFramePoolTest, BuffersReleasedOnOtherThreadReturnToPool) {
+  PcmFramePool pool(2, 16);
+  for (int i = 0; i < 200; ++i) {
+    auto buffer = pool.Acquire(16);
+    (*buffer)[0] = static_cast<float>(i);
+    std::thread consumer([b = std::move(buffer)]() mutable { b.reset(); });
+    consumer.join();
+  }
+  EXPECT_EQ(pool.stats().misses, 0u);
+  EXPECT_EQ(pool.stats().in_use, 0u);
+}
+
+}  // namespace sw
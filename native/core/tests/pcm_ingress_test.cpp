@@ -1,6 +1,11 @@
 #include "pcm_ingress.h"
 
 #include <gtest/gtest.h>
+
+#include "alloc_counter.h"
+
+#include <atomic>
+#include <thread>
 #include <vector>
 
 namespace sw {
@@ -75,4 +80,143 @@ TEST(PcmIngressTest, ThrottleAndEnqueueFrames) {
   EXPECT_EQ(out.num_frames, 0);
 }
 
+TEST(PcmIngressTest, PooledPayloadsAreRecycledAfterRelease) {
+  PcmIngressConfig cfg;
+  cfg.throttle.max_fps = 0;  // no rate limit: every push emits.
+  cfg.throttle.max_pending = 2;
+  cfg.pool_capacity = 2;
+  cfg.pool_samples_hint = 8;
+  PcmIngress ingress(cfg);
+
+  std::vector<float> samples(8, 0.5f);
+  PcmInputFrame frame{samples.data(), 4, 48000, 2, 0, 1};
+  const float* first_data = nullptr;
+  for (uint32_t i = 0; i < 50; ++i) {
+    frame.sequence = i + 1;
+    ASSERT_EQ(ingress.Push(frame, i), Status::kOk);
+    PcmFrame out;
+    ASSERT_TRUE(ingress.Pop(out));
+    ASSERT_TRUE(out.owner);
+    EXPECT_FLOAT_EQ(out.data[7], 0.5f);
+    if (first_data == nullptr) {
+      first_data = out.data;
+    }
+  }  // each popped frame is released before the next push.
+
+  const PcmFramePoolStats stats = ingress.pool_stats();
+  EXPECT_EQ(stats.capacity, 2u);
+  EXPECT_EQ(stats.hits, 50u);
+  EXPECT_EQ(stats.misses, 0u);
+  EXPECT_EQ(stats.grows, 0u);
+  EXPECT_LE(stats.high_water, 2u);
+
+  // Consumer holding frames beyond the pool size shows up as misses.
+  std::vector<PcmFrame> held(3);
+  for (auto& h : held) {
+    ASSERT_EQ(ingress.Push(frame, 100), Status::kOk);
+    ASSERT_TRUE(ingress.Pop(h));
+  }
+  EXPECT_EQ(ingress.pool_stats().misses, 1u);
+  EXPECT_EQ(ingress.pool_stats().high_water, 2u);
+}
+
+TEST(PcmIngressTest, QueueOverflowFoldsIntoNextDroppedBefore) {
+  PcmIngressConfig cfg;
+  cfg.throttle.max_fps = 0;
+  cfg.throttle.max_pending = 2;  // queue capacity 3
+  PcmIngress ingress(cfg);
+  EXPECT_EQ(ingress.queue_capacity(), 3u);
+
+  std::vector<float> samples(4, 1.0f);
+  PcmInputFrame frame{samples.data(), 2, 48000, 2, 0, 1};
+  for (uint32_t i = 0; i < 5; ++i) {
+    frame.sequence = i + 1;
+    ASSERT_EQ(ingress.Push(frame, i), Status::kOk);
+  }
+  EXPECT_EQ(ingress.queue_overflow_drops(), 2u);
+
+  PcmFrame out;
+  for (uint32_t seq = 1; seq <= 3; ++seq) {
+    ASSERT_TRUE(ingress.Pop(out));
+    EXPECT_EQ(out.sequence, seq);
+    EXPECT_EQ(out.dropped_before, 0u);
+  }
+  EXPECT_FALSE(ingress.Pop(out));
+
+  frame.sequence = 6;
+  ASSERT_EQ(ingress.Push(frame, 10), Status::kOk);
+  ASSERT_TRUE(ingress.Pop(out));
+  EXPECT_EQ(out.sequence, 6u);
+  EXPECT_EQ(out.dropped_before, 2u);  // sequences 4 and 5 were lost to overflow.
+}
+
+TEST(PcmIngressTest, ProducerAndConsumerOnSeparateThreads) {
+  PcmIngressConfig cfg;
+  cfg.throttle.max_fps = 0;
+  cfg.throttle.max_pending = 8;
+  PcmIngress ingress(cfg);
+
+  constexpr uint32_t kFrames = 20000;
+  std::atomic<bool> producer_done{false};
+  std::thread producer([&]() {
+    std::vector<float> samples(8);
+    for (uint32_t i = 0; i < kFrames; ++i) {
+      for (size_t s = 0; s < samples.size(); ++s) {
+        samples[s] = static_cast<float>(i);
+      }
+      PcmInputFrame frame{samples.data(), 4, 48000, 2, i, i + 1};
+      ingress.Push(frame, i);
+      if (i % 64 == 0) {
+        std::this_thread::yield();
+      }
+    }
+    producer_done.store(true);
+  });
+
+  uint64_t received = 0;
+  uint64_t dropped = 0;
+  uint32_t last_sequence = 0;
+  for (;;) {
+    const bool done = producer_done.load();
+    PcmFrame out;
+    if (!ingress.Pop(out)) {
+      if (done) break;  // 生产端结束后再确认一次队列已空。
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_GT(out.sequence, last_sequence);
+    ASSERT_FALSE(out.dropped);
+    // 负载内容与序号一致，说明缓冲未被生产端提前复用。
+    EXPECT_FLOAT_EQ(out.data[0], static_cast<float>(out.sequence - 1));
+    EXPECT_FLOAT_EQ(out.data[7], static_cast<float>(out.sequence - 1));
+    dropped += out.dropped_before;
+    last_sequence = out.sequence;
+    ++received;
+  }
+  producer.join();
+  // 末尾若发生溢出，丢帧只会记入下一帧，故这里仅能计到最后一帧为止。
+  EXPECT_EQ(received + dropped, last_sequence);
+  EXPECT_LE(ingress.queue_overflow_drops(), kFrames - received);
+}
+
+TEST(PcmIngressTest, SteadyStatePushPopDoesNotAllocate) {
+  PcmIngressConfig cfg;
+  cfg.throttle.max_fps = 0;
+  cfg.throttle.max_pending = 4;
+  cfg.pool_samples_hint = 512;
+  PcmIngress ingress(cfg);
+
+  std::vector<float> samples(512, 0.25f);
+  PcmInputFrame frame{samples.data(), 256, 48000, 2, 0, 1};
+  PcmFrame out;
+  sw::testing::ScopedAllocCounter allocs;
+  for (uint32_t i = 0; i < 200; ++i) {
+    frame.sequence = i + 1;
+    ASSERT_EQ(ingress.Push(frame, i), Status::kOk);
+    ASSERT_TRUE(ingress.Pop(out));
+    out = PcmFrame{};
+  }
+  EXPECT_EQ(allocs.count(), 0u);
+}
+
 }  // namespace sw
@@ -2,6 +2,9 @@
 
 #include <gtest/gtest.h>
 
+#include "alloc_counter.h"
+
+#include <chrono>
 #include <vector>
 
 using namespace std::chrono_literals;
@@ -71,4 +74,50 @@ TEST(PcmThrottleTest, DropsExcessPendingAndReports) {
   EXPECT_EQ(emitted[2].dropped_before, 1u);
 }
 
+TEST(PcmThrottleTest, SlotApiMatchesVectorApiWithoutAllocating) {
+  PcmThrottleConfig cfg;
+  cfg.max_fps = 50;
+  cfg.max_pending = 2;
+  PcmThrottler slot_throttler(cfg);
+  PcmThrottler vector_throttler(cfg);
+
+  std::vector<PcmThrottleOutput> expected;
+  std::vector<PcmThrottleOutput> emitted;
+  emitted.reserve(64);
+  for (uint32_t i = 0; i < 64; ++i) {
+    PcmThrottleInput in;
+    in.sequence = i + 1;
+    in.timestamp_ms = static_cast<int64_t>(i) * 3;
+    in.num_frames = 128;
+    in.num_channels = 2;
+    auto out = vector_throttler.Push(in, in.timestamp_ms);
+    expected.insert(expected.end(), out.begin(), out.end());
+  }
+
+  sw::testing::ScopedAllocCounter allocs;
+  for (uint32_t i = 0; i < 64; ++i) {
+    PcmThrottleInput in;
+    in.sequence = i + 1;
+    in.timestamp_ms = static_cast<int64_t>(i) * 3;
+    in.num_frames = 128;
+    in.num_channels = 2;
+    PcmThrottleOutput out;
+    if (slot_throttler.Push(in, in.timestamp_ms, &out)) {
+      emitted.push_back(out);
+    }
+  }
+  EXPECT_EQ(allocs.count(), 0u);
+
+  ASSERT_EQ(emitted.size(), expected.size());
+  for (size_t i = 0; i < emitted.size(); ++i) {
+    EXPECT_EQ(emitted[i].sequence, expected[i].sequence);
+    EXPECT_EQ(emitted[i].timestamp_ms, expected[i].timestamp_ms);
+    EXPECT_EQ(emitted[i].dropped_before, expected[i].dropped_before);
+    EXPECT_EQ(emitted[i].dropped, expected[i].dropped);
+  }
+
+  PcmThrottleInput in;
+  EXPECT_FALSE(slot_throttler.Push(in, 1000, nullptr));
+}
+
 }  // namespace sw
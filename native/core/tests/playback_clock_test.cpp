@@ -0,0 +1,60 @@
+#include "playback_clock.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace sw {
+
+TEST(PlaybackClockTest, ConvertsFramesToAllUnits) {
+  PlaybackClock clock(44100);
+  EXPECT_EQ(clock.frames(), 0);
+  EXPECT_EQ(clock.Advance(256), 256);
+  EXPECT_EQ(clock.ms(), 5);  // 5.8049 ms floors to 5.
+  EXPECT_EQ(clock.us(), 5804);
+  EXPECT_EQ(PlaybackClock::FramesToNs(256, 44100), 5804988);
+
+  clock.ResetMs(1500);
+  EXPECT_EQ(clock.frames(), 66150);
+  EXPECT_EQ(clock.ms(), 1500);
+  EXPECT_EQ(clock.us(), 1500000);
+
+  clock.Reset(44100);
+  EXPECT_EQ(clock.ms(), 1000);
+  EXPECT_EQ(PlaybackClock::MsToFrames(250, 48000), 12000);
+  EXPECT_EQ(PlaybackClock::FramesToMs(100, 0), 0);
+}
+
+TEST(PlaybackClockTest, TwentyFourSimulatedHoursHaveZeroDrift) {
+  constexpr int kSampleRate = 44100;
+  constexpr int64_t kFramesPerBuffer = 256;
+  constexpr int64_t kDaySeconds = 24 * 60 * 60;
+  constexpr int64_t kTotalFrames = kDaySeconds * kSampleRate;
+
+  PlaybackClock clock(kSampleRate);
+  int64_t legacy_ms = 0;  // previous behaviour: sum of per-buffer truncated milliseconds.
+  int64_t advanced = 0;
+  while (advanced < kTotalFrames) {
+    const int64_t n = std::min(kFramesPerBuffer, kTotalFrames - advanced);
+    clock.Advance(n);
+    legacy_ms += n * 1000 / kSampleRate;
+    advanced += n;
+  }
+
+  EXPECT_EQ(clock.frames(), kTotalFrames);
+  EXPECT_EQ(clock.ms(), kDaySeconds * 1000);
+  EXPECT_EQ(clock.us(), kDaySeconds * 1000000);
+  EXPECT_EQ(PlaybackClock::FramesToNs(clock.frames(), kSampleRate), kDaySeconds * 1000000000LL);
+  // The truncating accumulator loses ~0.8 ms per buffer: hours of drift over a day.
+  EXPECT_GT(kDaySeconds * 1000 - legacy_ms, 60 * 60 * 1000);
+}
+
+TEST(PlaybackClockTest, LargeFrameCountsDoNotOverflow) {
+  // ~6 years at 48 kHz: frames * 1e9 would overflow a naive int64 product.
+  const int64_t frames = int64_t{48000} * 60 * 60 * 24 * 365 * 6;
+  EXPECT_EQ(PlaybackClock::FramesToNs(frames, 48000), frames / 48000 * 1000000000LL);
+  EXPECT_EQ(PlaybackClock::FramesToUs(frames + 24000, 48000), frames / 48000 * 1000000 + 500000);
+}
+
+}  // namespace sw
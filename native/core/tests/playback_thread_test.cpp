@@ -62,6 +62,10 @@ TEST(PlaybackThreadTest, PositionIsMonotonicWithProducer) {
   EXPECT_GT(cb_count.load(), 0);
   EXPECT_EQ(regressions.load(), 0);
   EXPECT_GE(playback.position_ms(), 0);
+  // Consumed whole buffers: frames are exact and ms/us derive from them.
+  EXPECT_EQ(playback.position_frames() % cfg.frames_per_buffer, 0);
+  EXPECT_EQ(playback.position_us(), playback.position_frames() * 1000000 / cfg.sample_rate);
+  EXPECT_EQ(playback.position_ms(), playback.position_frames() * 1000 / cfg.sample_rate);
 }
 
 TEST(PlaybackThreadTest, StopsCleanlyWithoutData) {
@@ -0,0 +1,295 @@
+#include "resampler.h"
+
+#include <gtest/gtest.h>
+
+#include "alloc_counter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "pcm_file_decoder.h"
+
+namespace sw {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+std::vector<float> Sine(size_t frames, int channels, double freq, int rate, float amplitude) {
+  std::vector<float> out(frames * static_cast<size_t>(channels));
+  for (size_t i = 0; i < frames; ++i) {
+    for (int c = 0; c < channels; ++c) {
+      // 各声道相位错开，顺带验证声道没有串位。
+      const double phase = 2.0 * kPi * freq * static_cast<double>(i) / rate + 0.5 * c;
+      out[i * static_cast<size_t>(channels) + static_cast<size_t>(c)] =
+          amplitude * static_cast<float>(std::sin(phase));
+    }
+  }
+  return out;
+}
+
+// 以 block 帧为单位送入并 Flush，返回拼接后的全部输出。
+std::vector<float> ResampleAll(Resampler& r, const std::vector<float>& in, size_t block) {
+  const size_t ch = static_cast<size_t>(r.config().channels);
+  const size_t frames = in.size() / ch;
+  std::vector<float> all;
+  std::vector<float> out;
+  for (size_t pos = 0; pos < frames; pos += block) {
+    const size_t n = std::min(block, frames - pos);
+    const size_t produced = r.Process(in.data() + pos * ch, n, &out);
+    EXPECT_EQ(out.size(), produced * ch);
+    all.insert(all.end(), out.begin(), out.end());
+  }
+  r.Flush(&out);
+  all.insert(all.end(), out.begin(), out.end());
+  return all;
+}
+
+size_t ExpectedFrames(size_t in_frames, int in_rate, int out_rate) {
+  const uint64_t num = static_cast<uint64_t>(in_frames) * static_cast<uint64_t>(out_rate);
+  return static_cast<size_t>((num + static_cast<uint64_t>(in_rate) - 1) /
+                             static_cast<uint64_t>(in_rate));
+}
+
+ResamplerConfig MakeConfig(int in_rate, int out_rate, int channels, ResamplerQuality quality) {
+  ResamplerConfig cfg;
+  cfg.input_rate = in_rate;
+  cfg.output_rate = out_rate;
+  cfg.channels = channels;
+  cfg.quality = quality;
+  return cfg;
+}
+
+}  // namespace
+
+TEST(ResamplerTest, SincPreservesSineAcrossCommonRatios) {
+  const int kRates[][2] = {{44100, 48000}, {48000, 44100}, {44100, 88200}, {96000, 48000}};
+  for (const auto& rates : kRates) {
+    SCOPED_TRACE(std::to_string(rates[0]) + " -> " + std::to_string(rates[1]));
+    Resampler r;
+    ASSERT_TRUE(r.Configure(MakeConfig(rates[0], rates[1], 2, ResamplerQuality::kSinc)));
+    const size_t frames = static_cast<size_t>(rates[0]) / 4;
+    const std::vector<float> in = Sine(frames, 2, 1000.0, rates[0], 0.5f);
+    const std::vector<float> out = ResampleAll(r, in, 480);
+    const std::vector<float> ideal =
+        Sine(ExpectedFrames(frames, rates[0], rates[1]), 2, 1000.0, rates[1], 0.5f);
+    ASSERT_EQ(out.size(), ideal.size());
+    // 两端有半个滤波器窗口的截断效应，跳过后逐样本比对。
+    float max_err = 0.0f;
+    for (size_t i = 200; i + 200 < out.size(); ++i) {
+      max_err = std::max(max_err, std::fabs(out[i] - ideal[i]));
+    }
+    EXPECT_LT(max_err, 1e-3f);
+  }
+}
+
+TEST(ResamplerTest, SincAttenuatesContentAboveOutputNyquist) {
+  // 48k → 44.1k 时 23 kHz 的音会折叠到 21.1 kHz，应被抗混叠滤波压到 -60 dB 以下。
+  Resampler r;
+  ASSERT_TRUE(r.Configure(MakeConfig(48000, 44100, 1, ResamplerQuality::kSinc)));
+  const std::vector<float> out = ResampleAll(r, Sine(24000, 1, 23000.0, 48000, 1.0f), 1024);
+  double energy = 0.0;
+  size_t count = 0;
+  for (size_t i = 200; i + 200 < out.size(); ++i, ++count) energy += out[i] * out[i];
+  const double rms = std::sqrt(energy / static_cast<double>(count));
+  EXPECT_LT(rms, 1e-3 * std::sqrt(0.5));
+}
+
+TEST(ResamplerTest, SincAttenuatesAboveOutputNyquistForLargeDecimation) {
+  // 4:1 以上的抽取：截止频率随 L/M 下移，抽头数须同比例增加，过渡带才不会变宽。
+  struct Case {
+    int in_rate;
+    int out_rate;
+    double tone_hz;  // 略高于输出 Nyquist，会折叠回通带。
+  };
+  const Case kCases[] = {{192000, 48000, 25500.0}, {96000, 22050, 11700.0}};
+  for (const Case& c : kCases) {
+    SCOPED_TRACE(std::to_string(c.in_rate) + " -> " + std::to_string(c.out_rate));
+    Resampler r;
+    ASSERT_TRUE(r.Configure(MakeConfig(c.in_rate, c.out_rate, 1, ResamplerQuality::kSinc)));
+    const std::vector<float> out =
+        ResampleAll(r, Sine(static_cast<size_t>(c.in_rate) / 2, 1, c.tone_hz, c.in_rate, 1.0f),
+                    1024);
+    double energy = 0.0;
+    size_t count = 0;
+    for (size_t i = 400; i + 400 < out.size(); ++i, ++count) energy += out[i] * out[i];
+    const double rms = std::sqrt(energy / static_cast<double>(count));
+    EXPECT_LT(rms, 1e-3 * std::sqrt(0.5));
+  }
+
+  // 抽头数上限 kMaxSincTaps 对应 32:1；更大的比例 sinc 模式拒绝，线性模式照常工作。
+  Resampler r;
+  EXPECT_TRUE(r.Configure(MakeConfig(48000 * 32, 48000, 1, ResamplerQuality::kSinc)));
+  EXPECT_FALSE(r.Configure(MakeConfig(48000 * 33, 48000, 1, ResamplerQuality::kSinc)));
+  EXPECT_TRUE(r.Configure(MakeConfig(48000 * 33, 48000, 1, ResamplerQuality::kLinear)));
+}
+
+TEST(ResamplerTest, OutputLengthMatchesRatio) {
+  struct Case {
+    int in_rate;
+    int out_rate;
+    ResamplerQuality quality;
+  };
+  const Case kCases[] = {{44100, 48000, ResamplerQuality::kSinc},
+                         {48000, 44100, ResamplerQuality::kSinc},
+                         {8000, 48000, ResamplerQuality::kSinc},
+                         {192000, 8000, ResamplerQuality::kSinc},
+                         {44100, 48000, ResamplerQuality::kLinear},
+                         {44100, 22051, ResamplerQuality::kLinear}};
+  for (const Case& c : kCases) {
+    for (size_t frames : {size_t{0}, size_t{1}, size_t{63}, size_t{1000}, size_t{5000}}) {
+      SCOPED_TRACE(std::to_string(c.in_rate) + " -> " + std::to_string(c.out_rate) + ", " +
+                   std::to_string(frames) + " frames");
+      Resampler r;
+      ASSERT_TRUE(r.Configure(MakeConfig(c.in_rate, c.out_rate, 2, c.quality)));
+      const std::vector<float> in(frames * 2, 0.25f);
+      const std::vector<float> out = ResampleAll(r, in, 333);
+      EXPECT_EQ(out.size(), 2 * ExpectedFrames(frames, c.in_rate, c.out_rate));
+      // 直流增益为 1（端点处 sinc 受补零影响，只看中段）。
+      const size_t mid = out.size() / 2 & ~size_t{1};
+      if (out.size() > 256) {
+        EXPECT_NEAR(out[mid], 0.25f, 1e-4f);
+      }
+    }
+  }
+}
+
+TEST(ResamplerTest, ChunkingDoesNotChangeOutput) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> in(2 * 20000);
+  for (float& v : in) v = dist(rng);
+  for (ResamplerQuality quality : {ResamplerQuality::kSinc, ResamplerQuality::kLinear}) {
+    Resampler whole;
+    ASSERT_TRUE(whole.Configure(MakeConfig(44100, 48000, 2, quality)));
+    const std::vector<float> expected = ResampleAll(whole, in, in.size());
+
+    // 随机块长（含 1 帧与超过内部分块的长度）。
+    Resampler chunked;
+    ASSERT_TRUE(chunked.Configure(MakeConfig(44100, 48000, 2, quality)));
+    std::vector<float> all;
+    std::vector<float> out;
+    size_t pos = 0;
+    while (pos < 20000) {
+      const size_t n = std::min<size_t>(1 + rng() % 3000, 20000 - pos);
+      chunked.Process(in.data() + pos * 2, n, &out);
+      all.insert(all.end(), out.begin(), out.end());
+      pos += n;
+    }
+    chunked.Flush(&out);
+    all.insert(all.end(), out.begin(), out.end());
+    EXPECT_EQ(all, expected);
+
+    // Flush 之后状态复位，可以重新开始一条流。
+    EXPECT_EQ(ResampleAll(chunked, in, 4096), expected);
+  }
+}
+
+TEST(ResamplerTest, LinearModeHandlesArbitraryRatio) {
+  // 44100 → 44101 化简后 L = 44101，sinc 模式不支持，线性模式照常工作。
+  Resampler sinc;
+  EXPECT_FALSE(sinc.Configure(MakeConfig(44100, 44101, 1, ResamplerQuality::kSinc)));
+  EXPECT_FALSE(sinc.configured());
+
+  Resampler r;
+  ASSERT_TRUE(r.Configure(MakeConfig(44100, 44101, 1, ResamplerQuality::kLinear)));
+  EXPECT_EQ(r.interpolation(), 44101);
+  EXPECT_EQ(r.decimation(), 44100);
+  std::vector<float> ramp(10000);
+  for (size_t i = 0; i < ramp.size(); ++i) ramp[i] = 1e-4f * static_cast<float>(i);
+  const std::vector<float> out = ResampleAll(r, ramp, 777);
+  ASSERT_EQ(out.size(), ExpectedFrames(ramp.size(), 44100, 44101));
+  // 斜坡经线性插值仍是斜坡：输出 n 位于输入 n · 44100 / 44101 处。最后一帧与补的零插值，跳过。
+  for (size_t n = 0; n + 1 < out.size(); ++n) {
+    const double x = static_cast<double>(n) * 44100.0 / 44101.0;
+    ASSERT_NEAR(out[n], 1e-4 * x, 1e-5) << n;
+  }
+}
+
+TEST(ResamplerTest, RejectsInvalidConfigAndUnconfiguredUse) {
+  Resampler r;
+  std::vector<float> out(8, 1.0f);
+  const float in[4] = {};
+  EXPECT_EQ(r.Process(in, 2, &out), 0u);
+  EXPECT_TRUE(out.empty());
+  EXPECT_FALSE(r.Configure(MakeConfig(0, 48000, 2, ResamplerQuality::kSinc)));
+  EXPECT_FALSE(r.Configure(MakeConfig(44100, -1, 2, ResamplerQuality::kSinc)));
+  EXPECT_FALSE(r.Configure(MakeConfig(44100, 48000, 0, ResamplerQuality::kLinear)));
+  ASSERT_TRUE(r.Configure(MakeConfig(44100, 48000, 2, ResamplerQuality::kSinc)));
+  EXPECT_EQ(r.interpolation(), 160);
+  EXPECT_EQ(r.decimation(), 147);
+  EXPECT_EQ(r.Process(nullptr, 4, &out), 0u);
+}
+
+TEST(ResamplerTest, SteadyStateProcessDoesNotAllocate) {
+  for (ResamplerQuality quality : {ResamplerQuality::kSinc, ResamplerQuality::kLinear}) {
+    Resampler r;
+    ASSERT_TRUE(r.Configure(MakeConfig(44100, 48000, 2, quality)));
+    const std::vector<float> in = Sine(4096, 2, 440.0, 44100, 0.5f);
+    std::vector<float> out;
+    r.Process(in.data(), 4096, &out);  // 预热：out 增长到稳态大小
+    sw::testing::ScopedAllocCounter allocs;
+    for (int i = 0; i < 50; ++i) {
+      r.Process(in.data() + (i % 4) * 1024 * 2, 1024, &out);
+    }
+    EXPECT_EQ(allocs.count(), 0u);
+  }
+}
+
+TEST(ResamplerTest, PcmFileDecoderResamplesToOutputRate) {
+  // 44.1 kHz float32 裸 PCM 按 48 kHz 输出，结果应与直接用 Resampler 处理一致。
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "sw_resampler_decoder.raw").string();
+  const std::vector<float> src = Sine(10000, 2, 1000.0, 44100, 0.5f);
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(src.data()),
+               static_cast<std::streamsize>(src.size() * sizeof(float)));
+  }
+  PcmFileDecoderConfig cfg;
+  cfg.raw.sample_rate = 44100;
+  cfg.raw.channels = 2;
+  cfg.raw.encoding = PcmEncoding::kF32;
+  PcmFileDecoder dec(cfg);
+  ASSERT_TRUE(dec.ConfigureOutput(48000, 2));
+  ASSERT_TRUE(dec.Open(path));
+  EXPECT_EQ(dec.sample_rate(), 48000);
+
+  Resampler reference;
+  ASSERT_TRUE(reference.Configure(MakeConfig(44100, 48000, 2, ResamplerQuality::kSinc)));
+  const std::vector<float> expected = ResampleAll(reference, src, src.size());
+
+  std::vector<float> decoded;
+  PcmBuffer buf;
+  while (dec.Read(buf)) {
+    EXPECT_EQ(buf.sample_rate, 48000);
+    decoded.insert(decoded.end(), buf.interleaved.begin(), buf.interleaved.end());
+  }
+  EXPECT_EQ(dec.last_status(), Status::kOk);
+  EXPECT_EQ(decoded, expected);
+
+  // Seek 以输出帧计：输出帧 4800 对应源帧 4410。
+  ASSERT_TRUE(dec.Seek(4800));
+  EXPECT_EQ(dec.position(), 4410);
+  ASSERT_TRUE(dec.Read(buf));
+
+  // 打开后可以改采样率，但不能改声道数。
+  EXPECT_TRUE(dec.ConfigureOutput(44100, 2));
+  EXPECT_EQ(dec.sample_rate(), 44100);
+  EXPECT_FALSE(dec.ConfigureOutput(44101, 2));
+  EXPECT_EQ(dec.last_status(), Status::kNotSupported);
+  EXPECT_EQ(dec.sample_rate(), 44100);
+  ASSERT_TRUE(dec.Seek(0));
+  ASSERT_TRUE(dec.Read(buf));
+  ASSERT_EQ(buf.interleaved.size(), 2u * 1024u);
+  EXPECT_EQ(buf.interleaved[100], src[100]);
+  std::remove(path.c_str());
+}
+
+}  // namespace sw
@@ -0,0 +1,347 @@
+#include "simd_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+using sw::SimdKernels;
+using sw::SimdLevel;
+
+constexpr SimdLevel kAllLevels[] = {SimdLevel::kScalar, SimdLevel::kSse2, SimdLevel::kAvx2,
+                                    SimdLevel::kNeon};
+
+std::vector<const SimdKernels*> AvailableKernels() {
+  std::vector<const SimdKernels*> out;
+  for (SimdLevel level : kAllLevels) {
+    if (const SimdKernels* k = sw::SimdKernelsFor(level)) {
+      out.push_back(k);
+    }
+  }
+  return out;
+}
+
+std::vector<float> RandomSamples(size_t n, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> v(n);
+  for (float& x : v) x = dist(rng);
+  return v;
+}
+
+void ExpectNear(const std::vector<float>& expected, const std::vector<float>& actual,
+                const char* level, size_t n) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    const float tol = 1e-6f * std::max(1.0f, std::fabs(expected[i]));
+    ASSERT_NEAR(expected[i], actual[i], tol) << level << " n=" << n << " i=" << i;
+  }
+}
+
+// 长度覆盖 0、不足一个向量、若干整向量加尾部。
+constexpr size_t kLengths[] = {0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 64, 67, 513};
+
+}  // namespace
+
+namespace sw {
+
+TEST(SimdKernelsTest, ActiveLevelIsAvailable) {
+  const SimdKernels& active = ActiveSimdKernels();
+  ASSERT_NE(SimdKernelsFor(active.level), nullptr);
+  EXPECT_EQ(SimdKernelsFor(active.level)->multiply, active.multiply);
+  ASSERT_NE(SimdKernelsFor(SimdLevel::kScalar), nullptr);
+#if defined(__x86_64__) || defined(_M_X64)
+  EXPECT_NE(active.level, SimdLevel::kScalar);  // SSE2 是 x86-64 基线。
+#endif
+}
+
+TEST(SimdKernelsTest, MultiplyMatchesScalar) {
+  for (const SimdKernels* k : AvailableKernels()) {
+    for (size_t n : kLengths) {
+      const auto a = RandomSamples(n, 1);
+      const auto b = RandomSamples(n, 2);
+      std::vector<float> expected(n);
+      for (size_t i = 0; i < n; ++i) expected[i] = a[i] * b[i];
+
+      std::vector<float> out(n, -7.0f);
+      k->multiply(a.data(), b.data(), out.data(), n);
+      ExpectNear(expected, out, SimdLevelName(k->level), n);
+
+      std::vector<float> in_place = a;
+      k->multiply(in_place.data(), b.data(), in_place.data(), n);
+      ExpectNear(expected, in_place, SimdLevelName(k->level), n);
+    }
+  }
+}
+
+TEST(SimdKernelsTest, DownmixMatchesPerSampleDivide) {
+  for (const SimdKernels* k : AvailableKernels()) {
+    for (int channels : {1, 2, 3, 6}) {
+      for (size_t n : kLengths) {
+        const auto in = RandomSamples(n * static_cast<size_t>(channels), 3);
+        std::vector<float> expected(n);
+        for (size_t i = 0; i < n; ++i) {
+          float sum = 0.0f;
+          for (int c = 0; c < channels; ++c) sum += in[i * channels + c];
+          expected[i] = sum / static_cast<float>(channels);
+        }
+        std::vector<float> out(n + 1, -7.0f);
+        k->downmix(in.data(), n, channels, 1.0f / static_cast<float>(channels), out.data());
+        EXPECT_EQ(out[n], -7.0f) << "wrote past the end";
+        out.resize(n);
+        ExpectNear(expected, out, SimdLevelName(k->level), n);
+      }
+    }
+  }
+}
+
+TEST(SimdKernelsTest, PowerAndMagnitudeMatchScalar) {
+  const float inv_window_sum = 1.0f / 511.5f;
+  for (const SimdKernels* k : AvailableKernels()) {
+    for (size_t bins : kLengths) {
+      auto complex = RandomSamples(bins * 2, 4);
+      for (float& v : complex) v *= 300.0f;  // FFT 输出量级
+      std::vector<float> expected_power(bins);
+      std::vector<float> expected_mag(bins);
+      for (size_t i = 0; i < bins; ++i) {
+        const float re = complex[2 * i];
+        const float im = complex[2 * i + 1];
+        const float mag2 = re * re + im * im;
+        expected_power[i] = mag2 * inv_window_sum * inv_window_sum;
+        expected_mag[i] = std::sqrt(mag2) * inv_window_sum;
+      }
+      std::vector<float> power(bins);
+      std::vector<float> mag(bins);
+      k->power(complex.data(), bins, inv_window_sum * inv_window_sum, power.data());
+      k->magnitude(complex.data(), bins, inv_window_sum, mag.data());
+      ExpectNear(expected_power, power, SimdLevelName(k->level), bins);
+      ExpectNear(expected_mag, mag, SimdLevelName(k->level), bins);
+    }
+  }
+}
+
+TEST(SimdKernelsTest, DecibelsMatchLog10) {
+  // 覆盖十几个数量级（含非规格化数）与 0/负数/NaN/inf。
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> exponent(-40.0f, 6.0f);
+  std::vector<float> in(517);
+  for (float& x : in) x = std::pow(10.0f, exponent(rng));
+  in[0] = 0.0f;
+  in[1] = -1.0f;
+  in[2] = std::nanf("");
+  in[3] = 1.0f;
+  in[5] = 1.5e-39f;
+  in[8] = std::numeric_limits<float>::infinity();
+  in[9] = std::sqrt(2.0f);
+
+  for (const SimdKernels* k : AvailableKernels()) {
+    for (size_t n : kLengths) {
+      for (float per_decade : {10.0f, 20.0f}) {
+        const float floor_db = -120.0f;
+        std::vector<float> out(n, 1234.0f);
+        k->decibels(in.data(), n, per_decade, floor_db, out.data());
+        for (size_t i = 0; i < n; ++i) {
+          const float x = in[i];
+          float expected = floor_db;
+          if (x > 0.0f) {
+            expected = std::max(per_decade * std::log10(std::min(x, 3.0e38f)), floor_db);
+          }
+          if (std::isinf(x)) {
+            EXPECT_GT(out[i], per_decade * 38.0f) << SimdLevelName(k->level) << " i=" << i;
+            continue;
+          }
+          ASSERT_NEAR(out[i], expected, 1e-4f * per_decade / 10.0f + 1e-5f * std::fabs(expected))
+              << SimdLevelName(k->level) << " n=" << n << " i=" << i << " x=" << x;
+        }
+      }
+    }
+  }
+}
+
+TEST(SimdKernelsTest, MinMaxSumSqMatchesScalarForAllChannelLayouts) {
+  for (const SimdKernels* k : AvailableKernels()) {
+    for (int channels : {1, 2, 3, 4, 5, 6, 8, 10}) {
+      for (size_t frames : kLengths) {
+        const auto pcm = RandomSamples(frames * static_cast<size_t>(channels), 11);
+        std::vector<float> mn(static_cast<size_t>(channels), -9.0f);
+        std::vector<float> mx(mn);
+        std::vector<float> ss(mn);
+        k->min_max_sumsq(pcm.data(), frames, channels, mn.data(), mx.data(), ss.data());
+        for (int c = 0; c < channels; ++c) {
+          float emin = frames > 0 ? pcm[static_cast<size_t>(c)] : 0.0f;
+          float emax = emin;
+          double esum = 0.0;
+          for (size_t f = 0; f < frames; ++f) {
+            const float v = pcm[f * static_cast<size_t>(channels) + static_cast<size_t>(c)];
+            emin = std::min(emin, v);
+            emax = std::max(emax, v);
+            esum += static_cast<double>(v) * v;
+          }
+          const size_t ci = static_cast<size_t>(c);
+          ASSERT_EQ(mn[ci], emin) << SimdLevelName(k->level) << " ch=" << channels << " c=" << c
+                                  << " frames=" << frames;
+          ASSERT_EQ(mx[ci], emax) << SimdLevelName(k->level) << " ch=" << channels << " c=" << c;
+          ASSERT_NEAR(ss[ci], esum, 1e-5 * std::max(1.0, esum))
+              << SimdLevelName(k->level) << " ch=" << channels << " c=" << c;
+        }
+      }
+    }
+  }
+}
+
+TEST(SimdKernelsTest, IntegerPcmConversionIsExactAtAnyAlignment) {
+  // 覆盖满量程边界与随机字节；输入从奇数偏移开始，模拟未对齐的文件映射。
+  std::mt19937 rng(5);
+  std::vector<uint8_t> bytes(4 * 600 + 1);
+  for (uint8_t& b : bytes) b = static_cast<uint8_t>(rng());
+  const uint8_t s16_edges[] = {0x00, 0x80, 0xff, 0x7f, 0xff, 0xff, 0x01, 0x00};
+  const uint8_t s24_edges[] = {0x00, 0x00, 0x80, 0xff, 0xff, 0x7f, 0xff, 0xff, 0xff};
+  const uint8_t s32_edges[] = {0x00, 0x00, 0x00, 0x80, 0xff, 0xff, 0xff, 0x7f};
+  const SimdKernels& scalar = *sw::SimdKernelsFor(SimdLevel::kScalar);
+  for (const SimdKernels* k : AvailableKernels()) {
+    for (size_t n : kLengths) {
+      for (int width : {2, 3, 4}) {
+        std::vector<uint8_t> in(bytes.begin(), bytes.begin() + 1 + width * (n + 4));
+        if (width == 2) std::copy(std::begin(s16_edges), std::end(s16_edges), in.begin() + 1);
+        if (width == 3) std::copy(std::begin(s24_edges), std::end(s24_edges), in.begin() + 1);
+        if (width == 4) std::copy(std::begin(s32_edges), std::end(s32_edges), in.begin() + 1);
+        auto convert = [&](const SimdKernels& kernels, float* out) {
+          if (width == 2) kernels.s16_to_float(in.data() + 1, n, out);
+          if (width == 3) kernels.s24_to_float(in.data() + 1, n, out);
+          if (width == 4) kernels.s32_to_float(in.data() + 1, n, out);
+        };
+        std::vector<float> expected(n + 1, 7.0f);
+        std::vector<float> actual(n + 1, 7.0f);
+        convert(scalar, expected.data());
+        convert(*k, actual.data());
+        for (size_t i = 0; i < n; ++i) {
+          ASSERT_EQ(actual[i], expected[i])
+              << SimdLevelName(k->level) << " width=" << width << " n=" << n << " i=" << i;
+          ASSERT_GE(actual[i], -1.0f);
+          ASSERT_LE(actual[i], 1.0f);  // int32 最大值舍入到 1.0f。
+        }
+        EXPECT_EQ(actual[n], 7.0f);  // 不越界写。
+        if (n >= 2) {
+          EXPECT_EQ(expected[0], -1.0f);
+          EXPECT_GT(expected[1], 0.9999f);
+        }
+      }
+    }
+  }
+}
+
+TEST(SimdKernelsTest, LpcRestoreInvertsPredictionForAllOrders) {
+  // 先用 64 位参考实现从已知信号算出残差，再原地还原，要求逐样本复原。16 位样本 + 12 位系数
+  // + 32 阶正好不超过 32 位累加的约束。
+  std::mt19937 rng(11);
+  std::uniform_int_distribution<int32_t> sample(-32768, 32767);
+  std::uniform_int_distribution<int32_t> coef(-2048, 2047);
+  constexpr size_t kSignal = 32 + 513 + 1;
+  std::vector<int32_t> signal(kSignal);
+  for (int32_t& x : signal) x = sample(rng);
+  for (const SimdKernels* k : AvailableKernels()) {
+    for (int order = 1; order <= 32; ++order) {
+      std::vector<int32_t> coefs(static_cast<size_t>(order));
+      for (int32_t& c : coefs) c = coef(rng);
+      const int shift = order % 16;
+      for (size_t n : kLengths) {
+        std::vector<int32_t> work(signal.begin(), signal.begin() + order + n + 1);
+        for (size_t i = 0; i < n; ++i) {
+          const size_t at = static_cast<size_t>(order) + i;
+          int64_t sum = 0;
+          for (int j = 0; j < order; ++j) sum += int64_t{coefs[j]} * signal[at - j - 1];
+          work[at] = signal[at] - static_cast<int32_t>(sum >> shift);
+        }
+        k->lpc_restore(work.data() + order, n, coefs.data(), order, shift);
+        for (size_t i = 0; i < order + n + 1; ++i) {
+          ASSERT_EQ(work[i], signal[i])
+              << SimdLevelName(k->level) << " order=" << order << " n=" << n << " i=" << i;
+        }
+      }
+    }
+  }
+}
+
+TEST(SimdKernelsTest, StereoDecorrelationMatchesReference) {
+  // 24 位左右声道（side 需要 25 位），比较各模式还原后的交错输出。
+  std::mt19937 rng(13);
+  std::uniform_int_distribution<int32_t> sample(-(1 << 23), (1 << 23) - 1);
+  std::vector<int32_t> left(513);
+  std::vector<int32_t> right(513);
+  for (size_t i = 0; i < left.size(); ++i) {
+    left[i] = sample(rng);
+    right[i] = sample(rng);
+  }
+  left[0] = -(1 << 23);
+  right[0] = (1 << 23) - 1;
+  const float scale = 1.0f / static_cast<float>(1 << 23);
+  const StereoDecorrelation modes[] = {StereoDecorrelation::kIndependent,
+                                       StereoDecorrelation::kLeftSide,
+                                       StereoDecorrelation::kSideRight,
+                                       StereoDecorrelation::kMidSide};
+  for (const SimdKernels* k : AvailableKernels()) {
+    for (StereoDecorrelation mode : modes) {
+      for (size_t n : kLengths) {
+        std::vector<int32_t> a(n);
+        std::vector<int32_t> b(n);
+        for (size_t i = 0; i < n; ++i) {
+          const int32_t side = left[i] - right[i];
+          switch (mode) {
+            case StereoDecorrelation::kIndependent:
+              a[i] = left[i];
+              b[i] = right[i];
+              break;
+            case StereoDecorrelation::kLeftSide:
+              a[i] = left[i];
+              b[i] = side;
+              break;
+            case StereoDecorrelation::kSideRight:
+              a[i] = side;
+              b[i] = right[i];
+              break;
+            case StereoDecorrelation::kMidSide:
+              a[i] = (left[i] + right[i]) >> 1;
+              b[i] = side;
+              break;
+          }
+        }
+        std::vector<float> out(2 * n + 1, 7.0f);
+        k->stereo_to_float(a.data(), b.data(), n, mode, scale, out.data());
+        for (size_t i = 0; i < n; ++i) {
+          ASSERT_EQ(out[2 * i], static_cast<float>(left[i]) * scale)
+              << SimdLevelName(k->level) << " mode=" << static_cast<int>(mode) << " i=" << i;
+          ASSERT_EQ(out[2 * i + 1], static_cast<float>(right[i]) * scale)
+              << SimdLevelName(k->level) << " mode=" << static_cast<int>(mode) << " i=" << i;
+        }
+        EXPECT_EQ(out[2 * n], 7.0f);  // 不越界写。
+      }
+    }
+  }
+}
+
+TEST(SimdKernelsTest, DotMatchesDoublePrecisionReference) {
+  const std::vector<float> a = RandomSamples(513 + 3, 21);
+  const std::vector<float> b = RandomSamples(513 + 3, 22);
+  for (const SimdKernels* k : AvailableKernels()) {
+    for (size_t offset : {size_t{0}, size_t{1}, size_t{3}}) {  // 非对齐起点
+      for (size_t n : kLengths) {
+        double expected = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+          expected += static_cast<double>(a[offset + i]) * b[offset + i];
+        }
+        const float got = k->dot(a.data() + offset, b.data() + offset, n);
+        EXPECT_NEAR(got, expected, 1e-5 * (1.0 + static_cast<double>(n)))
+            << SimdLevelName(k->level) << " n=" << n << " offset=" << offset;
+      }
+    }
+  }
+}
+
+}  // namespace sw
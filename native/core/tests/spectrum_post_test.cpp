@@ -0,0 +1,319 @@
+#include "spectrum_post.h"
+
+#include <gtest/gtest.h>
+
+#include "alloc_counter.h"
+#include "pcm_event_bus.h"
+#include "streaming_stft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace sw {
+
+namespace {
+
+// 每帧间隔固定 |dt_ms| 的频谱帧，bins 指向调用方缓冲。
+struct FrameFeeder {
+  std::vector<float> bins;
+  int64_t timestamp_ms = 0;
+  bool power = true;
+
+  SpectrumFrame Next(int64_t dt_ms) {
+    SpectrumFrame f;
+    f.bins = bins.data();
+    f.num_bins = static_cast<int>(bins.size());
+    f.power_spectrum = power;
+    f.timestamp_ms = timestamp_ms;
+    timestamp_ms += dt_ms;
+    return f;
+  }
+};
+
+}  // namespace
+
+TEST(SpectrumPostTest, DisabledLeavesFrameUntouched) {
+  SpectrumPostProcessor post;
+  ASSERT_TRUE(post.Configure(SpectrumPostConfig{}));
+  EXPECT_FALSE(post.enabled());
+  FrameFeeder feed{{1.0f, 2.0f}};
+  SpectrumFrame f = feed.Next(10);
+  ASSERT_TRUE(post.Process(&f));
+  EXPECT_EQ(f.bins, feed.bins.data());
+  EXPECT_FALSE(f.decibels);
+  EXPECT_EQ(f.peaks, nullptr);
+}
+
+TEST(SpectrumPostTest, ConvertsPowerAndMagnitudeToDecibels) {
+  SpectrumPostConfig cfg;
+  cfg.decibels = true;
+  cfg.db_floor = -80.0f;
+  SpectrumPostProcessor post;
+  ASSERT_TRUE(post.Configure(cfg));
+
+  FrameFeeder feed{{1.0f, 0.01f, 1e-12f, 0.0f}};
+  SpectrumFrame f = feed.Next(10);
+  ASSERT_TRUE(post.Process(&f));
+  EXPECT_TRUE(f.decibels);
+  EXPECT_NEAR(f.bins[0], 0.0f, 1e-4f);
+  EXPECT_NEAR(f.bins[1], -20.0f, 1e-4f);
+  EXPECT_FLOAT_EQ(f.bins[2], -80.0f);  // -120 dB 截断到 floor
+  EXPECT_FLOAT_EQ(f.bins[3], -80.0f);
+
+  feed.power = false;  // 幅度谱：20·log10，同时触发状态重置
+  f = feed.Next(10);
+  ASSERT_TRUE(post.Process(&f));
+  EXPECT_NEAR(f.bins[1], -40.0f, 1e-4f);
+}
+
+TEST(SpectrumPostTest, AttackAndReleaseFollowTimeConstants) {
+  SpectrumPostConfig cfg;
+  cfg.attack_ms = 10.0f;
+  cfg.release_ms = 100.0f;
+  SpectrumPostProcessor post;
+  ASSERT_TRUE(post.Configure(cfg));
+
+  FrameFeeder feed{{0.0f}};
+  SpectrumFrame f = feed.Next(10);
+  ASSERT_TRUE(post.Process(&f));  // 首帧直接作为初值
+  EXPECT_FLOAT_EQ(f.bins[0], 0.0f);
+
+  // 上升：一个 attack 时间常数后到达 1 - e^-1。
+  feed.bins[0] = 1.0f;
+  f = feed.Next(10);
+  ASSERT_TRUE(post.Process(&f));
+  const float after_attack = f.bins[0];
+  EXPECT_NEAR(after_attack, 1.0f - std::exp(-1.0f), 1e-5f);
+
+  // 下降：release 慢 10 倍，同样间隔只下降 1 - e^-0.1。
+  feed.bins[0] = 0.0f;
+  f = feed.Next(10);
+  ASSERT_TRUE(post.Process(&f));
+  EXPECT_NEAR(f.bins[0], after_attack * std::exp(-0.1f), 1e-5f);
+}
+
+TEST(SpectrumPostTest, SmoothingIsIndependentOfFrameRate) {
+  SpectrumPostConfig cfg;
+  cfg.attack_ms = 50.0f;
+  cfg.release_ms = 50.0f;
+  SpectrumPostProcessor coarse;
+  SpectrumPostProcessor fine;
+  ASSERT_TRUE(coarse.Configure(cfg));
+  ASSERT_TRUE(fine.Configure(cfg));
+
+  FrameFeeder a{{0.0f}};
+  FrameFeeder b{{0.0f}};
+  SpectrumFrame fa = a.Next(40);
+  SpectrumFrame fb = b.Next(10);
+  ASSERT_TRUE(coarse.Process(&fa));
+  ASSERT_TRUE(fine.Process(&fb));
+  a.bins[0] = b.bins[0] = 1.0f;
+  fa = a.Next(40);
+  ASSERT_TRUE(coarse.Process(&fa));
+  for (int i = 0; i < 4; ++i) {
+    fb = b.Next(10);
+    ASSERT_TRUE(fine.Process(&fb));
+  }
+  EXPECT_NEAR(fa.bins[0], fb.bins[0], 1e-5f);
+}
+
+TEST(SpectrumPostTest, PeakHoldsThenDecaysInDecibels) {
+  SpectrumPostConfig cfg;
+  cfg.decibels = true;
+  cfg.db_floor = -100.0f;
+  cfg.peak_hold = true;
+  cfg.peak_hold_ms = 100.0f;
+  cfg.peak_decay_db_per_s = 20.0f;
+  SpectrumPostProcessor post;
+  ASSERT_TRUE(post.Configure(cfg));
+
+  FrameFeeder feed{{1.0f}};  // 0 dB
+  SpectrumFrame f = feed.Next(50);
+  ASSERT_TRUE(post.Process(&f));
+  ASSERT_NE(f.peaks, nullptr);
+  EXPECT_NEAR(f.peaks[0], 0.0f, 1e-4f);
+
+  feed.bins[0] = 1e-6f;  // -60 dB
+  f = feed.Next(50);
+  ASSERT_TRUE(post.Process(&f));  // age 50
+  EXPECT_NEAR(f.bins[0], -60.0f, 1e-3f);
+  EXPECT_NEAR(f.peaks[0], 0.0f, 1e-4f);
+  f = feed.Next(50);
+  ASSERT_TRUE(post.Process(&f));  // age 100：仍在保持期
+  EXPECT_NEAR(f.peaks[0], 0.0f, 1e-4f);
+  f = feed.Next(50);
+  ASSERT_TRUE(post.Process(&f));  // age 150：衰减 50 ms × 20 dB/s
+  EXPECT_NEAR(f.peaks[0], -1.0f, 1e-4f);
+  for (int i = 0; i < 200; ++i) {
+    f = feed.Next(50);
+    ASSERT_TRUE(post.Process(&f));
+  }
+  EXPECT_NEAR(f.peaks[0], -60.0f, 1e-3f);  // 不低于当前值
+}
+
+TEST(SpectrumPostTest, PeakDecayInLinearDomainMatchesDecibelRate) {
+  SpectrumPostConfig cfg;
+  cfg.peak_hold = true;
+  cfg.peak_hold_ms = 0.0f;
+  cfg.peak_decay_db_per_s = 10.0f;
+  SpectrumPostProcessor post;
+  ASSERT_TRUE(post.Configure(cfg));
+
+  FrameFeeder feed{{1.0f}};
+  SpectrumFrame f = feed.Next(1000);
+  ASSERT_TRUE(post.Process(&f));
+  feed.bins[0] = 0.0f;
+  f = feed.Next(1000);
+  ASSERT_TRUE(post.Process(&f));
+  EXPECT_NEAR(f.peaks[0], 0.1f, 1e-5f);  // 功率谱 1 s 衰减 10 dB
+  EXPECT_FLOAT_EQ(f.bins[0], 0.0f);
+}
+
+TEST(SpectrumPostTest, ResetsOnTimestampGapAndSizeChange) {
+  SpectrumPostConfig cfg;
+  cfg.attack_ms = 1000.0f;
+  cfg.release_ms = 1000.0f;
+  SpectrumPostProcessor post;
+  ASSERT_TRUE(post.Configure(cfg));
+
+  FrameFeeder feed{{0.0f, 0.0f}};
+  SpectrumFrame f = feed.Next(5000);
+  ASSERT_TRUE(post.Process(&f));
+  feed.bins = {1.0f, 1.0f};
+  f = feed.Next(10);
+  ASSERT_TRUE(post.Process(&f));  // 间隔 5 s：视为断流，直接取新值
+  EXPECT_FLOAT_EQ(f.bins[0], 1.0f);
+
+  feed.timestamp_ms -= 500;  // 时间戳倒退（Seek）
+  feed.bins = {0.0f, 0.0f};
+  f = feed.Next(10);
+  ASSERT_TRUE(post.Process(&f));
+  EXPECT_FLOAT_EQ(f.bins[0], 0.0f);
+
+  feed.bins = {1.0f, 1.0f, 1.0f};
+  f = feed.Next(10);
+  ASSERT_TRUE(post.Process(&f));
+  EXPECT_EQ(f.num_bins, 3);
+  EXPECT_FLOAT_EQ(f.bins[2], 1.0f);
+}
+
+TEST(SpectrumPostTest, RejectsInvalidConfig) {
+  SpectrumPostProcessor post;
+  SpectrumPostConfig cfg;
+  cfg.attack_ms = -1.0f;
+  EXPECT_FALSE(post.Configure(cfg));
+  FrameFeeder feed{{1.0f}};
+  SpectrumFrame f = feed.Next(10);
+  EXPECT_FALSE(post.Process(&f));
+
+  cfg = SpectrumPostConfig{};
+  cfg.decibels = true;
+  cfg.db_floor = std::nanf("");
+  EXPECT_FALSE(post.Configure(cfg));
+  cfg.db_floor = -90.0f;
+  cfg.peak_decay_db_per_s = -3.0f;
+  EXPECT_FALSE(post.Configure(cfg));
+  cfg.peak_decay_db_per_s = 3.0f;
+  EXPECT_TRUE(post.Configure(cfg));
+  EXPECT_TRUE(post.Process(&f));
+}
+
+TEST(SpectrumPostTest, SteadyStateDoesNotAllocate) {
+  SpectrumPostConfig cfg;
+  cfg.decibels = true;
+  cfg.attack_ms = 20.0f;
+  cfg.release_ms = 300.0f;
+  cfg.peak_hold = true;
+  SpectrumPostProcessor post;
+  ASSERT_TRUE(post.Configure(cfg));
+  FrameFeeder feed{std::vector<float>(513, 0.5f)};
+  SpectrumFrame f = feed.Next(16);
+  ASSERT_TRUE(post.Process(&f));
+
+  sw::testing::ScopedAllocCounter allocs;
+  for (int i = 0; i < 64; ++i) {
+    f = feed.Next(16);
+    ASSERT_TRUE(post.Process(&f));
+  }
+  EXPECT_EQ(allocs.count(), 0u);
+}
+
+TEST(SpectrumPostTest, EventBusAndStftApplyPostStage) {
+  SpectrumConfig cfg;
+  cfg.window_size = 256;
+  cfg.post.decibels = true;
+  cfg.post.db_floor = -90.0f;
+  cfg.post.peak_hold = true;
+
+  PcmIngressConfig ingress;
+  ingress.expected_sample_rate = 48000;
+  ingress.expected_channels = 2;
+  ingress.throttle.max_fps = 0;
+  PcmEventBus bus(ingress, cfg);
+  bool bus_db = false;
+  bool bus_peaks = false;
+  float bus_min = 0.0f;
+  bus.SetSpectrumCallback([&](const SpectrumFrame& s) {
+    bus_db = s.decibels;
+    bus_peaks = s.peaks != nullptr;
+    bus_min = s.bins[0];
+    for (int i = 0; i < s.num_bins; ++i) bus_min = std::min(bus_min, s.bins[i]);
+  });
+  std::vector<float> samples(256 * 2, 0.0f);
+  PcmInputFrame frame{samples.data(), 256, 48000, 2, 0, 1};
+  ASSERT_EQ(bus.Push(frame, 0), Status::kOk);
+  EXPECT_TRUE(bus_db);
+  EXPECT_TRUE(bus_peaks);
+  EXPECT_FLOAT_EQ(bus_min, -90.0f);  // 静音：全部落在 floor
+
+  cfg.overlap = 128;
+  StreamingStft stft;
+  ASSERT_TRUE(stft.Configure(cfg, 48000));
+  stft.Push(samples.data(), 256, 2);
+  StftFrame out;
+  ASSERT_TRUE(stft.Next(&out));
+  EXPECT_TRUE(out.spectrum.decibels);
+  ASSERT_NE(out.spectrum.peaks, nullptr);
+  EXPECT_FLOAT_EQ(out.spectrum.bins[0], -90.0f);
+
+  cfg.post.release_ms = -5.0f;
+  EXPECT_FALSE(stft.Configure(cfg, 48000));
+}
+
+TEST(SpectrumPostTest, EventBusResetDropsPeakHoldState) {
+  SpectrumConfig cfg;
+  cfg.window_size = 256;
+  cfg.post.peak_hold = true;
+  cfg.post.peak_hold_ms = 5000.0f;
+
+  PcmIngressConfig ingress;
+  ingress.expected_sample_rate = 48000;
+  ingress.expected_channels = 1;
+  ingress.throttle.max_fps = 0;
+  PcmEventBus bus(ingress, cfg);
+  float peak_max = -1.0f;
+  bus.SetSpectrumCallback([&](const SpectrumFrame& s) {
+    ASSERT_NE(s.peaks, nullptr);
+    peak_max = 0.0f;
+    for (int i = 0; i < s.num_bins; ++i) peak_max = std::max(peak_max, s.peaks[i]);
+  });
+  std::vector<float> tone(256);
+  for (size_t i = 0; i < tone.size(); ++i) {
+    tone[i] = 0.5f * static_cast<float>(std::sin(0.3 * static_cast<double>(i)));
+  }
+  const std::vector<float> silence(256, 0.0f);
+  ASSERT_EQ(bus.Push(PcmInputFrame{tone.data(), 256, 48000, 1, 0, 1}, 0), Status::kOk);
+  const float tone_peak = peak_max;
+  ASSERT_GT(tone_peak, 1e-3f);
+  // 保持期内静音帧的峰值仍是音调的峰值。
+  ASSERT_EQ(bus.Push(PcmInputFrame{silence.data(), 256, 48000, 1, 100, 2}, 100), Status::kOk);
+  EXPECT_FLOAT_EQ(peak_max, tone_peak);
+
+  // Seek 后 Reset：间隔虽不足 1 秒，新位置的第一帧也直接作为初值。
+  bus.Reset();
+  ASSERT_EQ(bus.Push(PcmInputFrame{silence.data(), 256, 48000, 1, 300, 1}, 300), Status::kOk);
+  EXPECT_FLOAT_EQ(peak_max, 0.0f);
+}
+
+}  // namespace sw
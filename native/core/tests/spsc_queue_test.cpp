@@ -0,0 +1,82 @@
+#include "spsc_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+
+namespace sw {
+
+TEST(SpscQueueTest, FifoOrderAndCapacity) {
+  SpscQueue<int> queue(3);
+  EXPECT_EQ(queue.capacity(), 3u);
+  EXPECT_TRUE(queue.empty());
+
+  int v = 1;
+  EXPECT_TRUE(queue.TryPush(std::move(v)));
+  v = 2;
+  EXPECT_TRUE(queue.TryPush(std::move(v)));
+  v = 3;
+  EXPECT_TRUE(queue.TryPush(std::move(v)));
+  v = 4;
+  EXPECT_FALSE(queue.TryPush(std::move(v)));  // full
+  EXPECT_EQ(queue.size(), 3u);
+
+  int out = 0;
+  ASSERT_TRUE(queue.TryPop(out));
+  EXPECT_EQ(out, 1);
+  v = 4;
+  EXPECT_TRUE(queue.TryPush(std::move(v)));  // wraps around
+  for (int expected : {2, 3, 4}) {
+    ASSERT_TRUE(queue.TryPop(out));
+    EXPECT_EQ(out, expected);
+  }
+  EXPECT_FALSE(queue.TryPop(out));
+}
+
+TEST(SpscQueueTest, PopReleasesSlotResources) {
+  SpscQueue<std::shared_ptr<int>> queue(2);
+  auto payload = std::make_shared<int>(7);
+  auto copy = payload;
+  ASSERT_TRUE(queue.TryPush(std::move(copy)));
+  EXPECT_EQ(payload.use_count(), 2);
+
+  std::shared_ptr<int> out;
+  ASSERT_TRUE(queue.TryPop(out));
+  out.reset();
+  EXPECT_EQ(payload.use_count(), 1);  // queue slot does not keep the payload alive.
+
+  copy = payload;
+  ASSERT_TRUE(queue.TryPush(std::move(copy)));
+  queue.Clear();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(payload.use_count(), 1);
+}
+
+TEST(SpscQueueTest, CrossThreadTransferPreservesOrder) {
+  constexpr int kCount = 200000;
+  SpscQueue<int> queue(64);
+  std::thread producer([&]() {
+    for (int i = 0; i < kCount; ++i) {
+      int v = i;
+      while (!queue.TryPush(std::move(v))) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  int expected = 0;
+  while (expected < kCount) {
+    int out = -1;
+    if (!queue.TryPop(out)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(out, expected);
+    ++expected;
+  }
+  producer.join();
+  EXPECT_TRUE(queue.empty());
+}
+
+}  // namespace sw
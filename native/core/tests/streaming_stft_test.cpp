@@ -0,0 +1,182 @@
+#include "streaming_stft.h"
+
+#include <gtest/gtest.h>
+
+#include "alloc_counter.h"
+
+#include <cmath>
+#include <vector>
+
+namespace sw {
+
+namespace {
+
+constexpr float kPi = 3.14159265358979323846f;
+
+// Stereo sine, both channels equal so the mono downmix is the sine itself.
+std::vector<float> StereoSine(int frames, float freq_hz, int sample_rate) {
+  std::vector<float> out(static_cast<size_t>(frames) * 2);
+  for (int i = 0; i < frames; ++i) {
+    const float v = std::sin(2.0f * kPi * freq_hz * static_cast<float>(i) / sample_rate);
+    out[static_cast<size_t>(i) * 2] = v;
+    out[static_cast<size_t>(i) * 2 + 1] = v;
+  }
+  return out;
+}
+
+SpectrumConfig OverlapConfig(int window, int overlap) {
+  SpectrumConfig cfg;
+  cfg.window_size = window;
+  cfg.overlap = overlap;
+  cfg.window = WindowType::kHann;
+  cfg.power_spectrum = false;
+  return cfg;
+}
+
+struct Hop {
+  int64_t start_frame;
+  int64_t timestamp_ms;
+  std::vector<float> bins;
+};
+
+std::vector<Hop> RunChunks(StreamingStft& stft, const std::vector<float>& interleaved,
+                           int chunk_frames) {
+  std::vector<Hop> hops;
+  const int total = static_cast<int>(interleaved.size() / 2);
+  for (int pos = 0; pos < total; pos += chunk_frames) {
+    const int n = std::min(chunk_frames, total - pos);
+    stft.Push(interleaved.data() + static_cast<size_t>(pos) * 2, n, 2);
+    StftFrame frame;
+    while (stft.Next(&frame)) {
+      hops.push_back({frame.start_frame, frame.spectrum.timestamp_ms,
+                      std::vector<float>(frame.spectrum.bins,
+                                         frame.spectrum.bins + frame.spectrum.num_bins)});
+    }
+  }
+  return hops;
+}
+
+}  // namespace
+
+TEST(StreamingStftTest, RejectsInvalidConfig) {
+  StreamingStft stft;
+  EXPECT_FALSE(stft.Configure(OverlapConfig(0, 0), 48000));
+  EXPECT_FALSE(stft.Configure(OverlapConfig(64, 64), 48000));
+  EXPECT_FALSE(stft.Configure(OverlapConfig(64, -1), 48000));
+  EXPECT_FALSE(stft.Configure(OverlapConfig(64, 16), 0));
+  EXPECT_FALSE(stft.configured());
+  ASSERT_TRUE(stft.Configure(OverlapConfig(64, 48), 48000));
+  EXPECT_EQ(stft.hop(), 16);
+  EXPECT_EQ(stft.num_bins(), 33);
+}
+
+TEST(StreamingStftTest, EmitsOneSpectrumPerHopRegardlessOfPushSize) {
+  const int sample_rate = 48000;
+  const auto signal = StereoSine(2000, 3000.0f, sample_rate);
+
+  StreamingStft whole;
+  ASSERT_TRUE(whole.Configure(OverlapConfig(256, 192), sample_rate));
+  const auto reference = RunChunks(whole, signal, 2000);
+  // floor((2000 - 256) / 64) + 1 hops.
+  ASSERT_EQ(reference.size(), 28u);
+  for (size_t i = 0; i < reference.size(); ++i) {
+    EXPECT_EQ(reference[i].start_frame, static_cast<int64_t>(i) * 64);
+  }
+
+  for (int chunk : {1, 7, 64, 100, 333}) {
+    StreamingStft stft;
+    ASSERT_TRUE(stft.Configure(OverlapConfig(256, 192), sample_rate));
+    const auto hops = RunChunks(stft, signal, chunk);
+    ASSERT_EQ(hops.size(), reference.size()) << "chunk " << chunk;
+    for (size_t i = 0; i < hops.size(); ++i) {
+      EXPECT_EQ(hops[i].start_frame, reference[i].start_frame);
+      ASSERT_EQ(hops[i].bins.size(), reference[i].bins.size());
+      for (size_t k = 0; k < hops[i].bins.size(); ++k) {
+        ASSERT_FLOAT_EQ(hops[i].bins[k], reference[i].bins[k]) << "chunk " << chunk;
+      }
+    }
+  }
+}
+
+TEST(StreamingStftTest, HopMatchesSingleFrameAnalyzerOnSameSlice) {
+  const int sample_rate = 48000;
+  const auto signal = StereoSine(1024, 1000.0f, sample_rate);
+  std::vector<float> mono(1024);
+  for (size_t i = 0; i < mono.size(); ++i) mono[i] = signal[i * 2];
+
+  const SpectrumConfig cfg = OverlapConfig(256, 128);
+  StreamingStft stft;
+  ASSERT_TRUE(stft.Configure(cfg, sample_rate));
+  const auto hops = RunChunks(stft, signal, 50);
+  ASSERT_EQ(hops.size(), 7u);
+
+  SpectrumAnalyzer analyzer(cfg);
+  std::vector<float> expected(static_cast<size_t>(analyzer.num_bins()));
+  for (const Hop& hop : hops) {
+    ASSERT_TRUE(analyzer.Compute(mono.data() + hop.start_frame, 256, expected.data(),
+                                 expected.size()));
+    for (size_t k = 0; k < expected.size(); ++k) {
+      EXPECT_NEAR(hop.bins[k], expected[k], 1e-6f);
+    }
+  }
+}
+
+TEST(StreamingStftTest, TimestampsAreHopAccurateAndResetReanchors) {
+  const int sample_rate = 48000;
+  StreamingStft stft;
+  // hop = 480 frames = 10 ms.
+  ASSERT_TRUE(stft.Configure(OverlapConfig(1024, 544), sample_rate));
+  const auto signal = StereoSine(48000, 440.0f, sample_rate);
+  auto hops = RunChunks(stft, signal, 441);
+  ASSERT_FALSE(hops.empty());
+  for (size_t i = 0; i < hops.size(); ++i) {
+    EXPECT_EQ(hops[i].timestamp_ms, static_cast<int64_t>(i) * 10);
+  }
+
+  const int64_t seek_frame = 48000 * 5;  // 5 s
+  stft.Reset(seek_frame);
+  EXPECT_EQ(stft.next_input_frame(), seek_frame);
+  EXPECT_FALSE(stft.ready());
+  hops = RunChunks(stft, signal, 1000);
+  ASSERT_FALSE(hops.empty());
+  EXPECT_EQ(hops[0].start_frame, seek_frame);
+  EXPECT_EQ(hops[0].timestamp_ms, 5000);
+  EXPECT_EQ(hops[1].timestamp_ms, 5010);
+}
+
+TEST(StreamingStftTest, SkipAdvancesWithoutComputing) {
+  StreamingStft stft;
+  ASSERT_TRUE(stft.Configure(OverlapConfig(64, 32), 48000));
+  const auto signal = StereoSine(256, 500.0f, 48000);
+  stft.Push(signal.data(), 256, 2);
+  EXPECT_TRUE(stft.Skip());
+  EXPECT_TRUE(stft.Skip());
+  StftFrame frame;
+  ASSERT_TRUE(stft.Next(&frame));
+  EXPECT_EQ(frame.start_frame, 64);
+}
+
+TEST(StreamingStftTest, SteadyStateDoesNotAllocate) {
+  StreamingStft stft;
+  ASSERT_TRUE(stft.Configure(OverlapConfig(1024, 768), 48000));
+  const auto signal = StereoSine(512, 440.0f, 48000);
+  StftFrame frame;
+  // Warm up: history reaches its steady-state size.
+  for (int i = 0; i < 8; ++i) {
+    stft.Push(signal.data(), 512, 2);
+    while (stft.Next(&frame)) {
+    }
+  }
+  sw::testing::ScopedAllocCounter allocs;
+  int hops = 0;
+  for (int i = 0; i < 100; ++i) {
+    stft.Push(signal.data(), 512, 2);
+    while (stft.Next(&frame)) {
+      ++hops;
+    }
+  }
+  EXPECT_EQ(allocs.count(), 0u);
+  EXPECT_EQ(hops, 200);
+}
+
+}  // namespace sw
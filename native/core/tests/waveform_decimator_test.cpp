@@ -0,0 +1,205 @@
+#include "waveform_decimator.h"
+
+#include <gtest/gtest.h>
+
+#include "alloc_counter.h"
+#include "pcm_event_bus.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace sw {
+
+namespace {
+
+PcmFrame MakeFrame(const std::vector<float>& pcm, int channels) {
+  PcmFrame f;
+  f.data = pcm.data();
+  f.num_channels = channels;
+  f.num_frames = static_cast<int>(pcm.size()) / channels;
+  f.sample_rate = 48000;
+  f.timestamp_ms = 123;
+  f.sequence = 7;
+  f.dropped_before = 2;
+  return f;
+}
+
+}  // namespace
+
+TEST(WaveformDecimatorTest, BucketsCarryPerChannelMinMaxRms) {
+  // 左声道为斜坡，右声道为 ±0.5 方波，8 帧分 2 个桶。
+  std::vector<float> pcm;
+  for (int i = 0; i < 8; ++i) {
+    pcm.push_back(static_cast<float>(i));
+    pcm.push_back(i % 2 == 0 ? 0.5f : -0.5f);
+  }
+  WaveformDecimator decimator;
+  ASSERT_TRUE(decimator.Configure(WaveformConfig{2}));
+  WaveformFrame out;
+  ASSERT_TRUE(decimator.Process(MakeFrame(pcm, 2), &out));
+  ASSERT_EQ(out.num_buckets, 2);
+  ASSERT_EQ(out.num_channels, 2);
+  EXPECT_EQ(out.num_frames, 8);
+  EXPECT_EQ(out.timestamp_ms, 123);
+  EXPECT_EQ(out.sequence, 7u);
+  EXPECT_EQ(out.dropped_before, 2u);
+
+  const WaveformBucket& l0 = out.buckets[0];
+  const WaveformBucket& r0 = out.buckets[1];
+  const WaveformBucket& l1 = out.buckets[2];
+  EXPECT_FLOAT_EQ(l0.min, 0.0f);
+  EXPECT_FLOAT_EQ(l0.max, 3.0f);
+  EXPECT_FLOAT_EQ(l0.rms, std::sqrt((0.0f + 1.0f + 4.0f + 9.0f) / 4.0f));
+  EXPECT_FLOAT_EQ(l1.min, 4.0f);
+  EXPECT_FLOAT_EQ(l1.max, 7.0f);
+  EXPECT_FLOAT_EQ(r0.min, -0.5f);
+  EXPECT_FLOAT_EQ(r0.max, 0.5f);
+  EXPECT_FLOAT_EQ(r0.rms, 0.5f);
+}
+
+TEST(WaveformDecimatorTest, UnevenBucketsCoverEveryFrame) {
+  // 10 帧单声道分 3 个桶：[0,3) [3,6) [6,10)。
+  std::vector<float> pcm(10);
+  for (size_t i = 0; i < pcm.size(); ++i) pcm[i] = static_cast<float>(i);
+  WaveformDecimator decimator;
+  ASSERT_TRUE(decimator.Configure(WaveformConfig{3}));
+  WaveformFrame out;
+  ASSERT_TRUE(decimator.Process(MakeFrame(pcm, 1), &out));
+  ASSERT_EQ(out.num_buckets, 3);
+  EXPECT_FLOAT_EQ(out.buckets[0].min, 0.0f);
+  EXPECT_FLOAT_EQ(out.buckets[0].max, 2.0f);
+  EXPECT_FLOAT_EQ(out.buckets[1].min, 3.0f);
+  EXPECT_FLOAT_EQ(out.buckets[1].max, 5.0f);
+  EXPECT_FLOAT_EQ(out.buckets[2].min, 6.0f);
+  EXPECT_FLOAT_EQ(out.buckets[2].max, 9.0f);
+
+  // 帧数少于桶数：每帧一个桶。
+  ASSERT_TRUE(decimator.Configure(WaveformConfig{64}));
+  ASSERT_TRUE(decimator.Process(MakeFrame(pcm, 1), &out));
+  EXPECT_EQ(out.num_buckets, 10);
+  EXPECT_FLOAT_EQ(out.buckets[9].rms, 9.0f);
+}
+
+TEST(WaveformDecimatorTest, RejectsInvalidInput) {
+  WaveformDecimator decimator;
+  EXPECT_FALSE(decimator.Configure(WaveformConfig{0}));
+  std::vector<float> pcm(16, 0.25f);
+  WaveformFrame out;
+  EXPECT_FALSE(decimator.Process(MakeFrame(pcm, 2), &out));
+
+  ASSERT_TRUE(decimator.Configure(WaveformConfig{4}));
+  PcmFrame marker = MakeFrame(pcm, 2);
+  marker.dropped = true;
+  EXPECT_FALSE(decimator.Process(marker, &out));
+  PcmFrame empty = MakeFrame(pcm, 2);
+  empty.data = nullptr;
+  EXPECT_FALSE(decimator.Process(empty, &out));
+  EXPECT_FALSE(decimator.Process(MakeFrame(pcm, 2), nullptr));
+}
+
+TEST(WaveformDecimatorTest, SteadyStateDoesNotAllocate) {
+  std::vector<float> pcm(1024 * 2, 0.1f);
+  WaveformDecimator decimator;
+  ASSERT_TRUE(decimator.Configure(WaveformConfig{128}));
+  WaveformFrame out;
+  ASSERT_TRUE(decimator.Process(MakeFrame(pcm, 2), &out));
+
+  sw::testing::ScopedAllocCounter allocs;
+  for (int i = 0; i < 32; ++i) {
+    ASSERT_TRUE(decimator.Process(MakeFrame(pcm, 2), &out));
+  }
+  EXPECT_EQ(allocs.count(), 0u);
+}
+
+TEST(WaveformDecimatorTest, EventBusDeliversCompactBuckets) {
+  PcmIngressConfig ingress;
+  ingress.expected_sample_rate = 48000;
+  ingress.expected_channels = 2;
+  ingress.throttle.max_fps = 0;
+  PcmEventBus bus(ingress, SpectrumConfig{}, PcmDispatchConfig{}, WaveformConfig{32});
+
+  int calls = 0;
+  int buckets = 0;
+  float left_max = 0.0f;
+  bus.SetWaveformCallback([&](const WaveformFrame& w) {
+    ++calls;
+    buckets = w.num_buckets;
+    left_max = w.buckets[0].max;
+  });
+  int sub_calls = 0;
+  PcmSubscriberConfig sub_cfg;
+  sub_cfg.max_fps = 0;
+  const SubscriptionId id =
+      bus.AddWaveformSubscriber(sub_cfg, [&](const WaveformFrame&) { ++sub_calls; });
+  ASSERT_NE(id, 0u);
+  EXPECT_EQ(bus.AddWaveformSubscriber(sub_cfg, nullptr), 0u);
+
+  std::vector<float> samples(1024 * 2, 0.25f);
+  PcmInputFrame frame{samples.data(), 1024, 48000, 2, 0, 1};
+  ASSERT_EQ(bus.Push(frame, 0), Status::kOk);
+  EXPECT_EQ(calls, 1);
+  EXPECT_EQ(sub_calls, 1);
+  EXPECT_EQ(buckets, 32);
+  EXPECT_FLOAT_EQ(left_max, 0.25f);
+  EXPECT_EQ(bus.stats().waveform.count, 2u);
+
+  EXPECT_TRUE(bus.RemoveSubscriber(id));
+  bus.SetWaveformCallback(nullptr);
+  ASSERT_EQ(bus.Push(frame, 10), Status::kOk);
+  EXPECT_EQ(calls, 1);
+  EXPECT_EQ(sub_calls, 1);
+}
+
+TEST(WaveformDecimatorTest, EngineEmitsWaveforms) {
+  auto engine = CreateAudioEngineStub();
+  AudioConfig cfg;
+  cfg.sample_rate = 48000;
+  cfg.channels = 2;
+  cfg.frames_per_buffer = 480;
+  cfg.pcm_max_fps = 0;
+  cfg.waveform_cfg.num_buckets = 48;
+  ASSERT_EQ(engine->Init(cfg), Status::kOk);
+  ASSERT_EQ(engine->Load("file:///tmp/sample.mp3"), Status::kOk);
+
+  struct Seen {
+    std::atomic<int> frames{0};
+    std::atomic<int> bad{0};
+  };
+  Seen by_callback;
+  Seen by_subscriber;
+  auto on_waveform = [](const WaveformFrame& w, void* ud) {
+    auto* seen = static_cast<Seen*>(ud);
+    if (w.num_buckets != 48 || w.num_channels != 2 || w.num_frames != 480) {
+      seen->bad.fetch_add(1);
+    }
+    for (int i = 0; i < w.num_buckets * w.num_channels; ++i) {
+      const WaveformBucket& b = w.buckets[i];
+      if (!(b.min <= b.max) || b.rms < 0.0f) seen->bad.fetch_add(1);
+    }
+    seen->frames.fetch_add(1);
+  };
+  engine->SetWaveformCallback(on_waveform, &by_callback);
+  PcmSubscriberConfig sub_cfg;
+  sub_cfg.max_fps = 0;
+  ASSERT_NE(engine->AddWaveformSubscriber(sub_cfg, on_waveform, &by_subscriber), 0u);
+
+  ASSERT_EQ(engine->Play(), Status::kOk);
+  for (int i = 0; i < 200 && (by_callback.frames.load() < 3 || by_subscriber.frames.load() < 3);
+       ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_EQ(engine->Stop(), Status::kOk);
+  EXPECT_GE(by_callback.frames.load(), 3);
+  EXPECT_GE(by_subscriber.frames.load(), 3);
+  EXPECT_EQ(by_callback.bad.load(), 0);
+  EXPECT_EQ(by_subscriber.bad.load(), 0);
+
+  AudioConfig bad = cfg;
+  bad.waveform_cfg.num_buckets = 0;
+  EXPECT_EQ(CreateAudioEngineStub()->Init(bad), Status::kInvalidArguments);
+}
+
+}  // namespace sw
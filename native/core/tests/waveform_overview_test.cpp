@@ -0,0 +1,289 @@
+#include "waveform_overview.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace sw {
+
+namespace {
+
+// 可复现的伪随机立体声信号，两个声道幅度不同。
+std::vector<float> MakeSignal(size_t frames, int channels) {
+  std::vector<float> pcm(frames * static_cast<size_t>(channels));
+  uint32_t state = 12345u;
+  for (size_t i = 0; i < pcm.size(); ++i) {
+    state = state * 1664525u + 1013904223u;
+    const float r = static_cast<float>(state >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+    pcm[i] = r * (i % static_cast<size_t>(channels) == 0 ? 0.9f : 0.3f);
+  }
+  return pcm;
+}
+
+// 暴力计算 [begin, end) 帧第 c 声道的 min/max/RMS。
+WaveformBucket BruteForce(const std::vector<float>& pcm, int channels, int64_t begin,
+                          int64_t end, int c) {
+  WaveformBucket b;
+  b.min = pcm[static_cast<size_t>(begin * channels + c)];
+  b.max = b.min;
+  double sumsq = 0.0;
+  for (int64_t i = begin; i < end; ++i) {
+    const float v = pcm[static_cast<size_t>(i * channels + c)];
+    b.min = std::min(b.min, v);
+    b.max = std::max(b.max, v);
+    sumsq += static_cast<double>(v) * v;
+  }
+  b.rms = static_cast<float>(std::sqrt(sumsq / static_cast<double>(end - begin)));
+  return b;
+}
+
+WaveformOverview BuildInChunks(const std::vector<float>& pcm, int channels, int base,
+                               size_t chunk) {
+  WaveformOverviewBuilder builder;
+  EXPECT_TRUE(builder.Begin(44100, channels, WaveformOverviewConfig{base}));
+  const size_t frames = pcm.size() / static_cast<size_t>(channels);
+  for (size_t at = 0; at < frames; at += chunk) {
+    const size_t n = std::min(chunk, frames - at);
+    EXPECT_TRUE(builder.Append(pcm.data() + at * static_cast<size_t>(channels), n));
+  }
+  WaveformOverview overview;
+  EXPECT_TRUE(builder.Finish(&overview));
+  return overview;
+}
+
+void ExpectLevelsMatch(const WaveformOverview& o, const std::vector<float>& pcm) {
+  for (int level = 0; level < o.num_levels(); ++level) {
+    const int64_t bf = o.bucket_frames(level);
+    const WaveformBucket* data = o.level_data(level);
+    ASSERT_NE(data, nullptr);
+    for (int64_t b = 0; b < o.level_buckets(level); ++b) {
+      const int64_t end = std::min(o.num_frames(), (b + 1) * bf);
+      for (int c = 0; c < o.channels(); ++c) {
+        const WaveformBucket want = BruteForce(pcm, o.channels(), b * bf, end, c);
+        const WaveformBucket& got = data[b * o.channels() + c];
+        ASSERT_FLOAT_EQ(got.min, want.min) << "level " << level << " bucket " << b;
+        ASSERT_FLOAT_EQ(got.max, want.max) << "level " << level << " bucket " << b;
+        ASSERT_NEAR(got.rms, want.rms, 1e-4f) << "level " << level << " bucket " << b;
+      }
+    }
+  }
+}
+
+std::string TempPath(const char* name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// 按给定块大小吐出固定 PCM 的解码器。
+class VectorDecoder : public Decoder {
+ public:
+  VectorDecoder(std::vector<float> pcm, int channels, size_t chunk)
+      : pcm_(std::move(pcm)), channels_(channels), chunk_(chunk) {}
+
+  bool Open(const std::string&) override { return true; }
+  bool Read(PcmBuffer& out) override {
+    const size_t frames = pcm_.size() / static_cast<size_t>(channels_);
+    if (pos_ >= frames) return false;
+    const size_t n = std::min(chunk_, frames - pos_);
+    out.interleaved.assign(pcm_.begin() + static_cast<std::ptrdiff_t>(pos_ * channels_),
+                           pcm_.begin() + static_cast<std::ptrdiff_t>((pos_ + n) * channels_));
+    out.sample_rate = 48000;
+    out.channels = channels_;
+    pos_ += n;
+    return true;
+  }
+  void Close() override {}
+  bool Seek(int64_t frame) override {
+    pos_ = static_cast<size_t>(frame);
+    return true;
+  }
+  int sample_rate() const override { return 48000; }
+  int channels() const override { return channels_; }
+  bool ConfigureOutput(int, int) override { return false; }
+  Status last_status() const override { return Status::kOk; }
+
+ private:
+  std::vector<float> pcm_;
+  int channels_;
+  size_t chunk_;
+  size_t pos_ = 0;
+};
+
+}  // namespace
+
+TEST(WaveformOverviewTest, LevelsMatchBruteForceAcrossChunking) {
+  // 10000 帧、基础桶 64：第 0 层 157 个桶（末桶不满），逐层减半到 1 个。
+  const std::vector<float> pcm = MakeSignal(10000, 2);
+  for (size_t chunk : {size_t{1}, size_t{37}, size_t{64}, size_t{1000}, size_t{10000}}) {
+    SCOPED_TRACE(chunk);
+    const WaveformOverview o = BuildInChunks(pcm, 2, 64, chunk);
+    ASSERT_TRUE(o.valid());
+    EXPECT_EQ(o.num_frames(), 10000);
+    EXPECT_EQ(o.sample_rate(), 44100);
+    ASSERT_EQ(o.num_levels(), 9);
+    EXPECT_EQ(o.level_buckets(0), 157);
+    EXPECT_EQ(o.level_buckets(1), 79);
+    EXPECT_EQ(o.level_buckets(8), 1);
+    EXPECT_EQ(o.bucket_frames(8), 64 << 8);
+    EXPECT_EQ(o.level_data(9), nullptr);
+    ExpectLevelsMatch(o, pcm);
+  }
+}
+
+TEST(WaveformOverviewTest, SaveOpenRoundTripNeedsNoDecode) {
+  const std::vector<float> pcm = MakeSignal(5000, 2);
+  const WaveformOverview built = BuildInChunks(pcm, 2, 32, 300);
+  const std::string path = TempPath("sw_waveform_overview_roundtrip.swov");
+  ASSERT_EQ(built.Save(path), Status::kOk);
+
+  WaveformOverview opened;
+  ASSERT_EQ(opened.Open(path), Status::kOk);
+  ASSERT_TRUE(opened.valid());
+  EXPECT_EQ(opened.sample_rate(), 44100);
+  EXPECT_EQ(opened.channels(), 2);
+  EXPECT_EQ(opened.num_frames(), 5000);
+  EXPECT_EQ(opened.base_bucket_frames(), 32);
+  ASSERT_EQ(opened.num_levels(), built.num_levels());
+  for (int level = 0; level < built.num_levels(); ++level) {
+    const size_t n = static_cast<size_t>(built.level_buckets(level)) * 2;
+    ASSERT_EQ(std::memcmp(opened.level_data(level), built.level_data(level),
+                          n * sizeof(WaveformBucket)),
+              0);
+  }
+  ExpectLevelsMatch(opened, pcm);
+
+  // 移动后映射仍然有效。
+  WaveformOverview moved = std::move(opened);
+  ASSERT_TRUE(moved.valid());
+  ExpectLevelsMatch(moved, pcm);
+  moved.Close();
+  EXPECT_FALSE(moved.valid());
+  std::remove(path.c_str());
+}
+
+TEST(WaveformOverviewTest, OpenRejectsMissingAndCorruptFiles) {
+  WaveformOverview o;
+  EXPECT_EQ(o.Open(TempPath("sw_waveform_overview_missing.swov")), Status::kIoError);
+  EXPECT_FALSE(o.valid());
+  EXPECT_EQ(WaveformOverview().Save(TempPath("sw_unused.swov")), Status::kInvalidState);
+
+  const std::vector<float> pcm = MakeSignal(4096, 1);
+  const WaveformOverview built = BuildInChunks(pcm, 1, 256, 4096);
+  const std::string path = TempPath("sw_waveform_overview_corrupt.swov");
+  ASSERT_EQ(built.Save(path), Status::kOk);
+  std::vector<char> bytes;
+  {
+    std::ifstream in(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  auto write = [&](const std::vector<char>& content) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(content.data(), static_cast<std::streamsize>(content.size()));
+  };
+
+  std::vector<char> bad_magic = bytes;
+  bad_magic[0] = 'X';
+  write(bad_magic);
+  EXPECT_EQ(o.Open(path), Status::kError);
+
+  std::vector<char> truncated(bytes.begin(), bytes.end() - 8);
+  write(truncated);
+  EXPECT_EQ(o.Open(path), Status::kError);
+
+  std::vector<char> wrong_frames = bytes;
+  wrong_frames[24] = static_cast<char>(wrong_frames[24] + 1);  // num_frames 低字节。
+  wrong_frames[25] = static_cast<char>(wrong_frames[25] + 1);
+  write(wrong_frames);
+  EXPECT_EQ(o.Open(path), Status::kError);
+  EXPECT_FALSE(o.valid());
+
+  write(bytes);
+  EXPECT_EQ(o.Open(path), Status::kOk);
+  std::remove(path.c_str());
+}
+
+TEST(WaveformOverviewTest, QueryPicksLevelAndAggregatesColumns) {
+  const std::vector<float> pcm = MakeSignal(1 << 16, 2);
+  const WaveformOverview o = BuildInChunks(pcm, 2, 256, 4096);
+  EXPECT_EQ(o.LevelFor(100.0), 0);
+  EXPECT_EQ(o.LevelFor(256.0), 0);
+  EXPECT_EQ(o.LevelFor(600.0), 1);
+  EXPECT_EQ(o.LevelFor(1e12), o.num_levels() - 1);
+
+  // 列边界与桶对齐时结果与暴力计算完全一致：整轨 64 列（每列 1024 帧 → 第 2 层）。
+  std::vector<WaveformBucket> out(64 * 2);
+  ASSERT_TRUE(o.Query(0, 1 << 16, 64, out.data(), out.size()));
+  for (int col = 0; col < 64; ++col) {
+    for (int c = 0; c < 2; ++c) {
+      const WaveformBucket want = BruteForce(pcm, 2, col * 1024, (col + 1) * 1024, c);
+      EXPECT_FLOAT_EQ(out[col * 2 + c].min, want.min);
+      EXPECT_FLOAT_EQ(out[col * 2 + c].max, want.max);
+      EXPECT_NEAR(out[col * 2 + c].rms, want.rms, 1e-4f);
+    }
+  }
+
+  // 不对齐的缩放：每列结果覆盖该列真实范围（按桶对齐向外取整）。
+  std::vector<WaveformBucket> zoom(37 * 2);
+  ASSERT_TRUE(o.Query(12345, 40000, 37, zoom.data(), zoom.size()));
+  const int64_t span = 40000 - 12345;
+  for (int col = 0; col < 37; ++col) {
+    const int64_t s = 12345 + span * col / 37;
+    const int64_t e = 12345 + span * (col + 1) / 37;
+    for (int c = 0; c < 2; ++c) {
+      const WaveformBucket want = BruteForce(pcm, 2, s, e, c);
+      EXPECT_LE(zoom[col * 2 + c].min, want.min);
+      EXPECT_GE(zoom[col * 2 + c].max, want.max);
+    }
+  }
+
+  // 列数多于帧数时每列至少取一个桶；超出轨道的终点被截断。
+  std::vector<WaveformBucket> dense(500 * 2);
+  EXPECT_TRUE(o.Query(1000, 1100, 500, dense.data(), dense.size()));
+  EXPECT_TRUE(o.Query((1 << 16) - 10, 1 << 20, 4, dense.data(), dense.size()));
+
+  EXPECT_FALSE(o.Query(100, 100, 4, dense.data(), dense.size()));
+  EXPECT_FALSE(o.Query(0, 1000, 0, dense.data(), dense.size()));
+  EXPECT_FALSE(o.Query(0, 1000, 4, dense.data(), 7));
+  EXPECT_FALSE(o.Query(0, 1000, 4, nullptr, 8));
+}
+
+TEST(WaveformOverviewTest, BuildsFromDecoder) {
+  const std::vector<float> pcm = MakeSignal(3000, 2);
+  VectorDecoder decoder(pcm, 2, 441);
+  WaveformOverview o;
+  ASSERT_EQ(BuildWaveformOverview(decoder, WaveformOverviewConfig{128}, &o), Status::kOk);
+  EXPECT_EQ(o.sample_rate(), 48000);
+  EXPECT_EQ(o.num_frames(), 3000);
+  ExpectLevelsMatch(o, pcm);
+
+  // 占位解码器直接 EOF：得到有效但为空的概览，可照常保存/打开。
+  auto stub = CreateStubDecoder();
+  ASSERT_TRUE(stub->Open("file:///tmp/sample.mp3"));
+  WaveformOverview empty;
+  ASSERT_EQ(BuildWaveformOverview(*stub, WaveformOverviewConfig{}, &empty), Status::kOk);
+  EXPECT_TRUE(empty.valid());
+  EXPECT_EQ(empty.num_levels(), 0);
+  std::vector<WaveformBucket> out(8);
+  EXPECT_FALSE(empty.Query(0, 100, 4, out.data(), out.size()));
+  const std::string path = TempPath("sw_waveform_overview_empty.swov");
+  ASSERT_EQ(empty.Save(path), Status::kOk);
+  WaveformOverview reopened;
+  EXPECT_EQ(reopened.Open(path), Status::kOk);
+  EXPECT_EQ(reopened.num_frames(), 0);
+  std::remove(path.c_str());
+
+  EXPECT_EQ(BuildWaveformOverview(decoder, WaveformOverviewConfig{0}, &o),
+            Status::kInvalidArguments);
+  WaveformOverviewBuilder builder;
+  EXPECT_FALSE(builder.Append(pcm.data(), 10));
+  EXPECT_FALSE(builder.Finish(&o));
+}
+
+}  // namespace sw
@@ -21,7 +21,12 @@ Java_com_soundwave_core_SpectrumEngine_computeSpectrumNative(
   cfg.power_spectrum = power_spectrum == JNI_TRUE;
   cfg.window = (window_type == 1) ? sw::WindowType::kHamming : sw::WindowType::kHann;
 
-  const auto spectrum = sw::ComputeSpectrum(input, static_cast<int>(sample_rate), cfg);
+  // 每个调用线程复用一个分析器：窗长/窗型不变时不重建 FFT 计划与窗表。
+  thread_local sw::SpectrumAnalyzer analyzer;
+  if (!analyzer.Configure(cfg)) {
+    return nullptr;
+  }
+  const auto spectrum = analyzer.Compute(input);
   if (spectrum.empty()) {
     return nullptr;
   }
@@ -10,36 +10,42 @@ public final class SpectrumEngine {
     public let windowType: WindowType
     public let powerSpectrum: Bool
 
+    // 复用的 FFT 计划（窗表/临时缓冲），窗长与窗型在实例生命周期内固定。
+    private let plan: OpaquePointer?
+
     public init(windowSize: Int = 1024,
                 windowType: WindowType = .hann,
                 powerSpectrum: Bool = true) {
         self.windowSize = windowSize
         self.windowType = windowType
         self.powerSpectrum = powerSpectrum
+        self.plan = sw_fft_plan_create(Int32(windowSize), windowType.rawValue)
+    }
+
+    deinit {
+        sw_fft_plan_destroy(plan)
     }
 
+    // 非线程安全：同一实例请勿并发调用。
     public func compute(samples: [Float], sampleRate: Int) -> (bins: [Float], binHz: Double)? {
-        guard !samples.isEmpty, sampleRate > 0 else { return nil }
-        var outPtr: UnsafeMutablePointer<Float>?
-        var outLen: Int = 0
+        guard !samples.isEmpty, sampleRate > 0, let plan = plan else { return nil }
+        let binCount = sw_fft_plan_bins(plan)
+        guard binCount > 0 else { return nil }
+        var bins = [Float](repeating: 0, count: binCount)
         var outBinHz: Float = 0
         let code = samples.withUnsafeBufferPointer { buf -> Int32 in
-            return sw_fft_compute(buf.baseAddress,
-                                  buf.count,
-                                  Int32(sampleRate),
-                                  Int32(windowSize),
-                                  windowType.rawValue,
-                                  powerSpectrum,
-                                  &outPtr,
-                                  &outLen,
-                                  &outBinHz)
-        }
-        guard code == 0, let ptr = outPtr, outLen > 0 else {
-            if let ptr = outPtr { sw_fft_free(ptr) }
-            return nil
+            bins.withUnsafeMutableBufferPointer { out -> Int32 in
+                return sw_fft_plan_compute(plan,
+                                           buf.baseAddress,
+                                           buf.count,
+                                           Int32(sampleRate),
+                                           powerSpectrum,
+                                           out.baseAddress,
+                                           out.count,
+                                           &outBinHz)
+            }
         }
-        let bins = Array(UnsafeBufferPointer(start: ptr, count: outLen))
-        sw_fft_free(ptr)
+        guard code == 0 else { return nil }
         return (bins, Double(outBinHz))
     }
 }
@@ -10,6 +10,16 @@
 #define KISS_FFT_PI 3.14159265358979323846f
 #endif
 
+struct sw_fft_plan {
+  int window_size;
+  int window_type;
+  kiss_fftr_cfg cfg;
+  float* window;
+  float inv_window_sum;
+  float* windowed;
+  kiss_fft_cpx* freq;
+};
+
 // 简单 Hann/Hamming 窗口。
 static float window_value(int n, int N, int window_type) {
   switch (window_type) {
@@ -20,6 +30,87 @@ static float window_value(int n, int N, int window_type) {
   }
 }
 
+sw_fft_plan* sw_fft_plan_create(int window_size, int window_type) {
+  if (window_size <= 0) {
+    return NULL;
+  }
+  const int N = window_size;
+  sw_fft_plan* plan = (sw_fft_plan*)calloc(1, sizeof(sw_fft_plan));
+  if (!plan) return NULL;
+  plan->window_size = N;
+  plan->window_type = window_type;
+  plan->cfg = kiss_fftr_alloc(N, 0, NULL, NULL);
+  plan->window = (float*)malloc(sizeof(float) * (size_t)N);
+  plan->windowed = (float*)malloc(sizeof(float) * (size_t)N);
+  plan->freq = (kiss_fft_cpx*)malloc(sizeof(kiss_fft_cpx) * (size_t)(N / 2 + 1));
+  if (!plan->cfg || !plan->window || !plan->windowed || !plan->freq) {
+    sw_fft_plan_destroy(plan);
+    return NULL;
+  }
+  float window_sum = 0.0f;
+  for (int n = 0; n < N; ++n) {
+    const float w = window_value(n, N, window_type);
+    plan->window[n] = w;
+    window_sum += w;
+  }
+  if (window_sum <= 0.0f) {
+    sw_fft_plan_destroy(plan);
+    return NULL;
+  }
+  plan->inv_window_sum = 1.0f / window_sum;
+  return plan;
+}
+
+size_t sw_fft_plan_bins(const sw_fft_plan* plan) {
+  return plan ? (size_t)(plan->window_size / 2 + 1) : 0;
+}
+
+int sw_fft_plan_compute(sw_fft_plan* plan,
+                        const float* samples,
+                        size_t length,
+                        int sample_rate,
+                        bool power_spectrum,
+                        float* out_spectrum,
+                        size_t out_capacity,
+                        float* out_bin_hz) {
+  if (!plan || !samples || length == 0 || sample_rate <= 0 || !out_spectrum || !out_bin_hz) {
+    return -1;
+  }
+  const int N = plan->window_size;
+  if ((int)length < N) {
+    return -2;
+  }
+  const size_t bins = (size_t)(N / 2 + 1);
+  if (out_capacity < bins) {
+    return -7;
+  }
+  for (int n = 0; n < N; ++n) {
+    plan->windowed[n] = samples[n] * plan->window[n];
+  }
+  kiss_fftr(plan->cfg, plan->windowed, plan->freq);
+
+  const float inv_window_sum = plan->inv_window_sum;
+  for (size_t k = 0; k < bins; ++k) {
+    const float real = plan->freq[k].r;
+    const float imag = plan->freq[k].i;
+    const float mag2 = real * real + imag * imag;
+    out_spectrum[k] =
+        power_spectrum ? (mag2 * inv_window_sum * inv_window_sum)
+                       : (sqrtf(mag2) * inv_window_sum);
+  }
+  *out_bin_hz = (float)sample_rate / (float)N;
+  return 0;
+}
+
+void sw_fft_plan_destroy(sw_fft_plan* plan) {
+  if (!plan) return;
+  if (plan->cfg) kiss_fftr_free(plan->cfg);
+  free(plan->window);
+  free(plan->windowed);
+  free(plan->freq);
+  free(plan);
+}
+
 int sw_fft_compute(const float* samples,
                    size_t length,
                    int sample_rate,
@@ -36,56 +127,25 @@ int sw_fft_compute(const float* samples,
   if ((int)length < window_size) {
     return -2;
   }
-  const int N = window_size;
-  float* windowed = (float*)malloc(sizeof(float) * (size_t)N);
-  if (!windowed) return -3;
-  float window_sum = 0.0f;
-  for (int n = 0; n < N; ++n) {
-    const float w = window_value(n, N, window_type);
-    windowed[n] = samples[n] * w;
-    window_sum += w;
-  }
-  if (window_sum <= 0.0f) {
-    free(windowed);
-    return -4;
-  }
-  const float inv_window_sum = 1.0f / window_sum;
-
-  kiss_fftr_cfg cfg = kiss_fftr_alloc(N, 0, NULL, NULL);
-  if (!cfg) {
-    free(windowed);
+  sw_fft_plan* plan = sw_fft_plan_create(window_size, window_type);
+  if (!plan) {
     return -5;
   }
-  kiss_fft_cpx* freq = (kiss_fft_cpx*)malloc(sizeof(kiss_fft_cpx) * (size_t)(N / 2 + 1));
-  if (!freq) {
-    free(cfg);
-    free(windowed);
-    return -6;
-  }
-
-  kiss_fftr(cfg, windowed, freq);
-  free(windowed);
-  kiss_fftr_free(cfg);
-
-  const size_t bins = (size_t)(N / 2 + 1);
+  const size_t bins = sw_fft_plan_bins(plan);
   float* spectrum = (float*)malloc(sizeof(float) * bins);
   if (!spectrum) {
-    free(freq);
+    sw_fft_plan_destroy(plan);
     return -7;
   }
-  for (size_t k = 0; k < bins; ++k) {
-    const float real = freq[k].r;
-    const float imag = freq[k].i;
-    const float mag2 = real * real + imag * imag;
-    spectrum[k] =
-        power_spectrum ? (mag2 * inv_window_sum * inv_window_sum)
-                       : (sqrtf(mag2) * inv_window_sum);
+  const int code = sw_fft_plan_compute(plan, samples, length, sample_rate, power_spectrum,
+                                       spectrum, bins, out_bin_hz);
+  sw_fft_plan_destroy(plan);
+  if (code != 0) {
+    free(spectrum);
+    return code;
   }
-
-  free(freq);
   *out_spectrum = spectrum;
   *out_len = bins;
-  *out_bin_hz = (float)sample_rate / (float)N;
   return 0;
 }
 
@@ -23,6 +23,27 @@ int sw_fft_compute(const float* samples,
 
 void sw_fft_free(float* ptr);
 
+// 可复用的 FFT 计划：持有 kiss_fftr 配置、预计算窗表及其和、临时缓冲。
+// 同一计划不可并发使用；窗长/窗型固定，重复计算不再分配。
+typedef struct sw_fft_plan sw_fft_plan;
+
+// 失败（参数非法或内存不足）返回 NULL。
+sw_fft_plan* sw_fft_plan_create(int window_size, int window_type);
+
+size_t sw_fft_plan_bins(const sw_fft_plan* plan);
+
+// 将 window_size/2+1 个 bin 写入 out_spectrum（容量 out_capacity）；返回值同 sw_fft_compute。
+int sw_fft_plan_compute(sw_fft_plan* plan,
+                        const float* samples,
+                        size_t length,
+                        int sample_rate,
+                        bool power_spectrum,
+                        float* out_spectrum,
+                        size_t out_capacity,
+                        float* out_bin_hz);
+
+void sw_fft_plan_destroy(sw_fft_plan* plan);
+
 #ifdef __cplusplus
 }
 #endif